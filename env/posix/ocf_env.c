@@ -8,6 +8,19 @@
 #include <execinfo.h>
 
 /* ALLOCATOR */
+
+/* Maximum number of items and bytes kept in per-thread cache */
+#define ENV_ALLOCATOR_TCACHE_ITEMS	64
+#define ENV_ALLOCATOR_TCACHE_BYTES	(256 * 1024)
+
+/* Number of allocators which may use per-thread caches at the same time */
+#define ENV_ALLOCATOR_TCACHE_IDS	1024
+
+/* Marks allocator without per-thread cache */
+#define ENV_ALLOCATOR_TCACHE_NO_ID	ENV_ALLOCATOR_TCACHE_IDS
+
+struct _env_allocator_tcache;
+
 struct _env_allocator {
 	/*!< Memory pool ID unique name */
 	char *name;
@@ -20,8 +33,48 @@ struct _env_allocator {
 
 	/*!< Should buffer be zeroed while allocating */
 	bool zero;
+
+	/*!< Capacity of per-thread cache (0 - caching disabled) */
+	uint32_t tcache_max;
+
+	/*!< Index of allocator in per-thread cache tables */
+	uint32_t tcache_id;
+
+	/*!< Per-thread caches of freed items, protected by tcache_lock */
+	struct _env_allocator_tcache *tcaches;
+};
+
+/*
+ * Items freed by given thread are kept in its cache and handed out to next
+ * allocations made by the same thread, so steady state allocation and
+ * freeing of requests doesn't go to malloc at all. Caches are linked to
+ * the allocator, so that cached items can be released on destroy.
+ */
+struct _env_allocator_tcache {
+	env_allocator *allocator;
+	struct _env_allocator_tcache *prev, *next;
+	/* Entry in table of owning thread */
+	struct _env_allocator_tcache **slot;
+	uint32_t count;
+	void *items[];
+};
+
+/*
+ * Caches of given thread are kept in single table indexed by allocator
+ * tcache_id and bound to one process-wide key, so number of allocators
+ * isn't limited by number of thread-specific keys.
+ */
+struct _env_allocator_tcache_table {
+	struct _env_allocator_tcache *caches[ENV_ALLOCATOR_TCACHE_IDS];
 };
 
+static pthread_key_t tcache_key;
+
+/* Protects tcache_ids and lists of per-thread caches of all allocators */
+static pthread_mutex_t tcache_lock = PTHREAD_MUTEX_INITIALIZER;
+static unsigned long tcache_ids[ENV_ALLOCATOR_TCACHE_IDS /
+		(sizeof(unsigned long) * 8)];
+
 static inline size_t env_allocator_align(size_t size)
 {
 	if (size <= 2)
@@ -35,11 +88,138 @@ struct _env_allocator_item {
 	char data[];
 };
 
+static void env_allocator_tcache_drain(struct _env_allocator_tcache *tcache)
+{
+	while (tcache->count)
+		free(tcache->items[--tcache->count]);
+}
+
+static void env_allocator_tcache_unlink(struct _env_allocator_tcache *tcache)
+{
+	env_allocator *allocator = tcache->allocator;
+
+	if (tcache->prev)
+		tcache->prev->next = tcache->next;
+	else
+		allocator->tcaches = tcache->next;
+	if (tcache->next)
+		tcache->next->prev = tcache->prev;
+
+	*tcache->slot = NULL;
+}
+
+/* Called on thread exit */
+static void env_allocator_tcache_release(void *ctx)
+{
+	struct _env_allocator_tcache_table *table = ctx;
+	struct _env_allocator_tcache *tcache;
+	unsigned i;
+
+	pthread_mutex_lock(&tcache_lock);
+	for (i = 0; i < ENV_ALLOCATOR_TCACHE_IDS; i++) {
+		tcache = table->caches[i];
+		if (!tcache)
+			continue;
+
+		env_allocator_tcache_unlink(tcache);
+		env_allocator_tcache_drain(tcache);
+		free(tcache);
+	}
+	pthread_mutex_unlock(&tcache_lock);
+
+	free(table);
+}
+
+static void __attribute__((constructor)) init_allocator_tcache(void)
+{
+	ENV_BUG_ON(pthread_key_create(&tcache_key,
+			env_allocator_tcache_release));
+}
+
+static void __attribute__((destructor)) deinit_allocator_tcache(void)
+{
+	pthread_key_delete(tcache_key);
+}
+
+static inline struct _env_allocator_tcache *env_allocator_tcache_lookup(
+		env_allocator *allocator)
+{
+	struct _env_allocator_tcache_table *table;
+
+	table = pthread_getspecific(tcache_key);
+
+	return table ? table->caches[allocator->tcache_id] : NULL;
+}
+
+static struct _env_allocator_tcache *env_allocator_tcache_get(
+		env_allocator *allocator)
+{
+	struct _env_allocator_tcache_table *table;
+	struct _env_allocator_tcache *tcache;
+
+	table = pthread_getspecific(tcache_key);
+	if (table && table->caches[allocator->tcache_id])
+		return table->caches[allocator->tcache_id];
+
+	if (!table) {
+		table = calloc(1, sizeof(*table));
+		if (!table)
+			return NULL;
+
+		if (pthread_setspecific(tcache_key, table)) {
+			free(table);
+			return NULL;
+		}
+	}
+
+	tcache = calloc(1, sizeof(*tcache) +
+			allocator->tcache_max * sizeof(tcache->items[0]));
+	if (!tcache)
+		return NULL;
+
+	tcache->allocator = allocator;
+	tcache->slot = &table->caches[allocator->tcache_id];
+
+	pthread_mutex_lock(&tcache_lock);
+	tcache->next = allocator->tcaches;
+	if (tcache->next)
+		tcache->next->prev = tcache;
+	allocator->tcaches = tcache;
+	*tcache->slot = tcache;
+	pthread_mutex_unlock(&tcache_lock);
+
+	return tcache;
+}
+
+/* Returns ENV_ALLOCATOR_TCACHE_NO_ID if all ids are taken */
+static uint32_t env_allocator_tcache_id_get(void)
+{
+	uint32_t id;
+
+	pthread_mutex_lock(&tcache_lock);
+	for (id = 0; id < ENV_ALLOCATOR_TCACHE_IDS; id++) {
+		if (!env_bit_test(id, tcache_ids)) {
+			env_bit_set(id, tcache_ids);
+			break;
+		}
+	}
+	pthread_mutex_unlock(&tcache_lock);
+
+	return id;
+}
+
 void *env_allocator_new(env_allocator *allocator)
 {
 	struct _env_allocator_item *item = NULL;
+	struct _env_allocator_tcache *tcache = NULL;
+
+	if (allocator->tcache_max)
+		tcache = env_allocator_tcache_lookup(allocator);
 
-	item = malloc(allocator->item_size);
+	if (tcache && tcache->count)
+		item = tcache->items[--tcache->count];
+	else
+		item = malloc(allocator->item_size);
 
 	if (!item) {
 		return NULL;
@@ -76,11 +256,22 @@ env_allocator *env_allocator_create(uint32_t size, const char *name, bool zero)
 		goto err;
 	}
 
+	/* Allocators created when all ids are taken just don't cache items */
+	allocator->tcache_id = env_allocator_tcache_id_get();
+	if (allocator->tcache_id != ENV_ALLOCATOR_TCACHE_NO_ID) {
+		allocator->tcache_max = MIN(ENV_ALLOCATOR_TCACHE_ITEMS,
+				ENV_ALLOCATOR_TCACHE_BYTES /
+				allocator->item_size);
+	}
+
 	return allocator;
 
 err:
 	printf("Cannot create memory allocator, ERROR %d", error);
-	env_allocator_destroy(allocator);
+	if (allocator) {
+		free(allocator->name);
+		free(allocator);
+	}
 
 	return NULL;
 }
@@ -89,20 +280,44 @@ void env_allocator_del(env_allocator *allocator, void *obj)
 {
 	struct _env_allocator_item *item =
 		container_of(obj, struct _env_allocator_item, data);
+	struct _env_allocator_tcache *tcache = NULL;
 
 	env_atomic_dec(&allocator->count);
 
-	free(item);
+	if (allocator->tcache_max)
+		tcache = env_allocator_tcache_get(allocator);
+
+	if (tcache && tcache->count < allocator->tcache_max)
+		tcache->items[tcache->count++] = item;
+	else
+		free(item);
 }
 
+/*
+ * Allocator must not be used by any thread at this point. Caches of threads
+ * which are still alive are released here and removed from their tables,
+ * so that allocator id can be reused.
+ */
 void env_allocator_destroy(env_allocator *allocator)
 {
+	struct _env_allocator_tcache *tcache;
+
 	if (allocator) {
 		if (env_atomic_read(&allocator->count)) {
 			printf("Not all objects deallocated\n");
 			ENV_WARN(true, OCF_PREFIX_SHORT" Cleanup problem\n");
 		}
 
+		pthread_mutex_lock(&tcache_lock);
+		while ((tcache = allocator->tcaches)) {
+			env_allocator_tcache_unlink(tcache);
+			env_allocator_tcache_drain(tcache);
+			free(tcache);
+		}
+		if (allocator->tcache_id != ENV_ALLOCATOR_TCACHE_NO_ID)
+			env_bit_clear(allocator->tcache_id, tcache_ids);
+		pthread_mutex_unlock(&tcache_lock);
+
 		free(allocator->name);
 		free(allocator);
 	}
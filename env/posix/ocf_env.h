@@ -32,6 +32,7 @@
 #include <zlib.h>
 
 #include "ocf_env_list.h"
+#include "ocf_env_rwlock.h"
 #include "ocf_env_headers.h"
 #include "ocf/ocf_err.h"
 #include "utils_mpool.h"
@@ -290,47 +291,48 @@ static inline int env_rmutex_destroy(env_rmutex *rmutex)
 
 /* RW SEMAPHORE */
 typedef struct {
-	 pthread_rwlock_t lock;
+	env_rp_rwlock lock;
 } env_rwsem;
 
 static inline int env_rwsem_init(env_rwsem *s)
 {
-	return pthread_rwlock_init(&s->lock, NULL);
+	env_rp_rwlock_init(&s->lock);
+	return 0;
 }
 
 static inline void env_rwsem_up_read(env_rwsem *s)
 {
-	pthread_rwlock_unlock(&s->lock);
+	env_rp_rwlock_read_unlock(&s->lock);
 }
 
 static inline void env_rwsem_down_read(env_rwsem *s)
 {
-	ENV_BUG_ON(pthread_rwlock_rdlock(&s->lock));
+	env_rp_rwlock_read_lock(&s->lock);
 }
 
 static inline int env_rwsem_down_read_trylock(env_rwsem *s)
 {
-	return pthread_rwlock_tryrdlock(&s->lock) ? -OCF_ERR_NO_LOCK : 0;
+	return env_rp_rwlock_read_trylock(&s->lock) ? 0 : -OCF_ERR_NO_LOCK;
 }
 
 static inline void env_rwsem_up_write(env_rwsem *s)
 {
-	ENV_BUG_ON(pthread_rwlock_unlock(&s->lock));
+	env_rp_rwlock_write_unlock(&s->lock);
 }
 
 static inline void env_rwsem_down_write(env_rwsem *s)
 {
-	ENV_BUG_ON(pthread_rwlock_wrlock(&s->lock));
+	env_rp_rwlock_write_lock(&s->lock);
 }
 
 static inline int env_rwsem_down_write_trylock(env_rwsem *s)
 {
-	return pthread_rwlock_trywrlock(&s->lock) ? -OCF_ERR_NO_LOCK : 0;
+	return env_rp_rwlock_write_trylock(&s->lock) ? 0 : -OCF_ERR_NO_LOCK;
 }
 
 static inline int env_rwsem_destroy(env_rwsem *s)
 {
-	return pthread_rwlock_destroy(&s->lock);
+	return env_rp_rwlock_is_locked(&s->lock) ? -EBUSY : 0;
 }
 
 /* COMPLETION */
@@ -524,37 +526,37 @@ static inline void env_spinlock_destroy(env_spinlock *l)
 
 /* RW LOCKS */
 typedef struct {
-	pthread_rwlock_t lock;
+	env_rp_rwlock lock;
 } env_rwlock;
 
 static inline void env_rwlock_init(env_rwlock *l)
 {
-	ENV_BUG_ON(pthread_rwlock_init(&l->lock, NULL));
+	env_rp_rwlock_init(&l->lock);
 }
 
 static inline void env_rwlock_read_lock(env_rwlock *l)
 {
-	ENV_BUG_ON(pthread_rwlock_rdlock(&l->lock));
+	env_rp_rwlock_read_lock(&l->lock);
 }
 
 static inline void env_rwlock_read_unlock(env_rwlock *l)
 {
-	ENV_BUG_ON(pthread_rwlock_unlock(&l->lock));
+	env_rp_rwlock_read_unlock(&l->lock);
 }
 
 static inline void env_rwlock_write_lock(env_rwlock *l)
 {
-	ENV_BUG_ON(pthread_rwlock_wrlock(&l->lock));
+	env_rp_rwlock_write_lock(&l->lock);
 }
 
 static inline void env_rwlock_write_unlock(env_rwlock *l)
 {
-	ENV_BUG_ON(pthread_rwlock_unlock(&l->lock));
+	env_rp_rwlock_write_unlock(&l->lock);
 }
 
 static inline void env_rwlock_destroy(env_rwlock *l)
 {
-	ENV_BUG_ON(pthread_rwlock_destroy(&l->lock));
+	ENV_BUG_ON(env_rp_rwlock_is_locked(&l->lock));
 }
 
 /* BIT OPERATIONS */
@@ -583,6 +585,12 @@ static inline bool env_bit_test(int nr, const volatile unsigned long *addr)
 	return !!(*byte & mask);
 }
 
+/* Number of trailing zero bits, val must be non-zero */
+static inline unsigned env_ctz64(uint64_t val)
+{
+	return __builtin_ctzll(val);
+}
+
 /* SCHEDULING */
 static inline int env_in_interrupt(void)
 {
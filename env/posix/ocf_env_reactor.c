@@ -0,0 +1,782 @@
+/*
+ * Copyright(c) 2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "ocf_env.h"
+#include "ocf_env_reactor.h"
+#include <sched.h>
+#include <time.h>
+
+#define ENV_REACTOR_POLLERS_MAX		64
+#define ENV_REACTOR_MSG_RING_SIZE	1024
+#define ENV_REACTOR_MSG_BUDGET		64
+#define ENV_REACTOR_QUEUE_BUDGET	64
+
+/* Retry period of cleaner which has no queue to run on */
+#define ENV_REACTOR_CLEANER_RETRY_US	1000000
+
+struct env_reactor_msg {
+	uint64_t seq;
+	env_reactor_msg_t fn;
+	void *arg;
+};
+
+struct env_reactor_poller {
+	env_reactor_poll_t fn;
+	void *priv;
+};
+
+struct env_reactor_queue {
+	ocf_queue_t queue;
+	struct env_reactor *reactor;
+	struct list_head list;
+};
+
+struct env_reactor_cleaner {
+	ocf_cleaner_t cleaner;
+
+	/* Reactor running cleaner poller, changed under lock */
+	struct env_reactor *reactor;
+	pthread_mutex_t lock;
+
+	/* Registry queues generation cleaner placement was checked at */
+	uint32_t queues_gen;
+
+	uint64_t next_run_us;
+	bool running;
+};
+
+struct env_reactor {
+	struct env_reactor_config cfg;
+
+	/* Bounded MPSC message ring (Vyukov's algorithm) */
+	struct env_reactor_msg msgs[ENV_REACTOR_MSG_RING_SIZE];
+	uint64_t msg_enqueue_pos __attribute__((__aligned__(64)));
+	uint64_t msg_dequeue_pos __attribute__((__aligned__(64)));
+
+	/* Modified only from reactor thread */
+	struct env_reactor_poller pollers[ENV_REACTOR_POLLERS_MAX];
+	uint32_t pollers_nr;
+
+	/* Timestamp of current loop iteration */
+	uint64_t now_us;
+
+	int sleeping __attribute__((__aligned__(64)));
+	sem_t wake_sem;
+
+	/* Queues served by reactor, protected by registry lock */
+	struct list_head queues;
+	struct list_head list;
+
+	pthread_t thread;
+	env_atomic stop;
+};
+
+static struct {
+	pthread_mutex_t lock;
+	struct list_head reactors;
+	uint32_t cleaner_rr;
+
+	/* Bumped each time queue is added to any reactor */
+	uint32_t queues_gen;
+} env_reactor_registry = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.reactors = LIST_HEAD_INIT(env_reactor_registry.reactors),
+};
+
+static __thread struct env_reactor *env_reactor_current;
+
+static inline uint64_t env_reactor_now_us(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+static inline void env_reactor_cpu_relax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#endif
+}
+
+struct env_reactor *env_reactor_get_current(void)
+{
+	return env_reactor_current;
+}
+
+/* MESSAGES */
+int env_reactor_send(struct env_reactor *reactor, env_reactor_msg_t fn,
+		void *arg)
+{
+	struct env_reactor_msg *msg;
+	uint64_t pos, seq;
+	int64_t dif;
+
+	pos = __atomic_load_n(&reactor->msg_enqueue_pos, __ATOMIC_RELAXED);
+	for (;;) {
+		msg = &reactor->msgs[pos % ENV_REACTOR_MSG_RING_SIZE];
+		seq = __atomic_load_n(&msg->seq, __ATOMIC_ACQUIRE);
+		dif = (int64_t)seq - (int64_t)pos;
+		if (dif == 0) {
+			if (__atomic_compare_exchange_n(
+					&reactor->msg_enqueue_pos, &pos,
+					pos + 1, true, __ATOMIC_RELAXED,
+					__ATOMIC_RELAXED)) {
+				break;
+			}
+		} else if (dif < 0) {
+			return -EAGAIN;
+		} else {
+			pos = __atomic_load_n(&reactor->msg_enqueue_pos,
+					__ATOMIC_RELAXED);
+		}
+	}
+
+	msg->fn = fn;
+	msg->arg = arg;
+	__atomic_store_n(&msg->seq, pos + 1, __ATOMIC_RELEASE);
+
+	env_reactor_wake(reactor);
+
+	return 0;
+}
+
+static int env_reactor_process_msgs(struct env_reactor *reactor)
+{
+	struct env_reactor_msg *msg;
+	uint64_t pos;
+	int count = 0;
+
+	while (count < ENV_REACTOR_MSG_BUDGET) {
+		pos = reactor->msg_dequeue_pos;
+		msg = &reactor->msgs[pos % ENV_REACTOR_MSG_RING_SIZE];
+		if (__atomic_load_n(&msg->seq, __ATOMIC_ACQUIRE) != pos + 1)
+			break;
+
+		reactor->msg_dequeue_pos = pos + 1;
+		msg->fn(reactor, msg->arg);
+		__atomic_store_n(&msg->seq, pos + ENV_REACTOR_MSG_RING_SIZE,
+				__ATOMIC_RELEASE);
+		count++;
+	}
+
+	return count;
+}
+
+struct env_reactor_sync_msg {
+	env_reactor_msg_t fn;
+	void *arg;
+	env_completion cmpl;
+};
+
+static void env_reactor_sync_msg_handle(struct env_reactor *reactor,
+		void *arg)
+{
+	struct env_reactor_sync_msg *msg = arg;
+
+	msg->fn(reactor, msg->arg);
+	env_completion_complete(&msg->cmpl);
+}
+
+/*
+ * Execute function in reactor context and wait until it's done. If called
+ * from reactor thread, function is executed directly.
+ */
+static void env_reactor_call_sync(struct env_reactor *reactor,
+		env_reactor_msg_t fn, void *arg)
+{
+	struct env_reactor_sync_msg msg = { .fn = fn, .arg = arg };
+
+	if (env_reactor_current == reactor) {
+		fn(reactor, arg);
+		return;
+	}
+
+	env_completion_init(&msg.cmpl);
+	while (env_reactor_send(reactor, env_reactor_sync_msg_handle, &msg))
+		sched_yield();
+	env_completion_wait(&msg.cmpl);
+	env_completion_destroy(&msg.cmpl);
+}
+
+/* POLLERS */
+struct env_reactor_poller_op {
+	struct env_reactor_poller poller;
+	int result;
+};
+
+static void _env_reactor_poller_register(struct env_reactor *reactor,
+		void *arg)
+{
+	struct env_reactor_poller_op *op = arg;
+
+	if (reactor->pollers_nr >= ENV_REACTOR_POLLERS_MAX) {
+		op->result = -ENOSPC;
+		return;
+	}
+
+	reactor->pollers[reactor->pollers_nr++] = op->poller;
+	op->result = 0;
+}
+
+static void _env_reactor_poller_unregister(struct env_reactor *reactor,
+		void *arg)
+{
+	struct env_reactor_poller_op *op = arg;
+	uint32_t i;
+
+	for (i = 0; i < reactor->pollers_nr; i++) {
+		if (reactor->pollers[i].fn != op->poller.fn ||
+				reactor->pollers[i].priv != op->poller.priv) {
+			continue;
+		}
+
+		reactor->pollers[i] = reactor->pollers[--reactor->pollers_nr];
+		return;
+	}
+}
+
+int env_reactor_poller_register(struct env_reactor *reactor,
+		env_reactor_poll_t fn, void *priv)
+{
+	struct env_reactor_poller_op op = {
+		.poller = { .fn = fn, .priv = priv },
+	};
+
+	env_reactor_call_sync(reactor, _env_reactor_poller_register, &op);
+
+	return op.result;
+}
+
+void env_reactor_poller_unregister(struct env_reactor *reactor,
+		env_reactor_poll_t fn, void *priv)
+{
+	struct env_reactor_poller_op op = {
+		.poller = { .fn = fn, .priv = priv },
+	};
+
+	env_reactor_call_sync(reactor, _env_reactor_poller_unregister, &op);
+}
+
+/* MAIN LOOP */
+void env_reactor_wake(struct env_reactor *reactor)
+{
+	if (env_reactor_current == reactor)
+		return;
+
+	if (__atomic_load_n(&reactor->sleeping, __ATOMIC_SEQ_CST) &&
+			__atomic_exchange_n(&reactor->sleeping, 0,
+					__ATOMIC_SEQ_CST)) {
+		sem_post(&reactor->wake_sem);
+	}
+}
+
+static int env_reactor_poll_once(struct env_reactor *reactor)
+{
+	int work;
+	uint32_t i;
+
+	reactor->now_us = env_reactor_now_us();
+
+	work = env_reactor_process_msgs(reactor);
+
+	/* Pollers may unregister themselves, so re-check count each time */
+	for (i = 0; i < reactor->pollers_nr; i++)
+		work += reactor->pollers[i].fn(reactor->pollers[i].priv);
+
+	return work;
+}
+
+static void env_reactor_sleep(struct env_reactor *reactor, uint32_t us)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_REALTIME, &ts);
+	ts.tv_nsec += (us % 1000000) * 1000;
+	ts.tv_sec += us / 1000000 + ts.tv_nsec / 1000000000;
+	ts.tv_nsec %= 1000000000;
+
+	sem_timedwait(&reactor->wake_sem, &ts);
+}
+
+static void *env_reactor_thread(void *ctx)
+{
+	struct env_reactor *reactor = ctx;
+	uint64_t idle_since = 0;
+	uint32_t sleep_us = 1;
+
+	env_reactor_current = reactor;
+
+	while (!env_atomic_read(&reactor->stop)) {
+		if (env_reactor_poll_once(reactor)) {
+			idle_since = 0;
+			sleep_us = 1;
+			continue;
+		}
+
+		if (!idle_since)
+			idle_since = reactor->now_us;
+
+		if (reactor->now_us - idle_since < reactor->cfg.busy_poll_us) {
+			env_reactor_cpu_relax();
+			continue;
+		}
+
+		/*
+		 * Announce sleeping before final check for work, so that
+		 * anyone who adds work after the check will see the flag and
+		 * wake us up.
+		 */
+		__atomic_store_n(&reactor->sleeping, 1, __ATOMIC_SEQ_CST);
+		if (env_reactor_poll_once(reactor) ||
+				env_atomic_read(&reactor->stop)) {
+			__atomic_store_n(&reactor->sleeping, 0,
+					__ATOMIC_SEQ_CST);
+			idle_since = 0;
+			sleep_us = 1;
+			continue;
+		}
+
+		env_reactor_sleep(reactor, sleep_us);
+		__atomic_store_n(&reactor->sleeping, 0, __ATOMIC_SEQ_CST);
+		sleep_us = MIN(sleep_us * 2, reactor->cfg.max_sleep_us);
+	}
+
+	/* Drain messages - senders of synchronous messages may wait */
+	while (env_reactor_process_msgs(reactor))
+		;
+
+	env_reactor_current = NULL;
+
+	return NULL;
+}
+
+struct env_reactor *env_reactor_create(const struct env_reactor_config *cfg)
+{
+	struct env_reactor *reactor;
+	cpu_set_t cpuset;
+	uint32_t i;
+
+	reactor = env_zalloc(sizeof(*reactor), ENV_MEM_NORMAL);
+	if (!reactor)
+		return NULL;
+
+	reactor->cfg = *cfg;
+	reactor->cfg.max_sleep_us = MAX(reactor->cfg.max_sleep_us, 1);
+
+	for (i = 0; i < ENV_REACTOR_MSG_RING_SIZE; i++)
+		reactor->msgs[i].seq = i;
+
+	INIT_LIST_HEAD(&reactor->queues);
+	env_atomic_set(&reactor->stop, 0);
+
+	if (sem_init(&reactor->wake_sem, 0, 0))
+		goto err_sem;
+
+	if (pthread_create(&reactor->thread, NULL, env_reactor_thread,
+				reactor)) {
+		goto err_thread;
+	}
+
+	if (cfg->name)
+		pthread_setname_np(reactor->thread, cfg->name);
+
+	if (cfg->cpu >= 0) {
+		CPU_ZERO(&cpuset);
+		CPU_SET(cfg->cpu, &cpuset);
+		pthread_setaffinity_np(reactor->thread, sizeof(cpuset),
+				&cpuset);
+	}
+
+	pthread_mutex_lock(&env_reactor_registry.lock);
+	list_add_tail(&reactor->list, &env_reactor_registry.reactors);
+	pthread_mutex_unlock(&env_reactor_registry.lock);
+
+	return reactor;
+
+err_thread:
+	sem_destroy(&reactor->wake_sem);
+err_sem:
+	env_free(reactor);
+	return NULL;
+}
+
+void env_reactor_destroy(struct env_reactor *reactor)
+{
+	ENV_BUG_ON(env_reactor_current == reactor);
+
+	pthread_mutex_lock(&env_reactor_registry.lock);
+	ENV_BUG_ON(!list_empty(&reactor->queues));
+	list_del(&reactor->list);
+	pthread_mutex_unlock(&env_reactor_registry.lock);
+
+	env_atomic_set(&reactor->stop, 1);
+	__atomic_store_n(&reactor->sleeping, 0, __ATOMIC_SEQ_CST);
+	sem_post(&reactor->wake_sem);
+
+	pthread_join(reactor->thread, NULL);
+
+	sem_destroy(&reactor->wake_sem);
+	env_free(reactor);
+}
+
+/* OCF QUEUES */
+static int env_reactor_queue_poll(void *priv)
+{
+	struct env_reactor_queue *rq = priv;
+	ocf_queue_t queue = rq->queue;
+	int count = 0;
+
+	if (!ocf_queue_pending_io(queue))
+		return 0;
+
+	/* Request completion may drop last queue reference, which would
+	 * unregister this poller and free the queue */
+	ocf_queue_get(queue);
+
+	while (count < ENV_REACTOR_QUEUE_BUDGET &&
+			ocf_queue_pending_io(queue)) {
+		ocf_queue_run_single(queue);
+		count++;
+	}
+
+	ocf_queue_put(queue);
+
+	return count;
+}
+
+/*
+ * Queue is processed in next iteration of reactor loop, so kick needs only
+ * to wake reactor up if it's sleeping.
+ */
+static void env_reactor_queue_kick(ocf_queue_t queue)
+{
+	struct env_reactor_queue *rq = ocf_queue_get_priv(queue);
+
+	env_reactor_wake(rq->reactor);
+}
+
+static void env_reactor_queue_stop(ocf_queue_t queue)
+{
+	struct env_reactor_queue *rq = ocf_queue_get_priv(queue);
+
+	env_reactor_poller_unregister(rq->reactor, env_reactor_queue_poll, rq);
+
+	pthread_mutex_lock(&env_reactor_registry.lock);
+	list_del(&rq->list);
+	pthread_mutex_unlock(&env_reactor_registry.lock);
+
+	env_free(rq);
+}
+
+const struct ocf_queue_ops env_reactor_queue_ops = {
+	.kick = env_reactor_queue_kick,
+	.stop = env_reactor_queue_stop,
+};
+
+int env_reactor_queue_create(struct env_reactor *reactor, ocf_cache_t cache,
+		ocf_queue_t *queue)
+{
+	struct env_reactor_queue *rq;
+	int result;
+
+	rq = env_zalloc(sizeof(*rq), ENV_MEM_NORMAL);
+	if (!rq)
+		return -OCF_ERR_NO_MEM;
+
+	rq->reactor = reactor;
+
+	result = ocf_queue_create(cache, &rq->queue, &env_reactor_queue_ops);
+	if (result) {
+		env_free(rq);
+		return result;
+	}
+
+	ocf_queue_set_priv(rq->queue, rq);
+
+	result = env_reactor_poller_register(reactor, env_reactor_queue_poll,
+			rq);
+	if (result) {
+		/* Queue stop callback frees rq */
+		INIT_LIST_HEAD(&rq->list);
+		ocf_queue_put(rq->queue);
+		return result;
+	}
+
+	pthread_mutex_lock(&env_reactor_registry.lock);
+	list_add_tail(&rq->list, &reactor->queues);
+	__atomic_add_fetch(&env_reactor_registry.queues_gen, 1,
+			__ATOMIC_RELEASE);
+	pthread_mutex_unlock(&env_reactor_registry.lock);
+
+	*queue = rq->queue;
+
+	return 0;
+}
+
+static ocf_queue_t env_reactor_find_queue(struct env_reactor *reactor,
+		ocf_cache_t cache)
+{
+	struct env_reactor_queue *rq;
+	ocf_queue_t queue = NULL;
+
+	pthread_mutex_lock(&env_reactor_registry.lock);
+	list_for_each_entry(rq, &reactor->queues, list) {
+		if (ocf_queue_get_cache(rq->queue) == cache) {
+			queue = rq->queue;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&env_reactor_registry.lock);
+
+	return queue;
+}
+
+/* OCF CLEANERS */
+static struct env_reactor *env_reactor_cleaner_pick(ocf_cache_t cache,
+		bool any);
+static int env_reactor_cleaner_poll(void *priv);
+
+static void _env_reactor_cleaner_attach(struct env_reactor *reactor,
+		void *arg)
+{
+	struct env_reactor_cleaner *rc = arg;
+	struct env_reactor_poller_op op = {
+		.poller = { .fn = env_reactor_cleaner_poll, .priv = rc },
+	};
+
+	_env_reactor_poller_register(reactor, &op);
+	ENV_BUG_ON(op.result);
+}
+
+/*
+ * Move cleaner, which is not running at the moment, to reactor serving
+ * queue of its cache. Called from cleaner poller, so current reactor is
+ * the one cleaner is registered to. New reactor registers poller when it
+ * handles attach message.
+ */
+static bool env_reactor_cleaner_move(struct env_reactor_cleaner *rc)
+{
+	struct env_reactor *reactor = rc->reactor, *target;
+	struct env_reactor_poller_op op = {
+		.poller = { .fn = env_reactor_cleaner_poll, .priv = rc },
+	};
+
+	target = env_reactor_cleaner_pick(ocf_cleaner_get_cache(rc->cleaner),
+			false);
+	if (!target || target == reactor)
+		return false;
+
+	pthread_mutex_lock(&rc->lock);
+	if (env_reactor_send(target, _env_reactor_cleaner_attach, rc)) {
+		pthread_mutex_unlock(&rc->lock);
+		return false;
+	}
+	_env_reactor_poller_unregister(reactor, &op);
+	__atomic_store_n(&rc->reactor, target, __ATOMIC_RELAXED);
+	pthread_mutex_unlock(&rc->lock);
+
+	return true;
+}
+
+static int env_reactor_cleaner_poll(void *priv)
+{
+	struct env_reactor_cleaner *rc = priv;
+	struct env_reactor *reactor = rc->reactor;
+	ocf_cache_t cache = ocf_cleaner_get_cache(rc->cleaner);
+	ocf_queue_t queue;
+	uint32_t gen;
+
+	if (__atomic_load_n(&rc->running, __ATOMIC_ACQUIRE))
+		return 0;
+
+	/*
+	 * Cleaner may have been assigned to reactor before any queue of its
+	 * cache was created. Re-check it once new queues appear.
+	 */
+	gen = __atomic_load_n(&env_reactor_registry.queues_gen,
+			__ATOMIC_ACQUIRE);
+	if (gen != rc->queues_gen) {
+		rc->queues_gen = gen;
+		if (!env_reactor_find_queue(reactor, cache) &&
+				env_reactor_cleaner_move(rc)) {
+			return 1;
+		}
+	}
+
+	if (reactor->now_us < __atomic_load_n(&rc->next_run_us,
+				__ATOMIC_RELAXED)) {
+		return 0;
+	}
+
+	queue = env_reactor_find_queue(reactor, cache);
+	if (!queue) {
+		rc->next_run_us = reactor->now_us +
+				ENV_REACTOR_CLEANER_RETRY_US;
+		return 0;
+	}
+
+	__atomic_store_n(&rc->running, true, __ATOMIC_RELAXED);
+	ocf_cleaner_run(rc->cleaner, queue);
+
+	return 1;
+}
+
+static void env_reactor_cleaner_end(ocf_cleaner_t cleaner, uint32_t interval)
+{
+	struct env_reactor_cleaner *rc = ocf_cleaner_get_priv(cleaner);
+
+	__atomic_store_n(&rc->next_run_us,
+			env_reactor_now_us() + interval * 1000ULL,
+			__ATOMIC_RELAXED);
+	__atomic_store_n(&rc->running, false, __ATOMIC_RELEASE);
+}
+
+/*
+ * Pick reactor for cleaner in round robin manner, preferring reactors
+ * which serve queues of cleaner's cache. If there are none, pick any
+ * reactor if allowed, or return NULL.
+ */
+static struct env_reactor *env_reactor_cleaner_pick(ocf_cache_t cache,
+		bool any)
+{
+	struct env_reactor *reactor, *picked = NULL;
+	struct env_reactor_queue *rq;
+	uint32_t candidates = 0, all = 0, idx;
+
+	pthread_mutex_lock(&env_reactor_registry.lock);
+
+	list_for_each_entry(reactor, &env_reactor_registry.reactors, list) {
+		all++;
+		list_for_each_entry(rq, &reactor->queues, list) {
+			if (ocf_queue_get_cache(rq->queue) == cache) {
+				candidates++;
+				break;
+			}
+		}
+	}
+
+	if (!all || (!candidates && !any))
+		goto out;
+
+	idx = env_reactor_registry.cleaner_rr++ % (candidates ?: all);
+
+	list_for_each_entry(reactor, &env_reactor_registry.reactors, list) {
+		if (candidates) {
+			list_for_each_entry(rq, &reactor->queues, list) {
+				if (ocf_queue_get_cache(rq->queue) == cache)
+					break;
+			}
+			if (&rq->list == &reactor->queues)
+				continue;
+		}
+
+		if (!idx--) {
+			picked = reactor;
+			break;
+		}
+	}
+
+out:
+	pthread_mutex_unlock(&env_reactor_registry.lock);
+
+	return picked;
+}
+
+int env_reactor_cleaner_init(ocf_cleaner_t cleaner)
+{
+	struct env_reactor_cleaner *rc;
+	int result;
+
+	rc = env_zalloc(sizeof(*rc), ENV_MEM_NORMAL);
+	if (!rc)
+		return -OCF_ERR_NO_MEM;
+
+	rc->cleaner = cleaner;
+	rc->queues_gen = __atomic_load_n(&env_reactor_registry.queues_gen,
+			__ATOMIC_ACQUIRE);
+	rc->reactor = env_reactor_cleaner_pick(ocf_cleaner_get_cache(cleaner),
+			true);
+	if (!rc->reactor) {
+		env_free(rc);
+		return -OCF_ERR_INVAL;
+	}
+
+	result = pthread_mutex_init(&rc->lock, NULL);
+	if (result) {
+		env_free(rc);
+		return -OCF_ERR_NO_MEM;
+	}
+
+	ocf_cleaner_set_cmpl(cleaner, env_reactor_cleaner_end);
+	ocf_cleaner_set_priv(cleaner, rc);
+
+	result = env_reactor_poller_register(rc->reactor,
+			env_reactor_cleaner_poll, rc);
+	if (result) {
+		ocf_cleaner_set_priv(cleaner, NULL);
+		pthread_mutex_destroy(&rc->lock);
+		env_free(rc);
+	}
+
+	return result;
+}
+
+void env_reactor_cleaner_kick(ocf_cleaner_t cleaner)
+{
+	struct env_reactor_cleaner *rc = ocf_cleaner_get_priv(cleaner);
+
+	__atomic_store_n(&rc->next_run_us, 0, __ATOMIC_RELAXED);
+	env_reactor_wake(__atomic_load_n(&rc->reactor, __ATOMIC_RELAXED));
+}
+
+struct env_reactor_cleaner_detach_op {
+	struct env_reactor_cleaner *rc;
+	bool done;
+};
+
+static void _env_reactor_cleaner_detach(struct env_reactor *reactor,
+		void *arg)
+{
+	struct env_reactor_cleaner_detach_op *op = arg;
+	struct env_reactor_cleaner *rc = op->rc;
+	struct env_reactor_poller_op poller_op = {
+		.poller = { .fn = env_reactor_cleaner_poll, .priv = rc },
+	};
+
+	pthread_mutex_lock(&rc->lock);
+	if (rc->reactor == reactor) {
+		_env_reactor_poller_unregister(reactor, &poller_op);
+		op->done = true;
+	}
+	pthread_mutex_unlock(&rc->lock);
+}
+
+void env_reactor_cleaner_stop(ocf_cleaner_t cleaner)
+{
+	struct env_reactor_cleaner *rc = ocf_cleaner_get_priv(cleaner);
+	struct env_reactor_cleaner_detach_op op = { .rc = rc };
+	struct env_reactor *reactor;
+
+	/*
+	 * Cleaner may be moved to another reactor in the meantime. Attach
+	 * message is sent before reactor is changed, so detach sent to
+	 * reactor read under lock is always handled after it.
+	 */
+	while (!op.done) {
+		pthread_mutex_lock(&rc->lock);
+		reactor = rc->reactor;
+		pthread_mutex_unlock(&rc->lock);
+
+		env_reactor_call_sync(reactor, _env_reactor_cleaner_detach,
+				&op);
+	}
+
+	ocf_cleaner_set_priv(cleaner, NULL);
+	pthread_mutex_destroy(&rc->lock);
+	env_free(rc);
+}
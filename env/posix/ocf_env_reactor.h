@@ -0,0 +1,150 @@
+/*
+ * Copyright(c) 2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __OCF_ENV_REACTOR_H__
+#define __OCF_ENV_REACTOR_H__
+
+#include <stdint.h>
+#include "ocf/ocf.h"
+
+/**
+ * @file
+ * @brief Polling mode runtime for posix environment
+ *
+ * Reactor is a thread pinned to single CPU, which in one loop runs all
+ * pollers registered to it - OCF queues, cleaners and any other user
+ * pollers (e.g. env_uring rings created with ENV_URING_NO_THREAD).
+ * Reactor busy-polls as long as there is work to do. When it gets idle
+ * it keeps spinning for configured time, and then goes to sleep with
+ * exponentially growing timeout. Sleeping reactor is woken up by queue
+ * kick or by message sent to it.
+ *
+ * Other threads communicate with reactor by sending messages through
+ * lock-free ring, so pollers list is modified only from reactor thread.
+ */
+
+struct env_reactor;
+
+/**
+ * @brief Poller function
+ *
+ * @param priv Poller private context
+ *
+ * @return Amount of work done (0 if poller was idle)
+ */
+typedef int (*env_reactor_poll_t)(void *priv);
+
+/**
+ * @brief Message function, executed in reactor thread
+ */
+typedef void (*env_reactor_msg_t)(struct env_reactor *reactor, void *arg);
+
+struct env_reactor_config {
+	/* CPU to pin reactor thread to, or -1 for no pinning */
+	int cpu;
+
+	/* Time reactor keeps busy-polling after it gets idle */
+	uint32_t busy_poll_us;
+
+	/* Maximum time reactor sleeps without being woken up */
+	uint32_t max_sleep_us;
+
+	const char *name;
+};
+
+static inline void env_reactor_config_set_default(
+		struct env_reactor_config *cfg)
+{
+	cfg->cpu = -1;
+	cfg->busy_poll_us = 100;
+	cfg->max_sleep_us = 10000;
+	cfg->name = "ocf_reactor";
+}
+
+/**
+ * @brief Create and start reactor
+ *
+ * @param[in] cfg Reactor configuration
+ *
+ * @return Reactor handle or NULL on failure
+ */
+struct env_reactor *env_reactor_create(const struct env_reactor_config *cfg);
+
+/**
+ * @brief Stop reactor and destroy it. All OCF queues and cleaners must be
+ *	detached from reactor before.
+ */
+void env_reactor_destroy(struct env_reactor *reactor);
+
+/**
+ * @brief Send message to reactor. Message is executed in reactor thread.
+ *
+ * @retval 0 Message sent
+ * @retval -EAGAIN Message ring full
+ */
+int env_reactor_send(struct env_reactor *reactor, env_reactor_msg_t fn,
+		void *arg);
+
+/**
+ * @brief Wake up reactor if it's sleeping
+ */
+void env_reactor_wake(struct env_reactor *reactor);
+
+/**
+ * @brief Get reactor running in current thread (NULL if none)
+ */
+struct env_reactor *env_reactor_get_current(void);
+
+/**
+ * @brief Register poller. If called outside of reactor thread, waits
+ *	until poller is actually registered.
+ *
+ * @retval 0 Poller registered
+ * @retval -ENOSPC Too many pollers
+ */
+int env_reactor_poller_register(struct env_reactor *reactor,
+		env_reactor_poll_t fn, void *priv);
+
+/**
+ * @brief Unregister poller. If called outside of reactor thread, waits
+ *	until poller is actually unregistered, so after this function
+ *	returns poller is guaranteed not to be called anymore.
+ */
+void env_reactor_poller_unregister(struct env_reactor *reactor,
+		env_reactor_poll_t fn, void *priv);
+
+/**
+ * @brief OCF queue ops for queues served by reactors. Queue private
+ *	data is reserved for reactor, so these ops shall be used only for
+ *	queues created with env_reactor_queue_create().
+ */
+extern const struct ocf_queue_ops env_reactor_queue_ops;
+
+/**
+ * @brief Create OCF queue served by reactor
+ *
+ * @param[in] reactor Reactor handle
+ * @param[in] cache Cache handle
+ * @param[out] queue Created queue
+ *
+ * @retval 0 Queue created
+ * @retval Non-zero Error
+ */
+int env_reactor_queue_create(struct env_reactor *reactor, ocf_cache_t cache,
+		ocf_queue_t *queue);
+
+/**
+ * @brief OCF context cleaner ops. Each cleaner is assigned to one of
+ *	reactors serving queues of its cache (in round robin manner), so
+ *	cleaning work is spread across reactors. Cleaner is run on queue
+ *	owned by the reactor it's assigned to. Cleaner initialized before
+ *	any queue of its cache exists is moved to reactor serving such
+ *	queue once it's created.
+ */
+int env_reactor_cleaner_init(ocf_cleaner_t cleaner);
+void env_reactor_cleaner_kick(ocf_cleaner_t cleaner);
+void env_reactor_cleaner_stop(ocf_cleaner_t cleaner);
+
+#endif /* __OCF_ENV_REACTOR_H__ */
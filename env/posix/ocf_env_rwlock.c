@@ -0,0 +1,105 @@
+/*
+ * Copyright(c) 2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "ocf_env.h"
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+#define ENV_RWLOCK_SPINS_MIN	16
+#define ENV_RWLOCK_SPINS_MAX	4096
+
+static inline void env_cpu_relax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#elif defined(__aarch64__)
+	asm volatile("yield" ::: "memory");
+#else
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+#endif
+}
+
+static inline void env_futex_wait(uint32_t *word, uint32_t val)
+{
+	syscall(SYS_futex, word, FUTEX_WAIT_PRIVATE, val, NULL, NULL, 0);
+}
+
+void env_futex_wake_all(uint32_t *word)
+{
+	syscall(SYS_futex, word, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+}
+
+static inline bool env_rwlock_cond(uint32_t v, uint32_t mask, uint32_t val,
+		bool until)
+{
+	return ((v & mask) == val) == until;
+}
+
+/*
+ * Spin count adapts to the lock hold time: if spinning succeeded, spin
+ * count converges to twice the number of iterations it took, and if it
+ * failed, spinning is assumed to be pointless and spin count shrinks.
+ */
+static bool env_rwlock_spin(uint32_t *spins, uint32_t *word, uint32_t mask,
+		uint32_t val, bool until)
+{
+	uint32_t limit = __atomic_load_n(spins, __ATOMIC_RELAXED);
+	uint32_t i, new;
+
+	for (i = 0; i < limit; i++) {
+		if (env_rwlock_cond(__atomic_load_n(word, __ATOMIC_ACQUIRE),
+				mask, val, until)) {
+			new = limit + ((int32_t)(2 * i) - (int32_t)limit) / 8;
+			new = MAX(new, ENV_RWLOCK_SPINS_MIN);
+			new = MIN(new, ENV_RWLOCK_SPINS_MAX);
+			__atomic_store_n(spins, new, __ATOMIC_RELAXED);
+			return true;
+		}
+		env_cpu_relax();
+	}
+
+	new = MAX(limit - limit / 8, ENV_RWLOCK_SPINS_MIN);
+	__atomic_store_n(spins, new, __ATOMIC_RELAXED);
+
+	return false;
+}
+
+/*
+ * Sleep until condition on lock word is met. Waiters counter is bumped
+ * before the last check of lock word, while lock holders modify lock word
+ * before checking waiters counter, so the wakeup can't be missed. If lock
+ * word changes between the check and going to sleep, futex returns
+ * immediately.
+ */
+static void env_rwlock_sleep(uint32_t *waiters, uint32_t *word, uint32_t mask,
+		uint32_t val, bool until)
+{
+	uint32_t v;
+
+	for (;;) {
+		__atomic_fetch_add(waiters, 1, __ATOMIC_SEQ_CST);
+		v = __atomic_load_n(word, __ATOMIC_SEQ_CST);
+		if (env_rwlock_cond(v, mask, val, until)) {
+			__atomic_fetch_sub(waiters, 1, __ATOMIC_RELAXED);
+			break;
+		}
+		env_futex_wait(word, v);
+		__atomic_fetch_sub(waiters, 1, __ATOMIC_RELAXED);
+	}
+
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+}
+
+/*
+ * Wait until bits of lock word selected by mask are clear. Caller retries
+ * taking the lock afterwards.
+ */
+void env_rp_rwlock_wait(env_rp_rwlock *l, uint32_t mask)
+{
+	if (env_rwlock_spin(&l->spins, &l->state, mask, 0, true))
+		return;
+
+	env_rwlock_sleep(&l->waiters, &l->state, mask, 0, true);
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright(c) 2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __OCF_ENV_RWLOCK_H__
+#define __OCF_ENV_RWLOCK_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @file
+ * @brief Reader-writer lock for posix environment
+ *
+ * env_rp_rwlock is reader-preferring, same as default pthread rwlock:
+ * reader gets the lock whenever no writer holds it, even if writers are
+ * waiting. Thread already holding the lock for read may thus take it for
+ * read again without deadlocking on writer queued in meantime. Uncontended
+ * lock and unlock are single atomic operation.
+ *
+ * Contended waiters spin for adaptively tuned number of iterations and
+ * then go to sleep on futex.
+ */
+
+typedef struct {
+	/* Number of readers, ENV_RP_RWLOCK_WRITER set if writer holds lock */
+	uint32_t state;
+
+	/* Number of threads sleeping on the lock word */
+	uint32_t waiters;
+
+	/* Number of spin iterations before going to sleep */
+	uint32_t spins;
+} env_rp_rwlock;
+
+#define ENV_RP_RWLOCK_WRITER	0x80000000U
+
+#define ENV_RWLOCK_SPINS_INIT	128
+
+/* Slow paths - implemented in ocf_env_rwlock.c */
+void env_rp_rwlock_wait(env_rp_rwlock *l, uint32_t mask);
+void env_futex_wake_all(uint32_t *word);
+
+/* Must be called after lock word modification with sequential consistency */
+static inline void env_rwlock_wake(uint32_t *waiters, uint32_t *word)
+{
+	if (__atomic_load_n(waiters, __ATOMIC_SEQ_CST))
+		env_futex_wake_all(word);
+}
+
+static inline void env_rp_rwlock_init(env_rp_rwlock *l)
+{
+	l->state = 0;
+	l->waiters = 0;
+	l->spins = ENV_RWLOCK_SPINS_INIT;
+}
+
+static inline void env_rp_rwlock_read_unlock(env_rp_rwlock *l)
+{
+	/* Only writers wait for readers to leave */
+	if (__atomic_sub_fetch(&l->state, 1, __ATOMIC_SEQ_CST) == 0)
+		env_rwlock_wake(&l->waiters, &l->state);
+}
+
+/*
+ * Reader optimistically bumps reader count and backs off if writer holds
+ * the lock. Writer only ever clears its own bit, so reader count stays
+ * consistent.
+ */
+static inline bool env_rp_rwlock_read_trylock(env_rp_rwlock *l)
+{
+	uint32_t s = __atomic_fetch_add(&l->state, 1, __ATOMIC_ACQUIRE);
+
+	if (!(s & ENV_RP_RWLOCK_WRITER))
+		return true;
+
+	env_rp_rwlock_read_unlock(l);
+
+	return false;
+}
+
+static inline void env_rp_rwlock_read_lock(env_rp_rwlock *l)
+{
+	while (!env_rp_rwlock_read_trylock(l))
+		env_rp_rwlock_wait(l, ENV_RP_RWLOCK_WRITER);
+}
+
+static inline bool env_rp_rwlock_write_trylock(env_rp_rwlock *l)
+{
+	uint32_t s = 0;
+
+	return __atomic_compare_exchange_n(&l->state, &s,
+			ENV_RP_RWLOCK_WRITER, false, __ATOMIC_ACQUIRE,
+			__ATOMIC_RELAXED);
+}
+
+static inline void env_rp_rwlock_write_lock(env_rp_rwlock *l)
+{
+	while (!env_rp_rwlock_write_trylock(l))
+		env_rp_rwlock_wait(l, ~0U);
+}
+
+static inline void env_rp_rwlock_write_unlock(env_rp_rwlock *l)
+{
+	__atomic_fetch_and(&l->state, ~ENV_RP_RWLOCK_WRITER, __ATOMIC_SEQ_CST);
+	env_rwlock_wake(&l->waiters, &l->state);
+}
+
+static inline bool env_rp_rwlock_is_locked(env_rp_rwlock *l)
+{
+	return __atomic_load_n(&l->state, __ATOMIC_RELAXED) != 0;
+}
+
+#endif /* __OCF_ENV_RWLOCK_H__ */
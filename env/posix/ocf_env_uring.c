@@ -0,0 +1,614 @@
+/*
+ * Copyright(c) 2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "ocf_env.h"
+#include "ocf_env_uring.h"
+#include <sched.h>
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+#define ENV_URING_POLL_SPIN	1024
+#define ENV_URING_POLL_SLEEP_MAX_US	1000
+
+struct env_uring_sq {
+	unsigned *khead;
+	unsigned *ktail;
+	unsigned *kflags;
+	unsigned *array;
+	unsigned mask;
+	unsigned entries;
+	unsigned tail;
+	struct io_uring_sqe *sqes;
+};
+
+struct env_uring_cq {
+	unsigned *khead;
+	unsigned *ktail;
+	unsigned mask;
+	struct io_uring_cqe *cqes;
+};
+
+struct env_uring {
+	int fd;
+	int flags;
+
+	struct env_uring_sq sq;
+	struct env_uring_cq cq;
+
+	void *sq_map;
+	size_t sq_map_size;
+	void *cq_map;
+	size_t cq_map_size;
+	size_t sqes_map_size;
+
+	/* Registered fixed buffers */
+	struct iovec *bufs;
+	unsigned bufs_nr;
+
+	/* SQEs written to SQ ring, but not yet passed to the kernel */
+	uint32_t pending;
+	uint32_t batch;
+
+	/* I/O passed to the kernel and not yet reaped */
+	env_atomic inflight;
+	unsigned cq_entries;
+
+	env_spinlock sq_lock;
+
+	env_uring_end_t end;
+
+	pthread_t thread;
+	env_atomic stop;
+};
+
+static inline int env_uring_enter(int fd, unsigned to_submit,
+		unsigned min_complete, unsigned flags)
+{
+	int ret;
+
+	ret = syscall(__NR_io_uring_enter, fd, to_submit, min_complete,
+			flags, NULL, 0);
+
+	return ret < 0 ? -errno : ret;
+}
+
+/* Ring which completions are being processed by current thread */
+static __thread struct env_uring *env_uring_reaping;
+
+/*
+ * Called under sq_lock. Number of I/O passed to the kernel is limited to CQ
+ * size, as overflowed completions would be visible only after calling
+ * io_uring_enter(), which is not done in CQ polling mode.
+ */
+static void _env_uring_submit(struct env_uring *ring)
+{
+	uint32_t inflight, to_submit;
+	int ret;
+
+	if (!ring->pending)
+		return;
+
+	if (ring->flags & ENV_URING_SQPOLL) {
+		/* Kernel thread consumes whole SQ, capacity is checked
+		 * when getting SQE */
+		env_atomic_add(ring->pending, &ring->inflight);
+		ring->pending = 0;
+		if (__atomic_load_n(ring->sq.kflags, __ATOMIC_ACQUIRE) &
+				IORING_SQ_NEED_WAKEUP) {
+			env_uring_enter(ring->fd, 0, 0,
+					IORING_ENTER_SQ_WAKEUP);
+		}
+		return;
+	}
+
+	inflight = env_atomic_read(&ring->inflight);
+	if (inflight >= ring->cq_entries)
+		return;
+
+	to_submit = MIN(ring->pending, ring->cq_entries - inflight);
+
+	ret = env_uring_enter(ring->fd, to_submit, 0, 0);
+	if (ret < 0) {
+		/* -EBUSY / -EAGAIN - lack of resources. Leave SQEs pending,
+		 * completion thread will resubmit them after reaping
+		 * completions. */
+		return;
+	}
+
+	env_atomic_add(ret, &ring->inflight);
+	ring->pending -= ret;
+}
+
+/*
+ * CQ head is advanced before calling completion callback, so that reap can be
+ * safely reentered from within the callback (see env_uring_get_sqe()).
+ */
+static unsigned env_uring_reap(struct env_uring *ring)
+{
+	struct env_uring_cq *cq = &ring->cq;
+	struct io_uring_cqe *cqe;
+	unsigned head, count = 0;
+	uint64_t user_data;
+	int res;
+
+	for (;;) {
+		head = *cq->khead;
+		if (head == __atomic_load_n(cq->ktail, __ATOMIC_ACQUIRE))
+			break;
+
+		cqe = &cq->cqes[head & cq->mask];
+		user_data = cqe->user_data;
+		res = cqe->res;
+
+		__atomic_store_n(cq->khead, head + 1, __ATOMIC_RELEASE);
+		env_atomic_dec(&ring->inflight);
+		count++;
+
+		if (user_data) {
+			env_uring_reaping = ring;
+			ring->end((void *)(uintptr_t)user_data, res);
+			env_uring_reaping = NULL;
+		}
+	}
+
+	return count;
+}
+
+static inline bool env_uring_has_room(struct env_uring *ring)
+{
+	struct env_uring_sq *sq = &ring->sq;
+	unsigned head = __atomic_load_n(sq->khead, __ATOMIC_ACQUIRE);
+
+	if (sq->tail - head >= sq->entries)
+		return false;
+
+	if ((ring->flags & ENV_URING_SQPOLL) && ring->pending +
+			env_atomic_read(&ring->inflight) >= ring->cq_entries) {
+		return false;
+	}
+
+	return true;
+}
+
+/*
+ * Called under sq_lock. If there is no room for new SQE, lock is dropped
+ * until completions are reaped - either by completion thread, or inline if
+ * called from completion callback or for ring without completion thread.
+ */
+static struct io_uring_sqe *env_uring_get_sqe(struct env_uring *ring)
+{
+	struct env_uring_sq *sq = &ring->sq;
+	struct io_uring_sqe *sqe;
+
+	for (;;) {
+		if (env_uring_has_room(ring))
+			break;
+
+		/* SQ full - push it to the kernel and retry */
+		_env_uring_submit(ring);
+		if (env_uring_has_room(ring))
+			break;
+
+		env_spinlock_unlock(&ring->sq_lock);
+		if (ring->flags & ENV_URING_NO_THREAD) {
+			/* Nobody else reaps this ring - wait for completion */
+			env_uring_enter(ring->fd, 0, 1,
+					IORING_ENTER_GETEVENTS);
+			env_uring_reap(ring);
+		} else if (env_uring_reaping == ring) {
+			env_uring_reap(ring);
+		} else {
+			sched_yield();
+		}
+		env_spinlock_lock(&ring->sq_lock);
+	}
+
+	sqe = &sq->sqes[sq->tail & sq->mask];
+	memset(sqe, 0, sizeof(*sqe));
+
+	return sqe;
+}
+
+/* Called under sq_lock */
+static void env_uring_commit_sqe(struct env_uring *ring)
+{
+	struct env_uring_sq *sq = &ring->sq;
+
+	sq->tail++;
+	__atomic_store_n(sq->ktail, sq->tail, __ATOMIC_RELEASE);
+	ring->pending++;
+
+	/*
+	 * Submit immediately if ring is idle, so that single I/O is not
+	 * delayed. Otherwise let SQEs accumulate - completion thread will
+	 * push them after reaping next completion.
+	 */
+	if (ring->pending >= ring->batch ||
+			env_atomic_read(&ring->inflight) == 0) {
+		_env_uring_submit(ring);
+	}
+}
+
+static int env_uring_find_buffer(struct env_uring *ring, void *buf,
+		uint32_t len)
+{
+	uintptr_t start = (uintptr_t)buf;
+	uintptr_t base;
+	unsigned i;
+
+	for (i = 0; i < ring->bufs_nr; i++) {
+		base = (uintptr_t)ring->bufs[i].iov_base;
+		if (start >= base && start + len <=
+				base + ring->bufs[i].iov_len) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+int env_uring_rw(struct env_uring *ring, int fd, bool write, void *buf,
+		uint32_t len, uint64_t offset, void *priv)
+{
+	struct io_uring_sqe *sqe;
+	int buf_idx;
+
+	ENV_BUG_ON(!priv);
+
+	buf_idx = env_uring_find_buffer(ring, buf, len);
+
+	env_spinlock_lock(&ring->sq_lock);
+
+	sqe = env_uring_get_sqe(ring);
+	if (buf_idx >= 0) {
+		sqe->opcode = write ? IORING_OP_WRITE_FIXED :
+				IORING_OP_READ_FIXED;
+		sqe->buf_index = buf_idx;
+	} else {
+		sqe->opcode = write ? IORING_OP_WRITE : IORING_OP_READ;
+	}
+	sqe->fd = fd;
+	sqe->addr = (uintptr_t)buf;
+	sqe->len = len;
+	sqe->off = offset;
+	sqe->user_data = (uintptr_t)priv;
+
+	env_uring_commit_sqe(ring);
+
+	env_spinlock_unlock(&ring->sq_lock);
+
+	return 0;
+}
+
+int env_uring_fsync(struct env_uring *ring, int fd, void *priv)
+{
+	struct io_uring_sqe *sqe;
+
+	ENV_BUG_ON(!priv);
+
+	if (ring->flags & ENV_URING_IOPOLL)
+		return -EINVAL;
+
+	env_spinlock_lock(&ring->sq_lock);
+
+	sqe = env_uring_get_sqe(ring);
+	sqe->opcode = IORING_OP_FSYNC;
+	sqe->fd = fd;
+	sqe->user_data = (uintptr_t)priv;
+
+	env_uring_commit_sqe(ring);
+
+	env_spinlock_unlock(&ring->sq_lock);
+
+	return 0;
+}
+
+int env_uring_discard(struct env_uring *ring, int fd, uint64_t offset,
+		uint64_t len, void *priv)
+{
+	struct io_uring_sqe *sqe;
+
+	ENV_BUG_ON(!priv);
+
+	if (ring->flags & ENV_URING_IOPOLL)
+		return -EINVAL;
+
+	env_spinlock_lock(&ring->sq_lock);
+
+	sqe = env_uring_get_sqe(ring);
+	sqe->opcode = IORING_OP_FALLOCATE;
+	sqe->fd = fd;
+	sqe->off = offset;
+	/* For fallocate length is passed in addr and mode in len */
+	sqe->addr = len;
+	sqe->len = FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE;
+	sqe->user_data = (uintptr_t)priv;
+
+	env_uring_commit_sqe(ring);
+
+	env_spinlock_unlock(&ring->sq_lock);
+
+	return 0;
+}
+
+void env_uring_submit(struct env_uring *ring)
+{
+	env_spinlock_lock(&ring->sq_lock);
+	_env_uring_submit(ring);
+	env_spinlock_unlock(&ring->sq_lock);
+}
+
+uint32_t env_uring_inflight(struct env_uring *ring)
+{
+	return env_atomic_read(&ring->inflight);
+}
+
+static inline bool env_uring_idle(struct env_uring *ring)
+{
+	return env_atomic_read(&ring->inflight) == 0 &&
+			__atomic_load_n(&ring->pending, __ATOMIC_RELAXED) == 0;
+}
+
+unsigned env_uring_poll(struct env_uring *ring)
+{
+	unsigned count;
+
+	/* Enter kernel without waiting - this polls device in IOPOLL mode,
+	 * and runs pending task work and flushes overflowed CQEs otherwise */
+	if (env_atomic_read(&ring->inflight))
+		env_uring_enter(ring->fd, 0, 0, IORING_ENTER_GETEVENTS);
+
+	count = env_uring_reap(ring);
+
+	/* Always under sq_lock - submitters decide whether to defer
+	 * submission based on inflight count read under this lock */
+	env_uring_submit(ring);
+
+	return count;
+}
+
+static void *env_uring_cmpl_thread(void *ctx)
+{
+	struct env_uring *ring = ctx;
+	unsigned spin = 0, sleep_us = 1;
+
+	for (;;) {
+		if (env_uring_reap(ring)) {
+			spin = 0;
+			sleep_us = 1;
+		}
+
+		/* Always under sq_lock - submitters decide whether to defer
+		 * submission based on inflight count read under this lock */
+		env_uring_submit(ring);
+
+		if (env_atomic_read(&ring->stop) && env_uring_idle(ring))
+			break;
+
+		/*
+		 * Wait in kernel for completion. With IOPOLL kernel polls
+		 * device from within enter(), which returns immediately when
+		 * nothing is in flight, so idle IOPOLL ring falls back to
+		 * adaptive polling below.
+		 */
+		if (!(ring->flags & ENV_URING_CQPOLL) &&
+				(env_atomic_read(&ring->inflight) ||
+				(!(ring->flags & ENV_URING_IOPOLL) &&
+				env_uring_idle(ring)))) {
+			env_uring_enter(ring->fd, 0, 1, IORING_ENTER_GETEVENTS);
+			continue;
+		}
+
+		/* Adaptive busy-polling: spin for a while, then back off
+		 * with exponentially growing sleep */
+		if (spin++ < ENV_URING_POLL_SPIN)
+			continue;
+
+		usleep(sleep_us);
+		sleep_us = MIN(sleep_us * 2, ENV_URING_POLL_SLEEP_MAX_US);
+	}
+
+	return NULL;
+}
+
+static int env_uring_map(struct env_uring *ring, struct io_uring_params *p)
+{
+	struct env_uring_sq *sq = &ring->sq;
+	struct env_uring_cq *cq = &ring->cq;
+	unsigned i;
+
+	ring->sq_map_size = p->sq_off.array + p->sq_entries * sizeof(unsigned);
+	ring->cq_map_size = p->cq_off.cqes +
+			p->cq_entries * sizeof(struct io_uring_cqe);
+
+	if (p->features & IORING_FEAT_SINGLE_MMAP) {
+		ring->sq_map_size = ring->cq_map_size =
+				MAX(ring->sq_map_size, ring->cq_map_size);
+	}
+
+	ring->sq_map = mmap(NULL, ring->sq_map_size, PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_POPULATE, ring->fd,
+			IORING_OFF_SQ_RING);
+	if (ring->sq_map == MAP_FAILED)
+		return -errno;
+
+	if (p->features & IORING_FEAT_SINGLE_MMAP) {
+		ring->cq_map = ring->sq_map;
+	} else {
+		ring->cq_map = mmap(NULL, ring->cq_map_size,
+				PROT_READ | PROT_WRITE,
+				MAP_SHARED | MAP_POPULATE, ring->fd,
+				IORING_OFF_CQ_RING);
+		if (ring->cq_map == MAP_FAILED) {
+			munmap(ring->sq_map, ring->sq_map_size);
+			return -errno;
+		}
+	}
+
+	ring->sqes_map_size = p->sq_entries * sizeof(struct io_uring_sqe);
+	sq->sqes = mmap(NULL, ring->sqes_map_size, PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+	if (sq->sqes == MAP_FAILED) {
+		if (ring->cq_map != ring->sq_map)
+			munmap(ring->cq_map, ring->cq_map_size);
+		munmap(ring->sq_map, ring->sq_map_size);
+		return -errno;
+	}
+
+	sq->khead = ring->sq_map + p->sq_off.head;
+	sq->ktail = ring->sq_map + p->sq_off.tail;
+	sq->kflags = ring->sq_map + p->sq_off.flags;
+	sq->array = ring->sq_map + p->sq_off.array;
+	sq->mask = *(unsigned *)(ring->sq_map + p->sq_off.ring_mask);
+	sq->entries = *(unsigned *)(ring->sq_map + p->sq_off.ring_entries);
+	sq->tail = *sq->ktail;
+
+	/* SQ array is static identity mapping - SQE index equals SQ slot */
+	for (i = 0; i < sq->entries; i++)
+		sq->array[i] = i;
+
+	cq->khead = ring->cq_map + p->cq_off.head;
+	cq->ktail = ring->cq_map + p->cq_off.tail;
+	cq->mask = *(unsigned *)(ring->cq_map + p->cq_off.ring_mask);
+	cq->cqes = ring->cq_map + p->cq_off.cqes;
+	ring->cq_entries = p->cq_entries;
+
+	return 0;
+}
+
+static void env_uring_unmap(struct env_uring *ring)
+{
+	munmap(ring->sq.sqes, ring->sqes_map_size);
+	if (ring->cq_map != ring->sq_map)
+		munmap(ring->cq_map, ring->cq_map_size);
+	munmap(ring->sq_map, ring->sq_map_size);
+}
+
+struct env_uring *env_uring_create(uint32_t entries, uint32_t batch,
+		int flags, env_uring_end_t end, const char *name)
+{
+	struct io_uring_params p = { };
+	struct env_uring *ring;
+	int result;
+
+	ENV_BUG_ON(!end);
+
+	ring = env_zalloc(sizeof(*ring), ENV_MEM_NORMAL);
+	if (!ring)
+		return NULL;
+
+	ring->flags = flags;
+	ring->end = end;
+	ring->batch = batch ?: 1;
+	env_atomic_set(&ring->inflight, 0);
+	env_atomic_set(&ring->stop, 0);
+
+	if (flags & ENV_URING_IOPOLL)
+		p.flags |= IORING_SETUP_IOPOLL;
+	if (flags & ENV_URING_SQPOLL)
+		p.flags |= IORING_SETUP_SQPOLL;
+
+	ring->fd = syscall(__NR_io_uring_setup, entries, &p);
+	if (ring->fd < 0)
+		goto err_setup;
+
+	if (env_uring_map(ring, &p))
+		goto err_map;
+
+	if (env_spinlock_init(&ring->sq_lock))
+		goto err_lock;
+
+	if (flags & ENV_URING_NO_THREAD)
+		return ring;
+
+	result = pthread_create(&ring->thread, NULL, env_uring_cmpl_thread,
+			ring);
+	if (result)
+		goto err_thread;
+
+	if (name)
+		pthread_setname_np(ring->thread, name);
+
+	return ring;
+
+err_thread:
+	env_spinlock_destroy(&ring->sq_lock);
+err_lock:
+	env_uring_unmap(ring);
+err_map:
+	close(ring->fd);
+err_setup:
+	env_free(ring);
+	return NULL;
+}
+
+void env_uring_destroy(struct env_uring *ring)
+{
+	struct io_uring_sqe *sqe;
+
+	if (ring->flags & ENV_URING_NO_THREAD) {
+		while (!env_uring_idle(ring)) {
+			if (!env_uring_poll(ring))
+				sched_yield();
+		}
+		goto deinit;
+	}
+
+	env_atomic_set(&ring->stop, 1);
+
+	if (!(ring->flags & (ENV_URING_IOPOLL | ENV_URING_CQPOLL))) {
+		/* Completion thread may sleep in io_uring_enter() - wake it
+		 * up with NOP which has no completion context attached */
+		env_spinlock_lock(&ring->sq_lock);
+		sqe = env_uring_get_sqe(ring);
+		sqe->opcode = IORING_OP_NOP;
+		sqe->user_data = 0;
+		ring->sq.tail++;
+		__atomic_store_n(ring->sq.ktail, ring->sq.tail,
+				__ATOMIC_RELEASE);
+		ring->pending++;
+		_env_uring_submit(ring);
+		env_spinlock_unlock(&ring->sq_lock);
+	}
+
+	pthread_join(ring->thread, NULL);
+
+deinit:
+	env_spinlock_destroy(&ring->sq_lock);
+	env_uring_unmap(ring);
+	close(ring->fd);
+	env_free(ring->bufs);
+	env_free(ring);
+}
+
+int env_uring_register_buffers(struct env_uring *ring,
+		const struct iovec *iov, unsigned nr)
+{
+	struct iovec *bufs;
+	int ret;
+
+	if (ring->bufs)
+		return -EBUSY;
+
+	bufs = env_malloc(nr * sizeof(*bufs), ENV_MEM_NORMAL);
+	if (!bufs)
+		return -ENOMEM;
+
+	memcpy(bufs, iov, nr * sizeof(*bufs));
+
+	ret = syscall(__NR_io_uring_register, ring->fd,
+			IORING_REGISTER_BUFFERS, bufs, nr);
+	if (ret < 0) {
+		ret = -errno;
+		env_free(bufs);
+		return ret;
+	}
+
+	ring->bufs = bufs;
+	ring->bufs_nr = nr;
+
+	return 0;
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright(c) 2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __OCF_ENV_URING_H__
+#define __OCF_ENV_URING_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/uio.h>
+
+/**
+ * @file
+ * @brief Asynchronous I/O engine for posix environment based on io_uring
+ *
+ * Each ring owns one completion thread which reaps completions and calls
+ * completion callbacks, unless ENV_URING_NO_THREAD is set, in which case
+ * owner of the ring is responsible for calling env_uring_poll().
+ * Submissions are batched: while there is I/O in flight, new SQEs are
+ * accumulated and pushed to the kernel either when batch size is reached,
+ * or by the completion thread after reaping completions. This gives low
+ * latency on idle ring and large batches under load.
+ */
+
+/* Use kernel side polling for completions (requires O_DIRECT file) */
+#define ENV_URING_IOPOLL	(1 << 0)
+
+/* Use kernel side submission queue polling thread */
+#define ENV_URING_SQPOLL	(1 << 1)
+
+/* Busy-poll completion queue from completion thread instead of sleeping
+ * in io_uring_enter() */
+#define ENV_URING_CQPOLL	(1 << 2)
+
+/* Don't create completion thread - completions are reaped only from
+ * env_uring_poll() (e.g. from reactor loop). I/O shall be queued only
+ * from the thread polling the ring. */
+#define ENV_URING_NO_THREAD	(1 << 3)
+
+struct env_uring;
+
+/**
+ * @brief I/O completion callback
+ *
+ * @param priv Private context passed on submission
+ * @param result Number of bytes transferred or negative errno
+ */
+typedef void (*env_uring_end_t)(void *priv, int result);
+
+/**
+ * @brief Create io_uring instance with completion thread
+ *
+ * @param entries Submission queue depth (rounded up to power of two)
+ * @param batch Number of SQEs accumulated before forced submission
+ * @param flags ENV_URING_* flags
+ * @param end Completion callback called for each finished I/O
+ * @param name Name of completion thread
+ *
+ * @return Ring handle or NULL on failure
+ */
+struct env_uring *env_uring_create(uint32_t entries, uint32_t batch,
+		int flags, env_uring_end_t end, const char *name);
+
+/**
+ * @brief Destroy ring. Waits for all in-flight I/O to complete.
+ *
+ * @param ring Ring handle
+ */
+void env_uring_destroy(struct env_uring *ring);
+
+/**
+ * @brief Register fixed buffers. I/O which data buffer fits entirely
+ *	within one of registered buffers is submitted as READ/WRITE_FIXED.
+ *	Buffers can be registered only once, before any I/O is queued.
+ *
+ * @param ring Ring handle
+ * @param iov Buffers to be registered
+ * @param nr Number of buffers
+ *
+ * @retval 0 Buffers registered
+ * @retval Non-zero Error code (negative errno)
+ */
+int env_uring_register_buffers(struct env_uring *ring,
+		const struct iovec *iov, unsigned nr);
+
+/**
+ * @brief Queue read or write
+ *
+ * @param ring Ring handle
+ * @param fd File descriptor
+ * @param write True for write, false for read
+ * @param buf Data buffer
+ * @param len Number of bytes
+ * @param offset Byte offset in file
+ * @param priv Completion callback context (must not be NULL)
+ *
+ * @retval 0 I/O queued
+ * @retval Non-zero Error code (negative errno)
+ */
+int env_uring_rw(struct env_uring *ring, int fd, bool write, void *buf,
+		uint32_t len, uint64_t offset, void *priv);
+
+/**
+ * @brief Queue fsync (not supported with ENV_URING_IOPOLL)
+ */
+int env_uring_fsync(struct env_uring *ring, int fd, void *priv);
+
+/**
+ * @brief Queue hole punching of given range (not supported with
+ *	ENV_URING_IOPOLL)
+ */
+int env_uring_discard(struct env_uring *ring, int fd, uint64_t offset,
+		uint64_t len, void *priv);
+
+/**
+ * @brief Push all queued SQEs to the kernel
+ *
+ * @param ring Ring handle
+ */
+void env_uring_submit(struct env_uring *ring);
+
+/**
+ * @brief Reap completions and push queued SQEs to the kernel. Intended
+ *	for rings created with ENV_URING_NO_THREAD. Must not be called
+ *	concurrently for the same ring.
+ *
+ * @param ring Ring handle
+ *
+ * @return Number of reaped completions
+ */
+unsigned env_uring_poll(struct env_uring *ring);
+
+/**
+ * @brief Get number of I/O submitted to kernel and not yet completed
+ */
+uint32_t env_uring_inflight(struct env_uring *ring);
+
+#endif /* __OCF_ENV_URING_H__ */
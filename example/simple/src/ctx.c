@@ -134,6 +134,28 @@ static void ctx_data_secure_erase(ctx_data_t *ctx_data)
 {
 }
 
+/*
+ * Check if data is all zeros. First 16 bytes are checked directly, the rest
+ * is compared with itself shifted by 16 bytes, which lets memcmp() do the
+ * heavy lifting.
+ */
+static bool ctx_data_is_zero(ctx_data_t *src, uint32_t size)
+{
+	struct volume_data *data = src;
+	const char *buf = data->ptr + data->offset;
+	uint32_t i;
+
+	for (i = 0; i < size && i < 16; i++) {
+		if (buf[i])
+			return false;
+	}
+
+	if (size <= 16)
+		return true;
+
+	return !memcmp(buf, buf + 16, size - 16);
+}
+
 /*
  * Initialize cleaner thread. Cleaner thread is left non-implemented,
  * to keep this example as simple as possible.
@@ -223,6 +245,7 @@ static const struct ocf_ctx_config ctx_cfg = {
 			.seek = ctx_data_seek,
 			.copy = ctx_data_copy,
 			.secure_erase = ctx_data_secure_erase,
+			.is_zero = ctx_data_is_zero,
 		},
 
 		.cleaner = {
@@ -241,7 +264,7 @@ static const struct ocf_ctx_config ctx_cfg = {
 
 /*
  * Function initializing context. Prepares context, sets logger and
- * registers volume type.
+ * registers volume types.
  */
 int ctx_init(ocf_ctx_t *ctx)
 {
@@ -257,15 +280,23 @@ int ctx_init(ocf_ctx_t *ctx)
 		return ret;
 	}
 
+	ret = uring_volume_init(*ctx);
+	if (ret) {
+		volume_cleanup(*ctx);
+		ocf_ctx_put(*ctx);
+		return ret;
+	}
+
 	return 0;
 }
 
 /*
- * Function cleaning up context. Unregisters volume type and
+ * Function cleaning up context. Unregisters volume types and
  * deinitializes context.
  */
 void ctx_cleanup(ocf_ctx_t ctx)
 {
+	uring_volume_cleanup(ctx);
 	volume_cleanup(ctx);
 	ocf_ctx_put(ctx);
 }
@@ -9,6 +9,7 @@
 #include <ocf/ocf.h>
 
 #define VOL_TYPE 1
+#define VOL_TYPE_URING 2
 
 ctx_data_t *ctx_data_alloc(uint32_t pages);
 void ctx_data_free(ctx_data_t *ctx_data);
@@ -7,9 +7,11 @@
 #include <stdlib.h>
 #include <errno.h>
 #include <string.h>
+#include <semaphore.h>
 #include <ocf/ocf.h>
 #include "data.h"
 #include "ctx.h"
+#include "volume.h"
 
 /*
  * Cache private data. Used to share information between async contexts.
@@ -157,6 +159,18 @@ int initialize_cache(ocf_ctx_t ctx, ocf_cache_t *cache)
 	if (ret)
 		goto err_cache;
 
+	/*
+	 * Bind queues to io_uring volume rings. Core may be opened with
+	 * io_uring volume, and both queues submit IO to it.
+	 */
+	ret = uring_volume_queue_register(cache_priv->mngt_queue);
+	if (ret)
+		goto err_cache;
+
+	ret = uring_volume_queue_register(cache_priv->io_queue);
+	if (ret)
+		goto err_cache;
+
 	/* Attach volume to cache */
 	ocf_mngt_cache_attach(*cache, &device_cfg, simple_complete, &context);
 	if (ret)
@@ -165,6 +179,8 @@ int initialize_cache(ocf_ctx_t ctx, ocf_cache_t *cache)
 	return 0;
 
 err_cache:
+	uring_volume_queue_unregister(cache_priv->io_queue);
+	uring_volume_queue_unregister(cache_priv->mngt_queue);
 	ocf_mngt_cache_stop(*cache, simple_complete, &context);
 	ocf_queue_put(cache_priv->mngt_queue);
 err_priv:
@@ -192,9 +208,10 @@ static void add_core_complete(ocf_cache_t cache, ocf_core_t core,
 }
 
 /*
- * Function adding cache to core.
+ * Function adding cache to core. If path is given, core is a file or block
+ * device accessed with io_uring, otherwise it's a memory volume.
  */
-int initialize_core(ocf_cache_t cache, ocf_core_t *core)
+int initialize_core(ocf_cache_t cache, ocf_core_t *core, const char *path)
 {
 	struct ocf_mngt_core_config core_cfg = { };
 	struct add_core_context context;
@@ -210,8 +227,8 @@ int initialize_core(ocf_cache_t cache, ocf_core_t *core)
 	/* Core configuration */
 	ocf_mngt_core_config_set_default(&core_cfg);
 	strcpy(core_cfg.name, "core1");
-	core_cfg.volume_type = VOL_TYPE;
-	ret = ocf_uuid_set_str(&core_cfg.uuid, "core");
+	core_cfg.volume_type = path ? VOL_TYPE_URING : VOL_TYPE;
+	ret = ocf_uuid_set_str(&core_cfg.uuid, path ? (char *)path : "core");
 	if (ret)
 		return ret;
 
@@ -227,12 +244,15 @@ int initialize_core(ocf_cache_t cache, ocf_core_t *core)
 void complete_write(struct ocf_io *io, int error)
 {
 	struct volume_data *data = ocf_io_get_data(io);
+	sem_t *done = io->priv1;
 
 	printf("WRITE COMPLETE: (error: %d)\n", error);
 
 	/* Free data buffer and io */
 	ctx_data_free(data);
 	ocf_io_put(io);
+
+	sem_post(done);
 }
 
 /*
@@ -241,6 +261,7 @@ void complete_write(struct ocf_io *io, int error)
 void complete_read(struct ocf_io *io, int error)
 {
 	struct volume_data *data = ocf_io_get_data(io);
+	sem_t *done = io->priv1;
 
 	printf("WRITE COMPLETE (error: %d)\n", error);
 	printf("DATA: \"%s\"\n", (char *)data->ptr);
@@ -248,13 +269,16 @@ void complete_read(struct ocf_io *io, int error)
 	/* Free data buffer and io */
 	ctx_data_free(data);
 	ocf_io_put(io);
+
+	sem_post(done);
 }
 
 /*
  * Wrapper function for io submition.
  */
 int submit_io(ocf_core_t core, struct volume_data *data,
-		uint64_t addr, uint64_t len, int dir, ocf_end_io_t cmpl)
+		uint64_t addr, uint64_t len, int dir, ocf_end_io_t cmpl,
+		sem_t *done)
 {
 	ocf_cache_t cache = ocf_core_get_cache(core);
 	struct cache_priv *cache_priv = ocf_cache_get_priv(cache);
@@ -268,7 +292,7 @@ int submit_io(ocf_core_t core, struct volume_data *data,
 	/* Assign data to io */
 	ocf_io_set_data(io, data, 0);
 	/* Setup completion function */
-	ocf_io_set_cmpl(io, NULL, NULL, cmpl);
+	ocf_io_set_cmpl(io, done, NULL, cmpl);
 	/* Submit io */
 	ocf_core_submit_io(io);
 
@@ -282,10 +306,9 @@ int submit_io(ocf_core_t core, struct volume_data *data,
  * 1. Allocate data buffer for write and write it with example data.
  * 2. Allocate new io, configure it for write, setup completion callback
  *    and perform write to the core.
- * 3. Wait for write io completion (write is handled synchronosly, so no
- *    actual wait is needed, but in real life we would need to use some
- *    synchronization to be sure, that completion function has been already
- *    called). Alternatively we could issue read io from write completion
+ * 3. Wait for write io completion (memory volume handles write
+ *    synchronously, but io_uring volume completes it from its completion
+ *    thread). Alternatively we could issue read io from write completion
  *    callback.
  * 4. Allocate data buffer for read.
  * 5. Allocate new io, configure it for read, setup completion callback
@@ -299,6 +322,9 @@ int submit_io(ocf_core_t core, struct volume_data *data,
 void perform_workload(ocf_core_t core)
 {
 	struct volume_data *data1, *data2;
+	sem_t done;
+
+	sem_init(&done, 0, 0);
 
 	/* Allocate data buffer and fill it with example data */
 	data1 = ctx_data_alloc(1);
@@ -306,23 +332,29 @@ void perform_workload(ocf_core_t core)
 		error("Unable to allocate data1\n");
 	strcpy(data1->ptr, "This is some test data");
 	/* Prepare and submit write IO to the core */
-	submit_io(core, data1, 0, 512, OCF_WRITE, complete_write);
+	if (submit_io(core, data1, 0, 512, OCF_WRITE, complete_write, &done))
+		error("Unable to submit write\n");
 	/* After write completes, complete_write() callback will be called. */
 
 	/*
-	 * Here we would need to wait until write completes to be sure, that
-	 * performing read we retrive written data.
+	 * Wait until write completes to be sure, that performing read we
+	 * retrive written data.
 	 */
+	sem_wait(&done);
 
 	/* Allocate data buffer for read */
 	data2 = ctx_data_alloc(1);
 	if (!data2)
 		error("Unable to allocate data2\n");
 	/* Prepare and submit read IO to the core */
-	submit_io(core, data2, 0, 512, OCF_READ, complete_read);
+	if (submit_io(core, data2, 0, 512, OCF_READ, complete_read, &done))
+		error("Unable to submit read\n");
 	/* After read completes, complete_read() callback will be called,
 	 * where we print our example data to stdout.
 	 */
+	sem_wait(&done);
+
+	sem_destroy(&done);
 }
 
 static void remove_core_complete(void *priv, int error)
@@ -351,8 +383,8 @@ int main(int argc, char *argv[])
 	if (initialize_cache(ctx, &cache1))
 		error("Unable to start cache\n");
 
-	/* Add core */
-	if (initialize_core(cache1, &core1))
+	/* Add core, optionally backed by file given as the only argument */
+	if (initialize_core(cache1, &core1, argc > 1 ? argv[1] : NULL))
 		error("Unable to add core\n");
 
 	/* Do some actual io operations */
@@ -370,6 +402,9 @@ int main(int argc, char *argv[])
 
 	cache_priv = ocf_cache_get_priv(cache1);
 
+	uring_volume_queue_unregister(cache_priv->io_queue);
+	uring_volume_queue_unregister(cache_priv->mngt_queue);
+
 	/* Put the management queue */
 	ocf_queue_put(cache_priv->mngt_queue);
 
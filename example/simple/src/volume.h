@@ -24,4 +24,26 @@ struct myvolume {
 int volume_init(ocf_ctx_t ocf_ctx);
 void volume_cleanup(ocf_ctx_t ocf_ctx);
 
+/*
+ * Optional parameters of io_uring file volume, passed as volume_params.
+ * If not provided, default values are used.
+ */
+struct uring_volume_params {
+	uint32_t queue_depth;
+	uint32_t batch;
+	uint32_t rings;
+	int flags;
+};
+
+int uring_volume_init(ocf_ctx_t ocf_ctx);
+void uring_volume_cleanup(ocf_ctx_t ocf_ctx);
+
+/*
+ * Each OCF queue submitting I/O to io_uring file volume has to be
+ * registered once it's created. Queues registered as N-th are bound to
+ * N-th ring of each volume (modulo number of rings).
+ */
+int uring_volume_queue_register(ocf_queue_t q);
+void uring_volume_queue_unregister(ocf_queue_t q);
+
 #endif
@@ -0,0 +1,302 @@
+/*
+ * Copyright(c) 2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <ocf/ocf.h>
+#include "ocf_env.h"
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <linux/fs.h>
+#include "ocf_env_uring.h"
+#include "volume.h"
+#include "data.h"
+#include "ctx.h"
+
+#define URING_VOL_QUEUE_DEPTH	128
+#define URING_VOL_BATCH		16
+#define URING_VOL_RINGS_MAX	64
+#define URING_VOL_QUEUES_MAX	URING_VOL_RINGS_MAX
+
+struct uring_volume {
+	int fd;
+	uint64_t length;
+	const char *name;
+	uint32_t rings_nr;
+	struct env_uring *rings[URING_VOL_RINGS_MAX];
+};
+
+struct uring_volume_io {
+	struct volume_data *data;
+	uint32_t offset;
+	/* Expected result of I/O - number of bytes for read/write */
+	uint32_t expected;
+};
+
+/*
+ * Completion is called from ring completion thread. Short read or write
+ * is treated as an error.
+ */
+static void uring_volume_io_end(void *priv, int result)
+{
+	struct ocf_io *io = priv;
+	struct uring_volume_io *uio = ocf_io_get_priv(io);
+
+	if (result >= 0)
+		result = (result == uio->expected) ? 0 : -EIO;
+
+	io->end(io, result);
+}
+
+/*
+ * OCF queues registered with uring_volume_queue_register(). Slot index of
+ * the queue selects its ring in each volume.
+ */
+static struct {
+	env_spinlock lock;
+	ocf_queue_t queue[URING_VOL_QUEUES_MAX];
+} uring_queues;
+
+int uring_volume_queue_register(ocf_queue_t q)
+{
+	int ret = -ENOSPC;
+	uint32_t i;
+
+	env_spinlock_lock(&uring_queues.lock);
+	for (i = 0; i < URING_VOL_QUEUES_MAX; i++) {
+		if (!uring_queues.queue[i]) {
+			uring_queues.queue[i] = q;
+			ret = 0;
+			break;
+		}
+	}
+	env_spinlock_unlock(&uring_queues.lock);
+
+	return ret;
+}
+
+void uring_volume_queue_unregister(ocf_queue_t q)
+{
+	uint32_t i;
+
+	env_spinlock_lock(&uring_queues.lock);
+	for (i = 0; i < URING_VOL_QUEUES_MAX; i++) {
+		if (uring_queues.queue[i] == q)
+			uring_queues.queue[i] = NULL;
+	}
+	env_spinlock_unlock(&uring_queues.lock);
+}
+
+/*
+ * Each OCF queue is bound to one ring, so that all I/O submitted from
+ * given queue completes in context of the same completion thread. Queues
+ * get distinct rings as long as volume has enough of them. I/O from queue
+ * which isn't registered goes to the first ring.
+ */
+static struct env_uring *uring_volume_get_ring(struct uring_volume *vol,
+		struct ocf_io *io)
+{
+	uint32_t i;
+
+	for (i = 0; i < URING_VOL_QUEUES_MAX; i++) {
+		if (uring_queues.queue[i] == io->io_queue)
+			return vol->rings[i % vol->rings_nr];
+	}
+
+	return vol->rings[0];
+}
+
+/*
+ * In open() function uuid is treated as path to file or block device.
+ * Device is opened with O_DIRECT only when polled completions are
+ * requested, as the rest of example doesn't guarantee buffer alignment.
+ */
+static int uring_volume_open(ocf_volume_t volume, void *volume_params)
+{
+	const struct ocf_volume_uuid *uuid = ocf_volume_get_uuid(volume);
+	struct uring_volume *vol = ocf_volume_get_priv(volume);
+	struct uring_volume_params params = {
+		.queue_depth = URING_VOL_QUEUE_DEPTH,
+		.batch = URING_VOL_BATCH,
+		.rings = 1,
+		.flags = 0,
+	};
+	int oflags = O_RDWR;
+	struct stat st;
+	uint32_t i;
+
+	if (volume_params)
+		params = *(struct uring_volume_params *)volume_params;
+
+	if (!params.rings || params.rings > URING_VOL_RINGS_MAX)
+		return -EINVAL;
+
+	if (params.flags & ENV_URING_IOPOLL)
+		oflags |= O_DIRECT;
+
+	vol->name = ocf_uuid_to_str(uuid);
+	vol->fd = open(vol->name, oflags);
+	if (vol->fd < 0)
+		return -errno;
+
+	if (fstat(vol->fd, &st))
+		goto err;
+
+	if (S_ISBLK(st.st_mode)) {
+		if (ioctl(vol->fd, BLKGETSIZE64, &vol->length))
+			goto err;
+	} else {
+		vol->length = st.st_size;
+	}
+
+	for (i = 0; i < params.rings; i++) {
+		vol->rings[i] = env_uring_create(params.queue_depth,
+				params.batch, params.flags,
+				uring_volume_io_end, "ocf_uring");
+		if (!vol->rings[i])
+			goto err_rings;
+	}
+	vol->rings_nr = params.rings;
+
+	printf("URING VOL OPEN: (name: %s, rings: %u)\n", vol->name,
+			vol->rings_nr);
+
+	return 0;
+
+err_rings:
+	while (i--)
+		env_uring_destroy(vol->rings[i]);
+err:
+	close(vol->fd);
+	return -EINVAL;
+}
+
+/*
+ * Destroying rings waits for all in-flight I/O.
+ */
+static void uring_volume_close(ocf_volume_t volume)
+{
+	struct uring_volume *vol = ocf_volume_get_priv(volume);
+	uint32_t i;
+
+	printf("URING VOL CLOSE: (name: %s)\n", vol->name);
+
+	for (i = 0; i < vol->rings_nr; i++)
+		env_uring_destroy(vol->rings[i]);
+
+	close(vol->fd);
+}
+
+static void uring_volume_submit_io(struct ocf_io *io)
+{
+	struct uring_volume *vol = ocf_volume_get_priv(ocf_io_get_volume(io));
+	struct uring_volume_io *uio = ocf_io_get_priv(io);
+	int ret;
+
+	uio->expected = io->bytes;
+
+	ret = env_uring_rw(uring_volume_get_ring(vol, io), vol->fd,
+			io->dir == OCF_WRITE,
+			uio->data->ptr + uio->data->offset + uio->offset,
+			io->bytes, io->addr, io);
+	if (ret)
+		io->end(io, ret);
+}
+
+static void uring_volume_submit_flush(struct ocf_io *io)
+{
+	struct uring_volume *vol = ocf_volume_get_priv(ocf_io_get_volume(io));
+	struct uring_volume_io *uio = ocf_io_get_priv(io);
+	int ret;
+
+	uio->expected = 0;
+
+	ret = env_uring_fsync(uring_volume_get_ring(vol, io), vol->fd, io);
+	if (ret)
+		io->end(io, ret);
+}
+
+static void uring_volume_submit_discard(struct ocf_io *io)
+{
+	struct uring_volume *vol = ocf_volume_get_priv(ocf_io_get_volume(io));
+	struct uring_volume_io *uio = ocf_io_get_priv(io);
+	int ret;
+
+	uio->expected = 0;
+
+	ret = env_uring_discard(uring_volume_get_ring(vol, io), vol->fd,
+			io->addr, io->bytes, io);
+	if (ret)
+		io->end(io, ret);
+}
+
+static unsigned int uring_volume_get_max_io_size(ocf_volume_t volume)
+{
+	return 1024 * 1024;
+}
+
+static uint64_t uring_volume_get_length(ocf_volume_t volume)
+{
+	struct uring_volume *vol = ocf_volume_get_priv(volume);
+
+	return vol->length;
+}
+
+static int uring_volume_io_set_data(struct ocf_io *io, ctx_data_t *data,
+		uint32_t offset)
+{
+	struct uring_volume_io *uio = ocf_io_get_priv(io);
+
+	uio->data = data;
+	uio->offset = offset;
+
+	return 0;
+}
+
+static ctx_data_t *uring_volume_io_get_data(struct ocf_io *io)
+{
+	struct uring_volume_io *uio = ocf_io_get_priv(io);
+
+	return uio->data;
+}
+
+const struct ocf_volume_properties uring_volume_properties = {
+	.name = "io_uring file volume",
+	.io_priv_size = sizeof(struct uring_volume_io),
+	.volume_priv_size = sizeof(struct uring_volume),
+	.caps = {
+		.atomic_writes = 0,
+	},
+	.ops = {
+		.open = uring_volume_open,
+		.close = uring_volume_close,
+		.submit_io = uring_volume_submit_io,
+		.submit_flush = uring_volume_submit_flush,
+		.submit_discard = uring_volume_submit_discard,
+		.get_max_io_size = uring_volume_get_max_io_size,
+		.get_length = uring_volume_get_length,
+	},
+	.io_ops = {
+		.set_data = uring_volume_io_set_data,
+		.get_data = uring_volume_io_get_data,
+	},
+};
+
+int uring_volume_init(ocf_ctx_t ocf_ctx)
+{
+	int ret;
+
+	ret = env_spinlock_init(&uring_queues.lock);
+	if (ret)
+		return ret;
+
+	return ocf_ctx_register_volume_type(ocf_ctx, VOL_TYPE_URING,
+			&uring_volume_properties);
+}
+
+void uring_volume_cleanup(ocf_ctx_t ocf_ctx)
+{
+	ocf_ctx_unregister_volume_type(ocf_ctx, VOL_TYPE_URING);
+	env_spinlock_destroy(&uring_queues.lock);
+}
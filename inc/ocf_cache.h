@@ -72,6 +72,73 @@ struct ocf_cache_info {
 			  set as a result of reaching IO error threshold */
 	} fallback_pt;
 
+	/* Statistics of latency based read steering */
+	struct {
+		bool status;
+			/*!< Clean reads are currently served from core */
+
+		uint64_t cache_latency;
+			/*!< Average cache device read latency (in nanoseconds) */
+
+		uint64_t core_latency;
+			/*!< Average core devices read latency (in nanoseconds) */
+
+		uint64_t steered;
+			/*!< Requests served from core because of cache latency */
+	} steering;
+
+	/* Statistics of hedged reads */
+	struct {
+		uint64_t deadline;
+			/*!< Current cache read deadline (in nanoseconds),
+			  0 if not known yet */
+
+		uint64_t hedged;
+			/*!< Read hits for which hedged core read was issued */
+
+		uint64_t core_won;
+			/*!< Read hits completed by hedged core read */
+	} hedging;
+
+	/* Statistics of background work limited by its bandwidth share */
+	struct {
+		uint64_t cleaner_deferred;
+			/*!< Cleaner runs postponed because of user IO */
+
+		uint64_t backfill_skipped;
+			/*!< Read misses not inserted because of user IO */
+	} background_io;
+
+	/* Statistics of requests waiting for cache line locks */
+	struct {
+		uint32_t waiting;
+			/*!< Requests currently waiting for cache line locks */
+
+		uint64_t resumed;
+			/*!< Requests resumed after waiting for cache line locks */
+
+		uint64_t wait_time;
+			/*!< Total time of waiting for cache line locks
+			  (in microseconds) */
+
+		uint64_t batches;
+			/*!< Number of per-queue batches of resumed requests */
+	} lock_wait;
+
+	/* Statistics of striped cache line lock table */
+	struct {
+		uint32_t slots;
+			/*!< Number of lock slots, 0 if each cache line has
+			  its own lock */
+
+		uint32_t busy;
+			/*!< Number of currently locked slots */
+
+		uint64_t collisions;
+			/*!< Estimated number of times lock slot was found busy
+			  because of other cache line sharing it */
+	} lock_table;
+
 	ocf_cleaning_t cleaning_policy;
 		/*!< Cleaning policy selected */
 
@@ -92,6 +159,55 @@ struct ocf_cache_info {
 
 	uint32_t metadata_end_offset;
 		/*!< LBA offset where metadata ends (in 4KiB blocks) */
+
+	/* Statistics of cache data compression */
+	struct {
+		ocf_compression_t ratio;
+			/*!< Compression ratio selected */
+
+		uint64_t bytes_in;
+			/*!< Data compressed before insertion (in bytes) */
+
+		uint64_t bytes_out;
+			/*!< Compressed size of inserted data (in bytes) */
+
+		uint64_t incompressible;
+			/*!< Requests not inserted because data didn't fit */
+
+		uint64_t compress_time;
+			/*!< Time spent compressing data (in microseconds) */
+
+		uint64_t decompress_time;
+			/*!< Time spent decompressing data (in microseconds) */
+	} compression;
+
+	/* Statistics of cache data deduplication */
+	struct {
+		ocf_dedup_t factor;
+			/*!< Cache lines per data slot selected */
+
+		uint32_t data_slots;
+			/*!< Number of data slots on cache device */
+
+		uint32_t free_slots;
+			/*!< Data slots not used by any cache line */
+
+		uint32_t shared_slots;
+			/*!< Data slots used by more than one cache line */
+
+		uint64_t hits;
+			/*!< Cache lines inserted into shared data slot */
+
+		uint64_t cow;
+			/*!< Shared data slots copied on write */
+
+		uint64_t no_slot;
+			/*!< Requests not inserted because of no free data slot */
+
+		uint64_t collisions;
+			/*!< Cache lines with matching fingerprint but different
+			 * data, which were not inserted into shared data slot */
+	} dedup;
 };
 
 /**
@@ -160,6 +276,33 @@ ocf_cache_mode_t ocf_cache_get_mode(ocf_cache_t cache);
  */
 ocf_cache_line_size_t ocf_cache_get_line_size(ocf_cache_t cache);
 
+/**
+ * @brief Get cache line status granularity of given cache object
+ *
+ * @param[in] cache Cache object
+ *
+ * @retval Cache line status granularity
+ */
+ocf_status_granularity_t ocf_cache_get_status_granularity(ocf_cache_t cache);
+
+/**
+ * @brief Get cache data compression ratio of given cache object
+ *
+ * @param[in] cache Cache object
+ *
+ * @retval Cache data compression ratio
+ */
+ocf_compression_t ocf_cache_get_compression(ocf_cache_t cache);
+
+/**
+ * @brief Get cache data deduplication factor of given cache object
+ *
+ * @param[in] cache Cache object
+ *
+ * @retval Cache data deduplication factor
+ */
+ocf_dedup_t ocf_cache_get_dedup(ocf_cache_t cache);
+
 /**
  * @brief Convert bytes to cache lines
  *
@@ -39,6 +39,21 @@ struct ocf_core_info {
 
 	/** Sequential cutoff policy */
 	ocf_seq_cutoff_policy seq_cutoff_policy;
+
+	/** Requests cut off by sequential cutoff, by detected stream pattern */
+	struct {
+		/** Strictly sequential streams */
+		uint64_t sequential;
+
+		/** Sequential streams with requests slightly out of order */
+		uint64_t reordered;
+
+		/** Streams with constant gap between requests */
+		uint64_t strided;
+
+		/** Streams with descending addresses */
+		uint64_t reverse;
+	} seq_cutoff_streams;
 };
 
 /**
@@ -125,6 +125,56 @@ struct ocf_data_ops {
 	 * @param[in] dst Contex data buffer which shall be erased
 	 */
 	void (*secure_erase)(ctx_data_t *dst);
+
+	/**
+	 * @brief Check if context data buffer content is all zeros
+	 *
+	 * @note Optional, zero blocks are not detected if not provided.
+	 *	Checked bytes start at current read/write head, which is not
+	 *	moved.
+	 *
+	 * @param[in] src Source context data buffer
+	 * @param[in] size Number of bytes to be checked
+	 *
+	 * @retval true All checked bytes are zero
+	 * @retval false At least one checked byte is not zero
+	 */
+	bool (*is_zero)(ctx_data_t *src, uint32_t size);
+
+	/**
+	 * @brief Compress context data buffer content
+	 *
+	 * @note Optional, required only by caches started with compression.
+	 *
+	 * @param[in,out] dst Destination context data buffer
+	 * @param[in] src Source context data buffer
+	 * @param[in] to Starting offset in destination buffer
+	 * @param[in] from Starting offset in source buffer
+	 * @param[in] bytes Number of bytes to be compressed
+	 * @param[in] max_size Space available in destination buffer
+	 *
+	 * @return Compressed size in bytes, 0 if it exceeds max_size
+	 */
+	uint32_t (*compress)(ctx_data_t *dst, ctx_data_t *src, uint64_t to,
+			uint64_t from, uint32_t bytes, uint32_t max_size);
+
+	/**
+	 * @brief Decompress context data buffer content
+	 *
+	 * @note Optional, required only by caches started with compression.
+	 *
+	 * @param[in,out] dst Destination context data buffer
+	 * @param[in] src Source context data buffer
+	 * @param[in] to Starting offset in destination buffer
+	 * @param[in] from Starting offset in source buffer
+	 * @param[in] size Compressed size in bytes
+	 * @param[in] bytes Expected number of decompressed bytes
+	 *
+	 * @retval 0 Data decompressed to exactly expected number of bytes
+	 * @retval Non-zero Compressed data is corrupted
+	 */
+	int (*decompress)(ctx_data_t *dst, ctx_data_t *src, uint64_t to,
+			uint64_t from, uint32_t size, uint32_t bytes);
 };
 
 /**
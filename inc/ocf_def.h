@@ -49,6 +49,58 @@
  * Maximum value of io error threshold
  */
 #define OCF_CACHE_FALLBACK_PT_MAX_ERROR_THRESHOLD	1000000
+/**
+ * Value to turn off steering of reads to core on cache device saturation
+ */
+#define OCF_CACHE_READ_STEERING_INACTIVE	0
+/**
+ * Minimum cache to core latency percentage activating read steering
+ */
+#define OCF_CACHE_READ_STEERING_MIN_THRESHOLD	100
+/**
+ * Maximum cache to core latency percentage activating read steering
+ */
+#define OCF_CACHE_READ_STEERING_MAX_THRESHOLD	10000
+/**
+ * Value to turn off hedged core reads of slow cache read hits
+ */
+#define OCF_CACHE_READ_HEDGE_INACTIVE		0
+/**
+ * Minimum cache read latency percentile (in per mille) used as read deadline
+ */
+#define OCF_CACHE_READ_HEDGE_MIN_PERCENTILE	500
+/**
+ * Maximum cache read latency percentile (in per mille) used as read deadline
+ */
+#define OCF_CACHE_READ_HEDGE_MAX_PERCENTILE	999
+/**
+ * Value to turn off limiting cache device bandwidth of background work
+ */
+#define OCF_CACHE_BACKGROUND_IO_SHARE_INACTIVE	0
+/**
+ * Minimum percentage of cache device bandwidth left to background work
+ */
+#define OCF_CACHE_BACKGROUND_IO_SHARE_MIN	1
+/**
+ * Maximum percentage of cache device bandwidth left to background work
+ */
+#define OCF_CACHE_BACKGROUND_IO_SHARE_MAX	99
+/**
+ * Minimum number of lock slots in striped cache line lock table
+ */
+#define OCF_CACHE_LINE_LOCK_SLOTS_MIN	1024
+/**
+ * Value to turn off splitting of large requests
+ */
+#define OCF_CACHE_IO_SPLIT_INACTIVE	0
+/**
+ * Minimum number of cache lines in sub-request of split request
+ */
+#define OCF_CACHE_IO_SPLIT_MIN_LINES	8
+/**
+ * Value to turn off discarding of freed cache lines
+ */
+#define OCF_CACHE_TRIM_INACTIVE		0
 /**
  * @}
  */
@@ -181,6 +233,7 @@ typedef enum {
 #define OCF_SEQ_CUTOFF_MAX_THRESHOLD 4294841344
 #define OCF_SEQ_CUTOFF_MIN_PROMOTION_COUNT 1
 #define OCF_SEQ_CUTOFF_MAX_PROMOTION_COUNT 65535
+#define OCF_IO_CLASS_SEQ_CUTOFF_INHERIT 0
 
 typedef enum {
 	ocf_seq_cutoff_policy_always = 0,
@@ -243,6 +296,29 @@ typedef enum {
 		/*!< Default cleaning policy type */
 } ocf_cleaning_t;
 
+/**
+ * OCF cache line allocation policies
+ */
+typedef enum {
+	ocf_alloc_policy_lru = 0,
+		/*!< Free cache lines are taken from free list in any order,
+		 * cache lines are evicted from LRU tail
+		 */
+
+	ocf_alloc_policy_log,
+		/*!< Cache lines are allocated at write frontier moving through
+		 * cache device in physical order. Clean cache lines found at
+		 * the frontier are evicted, so writes to cache device are
+		 * mostly sequential.
+		 */
+
+	ocf_alloc_policy_max,
+		/*!< Stopper of enumerator */
+
+	ocf_alloc_policy_default = ocf_alloc_policy_lru,
+		/*!< Default allocation policy */
+} ocf_alloc_policy_t;
+
 /**
  * OCF supported cache line sizes in bytes
  */
@@ -265,19 +341,106 @@ typedef enum {
 	ocf_cache_line_size_64 = 64 * KiB,
 		/*!< 64 kiB */
 
+	ocf_cache_line_size_128 = 128 * KiB,
+		/*!< 128 kiB - requires status granularity of at least 1 kiB */
+
+	ocf_cache_line_size_256 = 256 * KiB,
+		/*!< 256 kiB - requires status granularity of at least 2 kiB */
+
+	ocf_cache_line_size_512 = 512 * KiB,
+		/*!< 512 kiB - requires status granularity of at least 4 kiB */
+
+	ocf_cache_line_size_1024 = 1024 * KiB,
+		/*!< 1 MiB - requires status granularity of at least 8 kiB */
+
+	ocf_cache_line_size_2048 = 2048 * KiB,
+		/*!< 2 MiB - requires status granularity of at least 16 kiB */
+
 	ocf_cache_line_size_default = ocf_cache_line_size_4,
 		/*!< Default cache line size */
 
 	ocf_cache_line_size_min = ocf_cache_line_size_4,
 		/*!< Minimum cache line size */
 
-	ocf_cache_line_size_max = ocf_cache_line_size_64,
+	ocf_cache_line_size_max = ocf_cache_line_size_2048,
 		/*!< Maximal cache line size */
 
 	ocf_cache_line_size_inf = ~0ULL,
 		/*!< Force enum to be 64-bit */
 } ocf_cache_line_size_t;
 
+/**
+ * OCF supported cache line status granularities in bytes. Valid and dirty
+ * status is tracked for each unit of this size within cache line. Single
+ * cache line can hold at most 128 such units. I/O not aligned to the status
+ * granularity is served in pass-through mode.
+ */
+typedef enum {
+	ocf_status_granularity_512 = 512,
+		/*!< 512 B sectors */
+
+	ocf_status_granularity_1 = 1 * KiB,
+		/*!< 1 kiB blocks */
+
+	ocf_status_granularity_2 = 2 * KiB,
+		/*!< 2 kiB blocks */
+
+	ocf_status_granularity_4 = 4 * KiB,
+		/*!< 4 kiB blocks */
+
+	ocf_status_granularity_8 = 8 * KiB,
+		/*!< 8 kiB blocks */
+
+	ocf_status_granularity_16 = 16 * KiB,
+		/*!< 16 kiB blocks */
+
+	ocf_status_granularity_default = ocf_status_granularity_512,
+		/*!< Default status granularity */
+} ocf_status_granularity_t;
+
+/**
+ * OCF supported cache data compression ratios. With compression enabled
+ * each cache line is stored in a slot of cache line size divided by the
+ * ratio, so the cache holds ratio times more cache lines. Each status
+ * granularity unit is compressed separately and must fit into its share
+ * of the slot, otherwise it is not inserted into cache.
+ */
+typedef enum {
+	ocf_compression_none = 1,
+		/*!< Cache data is not compressed */
+
+	ocf_compression_2 = 2,
+		/*!< Cache lines are stored in half of their size */
+
+	ocf_compression_4 = 4,
+		/*!< Cache lines are stored in quarter of their size */
+
+	ocf_compression_default = ocf_compression_none,
+		/*!< Default compression ratio */
+} ocf_compression_t;
+
+/**
+ * OCF supported cache data deduplication factors. With deduplication
+ * enabled cache line data is stored in separate data slots and clean cache
+ * lines with identical content, also of different cores, share single data
+ * slot. The collision table gets factor times more entries than there are
+ * data slots on cache device, so the cache may hold that many more lines if
+ * their data repeats. Shared data slot is copied on write.
+ */
+typedef enum {
+	ocf_dedup_none = 1,
+		/*!< Cache line data is not deduplicated */
+
+	ocf_dedup_2 = 2,
+		/*!< Up to twice as many cache lines as data slots */
+
+	ocf_dedup_4 = 4,
+		/*!< Up to four times as many cache lines as data slots */
+
+	ocf_dedup_default = ocf_dedup_none,
+		/*!< Default deduplication factor */
+} ocf_dedup_t;
+
 /**
  * Metadata layout
  */
@@ -44,6 +44,42 @@ typedef void (*ocf_handle_io_t)(struct ocf_io *io, void *opaque);
  */
 typedef void (*ocf_end_io_t)(struct ocf_io *io, int error);
 
+/**
+ * @brief Origin of IO submitted by OCF to cache and core volumes
+ */
+typedef enum {
+	ocf_io_origin_user = 0,
+		/*!< Serving user request */
+
+	ocf_io_origin_metadata,
+		/*!< Reading or writing cache metadata */
+
+	ocf_io_origin_mngt,
+		/*!< Management operation */
+
+	ocf_io_origin_backfill,
+		/*!< Inserting data of read miss into cache */
+
+	ocf_io_origin_cleaner,
+		/*!< Cleaning dirty data */
+
+	ocf_io_origin_trim,
+		/*!< Discarding freed cache lines */
+
+	ocf_io_origin_max,
+} ocf_io_origin_t;
+
+/**
+ * @brief Priority of IO submitted by OCF to cache and core volumes
+ */
+typedef enum {
+	ocf_io_priority_foreground = 0,
+		/*!< User request or cache management waits for IO */
+
+	ocf_io_priority_background,
+		/*!< Nothing waits for IO, it may be delayed by volume */
+} ocf_io_priority_t;
+
 /**
  * @brief OCF IO main structure
  */
@@ -235,4 +271,25 @@ void ocf_io_handle(struct ocf_io *io, void *opaque);
  */
 ocf_volume_t ocf_io_get_volume(struct ocf_io *io);
 
+/**
+ * @brief Get origin of IO submitted by OCF
+ *
+ * @param[in] io OCF IO
+ *
+ * @retval Origin of IO
+ */
+ocf_io_origin_t ocf_io_get_origin(struct ocf_io *io);
+
+/**
+ * @brief Get priority of IO submitted by OCF
+ *
+ * @note Backfill, cleaner and trim IO is submitted with background
+ *	priority, all other IO with foreground priority
+ *
+ * @param[in] io OCF IO
+ *
+ * @retval Priority of IO
+ */
+ocf_io_priority_t ocf_io_get_priority(struct ocf_io *io);
+
 #endif /* __OCF_IO_H__ */
@@ -14,6 +14,24 @@
 #ifndef __OCF_IO_CLASS_H__
 #define __OCF_IO_CLASS_H__
 
+/**
+ * @brief IO class promotion policy override
+ */
+struct ocf_io_class_promotion {
+	bool enabled;
+		/*!< Promotion policy below is used for IO class instead of
+		 * cache promotion policy */
+
+	ocf_promotion_t policy;
+		/*!< Promotion policy of IO class */
+
+	uint32_t nhit_insertion_threshold;
+		/*!< Insertion threshold of ocf_promotion_nhit policy */
+
+	uint32_t nhit_trigger_threshold;
+		/*!< Trigger threshold (in percent) of ocf_promotion_nhit policy */
+};
+
 /**
  * @brief OCF IO class information
  */
@@ -46,6 +64,14 @@ struct ocf_io_class_info {
 
 	ocf_cleaning_t cleaning_policy_type;
 		/*!< The type of cleaning policy for given IO class */
+
+	struct ocf_io_class_promotion promotion;
+		/*!< Promotion policy override of IO class */
+
+	uint32_t seq_cutoff_threshold;
+		/*!< Sequential cutoff threshold of IO class (in bytes),
+		 * OCF_IO_CLASS_SEQ_CUTOFF_INHERIT if core configuration
+		 * is used */
 };
 
 /**
@@ -8,6 +8,7 @@
 
 #include "ocf_cache.h"
 #include "ocf_core.h"
+#include "ocf_io_class.h"
 
 /**
  * @file
@@ -256,6 +257,39 @@ struct ocf_mngt_cache_config {
 	 */
 	ocf_cache_line_size_t cache_line_size;
 
+	/**
+	 * @brief Cache line status granularity
+	 *
+	 * @note Can't be changed after cache is started. With granularity
+	 *	bigger than 512 B, I/O not aligned to the granularity is
+	 *	served in pass-through mode and discard is narrowed down to
+	 *	whole units. Cache line size divided by granularity must not
+	 *	exceed 128, so cache lines bigger than 64 kiB need coarser
+	 *	granularity.
+	 */
+	ocf_status_granularity_t status_granularity;
+
+	/**
+	 * @brief Cache data compression ratio
+	 *
+	 * @note Can't be changed after cache is started. Compression requires
+	 *	compress and decompress data operations in context and is not
+	 *	supported on atomic volumes. Status granularity divided by
+	 *	compression ratio must be at least 512 B, coarser granularity
+	 *	also gives the codec bigger blocks to work on.
+	 */
+	ocf_compression_t compression;
+
+	/**
+	 * @brief Cache data deduplication factor
+	 *
+	 * @note Can't be changed after cache is started. Deduplication is not
+	 *	supported on atomic volumes and can't be combined with discarding
+	 *	of freed cache lines (see ocf_mngt_cache_set_trim_rate()).
+	 *	Only data inserted on read miss is deduplicated.
+	 */
+	ocf_dedup_t dedup;
+
 	/**
 	 * @brief Metadata layout (stripping/sequential)
 	 */
@@ -304,6 +338,9 @@ static inline void ocf_mngt_cache_config_set_default(
 	cfg->cache_mode = ocf_cache_mode_default;
 	cfg->promotion_policy = ocf_promotion_default;
 	cfg->cache_line_size = ocf_cache_line_size_4;
+	cfg->status_granularity = ocf_status_granularity_default;
+	cfg->compression = ocf_compression_default;
+	cfg->dedup = ocf_dedup_default;
 	cfg->metadata_layout = ocf_metadata_layout_default;
 	cfg->metadata_volatile = false;
 	cfg->backfill.max_queue_size = 65536;
@@ -411,11 +448,47 @@ struct ocf_mngt_cache_device_config {
 	 */
 	bool discard_on_start;
 
+	/**
+	 * @brief Number of cache line lock slots
+	 *
+	 * If set to 0, each cache line has its own lock. Otherwise cache
+	 * lines are hashed into fixed size table of locks, so that memory
+	 * consumed by locks depends on this value instead of cache size.
+	 * Cache lines sharing a lock exclude each other, so the table should
+	 * be sized well above number of cache lines accessed concurrently.
+	 *
+	 * @note Must be either 0 or at least OCF_CACHE_LINE_LOCK_SLOTS_MIN.
+	 */
+	uint32_t cache_line_lock_slots;
+
 	/**
 	 * @brief Optional opaque volume parameters, passed down to cache volume
 	 * open callback
 	 */
 	void *volume_params;
+
+	/**
+	 * @brief Metadata volume UUID
+	 *
+	 * If UUID size is nonzero, cache metadata is kept on separate metadata
+	 * volume and whole cache volume is used for cache line data. The same
+	 * metadata volume has to be given again when loading cache.
+	 *
+	 * @note Separate metadata volume is not supported with atomic cache
+	 *       volume.
+	 */
+	struct ocf_volume_uuid metadata_uuid;
+
+	/**
+	 * @brief Metadata volume type
+	 */
+	uint8_t metadata_volume_type;
+
+	/**
+	 * @brief Optional opaque volume parameters, passed down to metadata
+	 * volume open callback
+	 */
+	void *metadata_volume_params;
 };
 
 /**
@@ -434,7 +507,11 @@ static inline void ocf_mngt_cache_device_config_set_default(
 	cfg->force = false;
 	cfg->perform_test = true;
 	cfg->discard_on_start = true;
+	cfg->cache_line_lock_slots = 0;
 	cfg->volume_params = NULL;
+	cfg->metadata_uuid.size = 0;
+	cfg->metadata_uuid.data = NULL;
+	cfg->metadata_volume_params = NULL;
 }
 
 /**
@@ -705,6 +782,38 @@ typedef void (*ocf_mngt_cache_save_end_t)(ocf_cache_t cache,
 void ocf_mngt_cache_save(ocf_cache_t cache,
 		ocf_mngt_cache_save_end_t cmpl, void *priv);
 
+/**
+ * @brief Completion callback of cache prewarm operation
+ *
+ * @param[in] cache Cache handle
+ * @param[in] priv Callback context
+ * @param[in] error Error code (zero on success)
+ */
+typedef void (*ocf_mngt_cache_prewarm_end_t)(ocf_cache_t cache,
+		void *priv, int error);
+
+/**
+ * @brief Read core ranges which were hot before cache restart into cache
+ *
+ * Warm state snapshot, containing ranges of core lines hot in cache and
+ * promotion policy state, is saved on cache volume when cache is stopped
+ * or detached, and it is restored when cache is loaded or attached. After
+ * dirty shutdown or detach cache content does not reflect saved hot ranges.
+ * This function reads them through the cache one IO at a time, so that
+ * they get inserted into cache without competing much with user IO. Ranges
+ * of cores which are not active are skipped. Prewarm reads are subject to
+ * regular promotion policy and IO classification.
+ *
+ * @attention Cache must stay locked (read lock is sufficient) until
+ *	      operation completes
+ *
+ * @param[in] cache Cache handle
+ * @param[in] cmpl Completion callback
+ * @param[in] priv Completion callback context
+ */
+void ocf_mngt_cache_prewarm(ocf_cache_t cache,
+		ocf_mngt_cache_prewarm_end_t cmpl, void *priv);
+
 /**
  * @brief Determines whether given cache mode has write-back semantics, i.e. it
  * allows for writes to be serviced in cache and lazily propagated to core.
@@ -876,6 +985,20 @@ struct ocf_mngt_io_class_config {
 	 * @brief IO class eviction priority
 	 */
 	int16_t prio;
+
+	/**
+	 * @brief IO class promotion policy override, cache promotion policy
+	 *	is used unless enabled
+	 */
+	struct ocf_io_class_promotion promotion;
+
+	/**
+	 * @brief IO class sequential cutoff threshold in bytes. Sequential
+	 *	streams of IO class exceeding it are not cached regardless of
+	 *	core sequential cutoff policy. OCF_IO_CLASS_SEQ_CUTOFF_INHERIT
+	 *	to use core sequential cutoff configuration.
+	 */
+	uint32_t seq_cutoff_threshold;
 };
 
 struct ocf_mngt_io_classes_config {
@@ -1085,6 +1208,173 @@ int ocf_mngt_cache_set_fallback_pt_error_threshold(ocf_cache_t cache,
 int ocf_mngt_cache_get_fallback_pt_error_threshold(ocf_cache_t cache,
 		uint32_t *threshold);
 
+/**
+ * @brief Set cache read steering threshold. Once read latency of cache
+ *	device exceeds given percentage of core read latency, reads of clean
+ *	data are served from core and new cache lines are not promoted.
+ *	Core read latency is sampled on misses and, while reads keep hitting
+ *	cache, by occasional clean read hits served from core.
+ *
+ * @param[in] cache Cache handle
+ * @param[in] threshold Cache to core read latency percentage
+ *	(OCF_CACHE_READ_STEERING_INACTIVE to disable steering)
+ *
+ * @retval 0 Read steering threshold have been set successfully
+ * @retval Non-zero Error occurred
+ */
+int ocf_mngt_cache_set_read_steering_threshold(ocf_cache_t cache,
+		uint32_t threshold);
+
+/**
+ * @brief Get cache read steering threshold
+ *
+ * @param[in] cache Cache handle
+ * @param[out] threshold Cache to core read latency percentage
+ *
+ * @retval 0 Read steering threshold have been get successfully
+ * @retval Non-zero Error occurred
+ */
+int ocf_mngt_cache_get_read_steering_threshold(ocf_cache_t cache,
+		uint32_t *threshold);
+
+/**
+ * @brief Set cache read hedging percentile. Clean read hit which is not
+ *	served by cache device within given percentile of cache read latency
+ *	is read also from core and completed by whichever read finishes first.
+ *
+ * @note Data of read hits eligible for hedging is read into separate buffer
+ *	and copied to request data, so that late read never overwrites data
+ *	of completed request. Deadlines are checked in ocf_queue_run() and
+ *	ocf_queue_check_deadlines().
+ *
+ * @param[in] cache Cache handle
+ * @param[in] percentile Cache read latency percentile in per mille
+ *	(OCF_CACHE_READ_HEDGE_INACTIVE to disable hedging)
+ *
+ * @retval 0 Read hedging percentile have been set successfully
+ * @retval Non-zero Error occurred
+ */
+int ocf_mngt_cache_set_read_hedge_percentile(ocf_cache_t cache,
+		uint32_t percentile);
+
+/**
+ * @brief Get cache read hedging percentile
+ *
+ * @param[in] cache Cache handle
+ * @param[out] percentile Cache read latency percentile in per mille
+ *
+ * @retval 0 Read hedging percentile have been get successfully
+ * @retval Non-zero Error occurred
+ */
+int ocf_mngt_cache_get_read_hedge_percentile(ocf_cache_t cache,
+		uint32_t *percentile);
+
+/**
+ * @brief Set share of cache device bandwidth available to background work.
+ *	While user IO is served by cache device, periodic cleaning is
+ *	postponed and read misses are not inserted into cache once backfill
+ *	and cleaner IO exceed given percentage of cache device bytes.
+ *
+ * @note IO submitted by OCF is tagged with its origin and priority, see
+ *	ocf_io_get_origin() and ocf_io_get_priority().
+ *
+ * @param[in] cache Cache handle
+ * @param[in] share Percentage of cache device bandwidth
+ *	(OCF_CACHE_BACKGROUND_IO_SHARE_INACTIVE to disable limiting)
+ *
+ * @retval 0 Background share have been set successfully
+ * @retval Non-zero Error occurred
+ */
+int ocf_mngt_cache_set_background_io_share(ocf_cache_t cache,
+		uint32_t share);
+
+/**
+ * @brief Get share of cache device bandwidth available to background work
+ *
+ * @param[in] cache Cache handle
+ * @param[out] share Percentage of cache device bandwidth
+ *
+ * @retval 0 Background share have been get successfully
+ * @retval Non-zero Error occurred
+ */
+int ocf_mngt_cache_get_background_io_share(ocf_cache_t cache,
+		uint32_t *share);
+
+/**
+ * @brief Set maximum size of request in cache lines. Larger requests are
+ *	split into sub-requests of given size, which are served in parallel
+ *	on different I/O queues.
+ *
+ * @param[in] cache Cache handle
+ * @param[in] lines Maximum request size in cache lines
+ *	(OCF_CACHE_IO_SPLIT_INACTIVE to disable splitting)
+ *
+ * @retval 0 Split size have been set successfully
+ * @retval Non-zero Error occurred
+ */
+int ocf_mngt_cache_set_io_split(ocf_cache_t cache, uint32_t lines);
+
+/**
+ * @brief Get maximum size of request in cache lines
+ *
+ * @param[in] cache Cache handle
+ * @param[out] lines Maximum request size in cache lines
+ *
+ * @retval 0 Split size have been get successfully
+ * @retval Non-zero Error occurred
+ */
+int ocf_mngt_cache_get_io_split(ocf_cache_t cache, uint32_t *lines);
+
+/**
+ * @brief Set cache line allocation policy
+ *
+ * @param[in] cache Cache handle
+ * @param[in] policy Allocation policy
+ *
+ * @retval 0 Allocation policy have been set successfully
+ * @retval Non-zero Error occurred
+ */
+int ocf_mngt_cache_set_alloc_policy(ocf_cache_t cache,
+		ocf_alloc_policy_t policy);
+
+/**
+ * @brief Get cache line allocation policy
+ *
+ * @param[in] cache Cache handle
+ * @param[out] policy Allocation policy
+ *
+ * @retval 0 Allocation policy have been get successfully
+ * @retval Non-zero Error occurred
+ */
+int ocf_mngt_cache_get_alloc_policy(ocf_cache_t cache,
+		ocf_alloc_policy_t *policy);
+
+/**
+ * @brief Set rate of discarding freed cache lines on cache device.
+ *	Freed cache lines are coalesced into ranges and discarded in
+ *	background by cleaner.
+ *
+ * @param[in] cache Cache handle
+ * @param[in] rate Maximum discard rate in MiB/s
+ *	(OCF_CACHE_TRIM_INACTIVE to disable discarding)
+ *
+ * @retval 0 Discard rate have been set successfully
+ * @retval -OCF_ERR_NOT_SUPP Cache data is deduplicated
+ * @retval Non-zero Error occurred
+ */
+int ocf_mngt_cache_set_trim_rate(ocf_cache_t cache, uint32_t rate);
+
+/**
+ * @brief Get rate of discarding freed cache lines on cache device
+ *
+ * @param[in] cache Cache handle
+ * @param[out] rate Maximum discard rate in MiB/s
+ *
+ * @retval 0 Discard rate have been get successfully
+ * @retval Non-zero Error occurred
+ */
+int ocf_mngt_cache_get_trim_rate(ocf_cache_t cache, uint32_t *rate);
+
 /**
  * @brief Reset cache fallback Pass Through error counter
  *
@@ -91,6 +91,18 @@ void ocf_queue_run_single(ocf_queue_t q);
  */
 void ocf_queue_run(ocf_queue_t q);
 
+/**
+ * @brief Issue hedged core reads of requests which have not been served
+ *	by cache device before their deadline
+ *
+ * @note Deadlines are checked each time queue is run. When read hedging is
+ *	enabled, adapter should also call this function periodically, so that
+ *	stuck cache read is hedged even if there is no other I/O in queue.
+ *
+ * @param[in] q Queue to check
+ */
+void ocf_queue_check_deadlines(ocf_queue_t q);
+
 /**
  * @brief Set queue private data
  *
@@ -108,6 +120,20 @@ void ocf_queue_set_priv(ocf_queue_t q, void *priv);
  */
 void *ocf_queue_get_priv(ocf_queue_t q);
 
+/**
+ * @brief Set whether next phase of request processing may be run
+ *	immediately in I/O completion context
+ *
+ * By default request is put back to the queue once its I/O completes.
+ * Adapter should allow for inline continuation only if its I/O completion
+ * context is fine for processing requests the same way as the queue worker
+ * does.
+ *
+ * @param[in] q I/O queue
+ * @param[in] enable Run next phase of request processing inline
+ */
+void ocf_queue_set_inline_continuation(ocf_queue_t q, bool enable);
+
 /**
  * @brief Get number of pending requests in I/O queue
  *
@@ -97,6 +97,12 @@ struct acp_chunk_info {
 	uint8_t bucket_id;
 };
 
+/* Chunks of single core, allocated when core is added */
+struct acp_core {
+	uint64_t num_chunks;
+	struct acp_chunk_info chunk_info[];
+};
+
 struct acp_bucket {
 	struct list_head chunk_list;
 	uint16_t threshold; /* threshold in clines */
@@ -105,11 +111,8 @@ struct acp_bucket {
 struct acp_context {
 	env_rwsem chunks_lock;
 
-	/* number of chunks per core */
-	uint64_t num_chunks[OCF_CORE_MAX];
-
-	/* per core array of all chunks */
-	struct acp_chunk_info *chunk_info[OCF_CORE_MAX];
+	/* per core chunks, NULL for cores not added */
+	struct acp_core *cores[OCF_CORE_MAX];
 
 	struct acp_bucket bucket_info[ACP_MAX_BUCKETS];
 
@@ -180,7 +183,7 @@ static struct acp_chunk_info *_acp_get_chunk(struct ocf_cache *cache,
 
 	chunk_id = core_line.core_line * ocf_line_size(cache) / ACP_CHUNK_SIZE;
 
-	return &acp->chunk_info[core_line.core_id][chunk_id];
+	return &acp->cores[core_line.core_id]->chunk_info[chunk_id];
 }
 
 static void _acp_remove_cores(struct ocf_cache *cache)
@@ -279,10 +282,10 @@ int cleaning_policy_acp_initialize(struct ocf_cache *cache,
 	/* bug if max chunk number would overflow dirty_no array type */
 #if defined (BUILD_BUG_ON)
 	BUILD_BUG_ON(ACP_CHUNK_SIZE / ocf_cache_line_size_min >=
-			1U << (sizeof(acp->chunk_info[0][0].num_dirty) * 8));
+			1U << (sizeof(acp->cores[0]->chunk_info[0].num_dirty) * 8));
 #else
 	ENV_BUG_ON(ACP_CHUNK_SIZE / ocf_cache_line_size_min >=
-			1U << (sizeof(acp->chunk_info[0][0].num_dirty) * 8));
+			1U << (sizeof(acp->cores[0]->chunk_info[0].num_dirty) * 8));
 #endif
 
 	ENV_BUG_ON(cache->cleaner.cleaning_policy_context);
@@ -417,7 +420,7 @@ static void _acp_handle_flush_error(struct ocf_cache *cache,
 			env_secs_to_ticks(ACP_CHUNK_CLEANING_BACKOFF_TIME);
 
 	if (ocf_cache_log_rl(cache)) {
-		ocf_core_log(&cache->core[flush->chunk->core_id],
+		ocf_core_log(cache->core[flush->chunk->core_id],
 				log_err, "Cleaning error (%d) in range"
 				" <%llu; %llu) backing off for %u seconds\n",
 				flush->error,
@@ -433,7 +436,7 @@ static inline bool _acp_can_clean_chunk(struct ocf_cache *cache,
 {
 	/* Check if core device is opened and if timeout after cleaning error
 	 * expired or wasn't set in the first place */
-	return (cache->core[chunk->core_id].opened &&
+	return (cache->core[chunk->core_id]->opened &&
 			(chunk->next_cleaning_timestamp > env_get_tick_count() ||
 					!chunk->next_cleaning_timestamp));
 }
@@ -663,10 +666,11 @@ void cleaning_policy_acp_remove_core(ocf_cache_t cache,
 		ocf_core_id_t core_id)
 {
 	struct acp_context *acp  = _acp_get_ctx_from_cache(cache);
+	struct acp_core *acp_core = acp->cores[core_id];
 	uint64_t i;
 
-	ENV_BUG_ON(acp->chunks_total < acp->num_chunks[core_id]);
-	ENV_BUG_ON(!acp->chunk_info[core_id]);
+	ENV_BUG_ON(!acp_core);
+	ENV_BUG_ON(acp->chunks_total < acp_core->num_chunks);
 
 	if (acp->state.in_progress && acp->state.chunk->core_id == core_id) {
 		acp->state.in_progress = false;
@@ -676,14 +680,13 @@ void cleaning_policy_acp_remove_core(ocf_cache_t cache,
 
 	ACP_LOCK_CHUNKS_WR();
 
-	for (i = 0; i < acp->num_chunks[core_id]; i++)
-		list_del(&acp->chunk_info[core_id][i].list);
+	for (i = 0; i < acp_core->num_chunks; i++)
+		list_del(&acp_core->chunk_info[i].list);
 
-	acp->chunks_total -= acp->num_chunks[core_id];
-	acp->num_chunks[core_id] = 0;
+	acp->chunks_total -= acp_core->num_chunks;
 
-	env_vfree(acp->chunk_info[core_id]);
-	acp->chunk_info[core_id] = NULL;
+	env_vfree(acp_core);
+	acp->cores[core_id] = NULL;
 
 	ACP_UNLOCK_CHUNKS_WR();
 }
@@ -695,6 +698,7 @@ int cleaning_policy_acp_add_core(ocf_cache_t cache,
 	uint64_t core_size = core->conf_meta->length;
 	uint64_t num_chunks = OCF_DIV_ROUND_UP(core_size, ACP_CHUNK_SIZE);
 	struct acp_context *acp = _acp_get_ctx_from_cache(cache);
+	struct acp_core *acp_core;
 	int i;
 
 	OCF_DEBUG_PARAM(cache, "%s core_id %llu num_chunks %llu\n",
@@ -702,12 +706,12 @@ int cleaning_policy_acp_add_core(ocf_cache_t cache,
 
 	ACP_LOCK_CHUNKS_WR();
 
-	ENV_BUG_ON(acp->chunk_info[core_id]);
+	ENV_BUG_ON(acp->cores[core_id]);
 
-	acp->chunk_info[core_id] =
-			env_vzalloc(num_chunks * sizeof(acp->chunk_info[0][0]));
+	acp_core = env_vzalloc(sizeof(*acp_core) +
+			num_chunks * sizeof(acp_core->chunk_info[0]));
 
-	if (!acp->chunk_info[core_id]) {
+	if (!acp_core) {
 		ACP_UNLOCK_CHUNKS_WR();
 		OCF_DEBUG_PARAM(cache, "failed to allocate acp tables\n");
 		return -OCF_ERR_NO_MEM;
@@ -716,14 +720,15 @@ int cleaning_policy_acp_add_core(ocf_cache_t cache,
 	OCF_DEBUG_PARAM(cache, "successfully allocated acp tables\n");
 
 	/* increment counters */
-	acp->num_chunks[core_id] = num_chunks;
+	acp_core->num_chunks = num_chunks;
+	acp->cores[core_id] = acp_core;
 	acp->chunks_total += num_chunks;
 
-	for (i = 0; i < acp->num_chunks[core_id]; i++) {
+	for (i = 0; i < acp_core->num_chunks; i++) {
 		/* fill in chunk metadata and add to the clean bucket */
-		acp->chunk_info[core_id][i].core_id = core_id;
-		acp->chunk_info[core_id][i].chunk_id = i;
-		list_add(&acp->chunk_info[core_id][i].list,
+		acp_core->chunk_info[i].core_id = core_id;
+		acp_core->chunk_info[i].chunk_id = i;
+		list_add(&acp_core->chunk_info[i].list,
 				&acp->bucket_info[0].chunk_list);
 	}
 
@@ -339,6 +339,38 @@ void cleaning_policy_alru_set_hot_cache_line(struct ocf_cache *cache,
 	env_spinlock_unlock(&ctx->list_lock[part_id]);
 }
 
+/* Timestamps are taken from tick counter, which may restart together with
+ * the system. Shift timestamps loaded from metadata so that age of dirty
+ * data relative to saved_time (when metadata was saved) is preserved. */
+void cleaning_policy_alru_rebase_timestamps(ocf_cache_t cache,
+		uint32_t saved_time)
+{
+	uint32_t now = env_ticks_to_secs(env_get_tick_count());
+	uint32_t collision_table_entries = cache->device->collision_table_entries;
+	struct alru_cleaning_policy_meta *alru;
+	struct ocf_user_part *user_part;
+	ocf_cache_line_t cline;
+	ocf_part_id_t part_id;
+	uint32_t age;
+
+	for_each_user_part(cache, user_part, part_id) {
+		if (env_atomic_read(&user_part->clean_pol->policy.alru.size) == 0)
+			continue;
+
+		cline = user_part->clean_pol->policy.alru.lru_head;
+		while (cline < collision_table_entries) {
+			alru = &ocf_metadata_get_cleaning_policy(cache,
+					cline)->meta.alru;
+
+			age = saved_time > alru->timestamp ?
+					saved_time - alru->timestamp : 0;
+			alru->timestamp = now > age ? now - age : 0;
+
+			cline = alru->lru_next;
+		}
+	}
+}
+
 static void _alru_rebuild(struct ocf_cache *cache)
 {
 	struct ocf_user_part *user_part;
@@ -646,7 +678,7 @@ static bool block_is_busy(struct ocf_cache *cache,
 	ocf_metadata_get_core_info(cache, cache_line,
 			&core_id, &core_line);
 
-	if (!cache->core[core_id].opened)
+	if (!cache->core[core_id]->opened)
 		return true;
 
 	if (ocf_cache_line_is_used(ocf_cache_line_concurrency(cache),
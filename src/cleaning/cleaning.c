@@ -79,6 +79,11 @@ static void ocf_cleaner_run_complete(ocf_cleaner_t cleaner, uint32_t interval)
 	cleaner->end(cleaner, interval);
 }
 
+static void ocf_cleaner_run_trim_complete(ocf_cache_t cache)
+{
+	ocf_cleaning_perform_cleaning(cache, ocf_cleaner_run_complete);
+}
+
 void ocf_cleaner_run(ocf_cleaner_t cleaner, ocf_queue_t queue)
 {
 	ocf_cache_t cache;
@@ -97,6 +102,13 @@ void ocf_cleaner_run(ocf_cleaner_t cleaner, ocf_queue_t queue)
 		return;
 	}
 
+	/* Leave cache device bandwidth to user IO */
+	if (ocf_bg_share_exceeded(cache)) {
+		env_atomic64_inc(&cache->bg_share.cleaner_deferred);
+		cleaner->end(cleaner, OCF_BG_SHARE_WINDOW_MS);
+		return;
+	}
+
 	/* Sleep in case there is management operation in progress. */
 	if (ocf_mngt_cache_trylock(cache)) {
 		cleaner->end(cleaner, SLEEP_TIME_MS);
@@ -112,5 +124,5 @@ void ocf_cleaner_run(ocf_cleaner_t cleaner, ocf_queue_t queue)
 	ocf_queue_get(queue);
 	cleaner->io_queue = queue;
 
-	ocf_cleaning_perform_cleaning(cache, ocf_cleaner_run_complete);
+	ocf_trimmer_run(cache, ocf_cleaner_run_trim_complete);
 }
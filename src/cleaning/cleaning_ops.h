@@ -22,6 +22,7 @@ struct cleaning_policy_ops {
 	int (*purge_range)(ocf_cache_t cache, int core_id,
 			uint64_t start_byte, uint64_t end_byte);
 	void (*set_hot_cache_line)(ocf_cache_t cache, uint32_t cache_line);
+	void (*rebase_timestamps)(ocf_cache_t cache, uint32_t saved_time);
 	int (*set_cleaning_param)(ocf_cache_t cache, uint32_t param_id,
 			uint32_t param_value);
 	int (*get_cleaning_param)(ocf_cache_t cache, uint32_t param_id,
@@ -42,6 +43,7 @@ static struct cleaning_policy_ops cleaning_policy_ops[ocf_cleaning_max] = {
 		.purge_cache_block = cleaning_policy_alru_purge_cache_block,
 		.purge_range = cleaning_policy_alru_purge_range,
 		.set_hot_cache_line = cleaning_policy_alru_set_hot_cache_line,
+		.rebase_timestamps = cleaning_policy_alru_rebase_timestamps,
 		.initialize = cleaning_policy_alru_initialize,
 		.deinitialize = cleaning_policy_alru_deinitialize,
 		.set_cleaning_param = cleaning_policy_alru_set_cleaning_param,
@@ -227,6 +229,26 @@ unlock:
 	ocf_refcnt_dec(&cache->cleaner.refcnt);
 }
 
+static inline void ocf_cleaning_rebase_timestamps(ocf_cache_t cache,
+		uint32_t saved_time)
+{
+	ocf_cleaning_t policy;
+
+	if (unlikely(!ocf_refcnt_inc(&cache->cleaner.refcnt)))
+		return;
+
+	policy = cache->conf_meta->cleaning_policy_type;
+	ENV_BUG_ON(policy >= ocf_cleaning_max);
+
+	if (unlikely(!cleaning_policy_ops[policy].rebase_timestamps))
+		goto unlock;
+
+	cleaning_policy_ops[policy].rebase_timestamps(cache, saved_time);
+
+unlock:
+	ocf_refcnt_dec(&cache->cleaner.refcnt);
+}
+
 static inline int ocf_cleaning_set_param(ocf_cache_t cache,
 		ocf_cleaning_t policy, uint32_t param_id, uint32_t param_value)
 {
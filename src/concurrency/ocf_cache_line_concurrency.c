@@ -9,6 +9,82 @@
 #include "../utils/utils_alock.h"
 #include "../utils/utils_cache_line.h"
 
+/*
+ * With striped lock table multiple cachelines of the request may share
+ * single lock slot. Request locks the slot only once - for its first
+ * cacheline mapped to it, unless it's already owned through cacheline
+ * remapped (and locked) during eviction. Otherwise request would wait
+ * for the lock it holds itself.
+ */
+static bool ocf_cl_lock_line_is_shared(struct ocf_alock *alock,
+		struct ocf_request *req, unsigned index)
+{
+	ocf_cache_line_t slot;
+	unsigned i;
+
+	slot = ocf_alock_entry_slot(alock, req->map[index].coll_idx);
+
+	for (i = 0; i < req->core_line_count; i++) {
+		if (i == index || req->map[i].status == LOOKUP_MISS)
+			continue;
+
+		if (i > index && req->map[i].status != LOOKUP_REMAPPED)
+			continue;
+
+		if (ocf_alock_entry_slot(alock, req->map[i].coll_idx) == slot)
+			return true;
+	}
+
+	return false;
+}
+
+#define OCF_CL_LOCK_SLOT_FILTER_BITS 1024
+
+/*
+ * Mark cachelines sharing lock slot once per lock attempt, after request
+ * is mapped. Filter of slots seen so far lets most cachelines skip
+ * comparing their slot with the rest of the request.
+ */
+static void ocf_cl_lock_mark_shared(struct ocf_alock *alock,
+		struct ocf_request *req)
+{
+	uint64_t filter[OCF_CL_LOCK_SLOT_FILTER_BITS / 64] = { };
+	struct ocf_map_info *entry;
+	unsigned i, bit;
+
+	if (!ocf_alock_is_striped(alock))
+		return;
+
+	for (i = 0; i < req->core_line_count; i++) {
+		entry = &req->map[i];
+		if (entry->status != LOOKUP_REMAPPED)
+			continue;
+
+		bit = ocf_alock_entry_slot(alock, entry->coll_idx) %
+				OCF_CL_LOCK_SLOT_FILTER_BITS;
+		filter[bit / 64] |= 1ULL << (bit % 64);
+	}
+
+	for (i = 0; i < req->core_line_count; i++) {
+		entry = &req->map[i];
+		entry->slot_shared = false;
+
+		if (entry->status == LOOKUP_MISS ||
+				entry->status == LOOKUP_REMAPPED) {
+			continue;
+		}
+
+		bit = ocf_alock_entry_slot(alock, entry->coll_idx) %
+				OCF_CL_LOCK_SLOT_FILTER_BITS;
+		if (filter[bit / 64] & (1ULL << (bit % 64))) {
+			entry->slot_shared =
+					ocf_cl_lock_line_is_shared(alock, req, i);
+		} else {
+			filter[bit / 64] |= 1ULL << (bit % 64);
+		}
+	}
+}
+
 static bool ocf_cl_lock_line_needs_lock(struct ocf_alock *alock,
 		struct ocf_request *req, unsigned index)
 {
@@ -16,7 +92,8 @@ static bool ocf_cl_lock_line_needs_lock(struct ocf_alock *alock,
 	 * during eviction
 	 */
 	return req->map[index].status != LOOKUP_MISS &&
-			req->map[index].status != LOOKUP_REMAPPED;
+			req->map[index].status != LOOKUP_REMAPPED &&
+			!req->map[index].slot_shared;
 }
 
 static bool ocf_cl_lock_line_is_acting(struct ocf_alock *alock,
@@ -160,7 +237,7 @@ void ocf_cache_line_unlock_rd(struct ocf_alock *alock, ocf_cache_line_t line)
 bool ocf_cache_line_try_lock_wr(struct ocf_alock *alock,
 		ocf_cache_line_t line)
 {
-	return ocf_alock_trylock_entry_wr(alock, line);
+	return ocf_alock_trylock_one_wr(alock, line);
 }
 
 void ocf_cache_line_unlock_wr(struct ocf_alock *alock,
@@ -172,20 +249,27 @@ void ocf_cache_line_unlock_wr(struct ocf_alock *alock,
 int ocf_req_async_lock_rd(struct ocf_alock *alock,
 		struct ocf_request *req, ocf_req_async_lock_cb cmpl)
 {
+	ocf_cl_lock_mark_shared(alock, req);
+
 	return ocf_alock_lock_rd(alock, req, cmpl);
 }
 
 int ocf_req_async_lock_wr(struct ocf_alock *alock,
 		struct ocf_request *req, ocf_req_async_lock_cb cmpl)
 {
+	ocf_cl_lock_mark_shared(alock, req);
+
 	return ocf_alock_lock_wr(alock, req, cmpl);
 }
 
 void ocf_req_unlock_rd(struct ocf_alock *alock, struct ocf_request *req)
 {
+	struct ocf_alock_wake_batch batch;
 	int32_t i;
 	ocf_cache_line_t entry;
 
+	ocf_alock_wake_batch_init(&batch);
+
 	for (i = 0; i < req->core_line_count; i++) {
 		if (!ocf_cl_lock_line_is_acting(alock, req, i))
 			continue;
@@ -195,16 +279,21 @@ void ocf_req_unlock_rd(struct ocf_alock *alock, struct ocf_request *req)
 
 		entry = ocf_cl_lock_line_get_entry(alock, req, i);
 
-		ocf_alock_unlock_one_rd(alock, entry);
+		ocf_alock_unlock_one_rd_batch(alock, entry, &batch);
 		ocf_alock_mark_index_locked(alock, req, i, false);
 	}
+
+	ocf_alock_wake_batch_flush(alock, &batch);
 }
 
 void ocf_req_unlock_wr(struct ocf_alock *alock, struct ocf_request *req)
 {
+	struct ocf_alock_wake_batch batch;
 	int32_t i;
 	ocf_cache_line_t entry;
 
+	ocf_alock_wake_batch_init(&batch);
+
 	for (i = 0; i < req->core_line_count; i++) {
 		if (!ocf_cl_lock_line_is_acting(alock, req, i))
 			continue;
@@ -214,9 +303,11 @@ void ocf_req_unlock_wr(struct ocf_alock *alock, struct ocf_request *req)
 
 		entry = ocf_cl_lock_line_get_entry(alock, req, i);
 
-		ocf_alock_unlock_one_wr(alock, entry);
+		ocf_alock_unlock_one_wr_batch(alock, entry, &batch);
 		ocf_alock_mark_index_locked(alock, req, i, false);
 	}
+
+	ocf_alock_wake_batch_flush(alock, &batch);
 }
 
 void ocf_req_unlock(struct ocf_alock *alock, struct ocf_request *req)
@@ -242,7 +333,7 @@ uint32_t ocf_cache_line_concurrency_suspended_no(struct ocf_alock *alock)
 #define ALLOCATOR_NAME_MAX (sizeof(ALLOCATOR_NAME_FMT) + OCF_CACHE_NAME_SIZE)
 
 int ocf_cache_line_concurrency_init(struct ocf_alock **self,
-		unsigned num_clines, ocf_cache_t cache)
+		unsigned num_clines, unsigned num_slots, ocf_cache_t cache)
 {
 	char name[ALLOCATOR_NAME_MAX];
 	int ret;
@@ -254,7 +345,13 @@ int ocf_cache_line_concurrency_init(struct ocf_alock **self,
 	if (ret >= ALLOCATOR_NAME_MAX)
 		return -ENOSPC;
 
-	return ocf_alock_init(self, num_clines, name, &ocf_cline_conc_cbs, cache);
+	/* Striped lock table makes sense only if it's smaller than cacheline
+	 * lock table */
+	if (num_slots >= num_clines)
+		num_slots = 0;
+
+	return ocf_alock_init_striped(self, num_clines, num_slots, name,
+			&ocf_cline_conc_cbs, cache);
 }
 
 void ocf_cache_line_concurrency_deinit(struct ocf_alock **self)
@@ -264,5 +361,10 @@ void ocf_cache_line_concurrency_deinit(struct ocf_alock **self)
 
 size_t ocf_cache_line_concurrency_size_of(ocf_cache_t cache)
 {
+	unsigned num_slots = cache->device->concurrency.lock_slots;
+
+	if (num_slots && num_slots < cache->device->collision_table_entries)
+		return ocf_alock_striped_size(num_slots);
+
 	return ocf_alock_size(cache->device->collision_table_entries);
 }
@@ -18,12 +18,14 @@
  *
  * @param self - cacheline concurrency private data
  * @param num_clines - cachelines count
+ * @param num_slots - number of lock slots shared by cachelines, 0 to
+ *		allocate lock for each cacheline
  * @param cache - OCF cache instance
 
  * @return 0 - Initialization successful, otherwise ERROR
  */
 int ocf_cache_line_concurrency_init(struct ocf_alock **self,
-		unsigned num_clines, struct ocf_cache *cache);
+		unsigned num_clines, unsigned num_slots, struct ocf_cache *cache);
 
 /**
  * @biref De-Initialize  OCF cache concurrency module
@@ -13,6 +13,7 @@ int ocf_concurrency_init(struct ocf_cache *cache)
 	result = ocf_cache_line_concurrency_init(
 			&cache->device->concurrency.cache_line,
 			ocf_metadata_collision_table_entries(cache),
+			cache->device->concurrency.lock_slots,
 			cache);
 
 	if (result)
@@ -182,7 +182,7 @@ void ocf_metadata_end_exclusive_access(
    is to spread calls across all available underlying locks to reduce contention
    on one single RW semaphor primitive. Technically any value is correct, but
    picking wisely would allow for higher read througput:
-   * free running per-cpu counter sounds good,
+   * stable per-queue (hence mostly per-cpu) index sounds good,
    * for rarely excercised code paths (e.g. management) any value would do.
 */
 void ocf_metadata_start_shared_access(
@@ -14,7 +14,7 @@
 
 static inline unsigned ocf_metadata_concurrency_next_idx(ocf_queue_t q)
 {
-	return q->lock_idx++ % OCF_NUM_GLOBAL_META_LOCKS;
+	return q->lock_idx % OCF_NUM_GLOBAL_META_LOCKS;
 }
 
 int ocf_metadata_concurrency_init(struct ocf_metadata_lock *metadata_lock);
@@ -113,21 +113,26 @@ int ocf_mio_async_lock(struct ocf_alock *alock,
 void ocf_mio_async_unlock(struct ocf_alock *alock,
 		struct metadata_io_request *m_req)
 {
+	struct ocf_alock_wake_batch batch;
 	ocf_cache_line_t entry;
 	struct ocf_request *req = &m_req->req;
 	int i;
 
+	ocf_alock_wake_batch_init(&batch);
+
 	for (i = 0; i < req->core_line_count; i++) {
 		if (!ocf_alock_is_index_locked(alock, req, i))
 			continue;
 
 		entry = ocf_mio_lock_get_entry(alock, req, i);
 
-		ocf_alock_unlock_one_wr(alock, entry);
+		ocf_alock_unlock_one_wr_batch(alock, entry, &batch);
 		ocf_alock_mark_index_locked(alock, req, i, false);
 	}
 
 	m_req->alock_status = 0;
+
+	ocf_alock_wake_batch_flush(alock, &batch);
 }
 
 
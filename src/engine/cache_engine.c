@@ -176,6 +176,12 @@ void ocf_resolve_effective_cache_mode(ocf_cache_t cache,
 		return;
 	}
 
+	/* Status bits can't describe part of a status granularity unit */
+	if (!ocf_engine_is_status_aligned(req)) {
+		req->cache_mode = ocf_req_cache_mode_pt;
+		return;
+	}
+
 	if (req->core_line_count > cache->conf_meta->cachelines) {
 		req->cache_mode = ocf_req_cache_mode_pt;
 		return;
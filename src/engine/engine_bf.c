@@ -12,6 +12,8 @@
 #include "cache_engine.h"
 #include "../ocf_request.h"
 #include "../utils/utils_io.h"
+#include "../utils/utils_cache_line.h"
+#include "../utils/utils_dedup.h"
 #include "../concurrency/ocf_concurrency.h"
 
 #define OCF_ENGINE_DEBUG_IO_NAME "bf"
@@ -63,7 +65,13 @@ static void _ocf_backfill_complete(struct ocf_request *req, int error)
 	if (req->error) {
 		ocf_core_stats_cache_error_update(req->core, OCF_WRITE);
 		ocf_engine_invalidate(req);
+	} else if (req->info.no_cache_write) {
+		/* Read data has not been inserted, drop its valid status */
+		ocf_engine_invalidate(req);
 	} else {
+		/* Written data slots can be shared now */
+		ocf_dedup_publish_req(req);
+
 		ocf_req_unlock(ocf_cache_line_concurrency(cache), req);
 
 		/* put the request at the last point of the completion path */
@@ -71,25 +79,109 @@ static void _ocf_backfill_complete(struct ocf_request *req, int error)
 	}
 }
 
-static int _ocf_backfill_do(struct ocf_request *req)
+static int _ocf_backfill_write(struct ocf_request *req)
 {
-	unsigned int reqs_to_issue;
+	int unshared;
 
-	backfill_queue_dec_unblock(req->cache);
+	env_atomic_set(&req->req_remaining, 1);
+
+	if (req->error) {
+		_ocf_backfill_complete(req, 0);
+		return 0;
+	}
 
-	reqs_to_issue = ocf_engine_io_count(req);
+	if (req->dedup_data) {
+		ocf_hb_req_prot_lock_wr(req);
+		unshared = ocf_dedup_verify_req(req);
+		ocf_hb_req_prot_unlock_wr(req);
+
+		if (unshared < 0) {
+			req->info.no_cache_write = 1;
+			_ocf_backfill_complete(req, 0);
+			return 0;
+		}
+
+		/* Cache lines which didn't match shared data are written too */
+		if (unshared)
+			ocf_engine_compress(req, true);
+
+		if (req->info.no_cache_write) {
+			_ocf_backfill_complete(req, 0);
+			return 0;
+		}
+	}
 
-	/* There will be #reqs_to_issue completions */
-	env_atomic_set(&req->req_remaining, reqs_to_issue);
+	if (req->info.zero_no) {
+		ocf_hb_req_prot_lock_wr(req);
+		ocf_set_zero_map_info(req);
+		ocf_hb_req_prot_unlock_wr(req);
+	}
 
-	req->data = req->cp_data;
+	ocf_engine_submit_cache_writes(req, true, _ocf_backfill_complete);
 
-	ocf_submit_cache_reqs(req->cache, req, OCF_WRITE, 0, req->byte_length,
-				reqs_to_issue, _ocf_backfill_complete);
+	_ocf_backfill_complete(req, 0);
 
 	return 0;
 }
 
+static const struct ocf_io_if _io_if_backfill_write = {
+	.read = _ocf_backfill_write,
+	.write = _ocf_backfill_write,
+};
+
+static void _ocf_backfill_read_complete(struct ocf_request *req, int error)
+{
+	if (error)
+		req->error = error;
+
+	if (env_atomic_dec_return(&req->req_remaining))
+		return;
+
+	ocf_engine_push_req_front_if(req, &_io_if_backfill_write, true);
+}
+
+/*
+ * Only cache lines which were not fully valid in cache are written, merging
+ * physically contiguous ones. Valid status bits have been set already by
+ * read miss, cache lines with all-zero data only get zero status bits set
+ * and cache lines with data found in deduplicated cache share its data slot,
+ * once the data slot has been read back and compared with request data.
+ * If data doesn't fit into compressed cache line slots, there are no free
+ * data slots or background work exceeds its share of cache device bandwidth
+ * nothing is written and the request is invalidated.
+ */
+static int _ocf_backfill_do(struct ocf_request *req)
+{
+	backfill_queue_dec_unblock(req->cache);
+
+	env_atomic_set(&req->req_remaining, 1);
+
+	req->data = req->cp_data;
+	req->offset = 0;
+
+	if (ocf_bg_share_exceeded(req->cache)) {
+		/* Leave cache device bandwidth to user IO */
+		env_atomic64_inc(&req->cache->bg_share.backfill_skipped);
+		req->info.no_cache_write = true;
+		_ocf_backfill_complete(req, 0);
+		return 0;
+	}
+
+	ocf_engine_prepare_cache_write(req, true);
+
+	if (req->info.no_cache_write) {
+		_ocf_backfill_complete(req, 0);
+		return 0;
+	}
+
+	if (ocf_dedup_read_req(req, _ocf_backfill_read_complete)) {
+		_ocf_backfill_read_complete(req, 0);
+		return 0;
+	}
+
+	return _ocf_backfill_write(req);
+}
+
 static const struct ocf_io_if _io_if_backfill = {
 	.read = _ocf_backfill_do,
 	.write = _ocf_backfill_do,
@@ -97,6 +189,7 @@ static const struct ocf_io_if _io_if_backfill = {
 
 void ocf_engine_backfill(struct ocf_request *req)
 {
+	req->io_origin = ocf_io_origin_backfill;
 	backfill_queue_inc_block(req->cache);
-	ocf_engine_push_req_front_if(req, &_io_if_backfill, true);
+	ocf_engine_continue_if(req, &_io_if_backfill);
 }
@@ -7,12 +7,16 @@
 #include "../ocf_priv.h"
 #include "../ocf_cache_priv.h"
 #include "../ocf_queue_priv.h"
+#include "../ocf_ctx_priv.h"
 #include "engine_common.h"
 #define OCF_ENGINE_DEBUG_IO_NAME "common"
 #include "engine_debug.h"
 #include "../utils/utils_cache_line.h"
 #include "../ocf_request.h"
 #include "../utils/utils_cleaner.h"
+#include "../utils/utils_io.h"
+#include "../utils/utils_compress.h"
+#include "../utils/utils_dedup.h"
 #include "../utils/utils_user_part.h"
 #include "../metadata/metadata.h"
 #include "../ocf_space.h"
@@ -92,27 +96,6 @@ static inline int _ocf_engine_check_map_entry(struct ocf_cache *cache,
 		return -1;
 }
 
-/* Returns true if core lines on index 'entry' and 'entry + 1' within the request
- * are physically contiguous.
- */
-static inline bool ocf_engine_clines_phys_cont(struct ocf_request *req,
-		uint32_t entry)
-{
-	struct ocf_map_info *entry1, *entry2;
-	ocf_cache_line_t phys1, phys2;
-
-	entry1 = &req->map[entry];
-	entry2 = &req->map[entry + 1];
-
-	if (entry1->status == LOOKUP_MISS || entry2->status == LOOKUP_MISS)
-		return false;
-
-	phys1 = ocf_metadata_map_lg2phy(req->cache, entry1->coll_idx);
-	phys2 = ocf_metadata_map_lg2phy(req->cache, entry2->coll_idx);
-
-	return phys1 < phys2 && phys1 + 1 == phys2;
-}
-
 void ocf_engine_patch_req_info(struct ocf_cache *cache,
 		struct ocf_request *req, uint32_t idx)
 {
@@ -130,6 +113,337 @@ void ocf_engine_patch_req_info(struct ocf_cache *cache,
 	}
 }
 
+void ocf_engine_sec_run_init(struct ocf_request *req,
+		struct ocf_engine_sec_run *run)
+{
+	run->offset = 0;
+	run->size = 0;
+	run->line = 0;
+	run->valid = false;
+	run->zero = false;
+	run->next_line = 0;
+	run->next_sector = ocf_map_line_start_sector(req, 0);
+}
+
+static uint8_t ocf_engine_line_sec_run(struct ocf_request *req,
+		uint32_t idx, uint8_t start, bool *valid, bool *zero)
+{
+	struct ocf_map_info *entry = &req->map[idx];
+	uint8_t end = ocf_map_line_end_sector(req, idx);
+	uint8_t len;
+
+	*zero = false;
+
+	if (entry->status != LOOKUP_HIT) {
+		*valid = false;
+		return end - start + 1;
+	}
+
+	len = ocf_metadata_valid_run(req->cache, entry->coll_idx,
+			start, end, valid);
+
+	/* Zero sectors are always valid */
+	if (*valid && req->info.zero_any) {
+		len = ocf_metadata_zero_run(req->cache, entry->coll_idx,
+				start, start + len - 1, zero);
+	}
+
+	return len;
+}
+
+bool ocf_engine_next_sec_run(struct ocf_request *req,
+		struct ocf_engine_sec_run *run)
+{
+	uint32_t idx = run->next_line;
+	uint8_t start = run->next_sector;
+	uint8_t len;
+	bool valid, zero;
+
+	if (idx >= req->core_line_count)
+		return false;
+
+	run->offset += run->size;
+	run->size = 0;
+	run->line = idx;
+
+	for (;;) {
+		len = ocf_engine_line_sec_run(req, idx, start, &valid, &zero);
+		if (run->size && (valid != run->valid || zero != run->zero))
+			break;
+
+		run->valid = valid;
+		run->zero = zero;
+		run->size += ocf_sectors_2_bytes(req->cache, len);
+		start += len;
+
+		/* Run ends within this cache line */
+		if (start <= ocf_map_line_end_sector(req, idx))
+			break;
+
+		idx++;
+		start = 0;
+
+		if (idx == req->core_line_count ||
+				!ocf_engine_clines_phys_cont(req, idx - 1)) {
+			break;
+		}
+	}
+
+	run->next_line = idx;
+	run->next_sector = start;
+
+	return true;
+}
+
+void ocf_engine_zero_data(struct ocf_request *req, uint64_t offset,
+		uint64_t size)
+{
+	ocf_ctx_t ctx = req->cache->owner;
+
+	ctx_data_seek_check(ctx, req->data, ctx_data_seek_begin,
+			req->offset + offset);
+	ctx_data_zero_check(ctx, req->data, size);
+}
+
+/* Runs change at sector boundaries at most */
+static inline uint32_t ocf_engine_io_runs_max(struct ocf_request *req)
+{
+	return BYTES_TO_SECTORS(req->byte_length);
+}
+
+int ocf_engine_io_runs_init(struct ocf_request *req)
+{
+	req->io_runs_count = 0;
+
+	if (req->io_runs)
+		return 0;
+
+	req->io_runs = env_malloc(sizeof(*req->io_runs) *
+			ocf_engine_io_runs_max(req),
+			ENV_MEM_NOIO);
+
+	return req->io_runs ? 0 : -OCF_ERR_NO_MEM;
+}
+
+void ocf_engine_io_runs_add(struct ocf_request *req,
+		enum ocf_engine_io_target target, uint64_t offset,
+		uint64_t size)
+{
+	struct ocf_engine_io_run *run;
+
+	if (req->io_runs_count) {
+		run = &req->io_runs[req->io_runs_count - 1];
+		if (run->target == target && target != ocf_engine_io_cache &&
+				run->offset + run->size == offset) {
+			run->size += size;
+			return;
+		}
+	}
+
+	ENV_BUG_ON(req->io_runs_count >= ocf_engine_io_runs_max(req));
+
+	run = &req->io_runs[req->io_runs_count++];
+	run->target = target;
+	run->offset = offset;
+	run->size = size;
+}
+
+void ocf_engine_io_runs_submit(struct ocf_request *req,
+		ocf_req_end_t cache_callback, ocf_req_end_t core_callback)
+{
+	struct ocf_engine_io_run *run;
+	uint32_t i;
+
+	for (i = 0; i < req->io_runs_count; i++) {
+		run = &req->io_runs[i];
+
+		switch (run->target) {
+		case ocf_engine_io_zero:
+			ocf_engine_zero_data(req, run->offset, run->size);
+			break;
+		case ocf_engine_io_cache:
+			env_atomic_inc(&req->req_remaining);
+			ocf_submit_cache_reqs(req->cache, req, OCF_READ,
+					run->offset, run->size, 1,
+					cache_callback);
+			break;
+		case ocf_engine_io_core:
+			env_atomic_inc(&req->req_remaining);
+			ocf_submit_volume_req_part(&req->core->volume, req,
+					run->offset, run->size, core_callback);
+			break;
+		}
+	}
+}
+
+void ocf_engine_submit_cache_reads(struct ocf_request *req,
+		ocf_req_end_t callback)
+{
+	struct ocf_engine_sec_run run;
+
+	if (!req->info.zero_any) {
+		env_atomic_add(ocf_engine_io_count(req), &req->req_remaining);
+		ocf_submit_cache_reqs(req->cache, req, OCF_READ, 0,
+				req->byte_length, ocf_engine_io_count(req),
+				callback);
+		return;
+	}
+
+	if (ocf_engine_io_runs_init(req)) {
+		env_atomic_inc(&req->req_remaining);
+		callback(req, -OCF_ERR_NO_MEM);
+		return;
+	}
+
+	ocf_hb_req_prot_lock_rd(req);
+
+	ocf_engine_sec_run_init(req, &run);
+	while (ocf_engine_next_sec_run(req, &run)) {
+		ENV_BUG_ON(!run.valid);
+
+		ocf_engine_io_runs_add(req, run.zero ? ocf_engine_io_zero :
+				ocf_engine_io_cache, run.offset, run.size);
+	}
+
+	ocf_hb_req_prot_unlock_rd(req);
+
+	ocf_engine_io_runs_submit(req, callback, NULL);
+}
+
+void ocf_engine_detect_zero(struct ocf_request *req, bool backfill)
+{
+	struct ocf_cache *cache = req->cache;
+	struct ocf_map_info *entry;
+	uint64_t offset, size;
+	bool detect;
+	uint32_t i;
+
+	req->info.zero_no = 0;
+
+	/* Atomic metadata is recovered from cache device data sectors, which
+	 * zero cache lines don't have */
+	detect = ctx_data_zero_detection(cache->owner) &&
+			!ocf_volume_is_atomic(&cache->device->volume);
+
+	for (i = 0; i < req->core_line_count; i++) {
+		entry = &req->map[i];
+
+		entry->zero = false;
+		entry->zero_update = !backfill || entry->backfill;
+
+		if (!detect || !entry->zero_update)
+			continue;
+
+		offset = ocf_engine_line_offset(req, i);
+		size = ocf_engine_line_offset(req, i + 1) - offset;
+
+		ctx_data_seek_check(cache->owner, req->data,
+				ctx_data_seek_begin, req->offset + offset);
+		entry->zero = ctx_data_is_zero(cache->owner, req->data, size);
+
+		if (entry->zero) {
+			req->info.zero_no++;
+			req->info.zero_any = true;
+		}
+	}
+}
+
+void ocf_engine_compress(struct ocf_request *req, bool backfill)
+{
+	struct ocf_cache *cache = req->cache;
+	uint64_t ratio = cache->conf_meta->compression;
+	struct ocf_map_info *entry;
+	uint64_t offset, size;
+	uint32_t i;
+
+	if (!ocf_cache_compression_enabled(cache) || req->info.no_cache_write)
+		return;
+
+	if (!req->cdata) {
+		req->cdata = ctx_data_alloc(cache->owner,
+				BYTES_TO_PAGES(req->byte_length / ratio));
+		if (!req->cdata) {
+			req->info.no_cache_write = 1;
+			return;
+		}
+	}
+
+	for (i = 0; i < req->core_line_count; i++) {
+		entry = &req->map[i];
+
+		if (entry->zero || entry->dedup ||
+				(backfill && !entry->backfill)) {
+			continue;
+		}
+
+		offset = ocf_engine_line_offset(req, i);
+		size = ocf_engine_line_offset(req, i + 1) - offset;
+
+		if (!ocf_compress_data(cache, req->cdata, offset / ratio,
+				req->data, req->offset + offset, size)) {
+			req->info.no_cache_write = 1;
+			env_atomic64_inc(&cache->compression.incompressible);
+			return;
+		}
+	}
+}
+
+void ocf_engine_prepare_cache_write(struct ocf_request *req, bool backfill)
+{
+	req->info.no_cache_write = 0;
+
+	ocf_engine_detect_zero(req, backfill);
+
+	if (ocf_cache_dedup_enabled(req->cache)) {
+		ocf_hb_req_prot_lock_wr(req);
+		if (!ocf_dedup_map_req(req, backfill))
+			req->info.no_cache_write = 1;
+		ocf_hb_req_prot_unlock_wr(req);
+	}
+
+	ocf_engine_compress(req, backfill);
+}
+
+void ocf_engine_submit_cache_writes(struct ocf_request *req, bool backfill,
+		ocf_req_end_t callback)
+{
+	struct ocf_map_info *map = req->map;
+	uint64_t offset, size;
+	uint32_t i, j;
+
+	if (!backfill && !req->info.zero_no) {
+		env_atomic_add(ocf_engine_io_count(req), &req->req_remaining);
+		ocf_submit_cache_reqs(req->cache, req, OCF_WRITE, 0,
+				req->byte_length, ocf_engine_io_count(req),
+				callback);
+		return;
+	}
+
+	/* Merge physically contiguous cache lines which need to be written */
+	for (i = 0; i < req->core_line_count; i = j) {
+		j = i + 1;
+
+		if (map[i].zero || map[i].dedup ||
+				(backfill && !map[i].backfill)) {
+			continue;
+		}
+
+		while (j < req->core_line_count && !map[j].zero &&
+				!map[j].dedup &&
+				(!backfill || map[j].backfill) &&
+				ocf_engine_clines_phys_cont(req, j - 1)) {
+			j++;
+		}
+
+		offset = ocf_engine_line_offset(req, i);
+		size = ocf_engine_line_offset(req, j) - offset;
+
+		env_atomic_inc(&req->req_remaining);
+		ocf_submit_cache_reqs(req->cache, req, OCF_WRITE, offset,
+				size, 1, callback);
+	}
+}
+
 static void ocf_engine_update_req_info(struct ocf_cache *cache,
 		struct ocf_request *req, uint32_t idx)
 {
@@ -162,6 +476,11 @@ static void ocf_engine_update_req_info(struct ocf_cache *cache,
 				start_sector, end_sector))
 				req->info.dirty_all++;
 		}
+
+		if (metadata_test_zero_any_sec(cache, entry->coll_idx,
+				start_sector, end_sector)) {
+			req->info.zero_any = true;
+		}
 	}
 
 	if (entry->status == LOOKUP_HIT || entry->status == LOOKUP_REMAPPED) {
@@ -479,9 +798,11 @@ int ocf_engine_prepare_clines(struct ocf_request *req)
 		return lock;
 	}
 
-	/* check if request should promote cachelines */
-	promote = ocf_promotion_req_should_promote(
-			req->cache->promotion_policy, req);
+	/* check if request should promote cachelines, promotion is suspended
+	 * while cache device is saturated */
+	promote = !ocf_steering_is_on(req->cache) &&
+			ocf_promotion_req_should_promote(
+				req->cache->promotion_policy, req);
 	if (!promote) {
 		ocf_req_set_mapping_error(req);
 		ocf_hb_req_prot_unlock_rd(req);
@@ -653,6 +974,28 @@ void ocf_engine_push_req_front_if(struct ocf_request *req,
 	ocf_engine_push_req_front(req, allow_sync);
 }
 
+void ocf_engine_continue_if(struct ocf_request *req,
+		const struct ocf_io_if *io_if)
+{
+	ocf_cache_t cache = req->cache;
+
+	/* Unless queue owner opted in, requests run only in queue context */
+	if (!req->io_queue->inline_continuation) {
+		ocf_engine_push_req_front_if(req, io_if, true);
+		return;
+	}
+
+	req->error = 0;
+	req->io_if = io_if;
+
+	if (!req->info.internal) {
+		env_atomic_set(&cache->last_access_ms,
+				env_ticks_to_msecs(env_get_tick_count()));
+	}
+
+	ocf_queue_process_req(req);
+}
+
 void inc_fallback_pt_error_counter(ocf_cache_t cache)
 {
 	ENV_BUG_ON(env_atomic_read(&cache->fallback_pt_error_counter) < 0);
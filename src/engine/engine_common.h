@@ -24,6 +24,21 @@
 void ocf_engine_error(struct ocf_request *req, bool stop_cache,
 		const char *msg);
 
+/**
+ * @brief Check if OCF request covers only whole status granularity units
+ *
+ * @param req OCF request
+ *
+ * @retval true Request is aligned to status granularity
+ * @retval false Request covers part of some status granularity unit
+ */
+static inline bool ocf_engine_is_status_aligned(struct ocf_request *req)
+{
+	uint64_t unit = ocf_line_sector_size(req->cache);
+
+	return !((req->byte_position | req->byte_length) & (unit - 1));
+}
+
 /**
  * @brief Check if OCF request is hit
  *
@@ -134,6 +149,54 @@ static inline uint32_t ocf_engine_is_sequential(struct ocf_request *req)
 			&& req->info.seq_no == req->core_line_count - 1;
 }
 
+/* Returns true if core lines on index 'entry' and 'entry + 1' within the request
+ * are physically contiguous. Deduplicated cache lines change their data slots
+ * on write, so they are never considered contiguous.
+ */
+static inline bool ocf_engine_clines_phys_cont(struct ocf_request *req,
+		uint32_t entry)
+{
+	struct ocf_map_info *entry1, *entry2;
+	ocf_cache_line_t phys1, phys2;
+
+	entry1 = &req->map[entry];
+	entry2 = &req->map[entry + 1];
+
+	if (entry1->status == LOOKUP_MISS || entry2->status == LOOKUP_MISS)
+		return false;
+
+	if (ocf_cache_dedup_enabled(req->cache))
+		return false;
+
+	phys1 = ocf_metadata_map_lg2phy(req->cache, entry1->coll_idx);
+	phys2 = ocf_metadata_map_lg2phy(req->cache, entry2->coll_idx);
+
+	return phys1 < phys2 && phys1 + 1 == phys2;
+}
+
+/**
+ * @brief Get offset of cache line data within request
+ *
+ * @param req OCF request
+ * @param idx Index of request map entry, may be equal to core line count
+ *	to get request end
+ *
+ * @return Offset in bytes
+ */
+static inline uint64_t ocf_engine_line_offset(struct ocf_request *req,
+		uint32_t idx)
+{
+	uint64_t line_size = ocf_line_size(req->cache);
+
+	if (idx == 0)
+		return 0;
+
+	if (idx == req->core_line_count)
+		return req->byte_length;
+
+	return idx * line_size - req->byte_position % line_size;
+}
+
 /**
  * @brief Get number of IOs to perform cache read or write
  *
@@ -190,6 +253,200 @@ bool ocf_engine_map_all_sec_valid(struct ocf_request *req, uint32_t line)
 			start, end);
 }
 
+/**
+ * @brief Run of sectors of OCF request with the same valid status
+ */
+struct ocf_engine_sec_run {
+	uint64_t offset;
+	/*!< Offset of the run within request (in bytes) */
+
+	uint64_t size;
+	/*!< Size of the run (in bytes) */
+
+	uint32_t line;
+	/*!< Index of first request map entry covered by the run */
+
+	bool valid;
+	/*!< Sectors in the run are valid */
+
+	bool zero;
+	/*!< Sectors in the run are valid and hold all-zero data */
+
+	uint32_t next_line;
+	uint8_t next_sector;
+	/*!< Iterator position */
+};
+
+/**
+ * @brief Initialize iterator over sector runs of OCF request
+ *
+ * @param req OCF request
+ * @param run Run iterator
+ */
+void ocf_engine_sec_run_init(struct ocf_request *req,
+		struct ocf_engine_sec_run *run);
+
+/**
+ * @brief Get next run of sectors with the same valid and zero status. Run
+ *	spans multiple cache lines only if they are physically contiguous, so
+ *	it can be served with single cache IO. Cache lines which are not
+ *	hit are treated as invalid.
+ *
+ * @note Caller must hold metadata read lock on request hash buckets
+ *
+ * @param req OCF request
+ * @param run Run iterator
+ *
+ * @retval true Next run found
+ * @retval false Request end reached
+ */
+bool ocf_engine_next_sec_run(struct ocf_request *req,
+		struct ocf_engine_sec_run *run);
+
+/**
+ * @brief Fill part of request data with zeros instead of reading it
+ *	from cache
+ *
+ * @param req OCF request
+ * @param offset Offset within request (in bytes)
+ * @param size Size of data to be zeroed (in bytes)
+ */
+void ocf_engine_zero_data(struct ocf_request *req, uint64_t offset,
+		uint64_t size);
+
+/**
+ * @brief Target of IO collected into request
+ */
+enum ocf_engine_io_target {
+	ocf_engine_io_cache,
+	/*!< Read data from cache */
+
+	ocf_engine_io_core,
+	/*!< Read data from core */
+
+	ocf_engine_io_zero,
+	/*!< Fill data with zeros */
+};
+
+/**
+ * @brief IO collected under metadata lock to be submitted after the lock
+ *	is released
+ */
+struct ocf_engine_io_run {
+	uint64_t offset;
+	/*!< Offset within request (in bytes) */
+
+	uint64_t size;
+	/*!< Size of IO (in bytes) */
+
+	enum ocf_engine_io_target target;
+	/*!< IO target */
+};
+
+/**
+ * @brief Prepare request for collecting IOs, allocating space for one IO
+ *	per request sector
+ *
+ * @param req OCF request
+ *
+ * @retval 0 Success
+ * @retval Non-zero Failed to allocate IO runs
+ */
+int ocf_engine_io_runs_init(struct ocf_request *req);
+
+/**
+ * @brief Add IO to request. IO contiguous with previous one is merged
+ *	with it, unless both are cache reads, which are merged already by
+ *	ocf_engine_next_sec_run() whenever cache lines are physically
+ *	contiguous.
+ *
+ * @param req OCF request
+ * @param target IO target
+ * @param offset Offset within request (in bytes)
+ * @param size Size of IO (in bytes)
+ */
+void ocf_engine_io_runs_add(struct ocf_request *req,
+		enum ocf_engine_io_target target, uint64_t offset,
+		uint64_t size);
+
+/**
+ * @brief Submit IOs collected in request
+ *
+ * @note Must be called without metadata lock held
+ *
+ * @param req OCF request
+ * @param cache_callback Completion of cache IO
+ * @param core_callback Completion of core IO
+ *	req_remaining is incremented for each submitted IO and has to be
+ *	guarded by caller
+ */
+void ocf_engine_io_runs_submit(struct ocf_request *req,
+		ocf_req_end_t cache_callback, ocf_req_end_t core_callback);
+
+/**
+ * @brief Read request data from cache, zero sectors are not read but
+ *	filled with zeros
+ *
+ * @note All cache lines of request must be valid in requested range
+ *
+ * @param req OCF request
+ * @param callback Completion called for each submitted IO, req_remaining
+ *	is incremented accordingly and has to be guarded by caller
+ */
+void ocf_engine_submit_cache_reads(struct ocf_request *req,
+		ocf_req_end_t callback);
+
+/**
+ * @brief Find cache lines for which request data is all zero. Such cache
+ *	lines are marked in request map and their data is not written
+ *	to cache device, only zero status bits are set.
+ *
+ * @note Does nothing if context doesn't provide zero detection
+ *
+ * @param req OCF request with data to be written to cache
+ * @param backfill Only cache lines marked for backfill are checked
+ */
+void ocf_engine_detect_zero(struct ocf_request *req, bool backfill);
+
+/**
+ * @brief Compress request data of cache lines to be written to cache
+ *	into req->cdata. If data of any cache line doesn't fit into its
+ *	slot, req->info.no_cache_write is set and request data must not
+ *	be written to cache.
+ *
+ * @note Does nothing if cache data compression is disabled or request data
+ *	already can't be written to cache. Must be called after
+ *	ocf_engine_detect_zero(), as all-zero cache lines are skipped, as well
+ *	as cache lines deduplicated into shared data slots.
+ *
+ * @param req OCF request with data to be written to cache
+ * @param backfill Only cache lines marked for backfill are compressed
+ */
+void ocf_engine_compress(struct ocf_request *req, bool backfill);
+
+/**
+ * @brief Prepare request data to be written to cache: detect all-zero cache
+ *	lines, assign data slots of deduplicated cache and compress data.
+ *	If request data can't be written to cache, req->info.no_cache_write
+ *	is set.
+ *
+ * @param req OCF request with data to be written to cache
+ * @param backfill Only cache lines marked for backfill are written
+ */
+void ocf_engine_prepare_cache_write(struct ocf_request *req, bool backfill);
+
+/**
+ * @brief Write request data to cache skipping all-zero cache lines found
+ *	by ocf_engine_detect_zero() and cache lines sharing data slot
+ *
+ * @param req OCF request
+ * @param backfill Only cache lines marked for backfill are written
+ * @param callback Completion called for each submitted IO, req_remaining
+ *	is incremented accordingly and has to be guarded by caller
+ */
+void ocf_engine_submit_cache_writes(struct ocf_request *req, bool backfill,
+		ocf_req_end_t callback);
+
 /**
  * @brief Clean request (flush dirty data to the core device)
  *
@@ -312,6 +569,20 @@ void ocf_engine_push_req_front_if(struct ocf_request *req,
 		const struct ocf_io_if *io_if,
 		bool allow_sync);
 
+/**
+ * @brief Continue processing of OCF request with next engine phase
+ *
+ * @note Next phase is ran immediately in caller context if inline
+ *	continuation is enabled for I/O queue, otherwise request is pushed
+ *	front to the OCF thread worker queue. Caller must not hold any
+ *	metadata or hash bucket locks.
+ *
+ * @param req OCF request
+ * @param io_if IO interface of next phase
+ */
+void ocf_engine_continue_if(struct ocf_request *req,
+		const struct ocf_io_if *io_if);
+
 void inc_fallback_pt_error_counter(ocf_cache_t cache);
 
 void ocf_engine_on_resume(struct ocf_request *req);
@@ -43,13 +43,13 @@ int ocf_io_d2c(struct ocf_request *req)
 	/* Get OCF request - increase reference counter */
 	ocf_req_get(req);
 
-	ocf_submit_volume_req(&core->volume, req, _ocf_d2c_completion);
-
 	ocf_engine_update_block_stats(req);
 
 	ocf_core_stats_request_pt_update(req->core, req->part_id, req->rw,
 			req->info.hit_no, req->core_line_count);
 
+	ocf_submit_volume_req(&core->volume, req, _ocf_d2c_completion);
+
 	/* Put OCF request - decrease reference counter */
 	ocf_req_put(req);
 
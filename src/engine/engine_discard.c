@@ -75,7 +75,7 @@ static int _ocf_discard_core(struct ocf_request *req)
 	}
 
 	ocf_io_set_cmpl(io, req, NULL, _ocf_discard_core_complete);
-	err = ocf_io_set_data(io, req->data, 0);
+	err = ocf_io_set_data(io, req->data, req->offset);
 	if (err) {
 		_ocf_discard_core_complete(io, err);
 		return err;
@@ -126,7 +126,7 @@ static void _ocf_discard_finish_step(struct ocf_request *req)
 {
 	req->discard.handled += BYTES_TO_SECTORS(req->byte_length);
 
-	if (req->discard.handled < req->discard.nr_sects)
+	if (req->discard.handled < req->discard.cache_nr_sects)
 		req->io_if = &_io_if_discard_step;
 	else if (!req->cache->metadata.is_volatile)
 		req->io_if = &_io_if_discard_flush_cache;
@@ -214,10 +214,11 @@ static int _ocf_discard_step(struct ocf_request *req)
 
 	OCF_DEBUG_TRACE(req->cache);
 
-	req->byte_position = SECTORS_TO_BYTES(req->discard.sector +
+	req->byte_position = SECTORS_TO_BYTES(req->discard.cache_sector +
 			req->discard.handled);
-	req->byte_length = OCF_MIN(SECTORS_TO_BYTES(req->discard.nr_sects -
-			req->discard.handled), MAX_TRIM_RQ_SIZE);
+	req->byte_length = OCF_MIN(SECTORS_TO_BYTES(
+			req->discard.cache_nr_sects - req->discard.handled),
+			MAX_TRIM_RQ_SIZE);
 	req->core_line_first = ocf_bytes_2_lines(cache, req->byte_position);
 	req->core_line_last =
 		ocf_bytes_2_lines(cache, req->byte_position + req->byte_length - 1);
@@ -277,7 +278,11 @@ int ocf_discard(struct ocf_request *req)
 	/* Get OCF request - increase reference counter */
 	ocf_req_get(req);
 
-	_ocf_discard_step(req);
+	/* No whole status granularity unit to be invalidated in cache */
+	if (req->discard.cache_nr_sects)
+		_ocf_discard_step(req);
+	else
+		_ocf_discard_core(req);
 
 	/* Put OCF request - decrease reference counter */
 	ocf_req_put(req);
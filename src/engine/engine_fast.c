@@ -82,17 +82,16 @@ static int _ocf_read_fast_do(struct ocf_request *req)
 		ocf_hb_req_prot_unlock_wr(req);
 	}
 
-	/* Submit IO */
-	OCF_DEBUG_RQ(req, "Submit");
-	env_atomic_set(&req->req_remaining, ocf_engine_io_count(req));
-	ocf_submit_cache_reqs(req->cache, req, OCF_READ, 0, req->byte_length,
-		ocf_engine_io_count(req), _ocf_read_fast_complete);
-
-
 	/* Update statistics */
 	ocf_engine_update_request_stats(req);
 	ocf_engine_update_block_stats(req);
 
+	/* Submit IO */
+	OCF_DEBUG_RQ(req, "Submit");
+	env_atomic_set(&req->req_remaining, 1);
+	ocf_engine_submit_cache_reads(req, _ocf_read_fast_complete);
+	_ocf_read_fast_complete(req, 0);
+
 	/* Put OCF request - decrease reference counter */
 	ocf_req_put(req);
 
@@ -126,6 +125,13 @@ int ocf_read_fast(struct ocf_request *req)
 
 	hit = ocf_engine_is_hit(req);
 
+	/* Clean hit may be steered or hedged to core by generic read engine */
+	if (hit && !req->info.dirty_any && (ocf_steering_is_on(req->cache) ||
+			ocf_steering_core_probe_due(req->cache) ||
+			ocf_hedge_is_enabled(req->cache))) {
+		hit = false;
+	}
+
 	part_has_space = ocf_user_part_has_space(req);
 
 	if (hit && part_has_space) {
@@ -67,5 +67,5 @@ static const struct ocf_io_if _io_if_invalidate = {
 
 void ocf_engine_invalidate(struct ocf_request *req)
 {
-	ocf_engine_push_req_front_if(req, &_io_if_invalidate, true);
+	ocf_engine_continue_if(req, &_io_if_invalidate);
 }
@@ -13,51 +13,200 @@
 #define OCF_ENGINE_DEBUG_IO_NAME "ops"
 #include "engine_debug.h"
 
-static void _ocf_engine_ops_complete(struct ocf_request *req, int error)
+/*
+ * Flush requests are served in generations. Flush arriving while device
+ * flushes of previous generation are in progress waits for them to complete
+ * and is then served together with all other flushes which arrived meanwhile.
+ * Generation flushes cache device once (and metadata device, if metadata is
+ * kept on separate volume) and each core device with flush request in
+ * generation once. As each request waits for device flushes
+ * submitted after it has arrived, data of all writes completed before it is
+ * durable once it completes.
+ */
+
+int ocf_engine_flush_group_init(ocf_cache_t cache)
 {
-	if (error)
-		req->error |= error;
+	int result;
 
-	if (env_atomic_dec_return(&req->req_remaining))
-		return;
+	result = env_spinlock_init(&cache->flush_group.lock);
+	if (result)
+		return result;
+
+	cache->flush_group.in_flight = false;
+	INIT_LIST_HEAD(&cache->flush_group.running);
+	INIT_LIST_HEAD(&cache->flush_group.pending);
 
-	OCF_DEBUG_RQ(req, "Completion");
+	return 0;
+}
+
+void ocf_engine_flush_group_deinit(ocf_cache_t cache)
+{
+	ENV_BUG_ON(cache->flush_group.in_flight);
+
+	env_spinlock_destroy(&cache->flush_group.lock);
+}
+
+static void _ocf_engine_flush_submit(ocf_cache_t cache);
+
+static void _ocf_engine_flush_complete(ocf_cache_t cache)
+{
+	struct ocf_request *req, *next;
+	struct list_head waiters;
+	ocf_core_id_t core_id;
+	bool submit;
 
-	if (req->error) {
-		/* An error occured */
-		ocf_engine_error(req, false, "Core operation failure");
+	INIT_LIST_HEAD(&waiters);
+
+	/* Resolve errors before next generation reuses group state */
+	list_for_each_entry_safe(req, next, &cache->flush_group.running, list) {
+		core_id = ocf_core_get_id(req->core);
+
+		if (cache->flush_group.error)
+			req->error = cache->flush_group.error;
+		else if (env_bit_test(core_id, cache->flush_group.failed))
+			req->error = cache->flush_group.core_error;
+
+		list_move_tail(&req->list, &waiters);
 	}
 
-	/* Complete requests - both to cache and to core*/
-	req->complete(req, req->error);
+	env_spinlock_lock(&cache->flush_group.lock);
+	submit = !list_empty(&cache->flush_group.pending);
+	cache->flush_group.in_flight = submit;
+	env_spinlock_unlock(&cache->flush_group.lock);
+
+	list_for_each_entry_safe(req, next, &waiters, list) {
+		list_del(&req->list);
+
+		OCF_DEBUG_RQ(req, "Completion");
+
+		if (req->error) {
+			/* An error occured */
+			ocf_engine_error(req, false, "Core operation failure");
+		}
+
+		/* Complete requests - both to cache and to core*/
+		req->complete(req, req->error);
 
-	/* Release OCF request */
-	ocf_req_put(req);
+		/* Release OCF request */
+		ocf_req_put(req);
+	}
+
+	if (submit)
+		_ocf_engine_flush_submit(cache);
 }
 
-int ocf_engine_ops(struct ocf_request *req)
+static void _ocf_engine_flush_end(ocf_cache_t cache)
 {
-	struct ocf_cache *cache = req->cache;
+	if (env_atomic_dec_return(&cache->flush_group.remaining))
+		return;
 
-	OCF_DEBUG_TRACE(req->cache);
+	_ocf_engine_flush_complete(cache);
+}
 
-	/* Get OCF request - increase reference counter */
-	ocf_req_get(req);
+static void _ocf_engine_flush_cache_complete(struct ocf_request *req,
+		int error)
+{
+	ocf_cache_t cache = req->cache;
 
-	/* IO to the core device and to the cache device */
-	env_atomic_set(&req->req_remaining, 2);
+	if (error)
+		cache->flush_group.error = error;
 
-	/* Submit operation into core device */
-	ocf_submit_volume_req(&req->core->volume, req,
-			_ocf_engine_ops_complete);
+	_ocf_engine_flush_end(cache);
+}
 
-	ocf_submit_cache_reqs(cache, req, req->rw, 0, req->byte_length,
-			1, _ocf_engine_ops_complete);
+static void _ocf_engine_flush_metadata_complete(void *priv, int error)
+{
+	ocf_cache_t cache = priv;
 
-	/* Put OCF request - decrease reference counter */
-	ocf_req_put(req);
+	if (error)
+		cache->flush_group.error = error;
 
-	return 0;
+	_ocf_engine_flush_end(cache);
+}
+
+static void _ocf_engine_flush_core_complete(struct ocf_request *req,
+		int error)
+{
+	ocf_cache_t cache = req->cache;
+
+	if (error) {
+		env_bit_set(ocf_core_get_id(req->core),
+				cache->flush_group.failed);
+		cache->flush_group.core_error = error;
+	}
+
+	_ocf_engine_flush_end(cache);
+}
+
+static void _ocf_engine_flush_submit(ocf_cache_t cache)
+{
+	struct ocf_request *req, *next, *leader = NULL;
+	ocf_core_id_t core_id;
+
+	env_spinlock_lock(&cache->flush_group.lock);
+	list_for_each_entry_safe(req, next, &cache->flush_group.pending, list)
+		list_move_tail(&req->list, &cache->flush_group.running);
+	env_spinlock_unlock(&cache->flush_group.lock);
+
+	cache->flush_group.error = 0;
+	cache->flush_group.core_error = 0;
+	env_memset(cache->flush_group.cores,
+			sizeof(cache->flush_group.cores), 0);
+	env_memset(cache->flush_group.failed,
+			sizeof(cache->flush_group.failed), 0);
+
+	/* Hold generation until all device flushes are submitted */
+	env_atomic_set(&cache->flush_group.remaining, 1);
+
+	list_for_each_entry(req, &cache->flush_group.running, list) {
+		core_id = ocf_core_get_id(req->core);
+		if (env_bit_test(core_id, cache->flush_group.cores))
+			continue;
+
+		env_bit_set(core_id, cache->flush_group.cores);
+		if (!leader)
+			leader = req;
+
+		OCF_DEBUG_RQ(req, "Submit");
+
+		/* Submit operation into core device */
+		env_atomic_inc(&cache->flush_group.remaining);
+		ocf_submit_volume_req(&req->core->volume, req,
+				_ocf_engine_flush_core_complete);
+	}
+
+	/* Submit operation into cache device */
+	env_atomic_inc(&cache->flush_group.remaining);
+	ocf_submit_cache_reqs(cache, leader, leader->rw, 0,
+			leader->byte_length, 1,
+			_ocf_engine_flush_cache_complete);
+
+	/* Metadata written along with data must be durable as well */
+	if (cache->device->separate_metadata) {
+		env_atomic_inc(&cache->flush_group.remaining);
+		ocf_submit_volume_flush(ocf_cache_get_metadata_volume(cache),
+				_ocf_engine_flush_metadata_complete, cache);
+	}
+
+	_ocf_engine_flush_end(cache);
 }
 
+int ocf_engine_ops(struct ocf_request *req)
+{
+	struct ocf_cache *cache = req->cache;
+	bool submit;
+
+	OCF_DEBUG_TRACE(req->cache);
+
+	/* Request is released once its generation completes */
+	env_spinlock_lock(&cache->flush_group.lock);
+	list_add_tail(&req->list, &cache->flush_group.pending);
+	submit = !cache->flush_group.in_flight;
+	cache->flush_group.in_flight = true;
+	env_spinlock_unlock(&cache->flush_group.lock);
 
+	if (submit)
+		_ocf_engine_flush_submit(cache);
+
+	return 0;
+}
@@ -8,4 +8,8 @@
 
 int ocf_engine_ops(struct ocf_request *req);
 
+int ocf_engine_flush_group_init(ocf_cache_t cache);
+
+void ocf_engine_flush_group_deinit(ocf_cache_t cache);
+
 #endif /* __CACHE_ENGINE_OPS_H_ */
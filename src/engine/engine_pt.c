@@ -80,14 +80,14 @@ int ocf_read_pt_do(struct ocf_request *req)
 		ocf_hb_req_prot_unlock_wr(req);
 	}
 
-	/* Submit read IO to the core */
-	_ocf_read_pt_submit(req);
-
 	/* Update statistics */
 	ocf_engine_update_block_stats(req);
 	ocf_core_stats_request_pt_update(req->core, req->part_id, req->rw,
 			req->info.hit_no, req->core_line_count);
 
+	/* Submit read IO to the core */
+	_ocf_read_pt_submit(req);
+
 	/* Put OCF request - decrease reference counter */
 	ocf_req_put(req);
 
@@ -44,6 +44,8 @@ static void _ocf_read_generic_hit_complete(struct ocf_request *req, int error)
 			ocf_core_stats_cache_error_update(req->core, OCF_READ);
 			ocf_engine_push_req_front_pt(req);
 		} else {
+			ocf_hedge_read_end(req);
+
 			ocf_req_unlock(c, req);
 
 			/* Complete request */
@@ -57,6 +59,28 @@ static void _ocf_read_generic_hit_complete(struct ocf_request *req, int error)
 	}
 }
 
+static void _ocf_read_generic_miss_complete(struct ocf_request *req, int error);
+
+static int _ocf_read_generic_refetch_do(struct ocf_request *req)
+{
+	uint32_t i;
+
+	for (i = 0; i < req->core_line_count; i++)
+		req->map[i].backfill = true;
+
+	env_atomic_set(&req->req_remaining, 1);
+
+	ocf_submit_volume_req(&req->core->volume, req,
+			_ocf_read_generic_miss_complete);
+
+	return 0;
+}
+
+static const struct ocf_io_if _io_if_read_generic_refetch = {
+	.read = _ocf_read_generic_refetch_do,
+	.write = _ocf_read_generic_refetch_do,
+};
+
 static void _ocf_read_generic_miss_complete(struct ocf_request *req, int error)
 {
 	struct ocf_cache *cache = req->cache;
@@ -71,6 +95,17 @@ static void _ocf_read_generic_miss_complete(struct ocf_request *req, int error)
 	if (env_atomic_dec_return(&req->req_remaining) == 0) {
 		OCF_DEBUG_RQ(req, "MISS completion");
 
+		if (req->error && !req->info.core_error) {
+			/* Failed to read valid sectors from cache - fetch
+			 * whole request from core */
+			inc_fallback_pt_error_counter(cache);
+			ocf_core_stats_cache_error_update(req->core, OCF_READ);
+			req->error = 0;
+			ocf_engine_continue_if(req,
+					&_io_if_read_generic_refetch);
+			return;
+		}
+
 		if (req->error) {
 			/*
 			 * --- Do not submit this request to write-back-thread.
@@ -78,9 +113,6 @@ static void _ocf_read_generic_miss_complete(struct ocf_request *req, int error)
 			 */
 			req->complete(req, req->error);
 
-			req->info.core_error = 1;
-			ocf_core_stats_core_error_update(req->core, OCF_READ);
-
 			ctx_data_free(cache->owner, req->cp_data);
 			req->cp_data = NULL;
 
@@ -93,8 +125,8 @@ static void _ocf_read_generic_miss_complete(struct ocf_request *req, int error)
 		/* Copy pages to copy vec, since this is the one needed
 		 * by the above layer
 		 */
-		ctx_data_cpy(cache->owner, req->cp_data, req->data, 0, 0,
-				req->byte_length);
+		ctx_data_cpy(cache->owner, req->cp_data, req->data, 0,
+				req->offset, req->byte_length);
 
 		/* Complete request */
 		req->complete(req, req->error);
@@ -103,17 +135,204 @@ static void _ocf_read_generic_miss_complete(struct ocf_request *req, int error)
 	}
 }
 
+static void _ocf_read_generic_miss_core_complete(struct ocf_request *req,
+		int error)
+{
+	if (error) {
+		req->info.core_error = 1;
+		ocf_core_stats_core_error_update(req->core, OCF_READ);
+	}
+
+	_ocf_read_generic_miss_complete(req, error);
+}
+
 void ocf_read_generic_submit_hit(struct ocf_request *req)
 {
-	env_atomic_set(&req->req_remaining, ocf_engine_io_count(req));
+	ocf_hedge_read_start(req);
+
+	env_atomic_set(&req->req_remaining, 1);
+
+	ocf_engine_submit_cache_reads(req, _ocf_read_generic_hit_complete);
+
+	_ocf_read_generic_hit_complete(req, 0);
+}
+
+/*
+ * Hedged read hit - cache data is read into private buffer. If cache device
+ * doesn't serve it before deadline, the same data is read also from core
+ * into another private buffer (see ocf_read_generic_hedge()). Request is
+ * completed with data of the read which succeeds first. Cache lines stay
+ * locked and buffers are kept until both reads complete.
+ */
+static void _ocf_read_hedged_read_end(struct ocf_request *req)
+{
+	struct ocf_cache *cache = req->cache;
+
+	if (env_atomic_dec_return(&req->hedge.reads))
+		return;
+
+	ctx_data_munlock(cache->owner, req->hedge.cache_data);
+	ctx_data_free(cache->owner, req->hedge.cache_data);
+	req->hedge.cache_data = NULL;
+
+	if (req->hedge.core_data) {
+		ctx_data_munlock(cache->owner, req->hedge.core_data);
+		ctx_data_free(cache->owner, req->hedge.core_data);
+		req->hedge.core_data = NULL;
+	}
+
+	if (!env_atomic_read(&req->hedge.completed)) {
+		/* No read succeeded - fall back to PT */
+		ocf_engine_push_req_front_pt(req);
+		return;
+	}
+
+	ocf_req_unlock(ocf_cache_line_concurrency(cache), req);
+
+	/* Free the request at the last point of the completion path */
+	ocf_req_put(req);
+}
+
+static bool _ocf_read_hedged_complete(struct ocf_request *req,
+		ctx_data_t *data)
+{
+	/* Only the first successful read completes request */
+	if (env_atomic_cmpxchg(&req->hedge.completed, 0, 1))
+		return false;
+
+	ctx_data_cpy(req->cache->owner, req->data, data, req->offset, 0,
+			req->byte_length);
+
+	req->complete(req, 0);
+
+	return true;
+}
+
+static void _ocf_read_hedged_cache_complete(struct ocf_request *req,
+		int error)
+{
+	if (error)
+		req->error |= error;
+
+	if (env_atomic_dec_return(&req->req_remaining))
+		return;
+
+	OCF_DEBUG_RQ(req, "HIT completion");
+
+	ocf_queue_deadline_del(req);
+
+	if (req->error) {
+		inc_fallback_pt_error_counter(req->cache);
+		ocf_core_stats_cache_error_update(req->core, OCF_READ);
+	} else {
+		ocf_hedge_read_end(req);
+		_ocf_read_hedged_complete(req, req->hedge.cache_data);
+	}
+
+	_ocf_read_hedged_read_end(req);
+}
+
+static void _ocf_read_hedged_core_complete(struct ocf_request *req,
+		int error)
+{
+	OCF_DEBUG_RQ(req, "Hedged read completion");
+
+	if (error) {
+		ocf_core_stats_core_error_update(req->core, OCF_READ);
+	} else if (_ocf_read_hedged_complete(req, req->hedge.core_data)) {
+		env_atomic64_inc(&req->cache->hedge.core_won);
+	}
+
+	_ocf_read_hedged_read_end(req);
+}
+
+static ctx_data_t *_ocf_read_hedged_alloc(struct ocf_request *req)
+{
+	ocf_cache_t cache = req->cache;
+	ctx_data_t *data;
+
+	data = ctx_data_alloc(cache->owner, BYTES_TO_PAGES(req->byte_length));
+	if (!data)
+		return NULL;
+
+	if (ctx_data_mlock(cache->owner, data)) {
+		ctx_data_free(cache->owner, data);
+		return NULL;
+	}
+
+	return data;
+}
+
+void ocf_read_generic_hedge(struct ocf_request *req)
+{
+	OCF_DEBUG_RQ(req, "Hedging");
 
-	ocf_submit_cache_reqs(req->cache, req, OCF_READ, 0, req->byte_length,
-		ocf_engine_io_count(req), _ocf_read_generic_hit_complete);
+	/* Cache read is still in progress, so buffer can't be freed yet */
+	req->hedge.core_data = _ocf_read_hedged_alloc(req);
+	if (!req->hedge.core_data) {
+		_ocf_read_hedged_read_end(req);
+		return;
+	}
+
+	env_atomic64_inc(&req->cache->hedge.hedged);
+
+	ocf_submit_volume_req_buf(&req->core->volume, req,
+			req->hedge.core_data, _ocf_read_hedged_core_complete);
 }
 
+/*
+ * Only clean hits can be read from core. Zero cache lines are not read at
+ * all and compressed data is decompressed directly into request data, so
+ * such requests are not hedged.
+ */
+static bool _ocf_read_generic_can_hedge(struct ocf_request *req)
+{
+	if (req->info.dirty_any || req->info.zero_any)
+		return false;
+
+	if (ocf_cache_compression_enabled(req->cache))
+		return false;
+
+	return ocf_hedge_get_deadline(req->cache);
+}
+
+static void _ocf_read_generic_submit_hedged_hit(struct ocf_request *req)
+{
+	req->hedge.cache_data = _ocf_read_hedged_alloc(req);
+	if (!req->hedge.cache_data) {
+		ocf_read_generic_submit_hit(req);
+		return;
+	}
+
+	req->hedge.core_data = NULL;
+	env_atomic_set(&req->hedge.reads, 1);
+	env_atomic_set(&req->hedge.completed, 0);
+
+	ocf_hedge_read_start(req);
+	req->hedge.deadline = ocf_hedge_get_deadline(req->cache);
+	ocf_queue_deadline_add(req);
+
+	env_atomic_set(&req->req_remaining, ocf_engine_io_count(req) + 1);
+
+	ocf_submit_cache_reqs_buf(req->cache, req, req->hedge.cache_data,
+			ocf_engine_io_count(req), _ocf_read_hedged_cache_complete);
+
+	_ocf_read_hedged_cache_complete(req, 0);
+}
+
+/*
+ * Sectors which are already valid in cache are read from cache and only
+ * the gaps are fetched from core. Adjacent gaps are merged, so request with
+ * no valid sectors is read from core with single IO. Zero sectors are not
+ * read at all. Cache lines with gaps are marked for backfill before their
+ * valid status bits are set. IOs are only collected under metadata lock and
+ * submitted after it is released.
+ */
 static inline void _ocf_read_generic_submit_miss(struct ocf_request *req)
 {
 	struct ocf_cache *cache = req->cache;
+	struct ocf_engine_sec_run run;
+	uint32_t i, last;
 	int ret;
 
 	env_atomic_set(&req->req_remaining, 1);
@@ -127,14 +346,46 @@ static inline void _ocf_read_generic_submit_miss(struct ocf_request *req)
 	if (ret)
 		goto err_alloc;
 
-	/* Submit read request to core device. */
-	ocf_submit_volume_req(&req->core->volume, req,
-			_ocf_read_generic_miss_complete);
+	ret = ocf_engine_io_runs_init(req);
+	if (ret)
+		goto err_alloc;
+
+	ocf_hb_req_prot_lock_wr(req);
+
+	for (i = 0; i < req->core_line_count; i++)
+		req->map[i].backfill = false;
+
+	ocf_engine_sec_run_init(req, &run);
+	while (ocf_engine_next_sec_run(req, &run)) {
+		if (!run.valid) {
+			last = run.next_sector ? run.next_line :
+					run.next_line - 1;
+			for (i = run.line; i <= last; i++)
+				req->map[i].backfill = true;
+
+			ocf_engine_io_runs_add(req, ocf_engine_io_core,
+					run.offset, run.size);
+			continue;
+		}
+
+		ocf_engine_io_runs_add(req, run.zero ? ocf_engine_io_zero :
+				ocf_engine_io_cache, run.offset, run.size);
+	}
+
+	/* Set valid status bits map */
+	ocf_set_valid_map_info(req);
+
+	ocf_hb_req_prot_unlock_wr(req);
+
+	ocf_engine_io_runs_submit(req, _ocf_read_generic_miss_complete,
+			_ocf_read_generic_miss_core_complete);
+
+	_ocf_read_generic_miss_complete(req, 0);
 
 	return;
 
 err_alloc:
-	_ocf_read_generic_miss_complete(req, -OCF_ERR_NO_MEM);
+	_ocf_read_generic_miss_core_complete(req, -OCF_ERR_NO_MEM);
 }
 
 static int _ocf_read_generic_do(struct ocf_request *req)
@@ -166,12 +417,6 @@ static int _ocf_read_generic_do(struct ocf_request *req)
 			return 0;
 		}
 
-		ocf_hb_req_prot_lock_wr(req);
-
-		/* Set valid status bits map */
-		ocf_set_valid_map_info(req);
-
-		ocf_hb_req_prot_unlock_wr(req);
 	}
 
 	if (ocf_engine_needs_repart(req)) {
@@ -187,17 +432,19 @@ static int _ocf_read_generic_do(struct ocf_request *req)
 		ocf_hb_req_prot_unlock_wr(req);
 	}
 
+	/* Update statistics */
+	ocf_engine_update_request_stats(req);
+	ocf_engine_update_block_stats(req);
+
 	OCF_DEBUG_RQ(req, "Submit");
 
 	/* Submit IO */
-	if (ocf_engine_is_hit(req))
-		ocf_read_generic_submit_hit(req);
-	else
+	if (!ocf_engine_is_hit(req))
 		_ocf_read_generic_submit_miss(req);
-
-	/* Update statistics */
-	ocf_engine_update_request_stats(req);
-	ocf_engine_update_block_stats(req);
+	else if (_ocf_read_generic_can_hedge(req))
+		_ocf_read_generic_submit_hedged_hit(req);
+	else
+		ocf_read_generic_submit_hit(req);
 
 	/* Put OCF request - decrease reference counter */
 	ocf_req_put(req);
@@ -215,6 +462,33 @@ static const struct ocf_engine_callbacks _rd_engine_callbacks =
 	.resume = ocf_engine_on_resume,
 };
 
+/*
+ * Check whether request should be served from core because cache device
+ * is saturated or core device latency needs to be sampled. Dirty data can be
+ * read only from cache, so only requests without dirty cache lines are
+ * steered.
+ */
+static bool _ocf_read_generic_steer(struct ocf_request *req)
+{
+	bool dirty;
+
+	if (!ocf_steering_is_on(req->cache) &&
+			!ocf_steering_core_probe_due(req->cache)) {
+		return false;
+	}
+
+	ocf_req_hash(req);
+	ocf_hb_req_prot_lock_rd(req);
+	ocf_engine_traverse(req);
+	dirty = req->info.dirty_any;
+	ocf_hb_req_prot_unlock_rd(req);
+
+	if (dirty)
+		return false;
+
+	return ocf_steering_steer_req(req);
+}
+
 int ocf_read_generic(struct ocf_request *req)
 {
 	int lock = OCF_LOCK_NOT_ACQUIRED;
@@ -229,6 +503,14 @@ int ocf_read_generic(struct ocf_request *req)
 		return 0;
 	}
 
+	if (_ocf_read_generic_steer(req)) {
+		OCF_DEBUG_RQ(req, "Steering to core");
+		ocf_req_clear(req);
+		req->force_pt = true;
+		ocf_get_io_if(ocf_cache_mode_pt)->read(req);
+		return 0;
+	}
+
 	/* Get OCF request - increase reference counter */
 	ocf_req_get(req);
 
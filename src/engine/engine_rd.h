@@ -10,4 +10,13 @@ int ocf_read_generic(struct ocf_request *req);
 
 void ocf_read_generic_submit_hit(struct ocf_request *req);
 
+/**
+ * @brief Issue hedged core read of request whose cache read has exceeded
+ *	deadline
+ *
+ * @param req Request removed from queue deadline list with hedge.reads
+ *	already incremented for the core read
+ */
+void ocf_read_generic_hedge(struct ocf_request *req);
+
 #endif /* ENGINE_RD_H_ */
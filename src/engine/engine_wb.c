@@ -8,6 +8,7 @@
 #include "cache_engine.h"
 #include "engine_common.h"
 #include "engine_wb.h"
+#include "engine_wt.h"
 #include "engine_inv.h"
 #include "../metadata/metadata.h"
 #include "../ocf_request.h"
@@ -29,8 +30,9 @@ static void _ocf_write_wb_update_bits(struct ocf_request *req)
 {
 	bool miss = ocf_engine_is_miss(req);
 	bool clean_any = !ocf_engine_is_dirty_all(req);
+	bool zero_any = req->info.zero_any;
 
-	if (!miss && !clean_any) {
+	if (!miss && !clean_any && !zero_any) {
 		ocf_req_set_cleaning_hot(req);
 		return;
 	}
@@ -40,6 +42,10 @@ static void _ocf_write_wb_update_bits(struct ocf_request *req)
 		/* Update valid status bits */
 		ocf_set_valid_map_info(req);
 	}
+	if (zero_any) {
+		/* Update zero status bits of valid sectors */
+		ocf_set_zero_map_info(req);
+	}
 	if (clean_any) {
 		/* set dirty bits, and mark if metadata flushing is required */
 		ocf_set_dirty_map_info(req);
@@ -111,17 +117,15 @@ static void _ocf_write_wb_complete(struct ocf_request *req, int error)
 
 		ocf_engine_invalidate(req);
 	} else {
-		ocf_engine_push_req_front_if(req, &_io_if_wb_flush_metadata,
-				true);
+		ocf_engine_continue_if(req, &_io_if_wb_flush_metadata);
 	}
 }
 
 
 static inline void _ocf_write_wb_submit(struct ocf_request *req)
 {
-	struct ocf_cache *cache = req->cache;
-
-	env_atomic_set(&req->req_remaining, ocf_engine_io_count(req));
+	/* Submission, cache IOs are counted on submit */
+	env_atomic_set(&req->req_remaining, 1);
 
 	/*
 	 * 1. Submit data
@@ -144,23 +148,33 @@ static inline void _ocf_write_wb_submit(struct ocf_request *req)
 
 	OCF_DEBUG_RQ(req, "Submit Data");
 
-	/* Data IO */
-	ocf_submit_cache_reqs(cache, req, OCF_WRITE, 0, req->byte_length,
-			ocf_engine_io_count(req), _ocf_write_wb_complete);
+	/* Data IO, all-zero cache lines are skipped */
+	ocf_engine_submit_cache_writes(req, false, _ocf_write_wb_complete);
+
+	_ocf_write_wb_complete(req, 0);
 }
 
 int ocf_write_wb_do(struct ocf_request *req)
 {
+	ocf_engine_prepare_cache_write(req, false);
+
+	if (req->info.no_cache_write) {
+		/* Data doesn't fit into compressed cache line slots or there
+		 * are no free data slots, write it through to core and
+		 * invalidate it in cache instead */
+		return ocf_write_wt_do(req);
+	}
+
 	/* Get OCF request - increase reference counter */
 	ocf_req_get(req);
 
-	/* Submit IO */
-	_ocf_write_wb_submit(req);
-
 	/* Update statistics */
 	ocf_engine_update_request_stats(req);
 	ocf_engine_update_block_stats(req);
 
+	/* Submit IO */
+	_ocf_write_wb_submit(req);
+
 	/* Put OCF request - decrease reference counter */
 	ocf_req_put(req);
 
@@ -134,8 +134,7 @@ static void _ocf_write_wi_core_complete(struct ocf_request *req, int error)
 
 		ocf_req_put(req);
 	} else {
-		ocf_engine_push_req_front_if(req, &_io_if_wi_update_metadata,
-				true);
+		ocf_engine_continue_if(req, &_io_if_wi_update_metadata);
 	}
 }
 
@@ -144,19 +143,32 @@ static int _ocf_write_wi_core_write(struct ocf_request *req)
 	/* Get OCF request - increase reference counter */
 	ocf_req_get(req);
 
-	env_atomic_set(&req->req_remaining, 1); /* One core IO */
+	if (req->info.dirty_any && !ocf_engine_is_status_aligned(req)) {
+		/* Invalidating partially written status unit would drop
+		 * dirty data around the request, so clean it first */
+		ocf_hb_req_prot_lock_rd(req);
+		ocf_engine_clean(req);
+		ocf_hb_req_prot_unlock_rd(req);
 
-	OCF_DEBUG_RQ(req, "Submit");
+		/* Core write is resumed once request is cleaned */
+		ocf_req_put(req);
 
-	/* Submit write IO to the core */
-	ocf_submit_volume_req(&req->core->volume, req,
-			   _ocf_write_wi_core_complete);
+		return 0;
+	}
+
+	env_atomic_set(&req->req_remaining, 1); /* One core IO */
 
 	/* Update statistics */
 	ocf_engine_update_block_stats(req);
 	ocf_core_stats_request_pt_update(req->core, req->part_id, req->rw,
 			req->info.hit_no, req->core_line_count);
 
+	OCF_DEBUG_RQ(req, "Submit");
+
+	/* Submit write IO to the core */
+	ocf_submit_volume_req(&req->core->volume, req,
+			   _ocf_write_wi_core_complete);
+
 	/* Put OCF request - decrease reference counter */
 	ocf_req_put(req);
 
@@ -42,109 +42,38 @@ static void ocf_read_wo_cache_complete(struct ocf_request *req, int error)
 	ocf_req_put(req);
 }
 
-static void ocf_read_wo_cache_io(struct ocf_request *req, uint64_t offset,
-		uint64_t size)
-{
-	OCF_DEBUG_RQ(req, "Submit cache");
-	env_atomic_inc(&req->req_remaining);
-	ocf_submit_cache_reqs(req->cache, req, OCF_READ, offset, size, 1,
-			ocf_read_wo_cache_complete);
-}
-
 static int ocf_read_wo_cache_do(struct ocf_request *req)
 {
-	ocf_cache_t cache = req->cache;
-	uint32_t s, e, i;
-	uint64_t line;
-	struct ocf_map_info *entry;
-	bool valid = false;
-	bool io = false;
-	uint64_t phys_prev, phys_curr = 0;
-	uint64_t io_start = 0;
-	uint64_t offset = 0;
-	uint64_t increment = 0;
+	struct ocf_engine_sec_run run;
 
 	env_atomic_set(&req->req_remaining, 1);
 
-	for (line = 0; line < req->core_line_count; ++line) {
-		entry = &req->map[line];
-		s = ocf_map_line_start_sector(req, line);
-		e = ocf_map_line_end_sector(req, line);
-
-		ocf_hb_cline_prot_lock_rd(&cache->metadata.lock,
-				req->lock_idx, entry->core_id,
-				entry->core_line);
-
-		/* if cacheline mapping is not sequential, send cache IO to
-		 * previous cacheline(s) */
-		phys_prev = phys_curr;
-		if (entry->status != LOOKUP_MISS)
-			phys_curr = ocf_metadata_map_lg2phy(cache,
-					entry->coll_idx);
-		if (io && phys_prev + 1 != phys_curr) {
-			ocf_read_wo_cache_io(req, io_start, offset - io_start);
-			io = false;
-		}
+	if (ocf_engine_io_runs_init(req)) {
+		ocf_req_unlock_rd(ocf_cache_line_concurrency(req->cache), req);
+		req->complete(req, -OCF_ERR_NO_MEM);
+		ocf_req_put(req);
+		return 0;
+	}
 
-		/* try to seek directly to the last sector */
-		if (entry->status == LOOKUP_MISS) {
-			/* all sectors invalid */
-			i = e + 1;
-			increment = SECTORS_TO_BYTES(e - s + 1);
-			valid = false;
-		}
-		else if (ocf_engine_map_all_sec_valid(req, line)) {
-			/* all sectors valid */
-			i = e + 1;
-			increment = SECTORS_TO_BYTES(e - s + 1);
-			valid = true;
-		} else {
-			/* need to iterate through CL sector by sector */
-			i = s;
+	ocf_hb_req_prot_lock_rd(req);
+
+	/* Collect valid sector runs to be read from cache, the rest has been
+	 * already read from core */
+	ocf_engine_sec_run_init(req, &run);
+	while (ocf_engine_next_sec_run(req, &run)) {
+		if (run.zero) {
+			ocf_engine_io_runs_add(req, ocf_engine_io_zero,
+					run.offset, run.size);
+		} else if (run.valid) {
+			ocf_engine_io_runs_add(req, ocf_engine_io_cache,
+					run.offset, run.size);
 		}
-
-		do {
-			if (i <= e) {
-				 valid = metadata_test_valid_one(cache,
-						entry->coll_idx, i);
-				 increment = 0;
-				 do {
-					++i;
-					increment += SECTORS_TO_BYTES(1);
-				 } while (i <= e && metadata_test_valid_one(
-						cache, entry->coll_idx, i)
-						== valid);
-			}
-
-			ocf_hb_cline_prot_unlock_rd(&cache->metadata.lock,
-					req->lock_idx, entry->core_id,
-					entry->core_line);
-
-			if (io && !valid) {
-				/* end of sequential valid region */
-				ocf_read_wo_cache_io(req, io_start,
-						offset - io_start);
-				io = false;
-			}
-
-			if (!io && valid) {
-				/* beginning of sequential valid region */
-				io = true;
-				io_start = offset;
-			}
-
-			offset += increment;
-
-			if (i <= e) {
-				ocf_hb_cline_prot_lock_rd(&cache->metadata.lock,
-					req->lock_idx, entry->core_id,
-					entry->core_line);
-			}
-		} while (i <= e);
 	}
 
-	if (io)
-		ocf_read_wo_cache_io(req, io_start, offset - io_start);
+	ocf_hb_req_prot_unlock_rd(req);
+
+	OCF_DEBUG_RQ(req, "Submit cache");
+	ocf_engine_io_runs_submit(req, ocf_read_wo_cache_complete, NULL);
 
 	ocf_read_wo_cache_complete(req, 0);
 
@@ -189,6 +118,9 @@ int ocf_read_wo_do(struct ocf_request *req)
 	 * and read requests do not carry write lifetime hint by definition.
 	 */
 
+	ocf_engine_update_request_stats(req);
+	ocf_engine_update_block_stats(req);
+
 	if (ocf_engine_is_hit(req)) {
 		/* read hit - just fetch the data from cache */
 		OCF_DEBUG_RQ(req, "Submit cache hit");
@@ -200,9 +132,6 @@ int ocf_read_wo_do(struct ocf_request *req)
 				_ocf_read_wo_core_complete);
 	}
 
-	ocf_engine_update_request_stats(req);
-	ocf_engine_update_block_stats(req);
-
 	ocf_req_put(req);
 	return 0;
 }
@@ -23,8 +23,9 @@ static void _ocf_write_wt_update_bits(struct ocf_request *req)
 	bool miss = ocf_engine_is_miss(req);
 	bool dirty_any = req->info.dirty_any;
 	bool repart = ocf_engine_needs_repart(req);
+	bool zero_any = req->info.zero_any;
 
-	if (!miss && !dirty_any && !repart)
+	if (!miss && !dirty_any && !repart && !zero_any)
 		return;
 
 	ocf_hb_req_prot_lock_wr(req);
@@ -34,6 +35,11 @@ static void _ocf_write_wt_update_bits(struct ocf_request *req)
 		ocf_set_valid_map_info(req);
 	}
 
+	if (zero_any) {
+		/* Update zero status bits of valid sectors */
+		ocf_set_zero_map_info(req);
+	}
+
 	if (dirty_any) {
 		/* Writes goes to both cache and core, need to update
 		 * status bits from dirty to clean
@@ -77,7 +83,9 @@ static int ocf_write_wt_do_flush_metadata(struct ocf_request *req)
 
 	env_atomic_set(&req->req_remaining, 1);
 
-	_ocf_write_wt_update_bits(req);
+	/* Without dirty lines bits were updated before submission */
+	if (req->info.dirty_any)
+		_ocf_write_wt_update_bits(req);
 
 	if (req->info.flush_metadata) {
 		/* Metadata flush IO */
@@ -103,8 +111,8 @@ static void _ocf_write_wt_req_complete(struct ocf_request *req)
 
 	OCF_DEBUG_RQ(req, "Completion");
 
-	if (req->error) {
-		/* An error occured */
+	if (req->error || req->info.no_cache_write) {
+		/* An error occured or data couldn't be written to cache */
 
 		/* Complete request */
 		req->complete(req, req->info.core_error ? req->error : 0);
@@ -114,9 +122,10 @@ static void _ocf_write_wt_req_complete(struct ocf_request *req)
 		return;
 	}
 
-	if (req->info.dirty_any) {
-		/* Some of the request's cachelines changed its state to clean */
-		ocf_engine_push_req_front_if(req, &_io_if_wt_flush_metadata, true);
+	if (req->info.dirty_any || req->info.flush_metadata) {
+		/* Some of the request's cachelines changed its state to clean
+		 * or its zero status */
+		ocf_engine_continue_if(req, &_io_if_wt_flush_metadata);
 	} else {
 		ocf_req_unlock_wr(ocf_cache_line_concurrency(req->cache), req);
 
@@ -152,49 +161,59 @@ static void _ocf_write_wt_core_complete(struct ocf_request *req, int error)
 
 static inline void _ocf_write_wt_submit(struct ocf_request *req)
 {
-	struct ocf_cache *cache = req->cache;
-
 	/* Submit IOs */
 	OCF_DEBUG_RQ(req, "Submit");
 
-	/* Calculate how many IOs need to be submited */
-	env_atomic_set(&req->req_remaining, ocf_engine_io_count(req)); /* Cache IO */
-	env_atomic_inc(&req->req_remaining); /* Core device IO */
+	/* Core device IO and submission, cache IOs are counted on submit */
+	env_atomic_set(&req->req_remaining, 2);
 
-	/* To cache */
-	ocf_submit_cache_reqs(cache, req, OCF_WRITE, 0, req->byte_length,
-			ocf_engine_io_count(req), _ocf_write_wt_cache_complete);
+	/* To cache, all-zero cache lines are skipped. Data which doesn't fit
+	 * into compressed cache line slots or free data slots is written only
+	 * to core and invalidated in cache on completion.
+	 */
+	if (!req->info.no_cache_write) {
+		ocf_engine_submit_cache_writes(req, false,
+				_ocf_write_wt_cache_complete);
+	}
 
 	/* To core */
 	ocf_submit_volume_req(&req->core->volume, req,
 			_ocf_write_wt_core_complete);
+
+	_ocf_write_wt_req_complete(req);
 }
 
-static int _ocf_write_wt_do(struct ocf_request *req)
+int ocf_write_wt_do(struct ocf_request *req)
 {
 	/* Get OCF request - increase reference counter */
 	ocf_req_get(req);
 
-	if (!req->info.dirty_any) {
+	if (!req->info.dirty_any && !req->info.no_cache_write) {
 		/* Set metadata bits before the request submission only if the dirty
 		   status for any of the request's cachelines won't change */
 		_ocf_write_wt_update_bits(req);
-		ENV_BUG_ON(req->info.flush_metadata);
 	}
 
-	/* Submit IO */
-	_ocf_write_wt_submit(req);
-
 	/* Update statistics */
 	ocf_engine_update_request_stats(req);
 	ocf_engine_update_block_stats(req);
 
+	/* Submit IO */
+	_ocf_write_wt_submit(req);
+
 	/* Put OCF request - decrease reference counter */
 	ocf_req_put(req);
 
 	return 0;
 }
 
+static int _ocf_write_wt_do(struct ocf_request *req)
+{
+	ocf_engine_prepare_cache_write(req, false);
+
+	return ocf_write_wt_do(req);
+}
+
 static const struct ocf_io_if _io_if_wt_resume = {
 	.read = _ocf_write_wt_do,
 	.write = _ocf_write_wt_do,
@@ -8,4 +8,6 @@
 
 int ocf_write_wt(struct ocf_request *req);
 
+int ocf_write_wt_do(struct ocf_request *req);
+
 #endif /* ENGINE_WT_H_ */
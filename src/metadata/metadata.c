@@ -16,6 +16,7 @@
 #include "../ocf_def_priv.h"
 #include "../ocf_priv.h"
 #include "../utils/utils_cache_line.h"
+#include "../utils/utils_dedup.h"
 #include "../utils/utils_io.h"
 #include "../utils/utils_pipeline.h"
 
@@ -43,6 +44,7 @@ struct ocf_part_runtime_meta {
 enum {
 	ocf_metadata_status_type_valid = 0,
 	ocf_metadata_status_type_dirty,
+	ocf_metadata_status_type_zero,
 
 	ocf_metadata_status_type_max
 };
@@ -50,7 +52,7 @@ enum {
 static inline size_t ocf_metadata_status_sizeof(
 		const struct ocf_cache_line_settings *settings) {
 	/* Number of bytes required to mark cache line status */
-	size_t size = settings->sector_count / 8;
+	size_t size = OCF_DIV_ROUND_UP(settings->sector_count, 8);
 
 	/* Number of types of status (valid, dirty, etc...) */
 	size *= ocf_metadata_status_type_max;
@@ -117,7 +119,8 @@ static ocf_cache_line_t ocf_metadata_get_entries(
  */
 static int64_t ocf_metadata_get_element_size(
 		enum ocf_metadata_segment_id type,
-		const struct ocf_cache_line_settings *settings)
+		const struct ocf_cache_line_settings *settings,
+		ocf_dedup_t dedup)
 {
 	int64_t size = 0;
 
@@ -135,6 +138,9 @@ static int64_t ocf_metadata_get_element_size(
 	case metadata_segment_collision:
 		size = sizeof(struct ocf_metadata_map)
 			+ ocf_metadata_status_sizeof(settings);
+		/* Data slot follows status of deduplicated cache line */
+		if (dedup != ocf_dedup_none)
+			size += sizeof(ocf_cache_line_t);
 		break;
 
 	case metadata_segment_list_info:
@@ -257,7 +263,7 @@ static bool ocf_metadata_calculate_exception_hndl(ocf_cache_t cache,
 static int ocf_metadata_calculate_metadata_size(
 		struct ocf_cache *cache,
 		struct ocf_metadata_ctrl *ctrl,
-		const struct ocf_cache_line_settings *settings)
+		uint64_t slot_size, ocf_dedup_t dedup)
 {
 	int64_t i_diff = 0, diff_lines = 0, cache_lines = ctrl->device_lines;
 	int64_t lowest_diff;
@@ -274,9 +280,10 @@ static int ocf_metadata_calculate_metadata_size(
 				i < metadata_segment_max; i++) {
 			struct ocf_metadata_raw *raw = &ctrl->raw_desc[i];
 
-			/* Setup number of entries */
-			raw->entries
-				= ocf_metadata_get_entries(i, cache_lines);
+			/* Setup number of entries, each data slot may be
+			 * shared by up to dedup factor cache lines */
+			raw->entries = ocf_metadata_get_entries(i,
+					cache_lines * dedup);
 
 			/*
 			 * Setup SSD location and size
@@ -289,6 +296,10 @@ static int ocf_metadata_calculate_metadata_size(
 			count_pages += ocf_metadata_raw_size_on_ssd(raw);
 		}
 
+		/* Metadata on separate volume takes no cache volume space */
+		if (cache->device->separate_metadata)
+			break;
+
 		/*
 		 * Check if max allowed iteration exceeded
 		 */
@@ -314,11 +325,11 @@ static int ocf_metadata_calculate_metadata_size(
 		/* Calculate diff of cache lines */
 
 		/* Cache size in bytes */
-		diff_lines = ctrl->device_lines * settings->size;
+		diff_lines = ctrl->device_lines * slot_size;
 		/* Sub metadata size which is in 4 kiB unit */
 		diff_lines -= count_pages * PAGE_SIZE;
 		/* Convert back to cache lines */
-		diff_lines /= settings->size;
+		diff_lines /= slot_size;
 		/* Calculate difference */
 		diff_lines -= cache_lines;
 
@@ -340,10 +351,11 @@ static int ocf_metadata_calculate_metadata_size(
 	} while (diff_lines);
 
 	ctrl->count_pages = count_pages;
-	ctrl->cachelines = cache_lines;
+	ctrl->cachelines = cache_lines * dedup;
+	ctrl->data_slots = cache_lines;
 	OCF_DEBUG_PARAM(cache, "Cache lines = %u", ctrl->cachelines);
 
-	if (ctrl->device_lines < ctrl->cachelines)
+	if (ctrl->device_lines < ctrl->data_slots)
 		return -1;
 
 	return 0;
@@ -434,6 +446,7 @@ void ocf_metadata_deinit_variable_size(struct ocf_cache *cache)
 	OCF_DEBUG_TRACE(cache);
 
 	ocf_metadata_concurrency_attached_deinit(&cache->metadata.lock);
+	ocf_dedup_deinit(cache);
 
 	/*
 	 * De initialize RAW types
@@ -445,14 +458,17 @@ void ocf_metadata_deinit_variable_size(struct ocf_cache *cache)
 }
 
 static inline void ocf_metadata_config_init(struct ocf_cache *cache,
-		struct ocf_cache_line_settings *settings, size_t size)
+		struct ocf_cache_line_settings *settings, size_t size,
+		ocf_status_granularity_t status_granularity)
 {
 	ENV_BUG_ON(!ocf_cache_line_size_is_valid(size));
+	ENV_BUG_ON(!ocf_status_granularity_is_valid(status_granularity));
 
 	ENV_BUG_ON(env_memset(settings, sizeof(*settings), 0));
 
 	settings->size = size;
-	settings->sector_count = BYTES_TO_SECTORS(settings->size);
+	settings->sector_shift = env_ctz64(status_granularity);
+	settings->sector_count = settings->size >> settings->sector_shift;
 	settings->sector_start = 0;
 	settings->sector_end = settings->sector_count - 1;
 
@@ -515,7 +531,8 @@ static struct ocf_metadata_ctrl *ocf_metadata_ctrl_init(
 
 		/* Entry size configuration */
 		raw->entry_size
-			= ocf_metadata_get_element_size(i, NULL);
+			= ocf_metadata_get_element_size(i, NULL,
+					ocf_dedup_none);
 		raw->entries_in_page = PAGE_SIZE / raw->entry_size;
 
 		/* Setup flapping support */
@@ -541,19 +558,16 @@ static struct ocf_metadata_ctrl *ocf_metadata_ctrl_init(
 }
 
 static int ocf_metadata_init_fixed_size(struct ocf_cache *cache,
-		ocf_cache_line_size_t cache_line_size)
+		ocf_cache_line_size_t cache_line_size,
+		ocf_status_granularity_t status_granularity)
 {
 	struct ocf_metadata_ctrl *ctrl = NULL;
 	struct ocf_metadata *metadata = &cache->metadata;
 	struct ocf_cache_line_settings *settings =
 		(struct ocf_cache_line_settings *)&metadata->settings;
-	struct ocf_core_meta_config *core_meta_config;
-	struct ocf_core_meta_runtime *core_meta_runtime;
 	struct ocf_user_part_config *part_config;
 	struct ocf_part_runtime_meta *part_runtime_meta;
 	struct ocf_metadata_segment *superblock;
-	ocf_core_t core;
-	ocf_core_id_t core_id;
 	uint32_t i = 0;
 	int result = 0;
 
@@ -561,7 +575,8 @@ static int ocf_metadata_init_fixed_size(struct ocf_cache *cache,
 
 	ENV_WARN_ON(metadata->priv);
 
-	ocf_metadata_config_init(cache, settings, cache_line_size);
+	ocf_metadata_config_init(cache, settings, cache_line_size,
+			status_granularity);
 
 	ctrl = ocf_metadata_ctrl_init(metadata->is_volatile);
 	if (!ctrl)
@@ -611,16 +626,7 @@ static int ocf_metadata_init_fixed_size(struct ocf_cache *cache,
 	}
 	cache->free.runtime= &part_runtime_meta[PARTITION_FREELIST].runtime;
 
-	/* Set core metadata */
-	core_meta_config = METADATA_MEM_POOL(ctrl,
-			metadata_segment_core_config);
-	core_meta_runtime = METADATA_MEM_POOL(ctrl,
-			metadata_segment_core_runtime);
-
-	for_each_core_all(cache, core, core_id) {
-		core->conf_meta = &core_meta_config[core_id];
-		core->runtime_meta = &core_meta_runtime[core_id];
-	}
+	/* Core metadata is bound to core object when its slot is allocated */
 
 	return 0;
 }
@@ -658,6 +664,8 @@ static void ocf_metadata_init_layout(struct ocf_cache *cache,
  */
 int ocf_metadata_init_variable_size(struct ocf_cache *cache,
 		uint64_t device_size, ocf_cache_line_size_t cache_line_size,
+		ocf_status_granularity_t status_granularity,
+		ocf_compression_t compression, ocf_dedup_t dedup,
 		ocf_metadata_layout_t layout)
 {
 	int result = 0;
@@ -675,8 +683,9 @@ int ocf_metadata_init_variable_size(struct ocf_cache *cache,
 
 	ctrl = cache->metadata.priv;
 
-	device_lines = device_size / cache_line_size;
-	if (device_lines >= (ocf_cache_line_t)(-1)){
+	/* Each compressed cache line takes only a slot of its size */
+	device_lines = device_size / (cache_line_size / compression);
+	if (device_lines * dedup >= (ocf_cache_line_t)(-1)){
 		/* TODO: This is just a rough check. Most optimal one would be
 		 * located in calculate_metadata_size. */
 		ocf_cache_log(cache, log_err, "Device exceeds maximum suported size "
@@ -686,9 +695,13 @@ int ocf_metadata_init_variable_size(struct ocf_cache *cache,
 
 	ctrl->device_lines = device_lines;
 
-	if (settings->size != cache_line_size)
-		/* Re-initialize settings with different cache line size */
-		ocf_metadata_config_init(cache, settings, cache_line_size);
+	if (settings->size != cache_line_size ||
+			ocf_line_sector_size(cache) != status_granularity) {
+		/* Re-initialize settings with different cache line size
+		 * or status granularity */
+		ocf_metadata_config_init(cache, settings, cache_line_size,
+				status_granularity);
+	}
 
 	ctrl->mapping_size = ocf_metadata_status_sizeof(settings)
 		+ sizeof(struct ocf_metadata_map);
@@ -714,7 +727,7 @@ int ocf_metadata_init_variable_size(struct ocf_cache *cache,
 
 		/* Entry size configuration */
 		raw->entry_size
-			= ocf_metadata_get_element_size(i, settings);
+			= ocf_metadata_get_element_size(i, settings, dedup);
 		raw->entries_in_page = PAGE_SIZE / raw->entry_size;
 
 		/* Setup flapping support */
@@ -722,10 +735,19 @@ int ocf_metadata_init_variable_size(struct ocf_cache *cache,
 	}
 
 	if (0 != ocf_metadata_calculate_metadata_size(cache, ctrl,
-			settings)) {
+			cache_line_size / compression, dedup)) {
 		return -1;
 	}
 
+	if (cache->device->separate_metadata &&
+			PAGES_TO_BYTES(ctrl->count_pages) > ocf_volume_get_length(
+					&cache->device->metadata_volume)) {
+		ocf_cache_log(cache, log_err, "Metadata volume too small, "
+				"%llu [kiB] required\n",
+				PAGES_TO_BYTES(ctrl->count_pages) / KiB);
+		return -OCF_ERR_INVAL_CACHE_DEV;
+	}
+
 	OCF_DEBUG_PARAM(cache, "Metadata begin pages = %u", ctrl->start_page);
 	OCF_DEBUG_PARAM(cache, "Metadata count pages = %u", ctrl->count_pages);
 	OCF_DEBUG_PARAM(cache, "Metadata end pages = %u", ctrl->start_page
@@ -794,19 +816,38 @@ finalize:
 			metadata_segment_sb_runtime);
 
 	cache->device->collision_table_entries = ctrl->cachelines;
+	cache->device->data_slots = ctrl->data_slots;
 
 	cache->device->hash_table_entries =
 			ctrl->raw_desc[metadata_segment_hash].entries;
 
-	cache->device->metadata_offset = ctrl->count_pages * PAGE_SIZE;
+	/* With separate metadata volume cache line data starts at the
+	 * beginning of cache volume */
+	cache->device->metadata_offset = cache->device->separate_metadata ?
+			0 : ctrl->count_pages * PAGE_SIZE;
 
 	cache->conf_meta->cachelines = ctrl->cachelines;
 	cache->conf_meta->line_size = cache_line_size;
+	cache->conf_meta->status_granularity = status_granularity;
+	cache->conf_meta->compression = compression;
+	cache->conf_meta->dedup = dedup;
+	cache->conf_meta->separate_metadata = cache->device->separate_metadata;
 
 	ocf_metadata_raw_info(cache, ctrl);
 
 	ocf_cache_log(cache, log_info, "Cache line size: %llu kiB\n",
 			settings->size / KiB);
+	ocf_cache_log(cache, log_info, "Cache line status granularity: %u B\n",
+			status_granularity);
+	if (compression != ocf_compression_none) {
+		ocf_cache_log(cache, log_info, "Cache data compression: %u:1\n",
+				compression);
+	}
+	if (dedup != ocf_dedup_none) {
+		ocf_cache_log(cache, log_info, "Cache data deduplication: "
+				"%u data slots for %u cache lines\n",
+				ctrl->data_slots, ctrl->cachelines);
+	}
 
 	ocf_cache_log(cache, log_info, "Metadata capacity: %llu MiB\n",
 			(uint64_t)ocf_metadata_size_of(cache) / MiB);
@@ -822,6 +863,14 @@ finalize:
 		return  result;
 	}
 
+	result = ocf_dedup_init(cache);
+	if (result) {
+		ocf_cache_log(cache, log_err, "Failed to initialize data "
+				"deduplication\n");
+		ocf_metadata_deinit_variable_size(cache);
+		return result;
+	}
+
 	return 0;
 }
 
@@ -834,6 +883,11 @@ static inline void _ocf_init_collision_entry(struct ocf_cache *cache,
 	ocf_metadata_set_core_info(cache, idx,
 			OCF_CORE_MAX, ULONG_MAX);
 	metadata_init_status_bits(cache, idx);
+
+	if (ocf_cache_dedup_enabled(cache)) {
+		ocf_metadata_set_data_slot(cache, idx,
+				cache->device->data_slots);
+	}
 }
 
 /*
@@ -940,6 +994,49 @@ uint64_t ocf_metadata_get_reserved_lba(
 			PAGE_SIZE;
 }
 
+void *ocf_metadata_get_reserved(ocf_cache_t cache, uint32_t *size)
+{
+	struct ocf_metadata_ctrl *ctrl;
+	struct ocf_metadata_raw *raw;
+
+	OCF_DEBUG_TRACE(cache);
+
+	ctrl = (struct ocf_metadata_ctrl *) cache->metadata.priv;
+	raw = &ctrl->raw_desc[metadata_segment_reserved];
+
+	*size = raw->entries * raw->entry_size;
+
+	return ocf_metadata_raw_get_mem(raw);
+}
+
+void ocf_metadata_flush_reserved(ocf_cache_t cache,
+		ocf_metadata_end_t cmpl, void *priv)
+{
+	struct ocf_metadata_ctrl *ctrl;
+
+	OCF_DEBUG_TRACE(cache);
+
+	ctrl = (struct ocf_metadata_ctrl *) cache->metadata.priv;
+
+	ocf_metadata_raw_flush_all(cache,
+			&ctrl->raw_desc[metadata_segment_reserved],
+			cmpl, priv, 0);
+}
+
+void ocf_metadata_load_reserved(ocf_cache_t cache,
+		ocf_metadata_end_t cmpl, void *priv)
+{
+	struct ocf_metadata_ctrl *ctrl;
+
+	OCF_DEBUG_TRACE(cache);
+
+	ctrl = (struct ocf_metadata_ctrl *) cache->metadata.priv;
+
+	ocf_metadata_raw_load_all(cache,
+			&ctrl->raw_desc[metadata_segment_reserved],
+			cmpl, priv, 0);
+}
+
 /*******************************************************************************
  * FLUSH AND LOAD ALL
  ******************************************************************************/
@@ -1265,7 +1362,8 @@ static void _recovery_rebuild_metadata(ocf_pipeline_t pipeline,
 			return;
 		}
 		if (core_id != OCF_CORE_MAX &&
-				cache->core[core_id].added &&
+				cache->core[core_id] &&
+				cache->core[core_id]->added &&
 				(!dirty_only || metadata_test_dirty(cache,
 						cline))) {
 			/* Rebuild metadata for mapped cache line */
@@ -1346,15 +1444,16 @@ static void _ocf_metadata_load_recovery_legacy(ocf_cache_t cache,
 static ocf_core_id_t _ocf_metadata_find_core_by_seq(
 		struct ocf_cache *cache, ocf_seq_no_t seq_no)
 {
-	ocf_core_t core;
 	ocf_core_id_t core_id;
 
 	if (seq_no == OCF_SEQ_NO_INVALID)
 		return OCF_CORE_ID_INVALID;
 
-	for_each_core_all(cache, core, core_id) {
-		if (core->conf_meta->seq_no == seq_no)
+	for (core_id = 0; core_id < OCF_CORE_MAX; core_id++) {
+		if (ocf_metadata_get_core_config(cache, core_id)->seq_no ==
+				seq_no) {
 			break;
+		}
 	}
 
 	return core_id;
@@ -1380,14 +1479,18 @@ static int ocf_metadata_load_atomic_metadata_drain(void *priv,
 	ocf_core_id_t core_id = OCF_CORE_ID_INVALID;
 	uint64_t core_line = 0;
 	bool core_line_ok = false;
+	uint64_t line_dev_sectors = BYTES_TO_SECTORS(ocf_line_size(cache));
 	uint32_t i;
 
 	for (i = 0; i < sector_no; i++) {
 		ctx_data_rd_check(cache->owner, &meta, data, sizeof(meta));
 
-		line = (sector_addr + i) / ocf_line_sectors(cache);
+		/* Atomic metadata is stored per 512 B sector, while status
+		 * bits may cover bigger units */
+		line = (sector_addr + i) / line_dev_sectors;
 		line = ocf_metadata_map_phy2lg(cache, line);
-		pos = (sector_addr + i) % ocf_line_sectors(cache);
+		pos = ocf_bytes_2_sectors(cache, SECTORS_TO_BYTES(
+				(sector_addr + i) % line_dev_sectors));
 		core_seq_no = meta.core_seq_no;
 		core_line = meta.core_line;
 
@@ -1395,7 +1498,7 @@ static int ocf_metadata_load_atomic_metadata_drain(void *priv,
 		core_id = _ocf_metadata_find_core_by_seq(
 				cache, core_seq_no);
 
-		if (pos == 0)
+		if ((sector_addr + i) % line_dev_sectors == 0)
 			core_line_ok = false;
 
 		if (meta.valid && core_id != OCF_CORE_ID_INVALID) {
@@ -1568,18 +1671,20 @@ void ocf_metadata_set_hash(struct ocf_cache *cache, ocf_cache_line_t index,
 bool ocf_metadata_##what(struct ocf_cache *cache, \
 	 ocf_cache_line_t line, uint8_t start, uint8_t stop, bool all) \
 { \
-	switch (cache->metadata.settings.size) { \
-		case ocf_cache_line_size_4: \
+	switch (cache->metadata.settings.sector_count) { \
+		case 1: \
+		case 2: \
+		case 4: \
+		case 8: \
 			return _ocf_metadata_##what##_u8(cache, line, start, stop, all); \
-		case ocf_cache_line_size_8: \
+		case 16: \
 			return _ocf_metadata_##what##_u16(cache, line, start, stop, all); \
-		case ocf_cache_line_size_16: \
+		case 32: \
 			return _ocf_metadata_##what##_u32(cache, line, start, stop, all); \
-		case ocf_cache_line_size_32: \
+		case 64: \
 			return _ocf_metadata_##what##_u64(cache, line, start, stop, all); \
-		case ocf_cache_line_size_64: \
+		case 128: \
 			return _ocf_metadata_##what##_u128(cache, line, start, stop, all); \
-		case ocf_cache_line_size_none: \
 		default: \
 			ENV_BUG_ON(1); \
 			return false; \
@@ -1591,49 +1696,79 @@ bool ocf_metadata_##what(struct ocf_cache *cache, \
 bool ocf_metadata_##what(struct ocf_cache *cache, \
 	 ocf_cache_line_t line, uint8_t start, uint8_t stop) \
 { \
-	switch (cache->metadata.settings.size) { \
-		case ocf_cache_line_size_4: \
+	switch (cache->metadata.settings.sector_count) { \
+		case 1: \
+		case 2: \
+		case 4: \
+		case 8: \
 			return _ocf_metadata_##what##_u8(cache, line, start, stop); \
-		case ocf_cache_line_size_8: \
+		case 16: \
 			return _ocf_metadata_##what##_u16(cache, line, start, stop); \
-		case ocf_cache_line_size_16: \
+		case 32: \
 			return _ocf_metadata_##what##_u32(cache, line, start, stop); \
-		case ocf_cache_line_size_32: \
+		case 64: \
 			return _ocf_metadata_##what##_u64(cache, line, start, stop); \
-		case ocf_cache_line_size_64: \
+		case 128: \
 			return _ocf_metadata_##what##_u128(cache, line, start, stop); \
-		case ocf_cache_line_size_none: \
 		default: \
 			ENV_BUG_ON(1); \
 			return false; \
 	} \
 } \
 
+#define _ocf_metadata_funcs_run(what) \
+uint8_t ocf_metadata_##what##_run(struct ocf_cache *cache, \
+	 ocf_cache_line_t line, uint8_t start, uint8_t stop, bool *set) \
+{ \
+	switch (cache->metadata.settings.sector_count) { \
+		case 1: \
+		case 2: \
+		case 4: \
+		case 8: \
+			return _ocf_metadata_##what##_run_u8(cache, line, start, stop, set); \
+		case 16: \
+			return _ocf_metadata_##what##_run_u16(cache, line, start, stop, set); \
+		case 32: \
+			return _ocf_metadata_##what##_run_u32(cache, line, start, stop, set); \
+		case 64: \
+			return _ocf_metadata_##what##_run_u64(cache, line, start, stop, set); \
+		case 128: \
+			return _ocf_metadata_##what##_run_u128(cache, line, start, stop, set); \
+		default: \
+			ENV_BUG_ON(1); \
+			return 0; \
+	} \
+} \
+
 #define _ocf_metadata_funcs(what) \
 	_ocf_metadata_funcs_5arg(test_##what) \
 	_ocf_metadata_funcs_4arg(test_out_##what) \
 	_ocf_metadata_funcs_4arg(clear_##what) \
 	_ocf_metadata_funcs_4arg(set_##what) \
 	_ocf_metadata_funcs_5arg(test_and_set_##what) \
-	_ocf_metadata_funcs_5arg(test_and_clear_##what)
+	_ocf_metadata_funcs_5arg(test_and_clear_##what) \
+	_ocf_metadata_funcs_run(what)
 
 _ocf_metadata_funcs(dirty)
 _ocf_metadata_funcs(valid)
+_ocf_metadata_funcs(zero)
 
 bool ocf_metadata_check(struct ocf_cache *cache, ocf_cache_line_t line)
 {
-	switch (cache->metadata.settings.size) {
-		case ocf_cache_line_size_4:
+	switch (cache->metadata.settings.sector_count) {
+		case 1:
+		case 2:
+		case 4:
+		case 8:
 			return _ocf_metadata_check_u8(cache, line);
-		case ocf_cache_line_size_8:
+		case 16:
 			return _ocf_metadata_check_u16(cache, line);
-		case ocf_cache_line_size_16:
+		case 32:
 			return _ocf_metadata_check_u32(cache, line);
-		case ocf_cache_line_size_32:
+		case 64:
 			return _ocf_metadata_check_u64(cache, line);
-		case ocf_cache_line_size_64:
+		case 128:
 			return _ocf_metadata_check_u128(cache, line);
-		case ocf_cache_line_size_none:
 		default:
 			ENV_BUG_ON(1);
 			return false;
@@ -1641,13 +1776,15 @@ bool ocf_metadata_check(struct ocf_cache *cache, ocf_cache_line_t line)
 }
 
 int ocf_metadata_init(struct ocf_cache *cache,
-		ocf_cache_line_size_t cache_line_size)
+		ocf_cache_line_size_t cache_line_size,
+		ocf_status_granularity_t status_granularity)
 {
 	int ret;
 
 	OCF_DEBUG_TRACE(cache);
 
-	ret = ocf_metadata_init_fixed_size(cache, cache_line_size);
+	ret = ocf_metadata_init_fixed_size(cache, cache_line_size,
+			status_granularity);
 	if (ret)
 		return ret;
 
@@ -1741,6 +1878,8 @@ static int ocf_metadata_read_sb(ocf_ctx_t ctx, ocf_volume_t volume,
 		goto err_io;
 	}
 
+	ocf_io_set_origin(io, ocf_io_origin_metadata);
+
 	data = ctx_data_alloc(ctx, sb_pages);
 	if (!data) {
 		ocf_log(ctx, log_err, "Memory allocation error");
@@ -1798,6 +1937,10 @@ static void ocf_metadata_load_properties_cmpl(
 		OCF_CMPL_RET(priv, ret, NULL);
 
 	properties.line_size = superblock->line_size;
+	properties.status_granularity = superblock->status_granularity;
+	properties.compression = superblock->compression;
+	properties.dedup = superblock->dedup;
+	properties.separate_metadata = superblock->separate_metadata;
 	properties.layout = superblock->metadata_layout;
 	properties.cache_mode = superblock->cache_mode;
 	properties.shutdown_status = superblock->clean_shutdown;
@@ -1810,7 +1953,7 @@ static void ocf_metadata_load_properties_cmpl(
 void ocf_metadata_load_properties(ocf_cache_t cache,
 		ocf_metadata_load_properties_end_t cmpl, void *priv)
 {
-	ocf_volume_t volume = &cache->device->volume;
+	ocf_volume_t volume = ocf_cache_get_metadata_volume(cache);
 	struct ocf_metadata_load_properties_ctx *context;
 	int result;
 
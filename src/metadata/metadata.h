@@ -23,16 +23,19 @@
 #define VALID 1
 #define CLEAN 2
 #define DIRTY 3
+#define ZERO 4
 
 /**
  * @brief Initialize metadata
  *
  * @param cache - Cache instance
  * @param cache_line_size Cache line size
+ * @param status_granularity Cache line status granularity
  * @return 0 - Operation success otherwise failure
  */
 int ocf_metadata_init(struct ocf_cache *cache,
-		ocf_cache_line_size_t cache_line_size);
+		ocf_cache_line_size_t cache_line_size,
+		ocf_status_granularity_t status_granularity);
 
 /**
  * @brief Initialize per-cacheline metadata
@@ -40,10 +43,15 @@ int ocf_metadata_init(struct ocf_cache *cache,
  * @param cache - Cache instance
  * @param device_size - Device size in bytes
  * @param cache_line_size Cache line size
+ * @param status_granularity Cache line status granularity
+ * @param compression Cache data compression ratio
+ * @param dedup Cache data deduplication factor
  * @return 0 - Operation success otherwise failure
  */
 int ocf_metadata_init_variable_size(struct ocf_cache *cache,
 		uint64_t device_size, ocf_cache_line_size_t cache_line_size,
+		ocf_status_granularity_t status_granularity,
+		ocf_compression_t compression, ocf_dedup_t dedup,
 		ocf_metadata_layout_t layout);
 
 /**
@@ -182,6 +190,34 @@ void ocf_metadata_load_recovery(ocf_cache_t cache,
  */
 uint64_t ocf_metadata_get_reserved_lba(ocf_cache_t cache);
 
+/**
+ * @brief Get reserved area memory
+ *
+ * @param cache Cache instance
+ * @param[out] size Size of reserved area in bytes
+ */
+void *ocf_metadata_get_reserved(ocf_cache_t cache, uint32_t *size);
+
+/**
+ * @brief Flush reserved area
+ *
+ * @param cache Cache instance
+ * @param cmpl Completion callback
+ * @param priv Completion context
+ */
+void ocf_metadata_flush_reserved(ocf_cache_t cache,
+		ocf_metadata_end_t cmpl, void *priv);
+
+/**
+ * @brief Load reserved area
+ *
+ * @param cache Cache instance
+ * @param cmpl Completion callback
+ * @param priv Completion context
+ */
+void ocf_metadata_load_reserved(ocf_cache_t cache,
+		ocf_metadata_end_t cmpl, void *priv);
+
 /*
  * NOTE Hash table is specific for hash table metadata service implementation
  * and should be used internally by metadata service.
@@ -201,6 +237,10 @@ struct ocf_metadata_load_properties {
 	ocf_metadata_layout_t layout;
 	ocf_cache_mode_t cache_mode;
 	ocf_cache_line_size_t line_size;
+	ocf_status_granularity_t status_granularity;
+	ocf_compression_t compression;
+	ocf_dedup_t dedup;
+	bool separate_metadata;
 	char *cache_name;
 };
 
@@ -44,11 +44,78 @@ static inline u128 _get_mask_u128(uint8_t start, uint8_t stop)
 	return mask;
 }
 
+/*******************************************************************************
+ * Sector run getter
+ ******************************************************************************/
+
+/*
+ * Returns length of run of bits equal to bit at position start, limited
+ * to range <start, stop>. Value of the bits in the run is returned in *set.
+ */
+static inline uint8_t _get_run(uint64_t bits, uint8_t start, uint8_t stop,
+		bool *set)
+{
+	uint8_t len;
+
+	ENV_BUG_ON(stop >= 64);
+	ENV_BUG_ON(stop < start);
+
+	bits >>= start;
+	*set = bits & 1;
+	if (*set)
+		bits = ~bits;
+
+	len = bits ? env_ctz64(bits) : 64;
+
+	return len < stop - start + 1 ? len : stop - start + 1;
+}
+
+#define _get_run_u8(bits, start, stop, set) _get_run(bits, start, stop, set)
+#define _get_run_u16(bits, start, stop, set) _get_run(bits, start, stop, set)
+#define _get_run_u32(bits, start, stop, set) _get_run(bits, start, stop, set)
+#define _get_run_u64(bits, start, stop, set) _get_run(bits, start, stop, set)
+
+static inline uint8_t _get_run_u128(u128 bits, uint8_t start, uint8_t stop,
+		bool *set)
+{
+	uint64_t lo, hi;
+	uint8_t len;
+
+	ENV_BUG_ON(stop >= 128);
+	ENV_BUG_ON(stop < start);
+
+	bits >>= start;
+	*set = bits & 1;
+	if (*set)
+		bits = ~bits;
+
+	lo = bits;
+	hi = bits >> 64;
+
+	if (lo)
+		len = env_ctz64(lo);
+	else if (hi)
+		len = 64 + env_ctz64(hi);
+	else
+		len = 128;
+
+	return len < stop - start + 1 ? len : stop - start + 1;
+}
+
+/*
+ * Collision entry of deduplicated cache line is followed by its data slot,
+ * so entry size is taken from RAW descriptor instead of status structure
+ */
+#define ocf_metadata_bit_map(raw, line) \
+	((void *)((uint8_t *)(raw)->mem_pool + \
+			(uint64_t)(raw)->entry_size * (line)))
+
 #define ocf_metadata_bit_struct(type) \
 struct ocf_metadata_map_##type { \
 	struct ocf_metadata_map map; \
 	type valid; \
 	type dirty; \
+	type zero; \
 } __attribute__((packed))
 
 #define ocf_metadata_bit_func(what, type) \
@@ -63,18 +130,18 @@ static bool _ocf_metadata_test_##what##_##type(struct ocf_cache *cache, \
 	struct ocf_metadata_raw *raw = \
 			&ctrl->raw_desc[metadata_segment_collision]; \
 \
-	const struct ocf_metadata_map_##type *map = raw->mem_pool; \
+	const struct ocf_metadata_map_##type *map = ocf_metadata_bit_map(raw, line); \
 \
 	_raw_bug_on(raw, line); \
 \
 	if (all) { \
-		if (mask == (map[line].what & mask)) { \
+		if (mask == (map->what & mask)) { \
 			return true; \
 		} else { \
 			return false; \
 		} \
 	} else { \
-		if (map[line].what & mask) { \
+		if (map->what & mask) { \
 			return true; \
 		} else { \
 			return false; \
@@ -93,11 +160,11 @@ static bool _ocf_metadata_test_out_##what##_##type(struct ocf_cache *cache, \
 	struct ocf_metadata_raw *raw = \
 			&ctrl->raw_desc[metadata_segment_collision]; \
 \
-	const struct ocf_metadata_map_##type *map = raw->mem_pool; \
+	const struct ocf_metadata_map_##type *map = ocf_metadata_bit_map(raw, line); \
 \
 	_raw_bug_on(raw, line); \
 \
-	if (map[line].what & ~mask) { \
+	if (map->what & ~mask) { \
 		return true; \
 	} else { \
 		return false; \
@@ -115,13 +182,13 @@ static bool _ocf_metadata_clear_##what##_##type(struct ocf_cache *cache, \
 	struct ocf_metadata_raw *raw = \
 			&ctrl->raw_desc[metadata_segment_collision]; \
 \
-	struct ocf_metadata_map_##type *map = raw->mem_pool; \
+	struct ocf_metadata_map_##type *map = ocf_metadata_bit_map(raw, line); \
 \
 	_raw_bug_on(raw, line); \
 \
-	map[line].what &= ~mask; \
+	map->what &= ~mask; \
 \
-	if (map[line].what) { \
+	if (map->what) { \
 		return true; \
 	} else { \
 		return false; \
@@ -140,13 +207,13 @@ static bool _ocf_metadata_set_##what##_##type(struct ocf_cache *cache, \
 	struct ocf_metadata_raw *raw = \
 			&ctrl->raw_desc[metadata_segment_collision]; \
 \
-	struct ocf_metadata_map_##type *map = raw->mem_pool; \
+	struct ocf_metadata_map_##type *map = ocf_metadata_bit_map(raw, line); \
 \
 	_raw_bug_on(raw, line); \
 \
-	result = map[line].what ? true : false; \
+	result = map->what ? true : false; \
 \
-	map[line].what |= mask; \
+	map->what |= mask; \
 \
 	return result; \
 } \
@@ -164,25 +231,25 @@ static bool _ocf_metadata_test_and_set_##what##_##type( \
 	struct ocf_metadata_raw *raw = \
 			&ctrl->raw_desc[metadata_segment_collision]; \
 \
-	struct ocf_metadata_map_##type *map = raw->mem_pool; \
+	struct ocf_metadata_map_##type *map = ocf_metadata_bit_map(raw, line); \
 \
 	_raw_bug_on(raw, line); \
 \
 	if (all) { \
-		if (mask == (map[line].what & mask)) { \
+		if (mask == (map->what & mask)) { \
 			test = true; \
 		} else { \
 			test = false; \
 		} \
 	} else { \
-		if (map[line].what & mask) { \
+		if (map->what & mask) { \
 			test = true; \
 		} else { \
 			test = false; \
 		} \
 	} \
 \
-	map[line].what |= mask; \
+	map->what |= mask; \
 	return test; \
 } \
 \
@@ -199,25 +266,25 @@ static bool _ocf_metadata_test_and_clear_##what##_##type( \
 	struct ocf_metadata_raw *raw = \
 			&ctrl->raw_desc[metadata_segment_collision]; \
 \
-	struct ocf_metadata_map_##type *map = raw->mem_pool; \
+	struct ocf_metadata_map_##type *map = ocf_metadata_bit_map(raw, line); \
 \
 	_raw_bug_on(raw, line); \
 \
 	if (all) { \
-		if (mask == (map[line].what & mask)) { \
+		if (mask == (map->what & mask)) { \
 			test = true; \
 		} else { \
 			test = false; \
 		} \
 	} else { \
-		if (map[line].what & mask) { \
+		if (map->what & mask) { \
 			test = true; \
 		} else { \
 			test = false; \
 		} \
 	} \
 \
-	map[line].what &= ~mask; \
+	map->what &= ~mask; \
 	return test; \
 } \
 
@@ -232,12 +299,30 @@ static bool _ocf_metadata_check_##type(struct ocf_cache *cache, \
 	struct ocf_metadata_raw *raw = \
 			&ctrl->raw_desc[metadata_segment_collision]; \
 \
-	const struct ocf_metadata_map_##type *map = raw->mem_pool; \
+	const struct ocf_metadata_map_##type *map = ocf_metadata_bit_map(raw, line); \
+\
+	_raw_bug_on(raw, line); \
+\
+	/* dirty and zero bits must have valid bit set */ \
+	return (map->dirty & (~map->valid)) == 0 && \
+			(map->zero & (~map->valid)) == 0; \
+} \
+
+#define ocf_metadata_bit_run_func(what, type) \
+static uint8_t _ocf_metadata_##what##_run_##type(struct ocf_cache *cache, \
+		ocf_cache_line_t line, uint8_t start, uint8_t stop, bool *set) \
+{ \
+	struct ocf_metadata_ctrl *ctrl = \
+		(struct ocf_metadata_ctrl *) cache->metadata.priv; \
+\
+	struct ocf_metadata_raw *raw = \
+			&ctrl->raw_desc[metadata_segment_collision]; \
+\
+	const struct ocf_metadata_map_##type *map = ocf_metadata_bit_map(raw, line); \
 \
 	_raw_bug_on(raw, line); \
 \
-	/* dirty bits must have valid bit set */ \
-	return (map[line].dirty & (~map[line].valid)) == 0; \
+	return _get_run_##type(map->what, start, stop, set); \
 } \
 
 ocf_metadata_bit_struct(u8);
@@ -258,8 +343,32 @@ ocf_metadata_bit_func(valid, u32);
 ocf_metadata_bit_func(valid, u64);
 ocf_metadata_bit_func(valid, u128);
 
+ocf_metadata_bit_func(zero, u8);
+ocf_metadata_bit_func(zero, u16);
+ocf_metadata_bit_func(zero, u32);
+ocf_metadata_bit_func(zero, u64);
+ocf_metadata_bit_func(zero, u128);
+
 ocf_metadata_bit_check_func(u8);
 ocf_metadata_bit_check_func(u16);
 ocf_metadata_bit_check_func(u32);
 ocf_metadata_bit_check_func(u64);
 ocf_metadata_bit_check_func(u128);
+
+ocf_metadata_bit_run_func(dirty, u8);
+ocf_metadata_bit_run_func(dirty, u16);
+ocf_metadata_bit_run_func(dirty, u32);
+ocf_metadata_bit_run_func(dirty, u64);
+ocf_metadata_bit_run_func(dirty, u128);
+
+ocf_metadata_bit_run_func(valid, u8);
+ocf_metadata_bit_run_func(valid, u16);
+ocf_metadata_bit_run_func(valid, u32);
+ocf_metadata_bit_run_func(valid, u64);
+ocf_metadata_bit_run_func(valid, u128);
+
+ocf_metadata_bit_run_func(zero, u8);
+ocf_metadata_bit_run_func(zero, u16);
+ocf_metadata_bit_run_func(zero, u32);
+ocf_metadata_bit_run_func(zero, u64);
+ocf_metadata_bit_run_func(zero, u128);
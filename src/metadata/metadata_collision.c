@@ -7,6 +7,7 @@
 #include "metadata.h"
 #include "metadata_internal.h"
 #include "../utils/utils_cache_line.h"
+#include "../utils/utils_dedup.h"
 
 static ocf_cache_line_t ocf_metadata_map_lg2phy_seq(
 		struct ocf_cache *cache, ocf_cache_line_t coll_idx)
@@ -145,6 +146,49 @@ ocf_cache_line_t ocf_metadata_map_phy2lg(
 	}
 }
 
+/*
+ * Data slot of deduplicated cache line is stored in collision entry right
+ * after its status bits
+ */
+ocf_cache_line_t ocf_metadata_get_data_slot(
+		struct ocf_cache *cache, ocf_cache_line_t line)
+{
+	const uint8_t *entry;
+	ocf_cache_line_t slot;
+	struct ocf_metadata_ctrl *ctrl =
+		(struct ocf_metadata_ctrl *) cache->metadata.priv;
+
+	entry = ocf_metadata_raw_rd_access(cache,
+			&(ctrl->raw_desc[metadata_segment_collision]), line);
+	if (!entry) {
+		ocf_metadata_error(cache);
+		return cache->device->data_slots;
+	}
+
+	ENV_BUG_ON(env_memcpy(&slot, sizeof(slot), entry + ctrl->mapping_size,
+			sizeof(slot)));
+
+	return slot;
+}
+
+void ocf_metadata_set_data_slot(struct ocf_cache *cache,
+		ocf_cache_line_t line, ocf_cache_line_t slot)
+{
+	uint8_t *entry;
+	struct ocf_metadata_ctrl *ctrl =
+		(struct ocf_metadata_ctrl *) cache->metadata.priv;
+
+	entry = ocf_metadata_raw_wr_access(cache,
+			&(ctrl->raw_desc[metadata_segment_collision]), line);
+
+	if (entry) {
+		ENV_BUG_ON(env_memcpy(entry + ctrl->mapping_size,
+				sizeof(slot), &slot, sizeof(slot)));
+	} else {
+		ocf_metadata_error(cache);
+	}
+}
+
 void ocf_metadata_set_collision_info(struct ocf_cache *cache,
 		ocf_cache_line_t line, ocf_cache_line_t next,
 		ocf_cache_line_t prev)
@@ -302,6 +346,9 @@ void ocf_metadata_remove_from_collision(struct ocf_cache *cache,
 
 	ocf_metadata_set_core_info(cache, line,
 			OCF_CORE_MAX, ULLONG_MAX);
+
+	if (ocf_cache_dedup_enabled(cache))
+		ocf_dedup_put_line(cache, line);
 }
 
 /* must be called under global metadata read(shared) lock */
@@ -40,6 +40,12 @@ ocf_cache_line_t ocf_metadata_map_lg2phy(
 ocf_cache_line_t ocf_metadata_map_phy2lg(
 		struct ocf_cache *cache, ocf_cache_line_t cache_line);
 
+ocf_cache_line_t ocf_metadata_get_data_slot(
+		struct ocf_cache *cache, ocf_cache_line_t line);
+
+void ocf_metadata_set_data_slot(struct ocf_cache *cache,
+		ocf_cache_line_t line, ocf_cache_line_t slot);
+
 void ocf_metadata_set_collision_info(
 		struct ocf_cache *cache, ocf_cache_line_t line,
 		ocf_cache_line_t next, ocf_cache_line_t prev);
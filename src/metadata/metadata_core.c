@@ -80,3 +80,25 @@ struct ocf_metadata_uuid *ocf_metadata_get_core_uuid(
 
 	return muuid;
 }
+
+struct ocf_core_meta_config *ocf_metadata_get_core_config(
+		struct ocf_cache *cache, ocf_core_id_t core_id)
+{
+	struct ocf_metadata_ctrl *ctrl =
+		(struct ocf_metadata_ctrl *) cache->metadata.priv;
+	struct ocf_core_meta_config *core_meta_config =
+		METADATA_MEM_POOL(ctrl, metadata_segment_core_config);
+
+	return &core_meta_config[core_id];
+}
+
+struct ocf_core_meta_runtime *ocf_metadata_get_core_runtime(
+		struct ocf_cache *cache, ocf_core_id_t core_id)
+{
+	struct ocf_metadata_ctrl *ctrl =
+		(struct ocf_metadata_ctrl *) cache->metadata.priv;
+	struct ocf_core_meta_runtime *core_meta_runtime =
+		METADATA_MEM_POOL(ctrl, metadata_segment_core_runtime);
+
+	return &core_meta_runtime[core_id];
+}
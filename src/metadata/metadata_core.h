@@ -22,6 +22,12 @@ ocf_core_id_t ocf_metadata_get_core_id(
 struct ocf_metadata_uuid *ocf_metadata_get_core_uuid(
 		struct ocf_cache *cache, ocf_core_id_t core_id);
 
+struct ocf_core_meta_config *ocf_metadata_get_core_config(
+		struct ocf_cache *cache, ocf_core_id_t core_id);
+
+struct ocf_core_meta_runtime *ocf_metadata_get_core_runtime(
+		struct ocf_cache *cache, ocf_core_id_t core_id);
+
 void ocf_metadata_get_core_and_part_id(
 		struct ocf_cache *cache, ocf_cache_line_t line,
 		ocf_core_id_t *core_id, ocf_part_id_t *part_id);
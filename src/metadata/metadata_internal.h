@@ -19,6 +19,7 @@
  */
 struct ocf_metadata_ctrl {
 	ocf_cache_line_t cachelines;
+	ocf_cache_line_t data_slots;
 	ocf_cache_line_t start_page;
 	ocf_cache_line_t count_pages;
 	uint32_t device_lines;
@@ -123,6 +123,7 @@ int metadata_io_read_i_atomic_step(struct ocf_request *req)
 	}
 
 	/* Setup IO */
+	ocf_io_set_origin(io, ocf_io_origin_metadata);
 	ocf_io_set_cmpl(io, context, NULL, metadata_io_read_i_atomic_step_end);
 	result = ocf_io_set_data(io, context->data, 0);
 	if (result) {
@@ -151,7 +152,7 @@ int metadata_io_read_i_atomic(ocf_cache_t cache, ocf_queue_t queue, void *priv,
 {
 	struct metadata_io_read_i_atomic_context *context;
 	uint64_t io_sectors_count = cache->device->collision_table_entries *
-					ocf_line_sectors(cache);
+			BYTES_TO_SECTORS(ocf_line_size(cache));
 
 	OCF_DEBUG_TRACE(cache);
 
@@ -238,7 +239,7 @@ static int metadata_io_do(struct ocf_request *req)
 				 m_req->page % OCF_NUM_GLOBAL_META_LOCKS);
 	}
 
-	io = ocf_new_cache_io(cache, req->io_queue,
+	io = ocf_new_metadata_io(cache, req->io_queue,
 			PAGES_TO_BYTES(m_req->page),
 			PAGES_TO_BYTES(m_req->count),
 			m_req->req.rw, 0, m_req->asynch->flags);
@@ -355,7 +356,7 @@ void metadata_io_req_end(struct metadata_io_request *m_req)
 static uint32_t metadata_io_max_page(ocf_cache_t cache)
 {
 	uint32_t volume_max_io_pages = ocf_volume_get_max_io_size(
-			&cache->device->volume) / PAGE_SIZE;
+			ocf_cache_get_metadata_volume(cache)) / PAGE_SIZE;
 	struct metadata_io_request *m_req;
 	uint32_t request_map_capacity_pages = sizeof(m_req->alock_status) * 8;
 
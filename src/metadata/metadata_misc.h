@@ -6,19 +6,26 @@
 #ifndef __METADATA_MISC_H__
 #define __METADATA_MISC_H__
 
+/* Multiplier spreading start offsets of cores over hash table (2^32 / phi) */
+#define OCF_METADATA_HASH_CORE_SPREAD 0x9E3779B9ULL
+
 /* Hash function intentionally returns consecutive (modulo @hash_table_entries)
  * values for consecutive @core_line_num. This way it is trivial to sort all
  * core lines within a single request in ascending hash value order. This kind
  * of sorting is required to assure that (future) hash bucket metadata locks are
  * always acquired in fixed order, eliminating the risk of dead locks.
+ *
+ * Each core starts at its own offset within hash table. Offsets are spread
+ * multiplicatively, so that beginnings of many small cores don't collide
+ * regardless of core count.
  */
 static inline ocf_cache_line_t ocf_metadata_hash_func(ocf_cache_t cache,
 		uint64_t core_line_num, ocf_core_id_t core_id)
 {
 	const unsigned int entries = cache->device->hash_table_entries;
 
-	return (ocf_cache_line_t) ((core_line_num  + (core_id * (entries / 32)))
-			% entries);
+	return (ocf_cache_line_t) ((core_line_num +
+			core_id * OCF_METADATA_HASH_CORE_SPREAD) % entries);
 }
 
 void ocf_metadata_remove_cache_line(struct ocf_cache *cache,
@@ -26,6 +26,8 @@ struct ocf_user_part_config {
 	} flags;
 	int16_t priority;
 	ocf_cache_mode_t cache_mode;
+	struct ocf_io_class_promotion promotion;
+	uint32_t seq_cutoff_threshold;
 };
 
 struct ocf_part_runtime {
@@ -354,7 +354,7 @@ static void _raw_ram_flush_mark(ocf_cache_t cache,
 		struct ocf_request *req, uint32_t map_idx, int to_state,
 		uint8_t start, uint8_t stop)
 {
-	if (to_state == DIRTY || to_state == CLEAN) {
+	if (to_state == DIRTY || to_state == CLEAN || to_state == ZERO) {
 		req->map[map_idx].flush = true;
 		req->info.flush_metadata = true;
 	}
@@ -78,6 +78,8 @@ static int _raw_atomic_io_discard_do(struct ocf_cache *cache, void *context,
 		return req->error;
 	}
 
+	ocf_io_set_origin(io, ocf_io_origin_metadata);
+
 	OCF_DEBUG_PARAM(cache, "Page to flushing = %u, count of pages = %u",
 			start_line, len);
 
@@ -126,9 +128,9 @@ static int _raw_atomic_flush_do_asynch_sec(struct ocf_cache *cache,
 	start_addr *= ocf_line_size(cache);
 	start_addr += cache->device->metadata_offset;
 
-	start_addr += SECTORS_TO_BYTES(map->start_flush);
-	len = SECTORS_TO_BYTES(map->stop_flush - map->start_flush);
-	len += SECTORS_TO_BYTES(1);
+	start_addr += ocf_sectors_2_bytes(cache, map->start_flush);
+	len = ocf_sectors_2_bytes(cache, map->stop_flush - map->start_flush);
+	len += ocf_line_sector_size(cache);
 
 	result = _raw_atomic_io_discard_do(cache, req, start_addr, len, ctx);
 
@@ -339,7 +339,7 @@ static int raw_dynamic_load_all_read(struct ocf_request *req)
 	count = metadata_io_size(context->i, raw->ssd_pages);
 
 	/* Allocate IO */
-	context->io = ocf_new_cache_io(context->cache, req->io_queue,
+	context->io = ocf_new_metadata_io(context->cache, req->io_queue,
 		PAGES_TO_BYTES(ssd_pages_offset + context->i),
 		PAGES_TO_BYTES(count), OCF_READ, 0, 0);
 
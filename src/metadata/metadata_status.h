@@ -18,6 +18,7 @@ bool ocf_metadata_clear_dirty(struct ocf_cache *cache, ocf_cache_line_t line, ui
 bool ocf_metadata_set_dirty(struct ocf_cache *cache, ocf_cache_line_t line, uint8_t start, uint8_t stop);
 bool ocf_metadata_test_and_set_dirty(struct ocf_cache *cache, ocf_cache_line_t line, uint8_t start, uint8_t stop, bool all);
 bool ocf_metadata_test_and_clear_dirty(struct ocf_cache *cache, ocf_cache_line_t line, uint8_t start, uint8_t stop, bool all);
+uint8_t ocf_metadata_dirty_run(struct ocf_cache *cache, ocf_cache_line_t line, uint8_t start, uint8_t stop, bool *set);
 
 bool ocf_metadata_test_valid(struct ocf_cache *cache, ocf_cache_line_t line, uint8_t start, uint8_t stop, bool all);
 bool ocf_metadata_test_out_valid(struct ocf_cache *cache, ocf_cache_line_t line, uint8_t start, uint8_t stop);
@@ -25,6 +26,15 @@ bool ocf_metadata_clear_valid(struct ocf_cache *cache, ocf_cache_line_t line, ui
 bool ocf_metadata_set_valid(struct ocf_cache *cache, ocf_cache_line_t line, uint8_t start, uint8_t stop);
 bool ocf_metadata_test_and_set_valid(struct ocf_cache *cache, ocf_cache_line_t line, uint8_t start, uint8_t stop, bool all);
 bool ocf_metadata_test_and_clear_valid(struct ocf_cache *cache, ocf_cache_line_t line, uint8_t start, uint8_t stop, bool all);
+uint8_t ocf_metadata_valid_run(struct ocf_cache *cache, ocf_cache_line_t line, uint8_t start, uint8_t stop, bool *set);
+
+bool ocf_metadata_test_zero(struct ocf_cache *cache, ocf_cache_line_t line, uint8_t start, uint8_t stop, bool all);
+bool ocf_metadata_test_out_zero(struct ocf_cache *cache, ocf_cache_line_t line, uint8_t start, uint8_t stop);
+bool ocf_metadata_clear_zero(struct ocf_cache *cache, ocf_cache_line_t line, uint8_t start, uint8_t stop);
+bool ocf_metadata_set_zero(struct ocf_cache *cache, ocf_cache_line_t line, uint8_t start, uint8_t stop);
+bool ocf_metadata_test_and_set_zero(struct ocf_cache *cache, ocf_cache_line_t line, uint8_t start, uint8_t stop, bool all);
+bool ocf_metadata_test_and_clear_zero(struct ocf_cache *cache, ocf_cache_line_t line, uint8_t start, uint8_t stop, bool all);
+uint8_t ocf_metadata_zero_run(struct ocf_cache *cache, ocf_cache_line_t line, uint8_t start, uint8_t stop, bool *set);
 
 static inline void metadata_init_status_bits(struct ocf_cache *cache,
 		ocf_cache_line_t line)
@@ -35,6 +45,9 @@ static inline void metadata_init_status_bits(struct ocf_cache *cache,
 	ocf_metadata_clear_valid(cache, line,
 			cache->metadata.settings.sector_start,
 			cache->metadata.settings.sector_end);
+	ocf_metadata_clear_zero(cache, line,
+			cache->metadata.settings.sector_start,
+			cache->metadata.settings.sector_end);
 }
 
 static inline bool metadata_test_dirty_all(struct ocf_cache *cache,
@@ -327,4 +340,42 @@ static inline bool metadata_clear_valid_sec_changed(
 	return was_any_valid && !*is_valid;
 }
 
+/*******************************************************************************
+ * Zero - Sector Implementation
+ *
+ * Zero sectors are valid sectors which hold all-zero data. Their content is
+ * not stored on cache device.
+ ******************************************************************************/
+
+static inline bool metadata_test_zero_sec(struct ocf_cache *cache,
+		ocf_cache_line_t line, uint8_t start, uint8_t stop)
+{
+	return ocf_metadata_test_zero(cache, line, start, stop, true);
+}
+
+static inline bool metadata_test_zero_any_sec(struct ocf_cache *cache,
+		ocf_cache_line_t line, uint8_t start, uint8_t stop)
+{
+	return ocf_metadata_test_zero(cache, line, start, stop, false);
+}
+
+static inline bool metadata_set_zero_sec_changed(struct ocf_cache *cache,
+		ocf_cache_line_t line, uint8_t start, uint8_t stop)
+{
+	return !ocf_metadata_test_and_set_zero(cache, line, start, stop, true);
+}
+
+static inline void metadata_clear_zero_sec(struct ocf_cache *cache,
+		ocf_cache_line_t line, uint8_t start, uint8_t stop)
+{
+	ocf_metadata_clear_zero(cache, line, start, stop);
+}
+
+static inline bool metadata_clear_zero_sec_changed(struct ocf_cache *cache,
+		ocf_cache_line_t line, uint8_t start, uint8_t stop)
+{
+	return ocf_metadata_test_and_clear_zero(cache, line, start, stop,
+			false);
+}
+
 #endif /* METADATA_STATUS_H_ */
@@ -38,6 +38,7 @@ typedef void (*ocf_metadata_query_cores_end_t)(void *priv, int error,
 
 struct ocf_cache_line_settings {
 	ocf_cache_line_size_t size;
+	uint64_t sector_shift;
 	uint64_t sector_count;
 	uint64_t sector_start;
 	uint64_t sector_end;
@@ -168,11 +168,35 @@ int ocf_metadata_validate_superblock(ocf_cache_t cache,
 		return -OCF_ERR_INVAL;
 	}
 
+	if (!ocf_status_granularity_is_valid(superblock->status_granularity) ||
+			!ocf_status_granularity_fits(superblock->line_size,
+				superblock->status_granularity)) {
+		ocf_log_invalid_superblock("status granularity");
+		return -OCF_ERR_INVAL;
+	}
+
+	if (!ocf_compression_is_valid(superblock->compression) ||
+			!ocf_compression_fits(superblock->status_granularity,
+				superblock->compression)) {
+		ocf_log_invalid_superblock("compression");
+		return -OCF_ERR_INVAL;
+	}
+
+	if (!ocf_dedup_is_valid(superblock->dedup)) {
+		ocf_log_invalid_superblock("deduplication");
+		return -OCF_ERR_INVAL;
+	}
+
 	if ((unsigned)superblock->metadata_layout >= ocf_metadata_layout_max) {
 		ocf_log_invalid_superblock("metadata layout");
 		return -OCF_ERR_INVAL;
 	}
 
+	if (superblock->separate_metadata > 1) {
+		ocf_log_invalid_superblock("metadata volume");
+		return -OCF_ERR_INVAL;
+	}
+
 	if (superblock->core_count > OCF_CORE_MAX) {
 		ocf_log_invalid_superblock("core count");
 		return -OCF_ERR_INVAL;
@@ -224,6 +248,15 @@ static void ocf_metadata_load_superblock_post(ocf_pipeline_t pipeline,
 	ocf_core_t core;
 	ocf_core_id_t core_id;
 
+	/* Allocate objects of cores saved in metadata */
+	for (core_id = 0; core_id < OCF_CORE_MAX; core_id++) {
+		if (!ocf_metadata_get_core_config(cache, core_id)->valid)
+			continue;
+
+		if (!ocf_core_slot_alloc(cache, core_id))
+			OCF_PL_FINISH_RET(pipeline, -OCF_ERR_NO_MEM);
+	}
+
 	for_each_core_metadata(cache, core, core_id) {
 		muuid = ocf_metadata_get_core_uuid(cache, core_id);
 		uuid.data = muuid->data;
@@ -466,7 +499,7 @@ static void ocf_metadata_flush_disk(ocf_pipeline_t pipeline,
 	struct ocf_metadata_context *context = priv;
 	ocf_cache_t cache = context->cache;
 
-	ocf_submit_volume_flush(ocf_cache_get_volume(cache),
+	ocf_submit_volume_flush(ocf_cache_get_metadata_volume(cache),
 		ocf_metadata_flush_disk_end, context);
 }
 
@@ -40,7 +40,11 @@ struct ocf_superblock_config {
 	uint32_t valid_parts_no;
 
 	ocf_cache_line_size_t line_size;
+	ocf_status_granularity_t status_granularity;
+	ocf_compression_t compression;
+	ocf_dedup_t dedup;
 	ocf_metadata_layout_t metadata_layout;
+	uint8_t separate_metadata;
 	uint32_t core_count;
 
 	unsigned long valid_core_bitmap[(OCF_CORE_MAX /
@@ -13,6 +13,7 @@
 #include "../metadata/metadata_io.h"
 #include "../metadata/metadata_partition_structs.h"
 #include "../engine/cache_engine.h"
+#include "../engine/engine_ops.h"
 #include "../utils/utils_user_part.h"
 #include "../utils/utils_cache_line.h"
 #include "../utils/utils_io.h"
@@ -22,6 +23,7 @@
 #include "../utils/utils_async_lock.h"
 #include "../concurrency/ocf_concurrency.h"
 #include "../ocf_lru.h"
+#include "../ocf_warm_state.h"
 #include "../ocf_ctx_priv.h"
 #include "../cleaning/cleaning.h"
 #include "../promotion/ops.h"
@@ -73,6 +75,15 @@ struct ocf_cache_mngt_init_params {
 		ocf_cache_line_size_t line_size;
 		/*!< Metadata cache line size */
 
+		ocf_status_granularity_t status_granularity;
+		/*!< Cache line status granularity */
+
+		ocf_compression_t compression;
+		/*!< Cache data compression ratio */
+
+		ocf_dedup_t dedup;
+		/*!< Cache data deduplication factor */
+
 		ocf_metadata_layout_t layout;
 		/*!< Metadata layout (striping/sequential) */
 
@@ -112,6 +123,12 @@ struct ocf_cache_attach_context {
 		bool device_opened : 1;
 			/*!< underlying device volume is open */
 
+		bool metadata_volume_inited : 1;
+			/*!< metadata volume is initialized */
+
+		bool metadata_volume_opened : 1;
+			/*!< metadata volume is open */
+
 		bool cleaner_started : 1;
 			/*!< Cleaner has been started */
 
@@ -130,6 +147,15 @@ struct ocf_cache_attach_context {
 		ocf_cache_line_size_t line_size;
 		/*!< Metadata cache line size */
 
+		ocf_status_granularity_t status_granularity;
+		/*!< Cache line status granularity */
+
+		ocf_compression_t compression;
+		/*!< Cache data compression ratio */
+
+		ocf_dedup_t dedup;
+		/*!< Cache data deduplication factor */
+
 		ocf_metadata_layout_t layout;
 		/*!< Metadata layout (striping/sequential) */
 
@@ -287,6 +313,10 @@ static ocf_error_t init_attached_data_structures(ocf_cache_t cache)
 	__init_parts_attached(cache);
 	__populate_free(cache);
 
+	result = ocf_dedup_rebuild(cache);
+	if (result)
+		return result;
+
 	result = __init_cleaning_policy(cache);
 	if (result) {
 		ocf_cache_log(cache, log_err,
@@ -316,25 +346,22 @@ static void init_attached_data_structures_recovery(ocf_cache_t cache)
 static void _ocf_mngt_close_all_uninitialized_cores(
 		ocf_cache_t cache)
 {
-	ocf_volume_t volume;
-	int j, i;
+	ocf_core_t core;
+	ocf_core_id_t core_id;
 
-	for (j = cache->conf_meta->core_count, i = 0; j > 0; ++i) {
-		if (!env_bit_test(i, cache->conf_meta->valid_core_bitmap))
+	for_each_core_all(cache, core, core_id) {
+		if (!env_bit_test(core_id, cache->conf_meta->valid_core_bitmap))
 			continue;
 
-		volume = &(cache->core[i].volume);
-		ocf_volume_close(volume);
-
-		--j;
+		ocf_volume_close(&core->volume);
 
-		if (cache->core[i].seq_cutoff)
-			ocf_core_seq_cutoff_deinit(&cache->core[i]);
+		if (core->seq_cutoff)
+			ocf_core_seq_cutoff_deinit(core);
 
-		env_free(cache->core[i].counters);
-		cache->core[i].counters = NULL;
+		env_free(core->counters);
+		core->counters = NULL;
 
-		env_bit_clear(i, cache->conf_meta->valid_core_bitmap);
+		env_bit_clear(core_id, cache->conf_meta->valid_core_bitmap);
 	}
 
 	cache->conf_meta->core_count = 0;
@@ -459,6 +486,13 @@ void _ocf_mngt_load_init_instance_complete(void *priv, int error)
 		OCF_PL_FINISH_RET(context->pipeline, -OCF_ERR_START_CACHE_FAIL);
 	}
 
+	result = ocf_dedup_rebuild(cache);
+	if (result) {
+		ocf_cache_log(cache, log_err,
+				"Invalid cache line data slot\n");
+		OCF_PL_FINISH_RET(context->pipeline, result);
+	}
+
 	if (context->metadata.shutdown_status != ocf_metadata_clean_shutdown)
 		__populate_free(cache);
 
@@ -553,6 +587,21 @@ static int _ocf_mngt_init_new_cache(struct ocf_cache_mngt_init_params *params)
 		goto lock_err;
 	}
 
+	if (env_spinlock_init(&cache->io_queues_lock)) {
+		result = -OCF_ERR_NO_MEM;
+		goto flush_mutex_err;
+	}
+
+	if (ocf_trimmer_init(cache)) {
+		result = -OCF_ERR_NO_MEM;
+		goto io_queues_lock_err;
+	}
+
+	if (ocf_engine_flush_group_init(cache)) {
+		result = -OCF_ERR_NO_MEM;
+		goto trimmer_err;
+	}
+
 	ENV_BUG_ON(!ocf_refcnt_inc(&cache->refcnt.cache));
 
 	/* start with freezed metadata ref counter to indicate detached device*/
@@ -568,6 +617,12 @@ static int _ocf_mngt_init_new_cache(struct ocf_cache_mngt_init_params *params)
 
 	return 0;
 
+trimmer_err:
+	ocf_trimmer_deinit(cache);
+io_queues_lock_err:
+	env_spinlock_destroy(&cache->io_queues_lock);
+flush_mutex_err:
+	env_mutex_destroy(&cache->flush_mutex);
 lock_err:
 	ocf_mngt_cache_lock_deinit(cache);
 alloc_err:
@@ -626,6 +681,40 @@ static void _ocf_mngt_attach_cache_device(ocf_pipeline_t pipeline,
 		OCF_PL_FINISH_RET(pipeline, -OCF_ERR_INVAL_CACHE_DEV);
 	}
 
+	if (!context->cfg.metadata_uuid.size)
+		OCF_PL_NEXT_RET(pipeline);
+
+	/* Atomic volume keeps metadata interleaved with cache line data */
+	if (ocf_volume_is_atomic(&cache->device->volume)) {
+		ocf_cache_log(cache, log_err, "Separate metadata volume is not "
+				"supported with atomic cache volume\n");
+		OCF_PL_FINISH_RET(pipeline, -OCF_ERR_NOT_SUPP);
+	}
+
+	type = ocf_ctx_get_volume_type(cache->owner,
+			context->cfg.metadata_volume_type);
+	if (!type)
+		OCF_PL_FINISH_RET(pipeline, -OCF_ERR_INVAL_VOLUME_TYPE);
+
+	ret = ocf_volume_init(&cache->device->metadata_volume, type,
+			&context->cfg.metadata_uuid, true);
+	if (ret)
+		OCF_PL_FINISH_RET(pipeline, ret);
+
+	cache->device->metadata_volume.cache = cache;
+	context->flags.metadata_volume_inited = true;
+
+	ret = ocf_volume_open(&cache->device->metadata_volume,
+			context->cfg.metadata_volume_params);
+	if (ret) {
+		ocf_cache_log(cache, log_err,
+				"ERROR: Metadata volume not available\n");
+		OCF_PL_FINISH_RET(pipeline, ret);
+	}
+	context->flags.metadata_volume_opened = true;
+
+	cache->device->separate_metadata = true;
+
 	ocf_pipeline_next(pipeline);
 }
 
@@ -690,7 +779,7 @@ static void _ocf_mngt_test_volume_initial_write(
 
 	ENV_BUG_ON(env_memset(context->test.rw_buffer, PAGE_SIZE, 1));
 
-	ocf_submit_cache_page(cache, context->test.reserved_lba_addr,
+	ocf_submit_metadata_page(cache, context->test.reserved_lba_addr,
 			OCF_WRITE, context->test.rw_buffer,
 			_ocf_mngt_test_volume_initial_write_complete, context);
 }
@@ -736,7 +825,7 @@ static void _ocf_mngt_test_volume_first_read(
 	ENV_BUG_ON(env_memset(context->test.rw_buffer, PAGE_SIZE, 0));
 	ENV_BUG_ON(env_memset(context->test.cmp_buffer, PAGE_SIZE, 1));
 
-	ocf_submit_cache_page(cache, context->test.reserved_lba_addr,
+	ocf_submit_metadata_page(cache, context->test.reserved_lba_addr,
 			OCF_READ, context->test.rw_buffer,
 			_ocf_mngt_test_volume_first_read_complete, context);
 }
@@ -799,7 +888,7 @@ static void _ocf_mngt_test_volume_second_read(
 	ENV_BUG_ON(env_memset(context->test.rw_buffer, PAGE_SIZE, 1));
 	ENV_BUG_ON(env_memset(context->test.cmp_buffer, PAGE_SIZE, 0));
 
-	ocf_submit_cache_page(cache, context->test.reserved_lba_addr,
+	ocf_submit_metadata_page(cache, context->test.reserved_lba_addr,
 			OCF_READ, context->test.rw_buffer,
 			_ocf_mngt_test_volume_second_read_complete, context);
 }
@@ -907,9 +996,20 @@ static void _ocf_mngt_load_read_properties_end(void *priv, int error,
 		OCF_PL_FINISH_RET(context->pipeline, -OCF_ERR_CACHE_NAME_MISMATCH);
 	}
 
+	/* Metadata found at the beginning of cache volume must not be used
+	 * with separate metadata volume and vice versa */
+	if (properties->separate_metadata != cache->device->separate_metadata) {
+		ocf_cache_log(cache, log_err, "Metadata volume configuration "
+				"doesn't match cache metadata\n");
+		OCF_PL_FINISH_RET(context->pipeline, -OCF_ERR_INVAL_CACHE_DEV);
+	}
+
 	context->metadata.shutdown_status = properties->shutdown_status;
 	context->metadata.dirty_flushed = properties->dirty_flushed;
 	context->metadata.line_size = properties->line_size;
+	context->metadata.status_granularity = properties->status_granularity;
+	context->metadata.compression = properties->compression;
+	context->metadata.dedup = properties->dedup;
 	cache->conf_meta->metadata_layout = properties->layout;
 	cache->conf_meta->cache_mode = properties->cache_mode;
 
@@ -927,6 +1027,9 @@ static void _ocf_mngt_init_properties(ocf_pipeline_t pipeline,
 	context->metadata.shutdown_status = ocf_metadata_clean_shutdown;
 	context->metadata.dirty_flushed = DIRTY_FLUSHED;
 	context->metadata.line_size = context->cfg.cache_line_size;
+	context->metadata.status_granularity = ocf_line_sector_size(cache);
+	context->metadata.compression = cache->conf_meta->compression;
+	context->metadata.dedup = cache->conf_meta->dedup;
 
 	ocf_pipeline_next(pipeline);
 }
@@ -963,18 +1066,65 @@ static void _ocf_mngt_attach_prepare_metadata(ocf_pipeline_t pipeline,
 
 	context->metadata.line_size = context->metadata.line_size ?:
 			cache->metadata.settings.size;
+	context->metadata.status_granularity =
+			context->metadata.status_granularity ?:
+			ocf_line_sector_size(cache);
+
+	if (!ocf_status_granularity_fits(context->metadata.line_size,
+			context->metadata.status_granularity)) {
+		ocf_cache_log(cache, log_err, "Cache line size too big for "
+				"status granularity\n");
+		OCF_PL_FINISH_RET(pipeline, -OCF_ERR_INVALID_CACHE_LINE_SIZE);
+	}
+
+	context->metadata.compression = context->metadata.compression ?:
+			cache->conf_meta->compression;
+
+	if (context->metadata.compression != ocf_compression_none) {
+		if (!ctx_data_compression(cache->owner)) {
+			ocf_cache_log(cache, log_err, "Context doesn't support "
+					"data compression\n");
+			OCF_PL_FINISH_RET(pipeline, -OCF_ERR_NOT_SUPP);
+		}
+
+		/* Atomic metadata is recovered from uncompressed data
+		 * sectors */
+		if (ocf_volume_is_atomic(&cache->device->volume)) {
+			ocf_cache_log(cache, log_err, "Data compression is not "
+					"supported on atomic volume\n");
+			OCF_PL_FINISH_RET(pipeline, -OCF_ERR_NOT_SUPP);
+		}
+	}
+
+	context->metadata.dedup = context->metadata.dedup ?:
+			cache->conf_meta->dedup;
+
+	/* Atomic metadata is recovered assuming cache line data is stored
+	 * at cache line position */
+	if (context->metadata.dedup != ocf_dedup_none &&
+			ocf_volume_is_atomic(&cache->device->volume)) {
+		ocf_cache_log(cache, log_err, "Data deduplication is not "
+				"supported on atomic volume\n");
+		OCF_PL_FINISH_RET(pipeline, -OCF_ERR_NOT_SUPP);
+	}
 
 	/*
 	 * Initialize variable size metadata segments
 	 */
 	ret = ocf_metadata_init_variable_size(cache, context->volume_size,
 			context->metadata.line_size,
+			context->metadata.status_granularity,
+			context->metadata.compression,
+			context->metadata.dedup,
 			cache->conf_meta->metadata_layout);
 	if (ret)
 		OCF_PL_FINISH_RET(pipeline, ret);
 
 	context->flags.attached_metadata_inited = true;
 
+	cache->device->concurrency.lock_slots =
+			context->cfg.cache_line_lock_slots;
+
 	ret = ocf_concurrency_init(cache);
 	if (ret)
 		OCF_PL_FINISH_RET(pipeline, ret);
@@ -1007,6 +1157,7 @@ static void _ocf_mngt_attach_init_instance(ocf_pipeline_t pipeline,
 }
 
 uint64_t _ocf_mngt_calculate_ram_needed(ocf_cache_line_size_t line_size,
+		ocf_status_granularity_t status_granularity,
 		uint64_t volume_size)
 {
 	uint64_t const_data_size;
@@ -1019,7 +1170,8 @@ uint64_t _ocf_mngt_calculate_ram_needed(ocf_cache_line_size_t line_size,
 
 	/* Cache metadata */
 	cache_line_no = volume_size / line_size;
-	data_per_line = (68 + (2 * (line_size / KiB / 4)));
+	data_per_line = 68 + 2 * OCF_DIV_ROUND_UP(
+			line_size / status_granularity, 8);
 
 	min_free_ram = const_data_size + cache_line_no * data_per_line;
 
@@ -1059,7 +1211,8 @@ int ocf_mngt_get_ram_needed(ocf_cache_t cache,
 
 	line_size = ocf_line_size(cache);
 	volume_size = ocf_volume_get_length(volume);
-	*ram_needed = _ocf_mngt_calculate_ram_needed(line_size, volume_size);
+	*ram_needed = _ocf_mngt_calculate_ram_needed(line_size,
+			ocf_line_sector_size(cache), volume_size);
 
 	ocf_volume_close(volume);
 	ocf_volume_destroy(volume);
@@ -1117,12 +1270,18 @@ static void _ocf_mngt_attach_handle_error(
 	if (context->flags.device_opened)
 		ocf_volume_close(&cache->device->volume);
 
+	if (context->flags.metadata_volume_opened)
+		ocf_volume_close(&cache->device->metadata_volume);
+
 	if (context->flags.concurrency_inited)
 		ocf_concurrency_deinit(cache);
 
 	if (context->flags.volume_inited)
 		ocf_volume_deinit(&cache->device->volume);
 
+	if (context->flags.metadata_volume_inited)
+		ocf_volume_deinit(&cache->device->metadata_volume);
+
 	if (context->flags.device_alloc)
 		env_vfree(cache->device);
 
@@ -1138,6 +1297,8 @@ static void _ocf_mngt_cache_init(ocf_cache_t cache,
 	cache->conf_meta->cache_mode = params->metadata.cache_mode;
 	cache->conf_meta->metadata_layout = params->metadata.layout;
 	cache->conf_meta->promotion_policy_type = params->metadata.promotion_policy;
+	cache->conf_meta->compression = params->metadata.compression;
+	cache->conf_meta->dedup = params->metadata.dedup;
 
 	INIT_LIST_HEAD(&cache->io_queues);
 
@@ -1163,6 +1324,9 @@ static int _ocf_mngt_cache_start(ocf_ctx_t ctx, ocf_cache_t *cache,
 	params.metadata.cache_mode = cfg->cache_mode;
 	params.metadata.layout = cfg->metadata_layout;
 	params.metadata.line_size = cfg->cache_line_size;
+	params.metadata.status_granularity = cfg->status_granularity;
+	params.metadata.compression = cfg->compression;
+	params.metadata.dedup = cfg->dedup;
 	params.metadata_volatile = cfg->metadata_volatile;
 	params.metadata.promotion_policy = cfg->promotion_policy;
 	params.locked = cfg->locked;
@@ -1185,7 +1349,8 @@ static int _ocf_mngt_cache_start(ocf_ctx_t ctx, ocf_cache_t *cache,
 	/*
 	 * Initialize metadata selected segments of metadata in memory
 	 */
-	result = ocf_metadata_init(tmp_cache, params.metadata.line_size);
+	result = ocf_metadata_init(tmp_cache, params.metadata.line_size,
+			params.metadata.status_granularity);
 	if (result) {
 		env_rmutex_unlock(&ctx->lock);
 		result =  -OCF_ERR_NO_MEM;
@@ -1245,6 +1410,11 @@ static void _ocf_mngt_init_attached_nonpersistent(ocf_pipeline_t pipeline,
 
 	env_atomic_set(&cache->fallback_pt_error_counter, 0);
 
+	/* Latency of previously attached device is no longer relevant */
+	ocf_steering_set_threshold(cache, cache->steering.threshold);
+	ocf_hedge_set_percentile(cache, cache->hedge.percentile);
+	ocf_bg_share_set(cache, cache->bg_share.share);
+
 	ocf_pipeline_next(pipeline);
 }
 
@@ -1253,7 +1423,7 @@ static void _ocf_mngt_copy_uuid_data(ocf_pipeline_t pipeline,
 {
 	struct ocf_cache_attach_context *context = priv;
 	struct ocf_mngt_cache_device_config *cfg = &context->cfg;
-	void *data;
+	void *data, *metadata_data = NULL;
 	int result;
 
 	data = env_vmalloc(cfg->uuid.size);
@@ -1262,14 +1432,33 @@ static void _ocf_mngt_copy_uuid_data(ocf_pipeline_t pipeline,
 
 	result = env_memcpy(data, cfg->uuid.size, cfg->uuid.data,
 			cfg->uuid.size);
-	if (result) {
-		env_vfree(data);
-		OCF_PL_FINISH_RET(pipeline, -OCF_ERR_INVAL);
+	if (result)
+		goto err;
+
+	if (cfg->metadata_uuid.size) {
+		metadata_data = env_vmalloc(cfg->metadata_uuid.size);
+		if (!metadata_data) {
+			env_vfree(data);
+			OCF_PL_FINISH_RET(pipeline, -OCF_ERR_NO_MEM);
+		}
+
+		result = env_memcpy(metadata_data, cfg->metadata_uuid.size,
+				cfg->metadata_uuid.data,
+				cfg->metadata_uuid.size);
+		if (result)
+			goto err;
 	}
 
 	context->cfg.uuid.data = data;
+	context->cfg.metadata_uuid.data = metadata_data;
 
 	ocf_pipeline_next(pipeline);
+	return;
+
+err:
+	env_vfree(metadata_data);
+	env_vfree(data);
+	OCF_PL_FINISH_RET(pipeline, -OCF_ERR_INVAL);
 }
 
 static void _ocf_mngt_attach_check_ram(ocf_pipeline_t pipeline,
@@ -1277,12 +1466,14 @@ static void _ocf_mngt_attach_check_ram(ocf_pipeline_t pipeline,
 {
 	struct ocf_cache_attach_context *context = priv;
 	ocf_cache_t cache = context->cache;
-	ocf_cache_line_size_t line_size = context->metadata.line_size;
+	ocf_cache_line_size_t line_size = context->metadata.line_size ?:
+			cache->metadata.settings.size;
 	uint64_t volume_size = ocf_volume_get_length(&cache->device->volume);
 	uint64_t min_free_ram;
 	uint64_t free_ram;
 
-	min_free_ram = _ocf_mngt_calculate_ram_needed(line_size, volume_size);
+	min_free_ram = _ocf_mngt_calculate_ram_needed(line_size,
+			context->metadata.status_granularity, volume_size);
 
 	free_ram = env_get_free_memory();
 
@@ -1370,6 +1561,33 @@ static void _ocf_mngt_init_promotion(ocf_pipeline_t pipeline,
 	ocf_pipeline_next(pipeline);
 }
 
+static void _ocf_mngt_load_warm_state_complete(void *priv, int error)
+{
+	struct ocf_cache_attach_context *context = priv;
+	ocf_cache_t cache = context->cache;
+
+	/* Cache starts cold if warm state cannot be restored */
+	if (!error) {
+		ocf_warm_state_restore(cache, context->metadata.shutdown_status ==
+				ocf_metadata_clean_shutdown);
+	}
+
+	ocf_pipeline_next(context->pipeline);
+}
+
+static void _ocf_mngt_load_warm_state(ocf_pipeline_t pipeline,
+		void *priv, ocf_pipeline_arg_t arg)
+{
+	struct ocf_cache_attach_context *context = priv;
+	ocf_cache_t cache = context->cache;
+
+	if (cache->metadata.is_volatile)
+		OCF_PL_NEXT_RET(pipeline);
+
+	ocf_metadata_load_reserved(cache,
+			_ocf_mngt_load_warm_state_complete, context);
+}
+
 static void _ocf_mngt_attach_flush_metadata_complete(void *priv, int error)
 {
 	struct ocf_cache_attach_context *context = priv;
@@ -1505,14 +1723,26 @@ static void _ocf_mngt_cache_attach_finish(ocf_pipeline_t pipeline,
 		void *priv, int error)
 {
 	struct ocf_cache_attach_context *context = priv;
+	_ocf_mngt_cache_attach_end_t cmpl = context->cmpl;
+	ocf_cache_t cache = context->cache;
+	void *priv1 = context->priv1;
+	void *priv2 = context->priv2;
 
 	if (error)
 		_ocf_mngt_attach_handle_error(context);
 
-	context->cmpl(context->cache, context->priv1, context->priv2, error);
-
 	env_vfree(context->cfg.uuid.data);
+	env_vfree(context->cfg.metadata_uuid.data);
+
+	/*
+	 * Destroy pipeline before completing management operation, so that
+	 * failed attach or load doesn't hold management queue reference
+	 * when cache is stopped right after the completion (same workaround
+	 * as in cache stop).
+	 */
 	ocf_pipeline_destroy(context->pipeline);
+
+	cmpl(cache, priv1, priv2, error);
 }
 
 struct ocf_pipeline_properties _ocf_mngt_cache_attach_pipeline_properties = {
@@ -1530,6 +1760,7 @@ struct ocf_pipeline_properties _ocf_mngt_cache_attach_pipeline_properties = {
 		OCF_PL_STEP(_ocf_mngt_init_cleaner),
 		OCF_PL_STEP(_ocf_mngt_init_promotion),
 		OCF_PL_STEP(_ocf_mngt_attach_init_instance),
+		OCF_PL_STEP(_ocf_mngt_load_warm_state),
 		OCF_PL_STEP(_ocf_mngt_attach_flush_metadata),
 		OCF_PL_STEP(_ocf_mngt_attach_discard),
 		OCF_PL_STEP(_ocf_mngt_attach_flush),
@@ -1555,6 +1786,7 @@ struct ocf_pipeline_properties _ocf_mngt_cache_load_pipeline_properties = {
 		OCF_PL_STEP(_ocf_mngt_init_cleaner),
 		OCF_PL_STEP(_ocf_mngt_init_promotion),
 		OCF_PL_STEP(_ocf_mngt_load_init_instance),
+		OCF_PL_STEP(_ocf_mngt_load_warm_state),
 		OCF_PL_STEP(_ocf_mngt_attach_flush_metadata),
 		OCF_PL_STEP(_ocf_mngt_attach_shutdown_status),
 		OCF_PL_STEP(_ocf_mngt_attach_post_init),
@@ -1623,6 +1855,33 @@ static void ocf_mngt_cache_stop_check_dirty(ocf_pipeline_t pipeline,
 	ocf_pipeline_next(context->pipeline);
 }
 
+static void ocf_mngt_cache_stop_save_warm_state_complete(void *priv,
+		int error)
+{
+	struct ocf_mngt_cache_stop_context *context = priv;
+
+	if (error) {
+		ocf_cache_log(context->cache, log_warn,
+				"Failed to save cache warm state\n");
+	}
+
+	ocf_pipeline_next(context->pipeline);
+}
+
+static void ocf_mngt_cache_stop_save_warm_state(ocf_pipeline_t pipeline,
+		void *priv, ocf_pipeline_arg_t arg)
+{
+	struct ocf_mngt_cache_stop_context *context = priv;
+	ocf_cache_t cache = context->cache;
+
+	if (cache->metadata.is_volatile)
+		OCF_PL_NEXT_RET(pipeline);
+
+	ocf_warm_state_build(cache);
+	ocf_metadata_flush_reserved(cache,
+			ocf_mngt_cache_stop_save_warm_state_complete, context);
+}
+
 static void _ocf_mngt_cache_stop_remove_cores(ocf_cache_t cache, bool attached)
 {
 	ocf_core_t core;
@@ -1708,6 +1967,8 @@ static void ocf_mngt_cache_remove(ocf_ctx_t ctx, ocf_cache_t cache)
 	/* Deinitialize locks */
 	ocf_mngt_cache_lock_deinit(cache);
 	env_mutex_destroy(&cache->flush_mutex);
+	ocf_trimmer_deinit(cache);
+	ocf_engine_flush_group_deinit(cache);
 
 	/* Remove cache from the list */
 	env_rmutex_lock(&ctx->lock);
@@ -1775,6 +2036,7 @@ struct ocf_pipeline_properties ocf_mngt_cache_stop_pipeline_properties = {
 	.steps = {
 		OCF_PL_STEP(ocf_mngt_cache_stop_wait_metadata_io),
 		OCF_PL_STEP(ocf_mngt_cache_stop_check_dirty),
+		OCF_PL_STEP(ocf_mngt_cache_stop_save_warm_state),
 		OCF_PL_STEP(ocf_mngt_cache_stop_remove_cores),
 		OCF_PL_STEP(ocf_mngt_cache_stop_unplug),
 		OCF_PL_STEP(ocf_mngt_cache_stop_put_io_queues),
@@ -1865,6 +2127,23 @@ static int _ocf_mngt_cache_validate_cfg(struct ocf_mngt_cache_config *cfg)
 	if (!ocf_cache_line_size_is_valid(cfg->cache_line_size))
 		return -OCF_ERR_INVALID_CACHE_LINE_SIZE;
 
+	if (!ocf_status_granularity_is_valid(cfg->status_granularity))
+		return -OCF_ERR_INVAL;
+
+	if (!ocf_status_granularity_fits(cfg->cache_line_size,
+			cfg->status_granularity)) {
+		return -OCF_ERR_INVALID_CACHE_LINE_SIZE;
+	}
+
+	if (!ocf_compression_is_valid(cfg->compression))
+		return -OCF_ERR_INVAL;
+
+	if (!ocf_compression_fits(cfg->status_granularity, cfg->compression))
+		return -OCF_ERR_INVAL;
+
+	if (!ocf_dedup_is_valid(cfg->dedup))
+		return -OCF_ERR_INVAL;
+
 	if (cfg->metadata_layout >= ocf_metadata_layout_max ||
 			cfg->metadata_layout < 0) {
 		return -OCF_ERR_INVAL;
@@ -1885,10 +2164,22 @@ static int _ocf_mngt_cache_validate_device_cfg(
 	if (device_cfg->uuid.size > OCF_VOLUME_UUID_MAX_SIZE)
 		return -OCF_ERR_INVAL;
 
+	if (device_cfg->metadata_uuid.size && !device_cfg->metadata_uuid.data)
+		return -OCF_ERR_INVAL;
+
+	if (device_cfg->metadata_uuid.size > OCF_VOLUME_UUID_MAX_SIZE)
+		return -OCF_ERR_INVAL;
+
 	if (device_cfg->cache_line_size != ocf_cache_line_size_none &&
 		!ocf_cache_line_size_is_valid(device_cfg->cache_line_size))
 		return -OCF_ERR_INVALID_CACHE_LINE_SIZE;
 
+	if (device_cfg->cache_line_lock_slots &&
+			device_cfg->cache_line_lock_slots <
+			OCF_CACHE_LINE_LOCK_SLOTS_MIN) {
+		return -OCF_ERR_INVAL;
+	}
+
 	return 0;
 }
 
@@ -1921,6 +2212,11 @@ int ocf_mngt_cache_start(ocf_ctx_t ctx, ocf_cache_t *cache,
 	if (result)
 		return result;
 
+	if (cfg->compression != ocf_compression_none &&
+			!ctx_data_compression(ctx)) {
+		return -OCF_ERR_NOT_SUPP;
+	}
+
 	result = _ocf_mngt_cache_start(ctx, cache, cfg, priv);
 	if (!result) {
 		_ocf_mngt_cache_set_valid(*cache);
@@ -1988,11 +2284,15 @@ static void _ocf_mngt_cache_unplug_complete(void *priv, int error)
 	ocf_cache_t cache = context->cache;
 
 	ocf_volume_close(&cache->device->volume);
+	if (cache->device->separate_metadata)
+		ocf_volume_close(&cache->device->metadata_volume);
 
 	ocf_metadata_deinit_variable_size(cache);
 	ocf_concurrency_deinit(cache);
 
 	ocf_volume_deinit(&cache->device->volume);
+	if (cache->device->separate_metadata)
+		ocf_volume_deinit(&cache->device->metadata_volume);
 
 	env_vfree(cache->device);
 	cache->device = NULL;
@@ -2230,6 +2530,170 @@ void ocf_mngt_cache_save(ocf_cache_t cache,
 			ocf_mngt_cache_save_flush_sb_complete, context);
 }
 
+/* Size of single prewarm read */
+#define OCF_MNGT_PREWARM_IO_SIZE (128 * KiB)
+
+struct ocf_mngt_cache_prewarm_context {
+	ocf_mngt_cache_prewarm_end_t cmpl;
+	void *priv;
+	ocf_pipeline_t pipeline;
+	ocf_cache_t cache;
+	ocf_queue_t queue;
+	ctx_data_t *data;
+	const struct ocf_warm_state_range *ranges;
+	uint32_t range_count;
+	uint32_t range;
+	uint64_t offset;
+};
+
+static void ocf_mngt_cache_prewarm_finish(ocf_pipeline_t pipeline,
+		void *priv, int error)
+{
+	struct ocf_mngt_cache_prewarm_context *context = priv;
+	ocf_cache_t cache = context->cache;
+
+	if (error) {
+		ocf_cache_log(cache, log_err, "Prewarming cache failed\n");
+	} else {
+		ocf_cache_log(cache, log_info, "Prewarming cache completed\n");
+	}
+
+	ctx_data_free(cache->owner, context->data);
+
+	context->cmpl(cache, context->priv, error);
+
+	ocf_pipeline_destroy(context->pipeline);
+}
+
+static void ocf_mngt_cache_prewarm_read_end(struct ocf_io *io, int error)
+{
+	struct ocf_mngt_cache_prewarm_context *context = io->priv1;
+
+	ocf_io_put(io);
+
+	if (error)
+		OCF_PL_FINISH_RET(context->pipeline, error);
+
+	ocf_pipeline_rerun(context->pipeline);
+}
+
+static void ocf_mngt_cache_prewarm_read(ocf_pipeline_t pipeline,
+		void *priv, ocf_pipeline_arg_t arg)
+{
+	struct ocf_mngt_cache_prewarm_context *context = priv;
+	ocf_cache_t cache = context->cache;
+	const struct ocf_warm_state_range *range;
+	uint64_t line_size = ocf_line_size(cache);
+	uint64_t addr, bytes, core_size;
+	ocf_core_t core;
+	struct ocf_io *io;
+
+	for (; context->range < context->range_count;
+			context->range++, context->offset = 0) {
+		range = &context->ranges[context->range];
+
+		if (!ocf_core_is_valid(cache, range->core_id))
+			continue;
+
+		core = ocf_cache_get_core(cache, range->core_id);
+		if (ocf_core_get_state(core) != ocf_core_state_active)
+			continue;
+
+		addr = (range->core_line + context->offset) * line_size;
+		core_size = ocf_volume_get_length(&core->volume);
+		if (context->offset >= range->count || addr >= core_size)
+			continue;
+
+		bytes = OCF_MIN((range->count - context->offset) * line_size,
+				(uint64_t)OCF_MNGT_PREWARM_IO_SIZE);
+		bytes = OCF_MIN(bytes, core_size - addr);
+		context->offset += OCF_DIV_ROUND_UP(bytes, line_size);
+
+		io = ocf_core_new_io(core, context->queue, addr, bytes,
+				OCF_READ, 0, 0);
+		if (!io)
+			OCF_PL_FINISH_RET(pipeline, -OCF_ERR_NO_MEM);
+
+		ocf_io_set_cmpl(io, context, NULL,
+				ocf_mngt_cache_prewarm_read_end);
+		if (ocf_io_set_data(io, context->data, 0)) {
+			ocf_io_put(io);
+			OCF_PL_FINISH_RET(pipeline, -OCF_ERR_INVAL);
+		}
+
+		ocf_core_submit_io(io);
+		return;
+	}
+
+	ocf_pipeline_next(pipeline);
+}
+
+struct ocf_pipeline_properties ocf_mngt_cache_prewarm_pipeline_properties = {
+	.priv_size = sizeof(struct ocf_mngt_cache_prewarm_context),
+	.finish = ocf_mngt_cache_prewarm_finish,
+	.steps = {
+		OCF_PL_STEP(ocf_mngt_cache_prewarm_read),
+		OCF_PL_STEP_TERMINATOR(),
+	},
+};
+
+void ocf_mngt_cache_prewarm(ocf_cache_t cache,
+		ocf_mngt_cache_prewarm_end_t cmpl, void *priv)
+{
+	struct ocf_mngt_cache_prewarm_context *context;
+	ocf_queue_t queue, io_queue = NULL;
+	ocf_pipeline_t pipeline;
+	int result;
+
+	OCF_CHECK_NULL(cache);
+
+	if (!cache->mngt_queue)
+		OCF_CMPL_RET(cache, priv, -OCF_ERR_INVAL);
+
+	/* Core I/O must not be submitted to management queue */
+	list_for_each_entry(queue, &cache->io_queues, list) {
+		if (queue != cache->mngt_queue) {
+			io_queue = queue;
+			break;
+		}
+	}
+	if (!io_queue)
+		OCF_CMPL_RET(cache, priv, -OCF_ERR_INVAL);
+
+	if (!ocf_cache_is_device_attached(cache))
+		OCF_CMPL_RET(cache, priv, -OCF_ERR_INVAL);
+
+	result = ocf_pipeline_create(&pipeline, cache,
+			&ocf_mngt_cache_prewarm_pipeline_properties);
+	if (result)
+		OCF_CMPL_RET(cache, priv, -OCF_ERR_NO_MEM);
+
+	context = ocf_pipeline_get_priv(pipeline);
+
+	context->cmpl = cmpl;
+	context->priv = priv;
+	context->pipeline = pipeline;
+	context->cache = cache;
+	context->queue = io_queue;
+
+	context->ranges = ocf_warm_state_get_ranges(cache,
+			&context->range_count);
+	if (!context->ranges) {
+		ocf_cache_log(cache, log_info, "No cache warm state to "
+				"prewarm cache from\n");
+		context->range_count = 0;
+	}
+
+	context->data = ctx_data_alloc(cache->owner,
+			OCF_DIV_ROUND_UP(OCF_MNGT_PREWARM_IO_SIZE, PAGE_SIZE));
+	if (!context->data) {
+		ocf_pipeline_destroy(pipeline);
+		OCF_CMPL_RET(cache, priv, -OCF_ERR_NO_MEM);
+	}
+
+	ocf_pipeline_next(pipeline);
+}
+
 static void _cache_mngt_update_initial_dirty_clines(ocf_cache_t cache)
 {
 	ocf_core_t core;
@@ -2403,6 +2867,209 @@ int ocf_mngt_cache_get_fallback_pt_error_threshold(ocf_cache_t cache,
 	return 0;
 }
 
+int ocf_mngt_cache_set_read_steering_threshold(ocf_cache_t cache,
+		uint32_t threshold)
+{
+	OCF_CHECK_NULL(cache);
+
+	if (threshold != OCF_CACHE_READ_STEERING_INACTIVE &&
+			(threshold < OCF_CACHE_READ_STEERING_MIN_THRESHOLD ||
+			threshold > OCF_CACHE_READ_STEERING_MAX_THRESHOLD)) {
+		return -OCF_ERR_INVAL;
+	}
+
+	ocf_steering_set_threshold(cache, threshold);
+
+	if (threshold == OCF_CACHE_READ_STEERING_INACTIVE) {
+		ocf_cache_log(cache, log_info, "Read steering disabled\n");
+	} else {
+		ocf_cache_log(cache, log_info, "Reads will be steered to core "
+				"when cache latency exceeds %u%% of core "
+				"latency\n", threshold);
+	}
+
+	return 0;
+}
+
+int ocf_mngt_cache_get_read_steering_threshold(ocf_cache_t cache,
+		uint32_t *threshold)
+{
+	OCF_CHECK_NULL(cache);
+	OCF_CHECK_NULL(threshold);
+
+	*threshold = cache->steering.threshold;
+
+	return 0;
+}
+
+int ocf_mngt_cache_set_read_hedge_percentile(ocf_cache_t cache,
+		uint32_t percentile)
+{
+	OCF_CHECK_NULL(cache);
+
+	if (percentile != OCF_CACHE_READ_HEDGE_INACTIVE &&
+			(percentile < OCF_CACHE_READ_HEDGE_MIN_PERCENTILE ||
+			percentile > OCF_CACHE_READ_HEDGE_MAX_PERCENTILE)) {
+		return -OCF_ERR_INVAL;
+	}
+
+	ocf_hedge_set_percentile(cache, percentile);
+
+	if (percentile == OCF_CACHE_READ_HEDGE_INACTIVE) {
+		ocf_cache_log(cache, log_info, "Read hedging disabled\n");
+	} else {
+		ocf_cache_log(cache, log_info, "Read hits exceeding %u.%u "
+				"percentile of cache latency will be hedged "
+				"to core\n", percentile / 10, percentile % 10);
+	}
+
+	return 0;
+}
+
+int ocf_mngt_cache_get_read_hedge_percentile(ocf_cache_t cache,
+		uint32_t *percentile)
+{
+	OCF_CHECK_NULL(cache);
+	OCF_CHECK_NULL(percentile);
+
+	*percentile = cache->hedge.percentile;
+
+	return 0;
+}
+
+int ocf_mngt_cache_set_background_io_share(ocf_cache_t cache,
+		uint32_t share)
+{
+	OCF_CHECK_NULL(cache);
+
+	if (share != OCF_CACHE_BACKGROUND_IO_SHARE_INACTIVE &&
+			(share < OCF_CACHE_BACKGROUND_IO_SHARE_MIN ||
+			share > OCF_CACHE_BACKGROUND_IO_SHARE_MAX)) {
+		return -OCF_ERR_INVAL;
+	}
+
+	ocf_bg_share_set(cache, share);
+
+	if (share == OCF_CACHE_BACKGROUND_IO_SHARE_INACTIVE) {
+		ocf_cache_log(cache, log_info, "Background IO bandwidth "
+				"not limited\n");
+	} else {
+		ocf_cache_log(cache, log_info, "Background IO limited to %u%% "
+				"of cache device bandwidth while user IO is "
+				"active\n", share);
+	}
+
+	return 0;
+}
+
+int ocf_mngt_cache_get_background_io_share(ocf_cache_t cache,
+		uint32_t *share)
+{
+	OCF_CHECK_NULL(cache);
+	OCF_CHECK_NULL(share);
+
+	*share = cache->bg_share.share;
+
+	return 0;
+}
+
+int ocf_mngt_cache_set_io_split(ocf_cache_t cache, uint32_t lines)
+{
+	OCF_CHECK_NULL(cache);
+
+	if (lines != OCF_CACHE_IO_SPLIT_INACTIVE &&
+			lines < OCF_CACHE_IO_SPLIT_MIN_LINES) {
+		return -OCF_ERR_INVAL;
+	}
+
+	cache->io_split_lines = lines;
+
+	if (lines == OCF_CACHE_IO_SPLIT_INACTIVE) {
+		ocf_cache_log(cache, log_info, "Request splitting disabled\n");
+	} else {
+		ocf_cache_log(cache, log_info, "Requests larger than %u "
+				"cache lines will be split\n", lines);
+	}
+
+	return 0;
+}
+
+int ocf_mngt_cache_get_io_split(ocf_cache_t cache, uint32_t *lines)
+{
+	OCF_CHECK_NULL(cache);
+	OCF_CHECK_NULL(lines);
+
+	*lines = cache->io_split_lines;
+
+	return 0;
+}
+
+static const char *_ocf_alloc_policy_names[ocf_alloc_policy_max] = {
+	[ocf_alloc_policy_lru] = "lru",
+	[ocf_alloc_policy_log] = "log",
+};
+
+int ocf_mngt_cache_set_alloc_policy(ocf_cache_t cache,
+		ocf_alloc_policy_t policy)
+{
+	OCF_CHECK_NULL(cache);
+
+	if (policy < 0 || policy >= ocf_alloc_policy_max)
+		return -OCF_ERR_INVAL;
+
+	cache->alloc_policy = policy;
+
+	ocf_cache_log(cache, log_info, "Allocation policy: %s\n",
+			_ocf_alloc_policy_names[policy]);
+
+	return 0;
+}
+
+int ocf_mngt_cache_get_alloc_policy(ocf_cache_t cache,
+		ocf_alloc_policy_t *policy)
+{
+	OCF_CHECK_NULL(cache);
+	OCF_CHECK_NULL(policy);
+
+	*policy = cache->alloc_policy;
+
+	return 0;
+}
+
+int ocf_mngt_cache_set_trim_rate(ocf_cache_t cache, uint32_t rate)
+{
+	OCF_CHECK_NULL(cache);
+
+	/* Deduplicated data is stored in data slots, not in cache line
+	 * space which trimmer discards */
+	if (rate != OCF_CACHE_TRIM_INACTIVE &&
+			cache->conf_meta->dedup != ocf_dedup_none) {
+		return -OCF_ERR_NOT_SUPP;
+	}
+
+	cache->trimmer.rate = rate;
+
+	if (rate == OCF_CACHE_TRIM_INACTIVE) {
+		ocf_cache_log(cache, log_info, "Discarding of freed cache "
+				"lines disabled\n");
+	} else {
+		ocf_cache_log(cache, log_info, "Freed cache lines will be "
+				"discarded at up to %u MiB/s\n", rate);
+	}
+
+	return 0;
+}
+
+int ocf_mngt_cache_get_trim_rate(ocf_cache_t cache, uint32_t *rate)
+{
+	OCF_CHECK_NULL(cache);
+	OCF_CHECK_NULL(rate);
+
+	*rate = cache->trimmer.rate;
+
+	return 0;
+}
+
 struct ocf_mngt_cache_detach_context {
 	/* unplug context - this is private structure of _ocf_mngt_cache_unplug,
 	 * it is member of detach context only to reserve memory in advance for
@@ -2470,6 +3137,33 @@ static void ocf_mngt_cache_detach_stop_cleaner_io(ocf_pipeline_t pipeline,
 			pipeline);
 }
 
+static void ocf_mngt_cache_detach_save_warm_state_complete(void *priv,
+		int error)
+{
+	struct ocf_mngt_cache_detach_context *context = priv;
+
+	if (error) {
+		ocf_cache_log(context->cache, log_warn,
+				"Failed to save cache warm state\n");
+	}
+
+	ocf_pipeline_next(context->pipeline);
+}
+
+static void ocf_mngt_cache_detach_save_warm_state(ocf_pipeline_t pipeline,
+		void *priv, ocf_pipeline_arg_t arg)
+{
+	struct ocf_mngt_cache_detach_context *context = priv;
+	ocf_cache_t cache = context->cache;
+
+	if (cache->metadata.is_volatile)
+		OCF_PL_NEXT_RET(pipeline);
+
+	ocf_warm_state_build(cache);
+	ocf_metadata_flush_reserved(cache,
+			ocf_mngt_cache_detach_save_warm_state_complete, context);
+}
+
 static void ocf_mngt_cache_detach_update_metadata(ocf_pipeline_t pipeline,
 		void *priv, ocf_pipeline_arg_t arg)
 {
@@ -2552,6 +3246,7 @@ struct ocf_pipeline_properties ocf_mngt_cache_detach_pipeline_properties = {
 		OCF_PL_STEP(ocf_mngt_cache_detach_stop_cache_io),
 		OCF_PL_STEP(ocf_mngt_cache_detach_stop_cleaner_io),
 		OCF_PL_STEP(ocf_mngt_cache_stop_check_dirty),
+		OCF_PL_STEP(ocf_mngt_cache_detach_save_warm_state),
 		OCF_PL_STEP(ocf_mngt_cache_detach_update_metadata),
 		OCF_PL_STEP(ocf_mngt_cache_detach_unplug),
 		OCF_PL_STEP_TERMINATOR(),
@@ -145,7 +145,9 @@ void ocf_mngt_cache_put(ocf_cache_t cache)
 
 	if (ocf_refcnt_dec(&cache->refcnt.cache) == 0) {
 		ctx = cache->owner;
+		ocf_core_slots_free(cache);
 		ocf_metadata_deinit(cache);
+		env_spinlock_destroy(&cache->io_queues_lock);
 		env_vfree(cache);
 		ocf_ctx_put(ctx);
 	}
@@ -201,10 +201,13 @@ static int ocf_mngt_find_free_core(ocf_cache_t cache, ocf_core_t *core)
 	core_id = _ocf_mngt_find_first_free_core(
 			cache->conf_meta->valid_core_bitmap);
 
-	tmp_core = ocf_cache_get_core(cache, core_id);
-	if (!tmp_core)
+	if (core_id >= OCF_CORE_MAX)
 		return -OCF_ERR_TOO_MANY_CORES;
 
+	tmp_core = ocf_core_slot_alloc(cache, core_id);
+	if (!tmp_core)
+		return -OCF_ERR_NO_MEM;
+
 	*core = tmp_core;
 
 	return 0;
@@ -366,7 +366,7 @@ static void _ocf_mngt_flush_portion_end(void *private_data, int error)
 	struct ocf_mngt_cache_flush_context *context = fc->context;
 	struct flush_containers_context *fsc = &context->fcs;
 	ocf_cache_t cache = context->cache;
-	ocf_core_t core = &cache->core[fc->core_id];
+	ocf_core_t core = cache->core[fc->core_id];
 	bool first_interrupt;
 
 	env_atomic_set(&core->flushed, fc->iter);
@@ -567,18 +567,14 @@ static void _ocf_mngt_flush_all_cores_complete(
 		struct ocf_mngt_cache_flush_context *context, int error)
 {
 	ocf_cache_t cache = context->cache;
-	uint32_t i, j;
+	ocf_core_t core;
+	ocf_core_id_t core_id;
 
 	env_atomic_set(&cache->flush_in_progress, 0);
 
-	for (i = 0, j = 0; i < OCF_CORE_MAX; i++) {
-		if (!env_bit_test(i, cache->conf_meta->valid_core_bitmap))
-			continue;
-
-		env_atomic_set(&cache->core[i].flushed, 0);
-
-		if (++j == cache->conf_meta->core_count)
-			break;
+	for_each_core_all(cache, core, core_id) {
+		if (env_bit_test(core_id, cache->conf_meta->valid_core_bitmap))
+			env_atomic_set(&core->flushed, 0);
 	}
 
 	if (error)
@@ -872,7 +868,7 @@ void ocf_mngt_core_purge(ocf_core_t core,
 		OCF_CMPL_RET(core, priv, -OCF_ERR_INVAL);
 	}
 
-	core_size = ocf_volume_get_length(&cache->core[core_id].volume);
+	core_size = ocf_volume_get_length(&core->volume);
 
 	result = ocf_pipeline_create(&pipeline, cache,
 			&_ocf_mngt_core_purge_pipeline_properties);
@@ -10,6 +10,7 @@
 #include "../engine/cache_engine.h"
 #include "../utils/utils_user_part.h"
 #include "../ocf_lru.h"
+#include "../promotion/promotion.h"
 #include "ocf_env.h"
 
 static uint64_t _ocf_mngt_count_user_parts_min_size(struct ocf_cache *cache)
@@ -72,6 +73,9 @@ int ocf_mngt_add_partition_to_cache(struct ocf_cache *cache,
 	cache->user_parts[part_id].config->max_size = max_size;
 	cache->user_parts[part_id].config->priority = priority;
 	cache->user_parts[part_id].config->cache_mode = ocf_cache_mode_max;
+	cache->user_parts[part_id].config->promotion.enabled = false;
+	cache->user_parts[part_id].config->seq_cutoff_threshold =
+			OCF_IO_CLASS_SEQ_CUTOFF_INHERIT;
 
 	ocf_user_part_set_valid(cache, part_id, valid);
 	ocf_lst_add(&cache->user_part_list, part_id);
@@ -153,6 +157,8 @@ static int _ocf_mngt_io_class_configure(ocf_cache_t cache,
 		}
 		ocf_user_part_set_prio(cache, dest_part, prio);
 		dest_part->config->cache_mode = cache_mode;
+		dest_part->config->promotion = cfg->promotion;
+		dest_part->config->seq_cutoff_threshold = cfg->seq_cutoff_threshold;
 
 		ocf_cache_log(cache, log_info,
 				"Updating unclassified IO class, id: %u, name :'%s',"
@@ -192,6 +198,8 @@ static int _ocf_mngt_io_class_configure(ocf_cache_t cache,
 
 	ocf_user_part_set_prio(cache, dest_part, prio);
 	dest_part->config->cache_mode = cache_mode;
+	dest_part->config->promotion = cfg->promotion;
+	dest_part->config->seq_cutoff_threshold = cfg->seq_cutoff_threshold;
 
 	return result;
 }
@@ -238,6 +246,26 @@ static int _ocf_mngt_io_class_edit(ocf_cache_t cache,
 	return result;
 }
 
+static bool _ocf_mngt_io_class_promotion_is_valid(
+		const struct ocf_io_class_promotion *promotion)
+{
+	if (!promotion->enabled)
+		return true;
+
+	if (promotion->policy < ocf_promotion_always ||
+			promotion->policy >= ocf_promotion_max) {
+		return false;
+	}
+
+	if (promotion->policy != ocf_promotion_nhit)
+		return true;
+
+	return promotion->nhit_insertion_threshold >= OCF_NHIT_MIN_THRESHOLD &&
+		promotion->nhit_insertion_threshold <= OCF_NHIT_MAX_THRESHOLD &&
+		promotion->nhit_trigger_threshold >= OCF_NHIT_MIN_TRIGGER &&
+		promotion->nhit_trigger_threshold <= OCF_NHIT_MAX_TRIGGER;
+}
+
 static int _ocf_mngt_io_class_validate_cfg(ocf_cache_t cache,
 		const struct ocf_mngt_io_class_config *cfg)
 {
@@ -272,6 +300,21 @@ static int _ocf_mngt_io_class_validate_cfg(ocf_cache_t cache,
 		return -OCF_ERR_INVAL;
 	}
 
+	if (!_ocf_mngt_io_class_promotion_is_valid(&cfg->promotion)) {
+		ocf_cache_log(cache, log_info,
+				"Invalid partition promotion policy\n");
+		return -OCF_ERR_INVAL;
+	}
+
+	if (cfg->seq_cutoff_threshold != OCF_IO_CLASS_SEQ_CUTOFF_INHERIT &&
+			(cfg->seq_cutoff_threshold < OCF_SEQ_CUTOFF_MIN_THRESHOLD ||
+			cfg->seq_cutoff_threshold >
+				OCF_SEQ_CUTOFF_MAX_THRESHOLD)) {
+		ocf_cache_log(cache, log_info,
+				"Invalid partition sequential cutoff threshold\n");
+		return -OCF_ERR_INVAL;
+	}
+
 	return 0;
 }
 
@@ -313,6 +356,12 @@ int ocf_mngt_cache_io_classes_configure(ocf_cache_t cache,
 
 	ocf_user_part_sort(cache);
 
+	result = ocf_promotion_update_classes(cache->promotion_policy);
+	if (result) {
+		ocf_cache_log(cache, log_err,
+				"Failed to initialize io class promotion policy\n");
+	}
+
 out_edit:
 	if (result) {
 		ENV_BUG_ON(env_memcpy(cache->user_parts, sizeof(cache->user_parts),
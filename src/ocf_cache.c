@@ -13,6 +13,7 @@
 #include "ocf_cache_priv.h"
 #include "ocf_queue_priv.h"
 #include "utils/utils_stats.h"
+#include "concurrency/ocf_cache_line_concurrency.h"
 
 ocf_volume_t ocf_cache_get_volume(ocf_cache_t cache)
 {
@@ -175,12 +176,70 @@ int ocf_cache_get_info(ocf_cache_t cache, struct ocf_cache_info *info)
 	info->fallback_pt.error_counter =
 		env_atomic_read(&cache->fallback_pt_error_counter);
 
+	info->steering.status = ocf_steering_is_on(cache);
+	info->steering.cache_latency =
+		env_atomic64_read(&cache->steering.cache_latency);
+	info->steering.core_latency =
+		env_atomic64_read(&cache->steering.core_latency);
+	info->steering.steered = env_atomic64_read(&cache->steering.steered);
+
+	info->hedging.deadline = ocf_hedge_get_deadline(cache);
+	info->hedging.hedged = env_atomic64_read(&cache->hedge.hedged);
+	info->hedging.core_won = env_atomic64_read(&cache->hedge.core_won);
+
+	info->background_io.cleaner_deferred =
+			env_atomic64_read(&cache->bg_share.cleaner_deferred);
+	info->background_io.backfill_skipped =
+			env_atomic64_read(&cache->bg_share.backfill_skipped);
+
+	if (ocf_cache_is_device_attached(cache)) {
+		struct ocf_alock *c = ocf_cache_line_concurrency(cache);
+		struct ocf_alock_stats lock_stats;
+
+		ocf_alock_get_stats(c, &lock_stats);
+
+		info->lock_wait.waiting =
+			ocf_cache_line_concurrency_suspended_no(c);
+		info->lock_wait.resumed = lock_stats.resumed;
+		info->lock_wait.wait_time = lock_stats.wait_time / 1000;
+		info->lock_wait.batches = lock_stats.batches;
+
+		info->lock_table.slots = lock_stats.slots;
+		info->lock_table.busy = lock_stats.busy;
+		info->lock_table.collisions = lock_stats.collisions;
+	}
+
 	info->cleaning_policy = cache->conf_meta->cleaning_policy_type;
 	info->promotion_policy = cache->conf_meta->promotion_policy_type;
 	info->metadata_footprint = ocf_cache_is_device_attached(cache) ?
 			ocf_metadata_size_of(cache) : 0;
 	info->cache_line_size = ocf_line_size(cache);
 
+	info->compression.ratio = cache->conf_meta->compression;
+	info->compression.bytes_in =
+		env_atomic64_read(&cache->compression.bytes_in);
+	info->compression.bytes_out =
+		env_atomic64_read(&cache->compression.bytes_out);
+	info->compression.incompressible =
+		env_atomic64_read(&cache->compression.incompressible);
+	info->compression.compress_time = env_atomic64_read(
+			&cache->compression.compress_ns) / 1000;
+	info->compression.decompress_time = env_atomic64_read(
+			&cache->compression.decompress_ns) / 1000;
+
+	info->dedup.factor = cache->conf_meta->dedup;
+	if (info->attached && ocf_cache_dedup_enabled(cache)) {
+		env_spinlock_lock(&cache->dedup.lock);
+		info->dedup.data_slots = cache->device->data_slots;
+		info->dedup.free_slots = cache->dedup.free_count;
+		info->dedup.shared_slots = cache->dedup.shared;
+		env_spinlock_unlock(&cache->dedup.lock);
+	}
+	info->dedup.hits = env_atomic64_read(&cache->dedup.hits);
+	info->dedup.cow = env_atomic64_read(&cache->dedup.cow);
+	info->dedup.no_slot = env_atomic64_read(&cache->dedup.no_slot);
+	info->dedup.collisions = env_atomic64_read(&cache->dedup.collisions);
+
 	return 0;
 }
 
@@ -207,6 +266,24 @@ ocf_cache_line_size_t ocf_cache_get_line_size(ocf_cache_t cache)
 	return ocf_line_size(cache);
 }
 
+ocf_status_granularity_t ocf_cache_get_status_granularity(ocf_cache_t cache)
+{
+	OCF_CHECK_NULL(cache);
+	return ocf_line_sector_size(cache);
+}
+
+ocf_compression_t ocf_cache_get_compression(ocf_cache_t cache)
+{
+	OCF_CHECK_NULL(cache);
+	return cache->conf_meta->compression;
+}
+
+ocf_dedup_t ocf_cache_get_dedup(ocf_cache_t cache)
+{
+	OCF_CHECK_NULL(cache);
+	return cache->conf_meta->dedup;
+}
+
 uint64_t ocf_cache_bytes_2_lines(ocf_cache_t cache, uint64_t bytes)
 {
 	OCF_CHECK_NULL(cache);
@@ -16,6 +16,11 @@
 #include "utils/utils_pipeline.h"
 #include "utils/utils_refcnt.h"
 #include "utils/utils_async_lock.h"
+#include "utils/utils_trimmer.h"
+#include "utils/utils_dedup.h"
+#include "utils/utils_steering.h"
+#include "utils/utils_hedge.h"
+#include "utils/utils_bg_share.h"
 #include "ocf_stats_priv.h"
 #include "cleaning/cleaning.h"
 #include "ocf_logger_priv.h"
@@ -42,6 +47,12 @@ struct ocf_trace {
 struct ocf_cache_device {
 	struct ocf_volume volume;
 
+	/* Volume holding cache metadata, valid only if separate_metadata is
+	 * set. Otherwise metadata is kept at the beginning of cache volume.
+	 */
+	struct ocf_volume metadata_volume;
+	bool separate_metadata;
+
 	/* Hash Table contains contains pointer to the entry in
 	 * Collision Table so it actually contains collision Table
 	 * indexes.
@@ -50,6 +61,11 @@ struct ocf_cache_device {
 	unsigned int hash_table_entries;
 	unsigned int collision_table_entries;
 
+	/* Number of cache line data slots on cache device. With deduplication
+	 * enabled it's also invalid data slot index.
+	 */
+	unsigned int data_slots;
+
 	int metadata_error;
 		/*!< This field indicates that an error during metadata IO
 		 * occurred
@@ -59,6 +75,9 @@ struct ocf_cache_device {
 
 	struct {
 		struct ocf_alock *cache_line;
+
+		/* Number of cache line lock slots, 0 for lock per line */
+		uint32_t lock_slots;
 	} concurrency;
 
 	struct ocf_superblock_runtime *runtime_meta;
@@ -82,6 +101,13 @@ struct ocf_cache {
 	struct ocf_part free;
 
 	uint32_t fallback_pt_error_threshold;
+	uint32_t io_split_lines;
+
+	ocf_alloc_policy_t alloc_policy;
+	/* Write frontier of log-structured allocation (physical line) */
+	env_atomic64 alloc_log_pos;
+
+	struct ocf_trimmer trimmer;
 	ocf_queue_t mngt_queue;
 
 	struct ocf_metadata metadata;
@@ -96,21 +122,73 @@ struct ocf_cache {
 		struct ocf_refcnt metadata __attribute__((aligned(64)));
 	} refcnt;
 
-	struct ocf_core core[OCF_CORE_MAX];
+	/* Core objects are allocated on demand, when core id is first used,
+	 * and kept until cache is freed. Allocated ids are tracked in
+	 * core_slots bitmap, so that core iteration skips unused ids in
+	 * chunks of bitmap words. */
+	struct ocf_core *core[OCF_CORE_MAX];
+	unsigned long core_slots[(OCF_CORE_MAX /
+			(sizeof(unsigned long) * 8)) + 1];
 
 	ocf_pipeline_t stop_pipeline;
 
 	env_atomic fallback_pt_error_counter;
 
+	/* Cache data compression statistics */
+	struct {
+		env_atomic64 bytes_in;
+		env_atomic64 bytes_out;
+		env_atomic64 incompressible;
+		env_atomic64 compress_ns;
+		env_atomic64 decompress_ns;
+	} compression;
+
+	/* Cache data deduplication runtime state */
+	struct ocf_dedup dedup;
+
+	/* Latency based steering of reads between cache and core */
+	struct ocf_steering steering;
+
+	/* Hedged core reads of slow cache read hits */
+	struct ocf_hedge hedge;
+
+	/* Cache device bandwidth share of background work */
+	struct ocf_bg_share bg_share;
+
 	env_atomic pending_read_misses_list_blocked;
 	env_atomic pending_read_misses_list_count;
 
 	env_atomic flush_in_progress;
 	env_mutex flush_mutex;
 
+	/* Coalescing of flush requests into generations (see engine_ops.c) */
+	struct {
+		env_spinlock lock;
+		/* Generation of device flushes is in progress */
+		bool in_flight;
+		/* Requests served by generation in progress */
+		struct list_head running;
+		/* Requests waiting for next generation */
+		struct list_head pending;
+		/* Device flushes of running generation not completed yet */
+		env_atomic remaining;
+		/* Cache device flush error */
+		int error;
+		/* Last core device flush error */
+		int core_error;
+		/* Cores with device flush submitted in running generation */
+		unsigned long cores[(OCF_CORE_MAX /
+				(sizeof(unsigned long) * 8)) + 1];
+		/* Cores which device flush failed in running generation */
+		unsigned long failed[(OCF_CORE_MAX /
+				(sizeof(unsigned long) * 8)) + 1];
+	} flush_group;
+
 	struct ocf_cleaner cleaner;
 
 	struct list_head io_queues;
+	/* Protects io_queues list against concurrent create and put */
+	env_spinlock io_queues_lock;
 	ocf_promotion_policy_t promotion_policy;
 
 	struct {
@@ -141,17 +219,44 @@ struct ocf_cache {
 	env_atomic last_access_ms;
 };
 
+static inline ocf_volume_t ocf_cache_get_metadata_volume(ocf_cache_t cache)
+{
+	return cache->device->separate_metadata ?
+			&cache->device->metadata_volume : &cache->device->volume;
+}
+
 static inline ocf_core_t ocf_cache_get_core(ocf_cache_t cache,
 		ocf_core_id_t core_id)
 {
 	if (core_id >= OCF_CORE_MAX)
 		return NULL;
 
-	return &cache->core[core_id];
+	return cache->core[core_id];
+}
+
+/* Return lowest allocated core id not less than @core_id or OCF_CORE_MAX */
+static inline ocf_core_id_t ocf_cache_next_core_id(ocf_cache_t cache,
+		uint32_t core_id)
+{
+	const uint32_t bits = sizeof(unsigned long) * 8;
+	unsigned long word;
+
+	while (core_id < OCF_CORE_MAX) {
+		word = cache->core_slots[core_id / bits] >> (core_id % bits);
+		if (word)
+			return core_id + env_ctz64(word);
+
+		core_id = (core_id / bits + 1) * bits;
+	}
+
+	return OCF_CORE_MAX;
 }
 
 #define for_each_core_all(_cache, _core, _id) \
-	for (_id = 0; _core = &_cache->core[_id], _id < OCF_CORE_MAX; _id++)
+	for (_id = ocf_cache_next_core_id(_cache, 0); \
+			_core = ocf_cache_get_core(_cache, _id), \
+			_id < OCF_CORE_MAX; \
+			_id = ocf_cache_next_core_id(_cache, _id + 1))
 
 #define for_each_core(_cache, _core, _id) \
 	for_each_core_all(_cache, _core, _id) \
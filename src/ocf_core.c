@@ -10,7 +10,9 @@
 #include "metadata/metadata.h"
 #include "engine/cache_engine.h"
 #include "utils/utils_user_part.h"
+#include "utils/utils_cache_line.h"
 #include "ocf_request.h"
+#include "ocf_queue_priv.h"
 #include "ocf_trace_priv.h"
 
 struct ocf_core_volume {
@@ -37,15 +39,45 @@ ocf_volume_t ocf_core_get_front_volume(ocf_core_t core)
 
 ocf_core_id_t ocf_core_get_id(ocf_core_t core)
 {
-	struct ocf_cache *cache;
-	ocf_core_id_t core_id;
-
 	OCF_CHECK_NULL(core);
 
-	cache = core->volume.cache;
-	core_id = core - cache->core;
+	return core->id;
+}
+
+ocf_core_t ocf_core_slot_alloc(ocf_cache_t cache, ocf_core_id_t id)
+{
+	ocf_core_t core;
+
+	if (id >= OCF_CORE_MAX)
+		return NULL;
 
-	return core_id;
+	if (cache->core[id])
+		return cache->core[id];
+
+	core = env_zalloc(sizeof(*core), ENV_MEM_NORMAL);
+	if (!core)
+		return NULL;
+
+	core->id = id;
+	core->conf_meta = ocf_metadata_get_core_config(cache, id);
+	core->runtime_meta = ocf_metadata_get_core_runtime(cache, id);
+
+	cache->core[id] = core;
+	env_bit_set(id, cache->core_slots);
+
+	return core;
+}
+
+void ocf_core_slots_free(ocf_cache_t cache)
+{
+	ocf_core_t core;
+	ocf_core_id_t core_id;
+
+	for_each_core_all(cache, core, core_id) {
+		env_bit_clear(core_id, cache->core_slots);
+		cache->core[core_id] = NULL;
+		env_free(core);
+	}
 }
 
 int ocf_core_get_by_name(ocf_cache_t cache, const char *name, size_t name_len,
@@ -100,7 +132,7 @@ int ocf_core_get(ocf_cache_t cache, ocf_core_id_t id, ocf_core_t *core)
 	if (!ocf_core_is_valid(cache, id))
 		return -OCF_ERR_CORE_NOT_AVAIL;
 
-	*core = &cache->core[id];
+	*core = cache->core[id];
 	return 0;
 }
 
@@ -122,6 +154,7 @@ uint32_t ocf_core_get_seq_cutoff_promotion_count(ocf_core_t core)
 int ocf_core_visit(ocf_cache_t cache, ocf_core_visitor_t visitor, void *cntx,
 		bool only_opened)
 {
+	ocf_core_t core;
 	ocf_core_id_t id;
 	int result = 0;
 
@@ -130,14 +163,14 @@ int ocf_core_visit(ocf_cache_t cache, ocf_core_visitor_t visitor, void *cntx,
 	if (!visitor)
 		return -OCF_ERR_INVAL;
 
-	for (id = 0; id < OCF_CORE_MAX; id++) {
+	for_each_core_all(cache, core, id) {
 		if (!env_bit_test(id, cache->conf_meta->valid_core_bitmap))
 			continue;
 
-		if (only_opened && !cache->core[id].opened)
+		if (only_opened && !core->opened)
 			continue;
 
-		result = visitor(&cache->core[id], cntx);
+		result = visitor(core, cntx);
 		if (result)
 			break;
 	}
@@ -182,6 +215,7 @@ static inline int ocf_core_validate_io(struct ocf_io *io)
 {
 	ocf_volume_t volume = ocf_io_get_volume(io);
 	ocf_core_t core = ocf_volume_to_core(volume);
+	ocf_cache_t cache = ocf_core_get_cache(core);
 
 	if (io->addr + io->bytes > ocf_volume_get_length(volume))
 		return -OCF_ERR_INVAL;
@@ -201,7 +235,7 @@ static inline int ocf_core_validate_io(struct ocf_io *io)
 	/* Core volume I/O must not be queued on management queue - this would
 	 * break I/O accounting code, resulting in use-after-free type of errors
 	 * after cache detach, core remove etc. */
-	if (io->io_queue == ocf_core_get_cache(core)->mngt_queue)
+	if (io->io_queue == cache->mngt_queue)
 		return -OCF_ERR_INVAL;
 
 	return 0;
@@ -268,6 +302,158 @@ static int ocf_core_submit_io_fast(struct ocf_io *io, struct ocf_request *req,
 	return -OCF_ERR_IO;
 }
 
+static inline bool ocf_core_should_split(struct ocf_request *req)
+{
+	uint32_t split_lines = req->cache->io_split_lines;
+
+	if (split_lines == OCF_CACHE_IO_SPLIT_INACTIVE)
+		return false;
+
+	if (req->cache_mode == ocf_req_cache_mode_pt ||
+			req->cache_mode == ocf_req_cache_mode_d2c) {
+		return false;
+	}
+
+	return req->core_line_count > split_lines;
+}
+
+/*
+ * Next I/O queue in round robin manner, skipping management queue and
+ * queues being released. Returns queue with reference taken, or NULL if
+ * there is no other I/O queue.
+ */
+static ocf_queue_t ocf_core_split_next_queue(ocf_cache_t cache,
+		ocf_queue_t queue)
+{
+	ocf_queue_t next = NULL, iter_queue;
+	struct list_head *iter;
+
+	env_spinlock_lock(&cache->io_queues_lock);
+
+	for (iter = queue->list.next; iter != &queue->list;
+			iter = iter->next) {
+		if (iter == &cache->io_queues)
+			continue;
+
+		iter_queue = list_entry(iter, struct ocf_queue, list);
+		if (iter_queue == cache->mngt_queue)
+			continue;
+
+		if (env_atomic_add_unless(&iter_queue->ref_count, 1, 0)) {
+			next = iter_queue;
+			break;
+		}
+	}
+
+	env_spinlock_unlock(&cache->io_queues_lock);
+
+	return next;
+}
+
+static void ocf_core_split_complete(struct ocf_request *sub, int error)
+{
+	struct ocf_request *req = sub->master_io_req;
+
+	if (error)
+		req->error = error;
+
+	if (env_atomic_dec_return(&req->master_remaining))
+		return;
+
+	ocf_req_complete(req, req->error);
+}
+
+static struct ocf_request *ocf_core_split_new(struct ocf_request *req,
+		ocf_queue_t queue, uint64_t addr, uint32_t bytes)
+{
+	struct ocf_io *io = &req->ioi.io;
+	struct ocf_request *sub;
+
+	sub = ocf_req_new(queue, req->core, addr, bytes, req->rw);
+	if (!sub)
+		return NULL;
+
+	if (ocf_req_alloc_map(sub)) {
+		ocf_req_put(sub);
+		return NULL;
+	}
+
+	sub->data = req->data;
+	sub->offset = addr - req->byte_position;
+	sub->part_id = req->part_id;
+	sub->seq_cutoff = req->seq_cutoff;
+	sub->cache_mode = sub->d2c ? ocf_req_cache_mode_d2c : req->cache_mode;
+	sub->ioi.io.flags = io->flags;
+	sub->ioi.io.io_class = io->io_class;
+	sub->ioi.io.dir = io->dir;
+	sub->master_io_req = req;
+	sub->complete = ocf_core_split_complete;
+
+	return sub;
+}
+
+/*
+ * Large request is split into sub-requests of at most io_split_lines cache
+ * lines, which are spread across I/O queues, so they are mapped, locked and
+ * served in parallel, and each of them holds only a short set of cache line
+ * locks. Original request completes when the last sub-request completes.
+ * Dirty counter reference taken for original request covers all of them.
+ */
+static void ocf_core_submit_io_split(struct ocf_request *req)
+{
+	ocf_cache_t cache = req->cache;
+	ocf_queue_t queue = req->io_queue, next;
+	uint64_t addr = req->byte_position;
+	uint64_t end = req->byte_position + req->byte_length;
+	uint64_t line = req->core_line_first;
+	uint32_t split_lines = cache->io_split_lines;
+	uint32_t count, i;
+	struct ocf_request *sub;
+	uint64_t sub_end;
+
+	count = OCF_DIV_ROUND_UP(req->core_line_count, split_lines);
+
+	/* One extra reference held until all sub-requests are issued */
+	env_atomic_set(&req->master_remaining, count + 1);
+
+	ocf_io_start(&req->ioi.io);
+
+	/* Reference of queue which next sub-request is submitted to */
+	ocf_queue_get(queue);
+
+	for (i = 0; i < count; i++) {
+		line += split_lines;
+		sub_end = OCF_MIN(end, ocf_lines_2_bytes(cache, line));
+
+		sub = ocf_core_split_new(req, queue, addr, sub_end - addr);
+		if (!sub)
+			break;
+
+		if (ocf_engine_hndl_req(sub))
+			ocf_core_split_complete(sub, -OCF_ERR_INVAL);
+
+		ocf_req_put(sub);
+
+		addr = sub_end;
+
+		/* With no other I/O queue stay on current one */
+		next = ocf_core_split_next_queue(cache, queue);
+		if (next) {
+			ocf_queue_put(queue);
+			queue = next;
+		}
+	}
+
+	ocf_queue_put(queue);
+
+	/* Sub-requests which couldn't be allocated */
+	req->error = (i < count) ? -OCF_ERR_NO_MEM : req->error;
+	for (; i <= count; i++) {
+		if (!env_atomic_dec_return(&req->master_remaining))
+			ocf_req_complete(req, req->error);
+	}
+}
+
 void ocf_core_volume_submit_io(struct ocf_io *io)
 {
 	struct ocf_request *req;
@@ -295,12 +481,6 @@ void ocf_core_volume_submit_io(struct ocf_io *io)
 		return;
 	}
 
-	ret = ocf_req_alloc_map(req);
-	if (ret) {
-		ocf_io_end(io, ret);
-		return;
-	}
-
 	req->part_id = ocf_user_part_class2id(cache, io->io_class);
 	req->core = core;
 	req->complete = ocf_req_complete;
@@ -309,6 +489,24 @@ void ocf_core_volume_submit_io(struct ocf_io *io)
 
 	ocf_core_update_stats(core, io);
 
+	if (ocf_core_should_split(req)) {
+		ocf_io_get(io);
+		ocf_core_seq_cutoff_update(core, req);
+		if (io->dir == OCF_WRITE)
+			ocf_trace_io(req, ocf_event_operation_wr);
+		else if (io->dir == OCF_READ)
+			ocf_trace_io(req, ocf_event_operation_rd);
+		ocf_core_submit_io_split(req);
+		return;
+	}
+
+	ret = ocf_req_alloc_map(req);
+	if (ret) {
+		dec_counter_if_req_was_dirty(req);
+		ocf_io_end(io, ret);
+		return;
+	}
+
 	ocf_io_get(io);
 	/* Prevent race condition */
 	ocf_req_get(req);
@@ -370,6 +568,34 @@ static void ocf_core_volume_submit_flush(struct ocf_io *io)
 	ocf_engine_hndl_ops_req(req);
 }
 
+/*
+ * Discard is only a hint, so instead of invalidating status granularity units
+ * which are discarded partially, and possibly dropping dirty data around the
+ * request, narrow the range invalidated in cache down to whole units. Core
+ * still gets the whole discard.
+ */
+static void ocf_core_discard_trim(struct ocf_request *req)
+{
+	ocf_cache_t cache = req->cache;
+	uint64_t unit = ocf_line_sector_size(cache);
+	uint64_t start = OCF_DIV_ROUND_UP(req->byte_position, unit) * unit;
+	uint64_t end = (req->byte_position + req->byte_length) / unit * unit;
+
+	if (start >= end) {
+		req->discard.cache_nr_sects = 0;
+		return;
+	}
+
+	req->byte_position = start;
+	req->byte_length = end - start;
+	req->core_line_first = ocf_bytes_2_lines(cache, start);
+	req->core_line_last = ocf_bytes_2_lines(cache, end - 1);
+	req->core_line_count = req->core_line_last - req->core_line_first + 1;
+
+	req->discard.cache_sector = BYTES_TO_SECTORS(start);
+	req->discard.cache_nr_sects = BYTES_TO_SECTORS(end - start);
+}
+
 static void ocf_core_volume_submit_discard(struct ocf_io *io)
 {
 	struct ocf_request *req;
@@ -400,6 +626,8 @@ static void ocf_core_volume_submit_discard(struct ocf_io *io)
 		return;
 	}
 
+	ocf_core_discard_trim(req);
+
 	ret = ocf_req_alloc_map_discard(req);
 	if (ret) {
 		ocf_io_end(io, -OCF_ERR_NO_MEM);
@@ -569,6 +797,14 @@ int ocf_core_get_info(ocf_core_t core, struct ocf_core_info *info)
 			info->core_size_bytes);
 	info->seq_cutoff_threshold = ocf_core_get_seq_cutoff_threshold(core);
 	info->seq_cutoff_policy = ocf_core_get_seq_cutoff_policy(core);
+	info->seq_cutoff_streams.sequential = env_atomic64_read(
+		&core->seq_cutoff_patterns[ocf_seq_cutoff_pattern_sequential]);
+	info->seq_cutoff_streams.reordered = env_atomic64_read(
+		&core->seq_cutoff_patterns[ocf_seq_cutoff_pattern_reordered]);
+	info->seq_cutoff_streams.strided = env_atomic64_read(
+		&core->seq_cutoff_patterns[ocf_seq_cutoff_pattern_strided]);
+	info->seq_cutoff_streams.reverse = env_atomic64_read(
+		&core->seq_cutoff_patterns[ocf_seq_cutoff_pattern_reverse]);
 
 	info->flushed = env_atomic_read(&core->flushed);
 	info->dirty = env_atomic_read(&core->runtime_meta->dirty_clines);
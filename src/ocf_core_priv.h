@@ -74,6 +74,8 @@ struct ocf_core_meta_runtime {
 };
 
 struct ocf_core {
+	ocf_core_id_t id;
+
 	struct ocf_volume front_volume;
 	struct ocf_volume volume;
 
@@ -82,6 +84,9 @@ struct ocf_core {
 
 	struct ocf_seq_cutoff *seq_cutoff;
 
+	/* Requests cut off, by pattern of sequential stream */
+	env_atomic64 seq_cutoff_patterns[ocf_seq_cutoff_pattern_max];
+
 	env_atomic flushed;
 
 	/* This bit means that core volume is initialized */
@@ -100,6 +105,10 @@ bool ocf_core_is_valid(ocf_cache_t cache, ocf_core_id_t id);
 
 ocf_core_id_t ocf_core_get_id(ocf_core_t core);
 
+ocf_core_t ocf_core_slot_alloc(ocf_cache_t cache, ocf_core_id_t id);
+
+void ocf_core_slots_free(ocf_cache_t cache);
+
 int ocf_core_volume_type_init(ocf_ctx_t ctx);
 
 #endif /* __OCF_CORE_PRIV_H__ */
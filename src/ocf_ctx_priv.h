@@ -145,6 +145,39 @@ static inline void ctx_data_secure_erase(ocf_ctx_t ctx, ctx_data_t *dst)
 	return ctx->ops->data.secure_erase(dst);
 }
 
+static inline bool ctx_data_zero_detection(ocf_ctx_t ctx)
+{
+	return !!ctx->ops->data.is_zero;
+}
+
+static inline bool ctx_data_is_zero(ocf_ctx_t ctx, ctx_data_t *src,
+		uint32_t size)
+{
+	if (!ctx->ops->data.is_zero)
+		return false;
+
+	return ctx->ops->data.is_zero(src, size);
+}
+
+static inline bool ctx_data_compression(ocf_ctx_t ctx)
+{
+	return ctx->ops->data.compress && ctx->ops->data.decompress;
+}
+
+static inline uint32_t ctx_data_compress(ocf_ctx_t ctx, ctx_data_t *dst,
+		ctx_data_t *src, uint64_t to, uint64_t from, uint32_t bytes,
+		uint32_t max_size)
+{
+	return ctx->ops->data.compress(dst, src, to, from, bytes, max_size);
+}
+
+static inline int ctx_data_decompress(ocf_ctx_t ctx, ctx_data_t *dst,
+		ctx_data_t *src, uint64_t to, uint64_t from, uint32_t size,
+		uint32_t bytes)
+{
+	return ctx->ops->data.decompress(dst, src, to, from, size, bytes);
+}
+
 static inline int ctx_cleaner_init(ocf_ctx_t ctx, ocf_cleaner_t cleaner)
 {
 	return ctx->ops->cleaner.init(cleaner);
@@ -106,6 +106,8 @@ struct ocf_io *ocf_io_new(ocf_volume_t volume, ocf_queue_t queue,
 	ioi->meta.volume = volume;
 	ioi->meta.ops = &volume->type->properties->io_ops;
 	env_atomic_set(&ioi->meta.ref_count, 1);
+	ioi->meta.timestamp = 0;
+	ioi->meta.origin = ocf_io_origin_user;
 
 	ioi->io.io_queue = queue;
 	ioi->io.addr = addr;
@@ -117,6 +119,21 @@ struct ocf_io *ocf_io_new(ocf_volume_t volume, ocf_queue_t queue,
 	return &ioi->io;
 }
 
+void ocf_io_set_timestamp(struct ocf_io *io, uint64_t timestamp)
+{
+	ocf_io_get_internal(io)->meta.timestamp = timestamp;
+}
+
+uint64_t ocf_io_get_timestamp(struct ocf_io *io)
+{
+	return ocf_io_get_internal(io)->meta.timestamp;
+}
+
+void ocf_io_set_origin(struct ocf_io *io, ocf_io_origin_t origin)
+{
+	ocf_io_get_internal(io)->meta.origin = origin;
+}
+
 /*
  * IO external API
  */
@@ -169,3 +186,22 @@ ocf_volume_t ocf_io_get_volume(struct ocf_io *io)
 
 	return ioi->meta.volume;
 }
+
+ocf_io_origin_t ocf_io_get_origin(struct ocf_io *io)
+{
+	struct ocf_io_internal *ioi = ocf_io_get_internal(io);
+
+	return ioi->meta.origin;
+}
+
+ocf_io_priority_t ocf_io_get_priority(struct ocf_io *io)
+{
+	switch (ocf_io_get_origin(io)) {
+	case ocf_io_origin_backfill:
+	case ocf_io_origin_cleaner:
+	case ocf_io_origin_trim:
+		return ocf_io_priority_background;
+	default:
+		return ocf_io_priority_foreground;
+	}
+}
@@ -45,6 +45,9 @@ int ocf_cache_io_class_get_info(ocf_cache_t cache, uint32_t io_class,
 	info->cleaning_policy_type = cache->conf_meta->cleaning_policy_type;
 
 	info->cache_mode = cache->user_parts[part_id].config->cache_mode;
+	info->promotion = cache->user_parts[part_id].config->promotion;
+	info->seq_cutoff_threshold =
+			cache->user_parts[part_id].config->seq_cutoff_threshold;
 
 	return 0;
 }
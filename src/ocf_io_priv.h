@@ -14,6 +14,10 @@ struct ocf_io_meta {
 	const struct ocf_io_ops *ops;
 	env_atomic ref_count;
 	struct ocf_request *req;
+	/* Submission time of IO with measured latency, 0 otherwise */
+	uint64_t timestamp;
+	/* Origin of IO submitted by OCF */
+	ocf_io_origin_t origin;
 };
 
 
@@ -30,6 +34,12 @@ struct ocf_io *ocf_io_new(ocf_volume_t volume, ocf_queue_t queue,
 		uint64_t addr, uint32_t bytes, uint32_t dir,
 		uint32_t io_class, uint64_t flags);
 
+void ocf_io_set_timestamp(struct ocf_io *io, uint64_t timestamp);
+
+uint64_t ocf_io_get_timestamp(struct ocf_io *io);
+
+void ocf_io_set_origin(struct ocf_io *io, ocf_io_origin_t origin);
+
 static inline void ocf_io_start(struct ocf_io *io)
 {
 	/*
@@ -7,6 +7,7 @@
 #include "ocf_lru.h"
 #include "utils/utils_cleaner.h"
 #include "utils/utils_cache_line.h"
+#include "utils/utils_user_part.h"
 #include "concurrency/ocf_concurrency.h"
 #include "mngt/ocf_mngt_common.h"
 #include "engine/engine_zero.h"
@@ -293,6 +294,7 @@ void ocf_lru_rm_cline(ocf_cache_t cache, ocf_cache_line_t cline)
 	struct ocf_part *part = &cache->user_parts[part_id].part;
 
 	ocf_lru_repart(cache, cline, part, &cache->free);
+	ocf_trimmer_add(cache, cline);
 }
 
 
@@ -677,6 +679,33 @@ static void ocf_lru_invalidate(ocf_cache_t cache, ocf_cache_line_t cline,
 			part_counters[part_id].cached_clines);
 }
 
+/* Map cacheline taken for the request to the first unmapped request entry,
+ * starting search at *req_idx. Cacheline must be write locked. */
+static void ocf_lru_map_req_cline(struct ocf_request *req, unsigned *req_idx,
+		ocf_cache_line_t cline)
+{
+	struct ocf_alock *alock = ocf_cache_line_concurrency(req->cache);
+	unsigned idx = *req_idx;
+
+	/* find next unmapped cacheline in request */
+	while (idx + 1 < req->core_line_count &&
+			req->map[idx].status != LOOKUP_MISS) {
+		idx++;
+	}
+
+	ENV_BUG_ON(req->map[idx].status != LOOKUP_MISS);
+
+	ocf_map_cache_line(req, idx, cline);
+
+	req->map[idx].status = LOOKUP_REMAPPED;
+	ocf_engine_patch_req_info(req->cache, req, idx);
+
+	ocf_alock_mark_index_locked(alock, req, idx, true);
+	req->alock_rw = OCF_WRITE;
+
+	*req_idx = idx + 1;
+}
+
 /* Assign cachelines from src_part to the request req. src_part is either
  * user partition (if inserted in the cache) or freelist partition. In case
  * of user partition mapped cachelines are invalidated (evicted from the cache)
@@ -689,7 +718,6 @@ static void ocf_lru_invalidate(ocf_cache_t cache, ocf_cache_line_t cline,
 uint32_t ocf_lru_req_clines(struct ocf_request *req,
 		struct ocf_part *src_part, uint32_t cline_no)
 {
-	struct ocf_alock* alock;
 	struct ocf_lru_iter iter;
 	uint32_t i;
 	ocf_cache_line_t cline;
@@ -736,29 +764,13 @@ uint32_t ocf_lru_req_clines(struct ocf_request *req,
 		/* TODO: if atomic mode is restored, need to zero metadata
 		 * before proceeding with cleaning (see version <= 20.12) */
 
-		/* find next unmapped cacheline in request */
-		while (req_idx + 1 < req->core_line_count &&
-				req->map[req_idx].status != LOOKUP_MISS) {
-			req_idx++;
-		}
-
-		ENV_BUG_ON(req->map[req_idx].status != LOOKUP_MISS);
-
 		if (src_part->id != PARTITION_FREELIST) {
 			ocf_lru_invalidate(cache, cline, core_id, src_part->id);
 			_lru_unlock_hash(&iter, core_id, core_line);
 		}
 
-		ocf_map_cache_line(req, req_idx, cline);
-
-		req->map[req_idx].status = LOOKUP_REMAPPED;
-		ocf_engine_patch_req_info(cache, req, req_idx);
+		ocf_lru_map_req_cline(req, &req_idx, cline);
 
-		alock = ocf_cache_line_concurrency(iter.cache);
-		ocf_alock_mark_index_locked(alock, req, req_idx, true);
-		req->alock_rw = OCF_WRITE;
-
-		++req_idx;
 		++i;
 		/* Number of cachelines to evict have to match space in the
 		 * request */
@@ -768,6 +780,137 @@ uint32_t ocf_lru_req_clines(struct ocf_request *req,
 	return i;
 }
 
+/* Number of write frontier positions examined per requested cacheline before
+ * log-structured allocation gives up */
+#define OCF_LRU_LOG_SCAN_FACTOR 4
+
+/* Check whether clean cachelines of user partition can be evicted at write
+ * frontier to map request of dst_part. Same rules as for LRU eviction apply:
+ * overflown partitions are always evicted, otherwise partition must allow
+ * eviction, must not have higher priority than dst_part and must exceed its
+ * minimum size. */
+static bool lru_log_can_evict(ocf_cache_t cache,
+		struct ocf_user_part *user_part, struct ocf_user_part *dst_part)
+{
+	if (ocf_user_part_overflow_size(cache, user_part) > 0)
+		return true;
+
+	if (!user_part->config->flags.eviction)
+		return false;
+
+	if (user_part->config->priority < dst_part->config->priority)
+		return false;
+
+	return ocf_part_get_occupancy(&user_part->part) >
+			ocf_user_part_get_min_size(cache, user_part);
+}
+
+/* Take cacheline at given physical position of write frontier and move it
+ * to dst_part. Free cachelines are taken as is, clean cachelines are evicted.
+ * If src_part is not NULL, only cachelines of src_part are taken.
+ * Returns end_marker if cacheline is dirty, in use or not evictable.
+ * - returned cacheline is write locked
+ * - evicted cacheline is invalidated */
+static ocf_cache_line_t lru_log_take(struct ocf_lru_iter *iter,
+		ocf_cache_line_t phys, struct ocf_user_part *src_only,
+		struct ocf_user_part *dst_part)
+{
+	ocf_cache_t cache = iter->cache;
+	ocf_cache_line_t cline = ocf_metadata_map_phy2lg(cache, phys);
+	uint32_t lru_idx = cline % OCF_NUM_LRU_LISTS;
+	struct ocf_user_part *user_part;
+	struct ocf_part *src_part = NULL;
+	ocf_part_id_t part_id;
+	ocf_core_id_t core_id = OCF_CORE_ID_INVALID;
+	uint64_t core_line = 0;
+
+	ocf_metadata_lru_wr_lock(&cache->metadata.lock, lru_idx);
+
+	part_id = ocf_metadata_get_partition_id(cache, cline);
+	if (part_id == PARTITION_FREELIST) {
+		if (!src_only && ocf_cache_line_try_lock_wr(iter->c, cline))
+			src_part = &cache->free;
+	} else {
+		user_part = &cache->user_parts[part_id];
+		if ((src_only ? user_part == src_only :
+				lru_log_can_evict(cache, user_part, dst_part)) &&
+				_lru_iter_evition_lock(iter, cline,
+					&core_id, &core_line)) {
+			src_part = &user_part->part;
+		}
+	}
+
+	/* dirty status can't change once cacheline is write locked */
+	if (src_part && src_part != &cache->free &&
+			metadata_test_dirty(cache, cline)) {
+		_lru_unlock_hash(iter, core_id, core_line);
+		ocf_cache_line_unlock_wr(iter->c, cline);
+		src_part = NULL;
+	}
+
+	if (src_part)
+		ocf_lru_repart_locked(cache, cline, src_part, &dst_part->part);
+
+	ocf_metadata_lru_wr_unlock(&cache->metadata.lock, lru_idx);
+
+	if (!src_part)
+		return end_marker;
+
+	if (src_part != &cache->free) {
+		ocf_lru_invalidate(cache, cline, core_id, part_id);
+		_lru_unlock_hash(iter, core_id, core_line);
+	}
+
+	return cline;
+}
+
+/* Assign cachelines at write frontier of log-structured allocation to the
+ * request req. Frontier moves through cache device in physical cacheline
+ * order, so cachelines assigned to subsequent requests are physically
+ * contiguous whenever possible. Frontier positions taken by dirty or busy
+ * cachelines are skipped. If src_part is not NULL, only clean cachelines of
+ * src_part are evicted and free cachelines are skipped as well. Number of
+ * assigned cachelines is returned - it is up to the caller to map the rest
+ * with ocf_lru_req_clines().
+ * NOTE: the same locking rules as for ocf_lru_req_clines() apply.
+ */
+uint32_t ocf_lru_req_clines_log(struct ocf_request *req,
+		struct ocf_user_part *src_part, uint32_t cline_no)
+{
+	ocf_cache_t cache = req->cache;
+	ocf_cache_line_t entries = ocf_metadata_collision_table_entries(cache);
+	struct ocf_user_part *dst_part;
+	struct ocf_lru_iter iter;
+	ocf_cache_line_t cline, phys;
+	uint64_t scan, scan_max;
+	unsigned req_idx = 0;
+	uint32_t i = 0;
+
+	if (cline_no == 0)
+		return 0;
+
+	ENV_BUG_ON(ocf_engine_unmapped_count(req) < cline_no);
+	ENV_BUG_ON(req->part_id == PARTITION_FREELIST);
+	dst_part = &cache->user_parts[req->part_id];
+
+	lru_iter_eviction_init(&iter, cache, &dst_part->part, 0, req);
+
+	scan_max = (uint64_t)cline_no * OCF_LRU_LOG_SCAN_FACTOR;
+	for (scan = 0; scan < scan_max && i < cline_no; scan++) {
+		phys = env_atomic64_inc_return(&cache->alloc_log_pos) %
+				entries;
+
+		cline = lru_log_take(&iter, phys, src_part, dst_part);
+		if (cline == end_marker)
+			continue;
+
+		ocf_lru_map_req_cline(req, &req_idx, cline);
+		++i;
+	}
+
+	return i;
+}
+
 /* the caller must hold the metadata lock */
 void ocf_lru_hot_cline(ocf_cache_t cache, ocf_cache_line_t cline)
 {
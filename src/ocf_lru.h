@@ -19,6 +19,8 @@ void ocf_lru_rm_cline(struct ocf_cache *cache, ocf_cache_line_t cline);
 bool ocf_lru_can_evict(struct ocf_cache *cache);
 uint32_t ocf_lru_req_clines(struct ocf_request *req,
 		struct ocf_part *src_part, uint32_t cline_no);
+uint32_t ocf_lru_req_clines_log(struct ocf_request *req,
+		struct ocf_user_part *src_part, uint32_t cline_no);
 void ocf_lru_hot_cline(struct ocf_cache *cache, ocf_cache_line_t cline);
 void ocf_lru_add(ocf_cache_t cache, ocf_cache_line_t cline);
 void ocf_lru_init(struct ocf_cache *cache, struct ocf_part *part);
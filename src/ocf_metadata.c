@@ -18,12 +18,18 @@ static inline uint8_t ocf_atomic_addr2pos(struct ocf_cache *cache,
 		uint64_t addr)
 {
 	addr -= cache->device->metadata_offset;
-	addr = BYTES_TO_SECTORS(addr);
+	addr = ocf_bytes_2_sectors(cache, addr);
 	addr %= ocf_line_sectors(cache);
 
 	return addr;
 }
 
+/* Convert number of status sectors to number of 512 B sectors */
+static inline int ocf_atomic_pos2sectors(struct ocf_cache *cache, int count)
+{
+	return BYTES_TO_SECTORS(ocf_sectors_2_bytes(cache, count));
+}
+
 int ocf_metadata_get_atomic_entry(ocf_cache_t cache,
 		uint64_t addr, struct ocf_atomic_metadata *entry)
 {
@@ -75,7 +81,7 @@ int ocf_metadata_check_invalid_before(ocf_cache_t cache, uint64_t addr)
 			return 0;
 	}
 
-	return i;
+	return ocf_atomic_pos2sectors(cache, i);
 }
 
 int ocf_metadata_check_invalid_after(ocf_cache_t cache, uint64_t addr,
@@ -100,5 +106,5 @@ int ocf_metadata_check_invalid_after(ocf_cache_t cache, uint64_t addr,
 		count++;
 	}
 
-	return count;
+	return ocf_atomic_pos2sectors(cache, count);
 }
@@ -11,8 +11,23 @@
 #include "ocf_request.h"
 #include "mngt/ocf_mngt_common.h"
 #include "engine/cache_engine.h"
+#include "engine/engine_rd.h"
 #include "ocf_def_priv.h"
 
+/* Each queue keeps taking the same one of global metadata locks for read,
+ * so that the lock cache line stays local to the CPU serving the queue.
+ * Indexes are handed out in round robin manner. */
+static unsigned ocf_queue_next_lock_idx(ocf_cache_t cache)
+{
+	struct list_head *iter;
+	unsigned idx = 0;
+
+	list_for_each(iter, &cache->io_queues)
+		idx++;
+
+	return idx;
+}
+
 int ocf_queue_create(ocf_cache_t cache, ocf_queue_t *queue,
 		const struct ocf_queue_ops *ops)
 {
@@ -39,19 +54,46 @@ int ocf_queue_create(ocf_cache_t cache, ocf_queue_t *queue,
 		return result;
 	}
 
+	result = env_spinlock_init(&tmp_queue->map_cache.lock);
+	if (result) {
+		env_spinlock_destroy(&tmp_queue->io_list_lock);
+		ocf_mngt_cache_put(cache);
+		env_free(tmp_queue);
+		return result;
+	}
+
+	result = env_spinlock_init(&tmp_queue->deadlines.lock);
+	if (result) {
+		env_spinlock_destroy(&tmp_queue->map_cache.lock);
+		env_spinlock_destroy(&tmp_queue->io_list_lock);
+		ocf_mngt_cache_put(cache);
+		env_free(tmp_queue);
+		return result;
+	}
+
 	INIT_LIST_HEAD(&tmp_queue->io_list);
+	INIT_LIST_HEAD(&tmp_queue->deadlines.list);
 	env_atomic_set(&tmp_queue->ref_count, 1);
 	tmp_queue->cache = cache;
 	tmp_queue->ops = ops;
 
+	env_spinlock_lock(&cache->io_queues_lock);
+	tmp_queue->lock_idx = ocf_queue_next_lock_idx(cache);
+	env_spinlock_unlock(&cache->io_queues_lock);
+
 	result = ocf_queue_seq_cutoff_init(tmp_queue);
 	if (result) {
+		env_spinlock_destroy(&tmp_queue->deadlines.lock);
+		env_spinlock_destroy(&tmp_queue->map_cache.lock);
+		env_spinlock_destroy(&tmp_queue->io_list_lock);
 		ocf_mngt_cache_put(cache);
 		env_free(tmp_queue);
 		return result;
 	}
 
+	env_spinlock_lock(&cache->io_queues_lock);
 	list_add(&tmp_queue->list, &cache->io_queues);
+	env_spinlock_unlock(&cache->io_queues_lock);
 
 	*queue = tmp_queue;
 
@@ -70,11 +112,16 @@ void ocf_queue_put(ocf_queue_t queue)
 	OCF_CHECK_NULL(queue);
 
 	if (env_atomic_dec_return(&queue->ref_count) == 0) {
+		env_spinlock_lock(&queue->cache->io_queues_lock);
 		list_del(&queue->list);
+		env_spinlock_unlock(&queue->cache->io_queues_lock);
 		queue->ops->stop(queue);
 		ocf_queue_seq_cutoff_deinit(queue);
 		ocf_mngt_cache_put(queue->cache);
 		env_spinlock_destroy(&queue->io_list_lock);
+		env_spinlock_destroy(&queue->map_cache.lock);
+		env_spinlock_destroy(&queue->deadlines.lock);
+		env_free(queue->map_cache.buf);
 		env_free(queue);
 	}
 }
@@ -91,6 +138,14 @@ void ocf_io_handle(struct ocf_io *io, void *opaque)
 		req->io_if->read(req);
 }
 
+void ocf_queue_process_req(struct ocf_request *req)
+{
+	if (req->ioi.io.handle)
+		req->ioi.io.handle(&req->ioi.io, req);
+	else
+		ocf_io_handle(&req->ioi.io, req);
+}
+
 void ocf_queue_run_single(ocf_queue_t q)
 {
 	struct ocf_request *io_req = NULL;
@@ -102,10 +157,7 @@ void ocf_queue_run_single(ocf_queue_t q)
 	if (!io_req)
 		return;
 
-	if (io_req->ioi.io.handle)
-		io_req->ioi.io.handle(&io_req->ioi.io, io_req);
-	else
-		ocf_io_handle(&io_req->ioi.io, io_req);
+	ocf_queue_process_req(io_req);
 }
 
 void ocf_queue_run(ocf_queue_t q)
@@ -119,6 +171,71 @@ void ocf_queue_run(ocf_queue_t q)
 
 		OCF_COND_RESCHED(step, 128);
 	}
+
+	ocf_queue_check_deadlines(q);
+}
+
+void ocf_queue_deadline_add(struct ocf_request *req)
+{
+	ocf_queue_t q = req->io_queue;
+
+	env_spinlock_lock(&q->deadlines.lock);
+	list_add_tail(&req->hedge.list, &q->deadlines.list);
+	env_spinlock_unlock(&q->deadlines.lock);
+}
+
+void ocf_queue_deadline_del(struct ocf_request *req)
+{
+	ocf_queue_t q = req->io_queue;
+
+	env_spinlock_lock(&q->deadlines.lock);
+	/* Entry is already removed if request deadline has expired */
+	list_del_init(&req->hedge.list);
+	env_spinlock_unlock(&q->deadlines.lock);
+}
+
+/* Take the oldest request if its deadline has expired */
+static struct ocf_request *ocf_queue_deadline_pop(ocf_queue_t q)
+{
+	struct ocf_request *req = NULL;
+	uint64_t elapsed;
+
+	env_spinlock_lock(&q->deadlines.lock);
+
+	if (list_empty(&q->deadlines.list))
+		goto unlock;
+
+	req = list_first_entry(&q->deadlines.list, struct ocf_request,
+			hedge.list);
+	elapsed = env_ticks_to_nsecs(env_get_tick_count() - req->hedge.start);
+	if (elapsed < req->hedge.deadline) {
+		req = NULL;
+		goto unlock;
+	}
+
+	list_del_init(&req->hedge.list);
+	/* Cache read may complete as soon as the lock is released */
+	env_atomic_inc(&req->hedge.reads);
+
+unlock:
+	env_spinlock_unlock(&q->deadlines.lock);
+
+	return req;
+}
+
+void ocf_queue_check_deadlines(ocf_queue_t q)
+{
+	struct ocf_request *req;
+
+	OCF_CHECK_NULL(q);
+
+	if (list_empty(&q->deadlines.list))
+		return;
+
+	/* Requests are tracked in order of submission and deadline changes
+	 * slowly, so the oldest request expires first */
+	while ((req = ocf_queue_deadline_pop(q)))
+		ocf_read_generic_hedge(req);
 }
 
 void ocf_queue_set_priv(ocf_queue_t q, void *priv)
@@ -127,6 +244,12 @@ void ocf_queue_set_priv(ocf_queue_t q, void *priv)
 	q->priv = priv;
 }
 
+void ocf_queue_set_inline_continuation(ocf_queue_t q, bool enable)
+{
+	OCF_CHECK_NULL(q);
+	q->inline_continuation = enable;
+}
+
 void *ocf_queue_get_priv(ocf_queue_t q)
 {
 	OCF_CHECK_NULL(q);
@@ -15,7 +15,7 @@ struct ocf_queue {
 
 	struct list_head io_list;
 
-	/* per-queue free running global metadata lock index */
+	/* per-queue global metadata lock reader index */
 	unsigned lock_idx;
 
 	/* per-queue free running lru list index */
@@ -27,6 +27,9 @@ struct ocf_queue {
 
 	const struct ocf_queue_ops *ops;
 
+	/* Next phase of request may be run in I/O completion context */
+	bool inline_continuation;
+
 	/* Tracing reference counter */
 	env_atomic64 trace_ref_cntr;
 
@@ -36,14 +39,78 @@ struct ocf_queue {
 
 	env_atomic ref_count;
 	env_spinlock io_list_lock;
+
+	/* Number of batches of requests being pushed into the queue */
+	env_atomic kick_hold;
+
+	/* Requests waiting for cache read, in order of submission */
+	struct {
+		struct list_head list;
+		env_spinlock lock;
+	} deadlines;
+
+	/* Recycled map buffer for requests not fitting into request pool */
+	struct {
+		void *buf;
+		uint32_t lines;
+		env_spinlock lock;
+	} map_cache;
 } __attribute__((__aligned__(64)));
 
+struct ocf_request;
+
+/**
+ * @brief Run current engine phase of OCF request
+ *
+ * @param req OCF request not present on any I/O queue
+ */
+void ocf_queue_process_req(struct ocf_request *req);
+
+/**
+ * @brief Track deadline of cache read of OCF request
+ *
+ * @param req OCF request with deadline set
+ */
+void ocf_queue_deadline_add(struct ocf_request *req);
+
+/**
+ * @brief Stop tracking deadline of cache read of OCF request
+ *
+ * @param req OCF request passed to ocf_queue_deadline_add() before
+ */
+void ocf_queue_deadline_del(struct ocf_request *req);
+
 static inline void ocf_queue_kick(ocf_queue_t queue, bool allow_sync)
 {
+	/* Queue is kicked once the whole batch is pushed */
+	if (env_atomic_read(&queue->kick_hold))
+		return;
+
 	if (allow_sync && queue->ops->kick_sync)
 		queue->ops->kick_sync(queue);
 	else
 		queue->ops->kick(queue);
 }
 
+/**
+ * @brief Defer kicking the queue until batch of requests is pushed
+ *
+ * @param queue I/O queue
+ */
+static inline void ocf_queue_hold_kick(ocf_queue_t queue)
+{
+	env_atomic_inc(&queue->kick_hold);
+}
+
+/**
+ * @brief Finish pushing batch of requests and kick the queue
+ *
+ * @param queue I/O queue
+ */
+static inline void ocf_queue_release_kick(ocf_queue_t queue)
+{
+	if (!env_atomic_dec_return(&queue->kick_hold))
+		queue->ops->kick(queue);
+}
+
 #endif
@@ -6,6 +6,7 @@
 #include "ocf/ocf.h"
 #include "ocf_request.h"
 #include "ocf_cache_priv.h"
+#include "ocf_ctx_priv.h"
 #include "concurrency/ocf_metadata_concurrency.h"
 #include "utils/utils_cache_line.h"
 
@@ -43,13 +44,61 @@ static inline size_t ocf_req_sizeof_map(struct ocf_request *req)
 	return size;
 }
 
-static inline size_t ocf_req_sizeof_alock_status(struct ocf_request *req)
+/* Separately allocated maps are at least twice the size of the largest
+ * map embedded in request */
+#define OCF_REQ_MAP_BUF_MIN_LINES (2 << ocf_req_size_128)
+
+static inline size_t ocf_req_sizeof_map_buf(uint32_t lines)
 {
-	uint32_t lines = req->core_line_count;
-	size_t size = (lines * sizeof(uint8_t));
+	return lines * (sizeof(struct ocf_map_info) + sizeof(uint8_t));
+}
 
-	ENV_BUG_ON(lines == 0);
-	return size;
+/*
+ * Requests too big for request pool take their map from single-entry cache
+ * kept in the queue, so that stream of large I/Os submitted to the same
+ * queue doesn't allocate and free big map buffer for each request. Buffer
+ * capacity is rounded up to power of two to make reuse more likely.
+ */
+static void *ocf_req_map_buf_get(ocf_queue_t queue, uint32_t lines,
+		uint32_t *capacity)
+{
+	void *buf = NULL;
+
+	env_spinlock_lock(&queue->map_cache.lock);
+	if (queue->map_cache.buf && queue->map_cache.lines >= lines) {
+		buf = queue->map_cache.buf;
+		*capacity = queue->map_cache.lines;
+		queue->map_cache.buf = NULL;
+	}
+	env_spinlock_unlock(&queue->map_cache.lock);
+
+	if (buf) {
+		ENV_BUG_ON(env_memset(buf, ocf_req_sizeof_map_buf(lines), 0));
+		return buf;
+	}
+
+	*capacity = OCF_REQ_MAP_BUF_MIN_LINES;
+	while (*capacity < lines)
+		*capacity <<= 1;
+
+	return env_zalloc(ocf_req_sizeof_map_buf(*capacity), ENV_MEM_NOIO);
+}
+
+static void ocf_req_map_buf_put(ocf_queue_t queue, void *buf,
+		uint32_t capacity)
+{
+	void *old = buf;
+
+	/* Keep the bigger buffer */
+	env_spinlock_lock(&queue->map_cache.lock);
+	if (queue->map_cache.lines < capacity) {
+		old = queue->map_cache.buf;
+		queue->map_cache.buf = buf;
+		queue->map_cache.lines = capacity;
+	}
+	env_spinlock_unlock(&queue->map_cache.lock);
+
+	env_free(old);
 }
 
 int ocf_req_allocator_init(struct ocf_ctx *ocf_ctx)
@@ -129,6 +178,8 @@ struct ocf_request *ocf_req_new(ocf_queue_t queue, ocf_core_t core,
 
 	req->discard.sector = BYTES_TO_SECTORS(addr);
 	req->discard.nr_sects = BYTES_TO_SECTORS(bytes);
+	req->discard.cache_sector = req->discard.sector;
+	req->discard.cache_nr_sects = req->discard.nr_sects;
 	req->discard.handled = 0;
 
 	req->lock_idx = ocf_metadata_concurrency_next_idx(queue);
@@ -141,8 +192,8 @@ int ocf_req_alloc_map(struct ocf_request *req)
 	if (req->map)
 		return 0;
 
-	req->map = env_zalloc(ocf_req_sizeof_map(req) +
-			ocf_req_sizeof_alock_status(req), ENV_MEM_NOIO);
+	req->map = ocf_req_map_buf_get(req->io_queue, req->core_line_count,
+			&req->map_capacity);
 	if (!req->map) {
 		req->error = -OCF_ERR_NO_MEM;
 		return -OCF_ERR_NO_MEM;
@@ -221,8 +272,16 @@ void ocf_req_put(struct ocf_request *req)
 	if (!req->d2c && req->io_queue != req->cache->mngt_queue)
 		ocf_refcnt_dec(&req->cache->refcnt.metadata);
 
-	if (req->map != req->__map)
-		env_free(req->map);
+	if (req->map && req->map != req->__map)
+		ocf_req_map_buf_put(queue, req->map, req->map_capacity);
+
+	if (req->cdata)
+		ctx_data_free(req->cache->owner, req->cdata);
+
+	if (req->dedup_data)
+		ctx_data_free(req->cache->owner, req->dedup_data);
+
+	env_free(req->io_runs);
 
 	env_mpool_del(req->cache->owner->resources.req, req,
 			req->alloc_core_line_count);
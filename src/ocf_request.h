@@ -27,6 +27,9 @@ struct ocf_req_info {
 	uint32_t dirty_any;
 	/*!< Indicates that at least one request is dirty */
 
+	uint32_t zero_no;
+	/*!< Number of cache lines with all-zero data in write request */
+
 	uint32_t flush_metadata : 1;
 	/*!< This bit tells if metadata flushing is required */
 
@@ -44,6 +47,13 @@ struct ocf_req_info {
 
 	uint32_t internal : 1;
 	/**!< this is an internal request */
+
+	uint32_t zero_any : 1;
+	/*!< Request covers zero sectors or writes all-zero cache lines */
+
+	uint32_t no_cache_write : 1;
+	/*!< Request data can't be written to cache, as it doesn't fit into
+	 * compressed cache line slots or there are no free data slots */
 };
 
 struct ocf_map_info {
@@ -72,6 +82,29 @@ struct ocf_map_info {
 	uint16_t flush : 1;
 	/*!< This bit indicates if cache line need to be flushed */
 
+	uint16_t backfill : 1;
+	/*!< This bit indicates if cache line data need to be written to
+	 * cache by backfill
+	 */
+
+	uint16_t zero : 1;
+	/*!< This bit indicates that request data for cache line is all zero */
+
+	uint16_t zero_update : 1;
+	/*!< This bit indicates if zero status of cache line need to be
+	 * updated
+	 */
+
+	uint16_t dedup : 1;
+	/*!< This bit indicates that cache line data is already stored in
+	 * shared data slot and doesn't need to be written to cache
+	 */
+
+	uint16_t slot_shared : 1;
+	/*!< This bit indicates that cache line lock slot is locked through
+	 * another cache line of the request
+	 */
+
 	uint8_t start_flush;
 	/*!< If req need flush, contain first sector of range to flush */
 
@@ -89,6 +122,13 @@ struct ocf_req_discard_info {
 	sector_t nr_sects;
 		/*!< Number of sectors to be discarded */
 
+	sector_t cache_sector;
+		/*!< The start sector of range invalidated in cache */
+
+	sector_t cache_nr_sects;
+		/*!< Number of sectors invalidated in cache, range may be
+		 * narrower than the one discarded on core */
+
 	sector_t handled;
 		/*!< Number of processed sector during discard operation */
 };
@@ -140,9 +180,26 @@ struct ocf_request {
 	ctx_data_t *data;
 	/*!< Request data*/
 
+	uint32_t offset;
+	/*!< Offset of request data within data buffer */
+
 	ctx_data_t *cp_data;
 	/*!< Copy of request data */
 
+	ctx_data_t *cdata;
+	/*!< Compressed request data, freed together with request */
+
+	ctx_data_t *dedup_data;
+	/*!< Shared data slots read back to verify deduplicated cache lines,
+	 * freed together with request */
+
+	struct ocf_engine_io_run *io_runs;
+	/*!< IOs collected under metadata lock to be submitted after it is
+	 * released, freed together with request */
+
+	uint32_t io_runs_count;
+	/*!< Number of collected IOs */
+
 	uint64_t byte_position;
 	/*!< LBA byte position of request in core domain */
 
@@ -161,6 +218,9 @@ struct ocf_request {
 	uint32_t alloc_core_line_count;
 	/*! Number of core lines at time of request allocation */
 
+	uint32_t map_capacity;
+	/*! Number of core lines separately allocated map can hold */
+
 	int error;
 	/*!< This filed indicates an error for OCF request */
 
@@ -199,6 +259,9 @@ struct ocf_request {
 
 	ocf_req_cache_mode_t cache_mode;
 
+	ocf_io_origin_t io_origin;
+	/*!< Origin tagged on cache and core IO submitted for request */
+
 	log_sid_t sid;
 	/*!< Tracing sequence ID */
 
@@ -225,6 +288,33 @@ struct ocf_request {
 	uint8_t *alock_status;
 	/*!< Mapping for locked/unlocked alock entries */
 
+	uint64_t alock_wait_start;
+	/*!< Time at which request started waiting for alock entries */
+
+	struct {
+		struct list_head list;
+		/*!< Entry in deadline list of request I/O queue */
+
+		uint64_t start;
+		/*!< Time of cache read submission, 0 if not measured */
+
+		uint64_t deadline;
+		/*!< Cache read deadline (in nanoseconds) */
+
+		ctx_data_t *cache_data;
+		/*!< Private buffer of cache read */
+
+		ctx_data_t *core_data;
+		/*!< Private buffer of hedged core read */
+
+		env_atomic reads;
+		/*!< Number of cache and core reads in progress */
+
+		env_atomic completed;
+		/*!< Request has been completed by one of the reads */
+	} hedge;
+	/*!< Hedged read state */
+
 	struct ocf_map_info *map;
 
 	struct ocf_map_info __map[0];
@@ -43,6 +43,12 @@ static int ocf_seq_cutoff_stream_cmp(struct ocf_rb_node *n1,
 	if (stream1->rw > stream2->rw)
 		return 1;
 
+	if (stream1->reverse < stream2->reverse)
+		return -1;
+
+	if (stream1->reverse > stream2->reverse)
+		return 1;
+
 	if (stream1->last < stream2->last)
 		return -1;
 
@@ -85,7 +91,12 @@ static void ocf_seq_cutoff_base_init(struct ocf_seq_cutoff *base, int nstreams)
 		stream = &base->streams[i];
 		stream->last = 4096 * i;
 		stream->bytes = 0;
+		stream->len = 0;
+		stream->stride = 0;
+		stream->skipped = 0;
 		stream->rw = 0;
+		stream->reverse = false;
+		stream->pattern = ocf_seq_cutoff_pattern_sequential;
 		stream->valid = false;
 		ocf_rb_tree_insert(&base->tree, &stream->node);
 		list_add_tail(&stream->list, &base->lru);
@@ -99,8 +110,13 @@ void ocf_seq_cutoff_base_deinit(struct ocf_seq_cutoff *base)
 
 int ocf_core_seq_cutoff_init(ocf_core_t core)
 {
+	int i;
+
 	ocf_core_log(core, log_info, "Seqential cutoff init\n");
 
+	for (i = 0; i < ocf_seq_cutoff_pattern_max; i++)
+		env_atomic64_set(&core->seq_cutoff_patterns[i], 0);
+
 	core->seq_cutoff = env_vmalloc(sizeof(struct ocf_seq_cutoff_percore));
 	if (!core->seq_cutoff)
 		return -OCF_ERR_NO_MEM;
@@ -158,22 +174,194 @@ void ocf_dbg_get_seq_cutoff_status(ocf_core_t core,
 	env_rwlock_read_unlock(&core->seq_cutoff->lock);
 }
 
-static bool ocf_core_seq_cutoff_base_check(struct ocf_seq_cutoff *seq_cutoff,
-		uint64_t addr, uint32_t len, int rw, uint32_t threshold,
-		struct ocf_seq_cutoff_stream **out_stream)
+enum ocf_seq_cutoff_match {
+	/* Request continues stream within tolerance */
+	ocf_seq_cutoff_match_next,
+	/* Request follows single request stream with gap, making it strided */
+	ocf_seq_cutoff_match_stride,
+	/* Request precedes single request stream, making it reverse */
+	ocf_seq_cutoff_match_reverse,
+};
+
+static struct ocf_seq_cutoff_stream *ocf_seq_cutoff_lookup(
+		struct ocf_seq_cutoff *seq_cutoff, uint64_t pos, int rw,
+		bool reverse, bool exact)
 {
 	struct ocf_seq_cutoff_stream item = {
-		.last = addr, .rw = rw, .valid = true
+		.last = pos, .rw = rw, .reverse = reverse, .valid = true
 	};
 	struct ocf_seq_cutoff_stream *stream;
 	struct ocf_rb_node *node;
+
+	if (exact)
+		node = ocf_rb_tree_find(&seq_cutoff->tree, &item.node);
+	else
+		node = ocf_rb_tree_find_floor(&seq_cutoff->tree, &item.node);
+
+	if (!node)
+		return NULL;
+
+	stream = container_of(node, struct ocf_seq_cutoff_stream, node);
+	if (!stream->valid || stream->rw != rw || stream->reverse != reverse)
+		return NULL;
+
+	return stream;
+}
+
+/* Distance of request from expected position, positive if request is ahead */
+static int64_t ocf_seq_cutoff_distance(struct ocf_seq_cutoff_stream *stream,
+		uint64_t addr, uint32_t len)
+{
+	if (stream->reverse)
+		return (int64_t)stream->last - (int64_t)(addr + len);
+
+	return (int64_t)addr - (int64_t)stream->last;
+}
+
+static bool ocf_seq_cutoff_continues(struct ocf_seq_cutoff_stream *stream,
+		uint64_t addr, uint32_t len)
+{
+	int64_t distance = ocf_seq_cutoff_distance(stream, addr, len);
+
+	if (distance >= 0)
+		return distance <= OCF_SEQ_CUTOFF_TOLERANCE;
+
+	/* Request behind the stream continues it only if it fills the gap left
+	 * by request reordered ahead of it, otherwise it's a rewrite */
+	return -distance <= OCF_SEQ_CUTOFF_TOLERANCE && stream->skipped >= len;
+}
+
+static inline bool ocf_seq_cutoff_is_single(
+		struct ocf_seq_cutoff_stream *stream)
+{
+	return stream->bytes == stream->len && !stream->reverse;
+}
+
+static struct ocf_seq_cutoff_stream *ocf_seq_cutoff_lookup_next(
+		struct ocf_seq_cutoff *seq_cutoff, uint64_t pos, int rw,
+		bool reverse, bool exact, uint64_t addr, uint32_t len)
+{
+	struct ocf_seq_cutoff_stream *stream;
+
+	stream = ocf_seq_cutoff_lookup(seq_cutoff, pos, rw, reverse, exact);
+	if (stream && ocf_seq_cutoff_continues(stream, addr, len))
+		return stream;
+
+	return NULL;
+}
+
+/*
+ * Streams are looked up at exact expected position first, so that nearby
+ * streams don't shadow each other, then within tolerance ahead of and behind
+ * the request.
+ */
+static struct ocf_seq_cutoff_stream *ocf_seq_cutoff_match(
+		struct ocf_seq_cutoff *seq_cutoff, uint64_t addr, uint32_t len,
+		int rw, enum ocf_seq_cutoff_match *match)
+{
+	const uint64_t tolerance = OCF_SEQ_CUTOFF_TOLERANCE;
+	uint64_t end = addr + len;
+	struct ocf_seq_cutoff_stream *stream;
+
+	*match = ocf_seq_cutoff_match_next;
+
+	stream = ocf_seq_cutoff_lookup_next(seq_cutoff, addr, rw, false, true,
+			addr, len);
+	if (stream)
+		return stream;
+
+	stream = ocf_seq_cutoff_lookup(seq_cutoff, addr, rw, false, false);
+	if (stream) {
+		if (ocf_seq_cutoff_is_single(stream) &&
+				addr - stream->last <=
+					OCF_SEQ_CUTOFF_MAX_STRIDE) {
+			*match = ocf_seq_cutoff_match_stride;
+			return stream;
+		}
+
+		if (ocf_seq_cutoff_continues(stream, addr, len))
+			return stream;
+	}
+
+	stream = ocf_seq_cutoff_lookup_next(seq_cutoff, addr + tolerance, rw,
+			false, false, addr, len);
+	if (stream)
+		return stream;
+
+	stream = ocf_seq_cutoff_lookup_next(seq_cutoff, end, rw, true, true,
+			addr, len);
+	if (stream)
+		return stream;
+
+	stream = ocf_seq_cutoff_lookup_next(seq_cutoff, end + tolerance, rw,
+			true, false, addr, len);
+	if (stream)
+		return stream;
+
+	stream = ocf_seq_cutoff_lookup_next(seq_cutoff, end, rw, true, false,
+			addr, len);
+	if (stream)
+		return stream;
+
+	/* Single request stream starting where request ends makes reverse
+	 * stream, assuming its request had the same length */
+	stream = ocf_seq_cutoff_lookup(seq_cutoff, end + len, rw, false, true);
+	if (!stream) {
+		stream = ocf_seq_cutoff_lookup(seq_cutoff,
+				end + len + tolerance, rw, false, false);
+	}
+	if (stream && ocf_seq_cutoff_is_single(stream) &&
+			stream->last - stream->len >= end &&
+			stream->last - stream->len - end <= tolerance) {
+		*match = ocf_seq_cutoff_match_reverse;
+		return stream;
+	}
+
+	return NULL;
+}
+
+static enum ocf_seq_cutoff_pattern ocf_seq_cutoff_match_pattern(
+		struct ocf_seq_cutoff_stream *stream, uint64_t addr,
+		uint32_t len, enum ocf_seq_cutoff_match match)
+{
+	if (match == ocf_seq_cutoff_match_stride)
+		return ocf_seq_cutoff_pattern_strided;
+
+	if (match == ocf_seq_cutoff_match_reverse)
+		return ocf_seq_cutoff_pattern_reverse;
+
+	if (ocf_seq_cutoff_distance(stream, addr, len) < 0 &&
+			!stream->reverse) {
+		return ocf_seq_cutoff_pattern_reordered;
+	}
+
+	if (stream->pattern == ocf_seq_cutoff_pattern_sequential &&
+			ocf_seq_cutoff_distance(stream, addr, len)) {
+		return ocf_seq_cutoff_pattern_reordered;
+	}
+
+	return stream->pattern;
+}
+
+static bool ocf_core_seq_cutoff_base_check(struct ocf_seq_cutoff *seq_cutoff,
+		uint64_t addr, uint32_t len, int rw, uint32_t threshold,
+		struct ocf_seq_cutoff_stream **out_stream,
+		enum ocf_seq_cutoff_pattern *pattern)
+{
+	struct ocf_seq_cutoff_stream *stream;
+	enum ocf_seq_cutoff_match match;
 	bool result = false;
 
-	node = ocf_rb_tree_find(&seq_cutoff->tree, &item.node);
-	if (node) {
-		stream = container_of(node, struct ocf_seq_cutoff_stream, node);
-		if (stream->bytes + len >= threshold)
+	stream = ocf_seq_cutoff_match(seq_cutoff, addr, len, rw, &match);
+	if (stream) {
+		/* Stride is not trusted until confirmed by next request */
+		if (match != ocf_seq_cutoff_match_stride &&
+				stream->bytes + len >= threshold) {
 			result = true;
+		}
+
+		*pattern = ocf_seq_cutoff_match_pattern(stream, addr, len,
+				match);
 
 		if (out_stream)
 			*out_stream = stream;
@@ -182,15 +370,37 @@ static bool ocf_core_seq_cutoff_base_check(struct ocf_seq_cutoff *seq_cutoff,
 	return result;
 }
 
+/* IO class threshold, if set, overrides core sequential cutoff config */
+static void ocf_seq_cutoff_get_config(ocf_core_t core,
+		struct ocf_request *req, ocf_seq_cutoff_policy *policy,
+		uint32_t *threshold)
+{
+	ocf_cache_t cache = ocf_core_get_cache(core);
+	uint32_t class_threshold =
+		cache->user_parts[req->part_id].config->seq_cutoff_threshold;
+
+	if (class_threshold != OCF_IO_CLASS_SEQ_CUTOFF_INHERIT) {
+		*policy = ocf_seq_cutoff_policy_always;
+		*threshold = class_threshold;
+		return;
+	}
+
+	*policy = ocf_core_get_seq_cutoff_policy(core);
+	*threshold = ocf_core_get_seq_cutoff_threshold(core);
+}
+
 bool ocf_core_seq_cutoff_check(ocf_core_t core, struct ocf_request *req)
 {
-	ocf_seq_cutoff_policy policy = ocf_core_get_seq_cutoff_policy(core);
-	uint32_t threshold = ocf_core_get_seq_cutoff_threshold(core);
+	ocf_seq_cutoff_policy policy;
+	uint32_t threshold;
 	ocf_cache_t cache = ocf_core_get_cache(core);
 	struct ocf_seq_cutoff_stream *queue_stream = NULL;
 	struct ocf_seq_cutoff_stream *core_stream = NULL;
+	enum ocf_seq_cutoff_pattern pattern;
 	bool result;
 
+	ocf_seq_cutoff_get_config(core, req, &policy, &threshold);
+
 	switch (policy) {
 		case ocf_seq_cutoff_policy_always:
 			break;
@@ -209,20 +419,24 @@ bool ocf_core_seq_cutoff_check(ocf_core_t core, struct ocf_request *req)
 	env_rwlock_read_lock(&req->io_queue->seq_cutoff->lock);
 	result = ocf_core_seq_cutoff_base_check(req->io_queue->seq_cutoff,
 			req->byte_position, req->byte_length, req->rw,
-			threshold, &queue_stream);
+			threshold, &queue_stream, &pattern);
 	env_rwlock_read_unlock(&req->io_queue->seq_cutoff->lock);
 	if (queue_stream)
-		return result;
+		goto out;
 
 	env_rwlock_read_lock(&core->seq_cutoff->lock);
 	result = ocf_core_seq_cutoff_base_check(core->seq_cutoff,
 			req->byte_position, req->byte_length, req->rw,
-			threshold, &core_stream);
+			threshold, &core_stream, &pattern);
 	env_rwlock_read_unlock(&core->seq_cutoff->lock);
 
 	if (core_stream)
 		req->seq_cutoff_core = true;
 
+out:
+	if (result)
+		env_atomic64_inc(&core->seq_cutoff_patterns[pattern]);
+
 	return result;
 }
 
@@ -231,24 +445,60 @@ static struct ocf_seq_cutoff_stream *ocf_core_seq_cutoff_base_update(
 		uint64_t addr, uint32_t len, int rw, bool insert)
 {
 	struct ocf_seq_cutoff_stream item = {
-		.last = addr, .rw = rw, .valid = true
+		.rw = rw, .valid = true
 	};
 	struct ocf_seq_cutoff_stream *stream;
-	struct ocf_rb_node *node;
+	enum ocf_seq_cutoff_match match;
+	int64_t distance;
 	bool can_update;
 
-	node = ocf_rb_tree_find(&seq_cutoff->tree, &item.node);
-	if (node) {
-		stream = container_of(node, struct ocf_seq_cutoff_stream, node);
-		item.last = addr + len;
+	stream = ocf_seq_cutoff_match(seq_cutoff, addr, len, rw, &match);
+	if (stream) {
+		item.reverse = stream->reverse;
+		item.last = stream->last;
+		distance = ocf_seq_cutoff_distance(stream, addr, len);
+		stream->pattern = ocf_seq_cutoff_match_pattern(stream, addr,
+				len, match);
+
+		switch (match) {
+		case ocf_seq_cutoff_match_stride:
+			/* Gap may be also left by reordered request */
+			stream->stride = addr - stream->last;
+			stream->skipped = OCF_MIN(stream->stride,
+					(uint32_t)OCF_SEQ_CUTOFF_TOLERANCE);
+			item.last = addr + len + stream->stride;
+			break;
+		case ocf_seq_cutoff_match_reverse:
+			item.reverse = true;
+			item.last = addr;
+			break;
+		case ocf_seq_cutoff_match_next:
+			if (distance < 0) {
+				/* Request filled the gap, so it wasn't stride */
+				item.last -= stream->stride;
+				stream->stride = 0;
+				stream->skipped -= len;
+				break;
+			}
+
+			stream->skipped = OCF_MIN(
+					stream->skipped + (uint64_t)distance,
+					OCF_SEQ_CUTOFF_TOLERANCE);
+			item.last = item.reverse ? addr :
+					addr + len + stream->stride;
+			break;
+		}
+
 		can_update = ocf_rb_tree_can_update(&seq_cutoff->tree,
-				node, &item.node);
-		stream->last = addr + len;
+				&stream->node, &item.node);
+		stream->last = item.last;
+		stream->reverse = item.reverse;
+		stream->len = len;
 		stream->bytes += len;
 		stream->req_count++;
 		if (!can_update) {
-			ocf_rb_tree_remove(&seq_cutoff->tree, node);
-			ocf_rb_tree_insert(&seq_cutoff->tree, node);
+			ocf_rb_tree_remove(&seq_cutoff->tree, &stream->node);
+			ocf_rb_tree_insert(&seq_cutoff->tree, &stream->node);
 		}
 		list_move_tail(&stream->list, &seq_cutoff->lru);
 
@@ -262,6 +512,11 @@ static struct ocf_seq_cutoff_stream *ocf_core_seq_cutoff_base_update(
 		stream->rw = rw;
 		stream->last = addr + len;
 		stream->bytes = len;
+		stream->len = len;
+		stream->stride = 0;
+		stream->skipped = 0;
+		stream->reverse = false;
+		stream->pattern = ocf_seq_cutoff_pattern_sequential;
 		stream->req_count = 1;
 		stream->valid = true;
 		ocf_rb_tree_insert(&seq_cutoff->tree, &stream->node);
@@ -286,6 +541,11 @@ static void ocf_core_seq_cutoff_base_promote(
 	dst_stream->rw = src_stream->rw;
 	dst_stream->last = src_stream->last;
 	dst_stream->bytes = src_stream->bytes;
+	dst_stream->len = src_stream->len;
+	dst_stream->stride = src_stream->stride;
+	dst_stream->skipped = src_stream->skipped;
+	dst_stream->reverse = src_stream->reverse;
+	dst_stream->pattern = src_stream->pattern;
 	dst_stream->req_count = src_stream->req_count;
 	dst_stream->valid = true;
 	ocf_rb_tree_insert(&dst_seq_cutoff->tree, &dst_stream->node);
@@ -296,13 +556,15 @@ static void ocf_core_seq_cutoff_base_promote(
 
 void ocf_core_seq_cutoff_update(ocf_core_t core, struct ocf_request *req)
 {
-	ocf_seq_cutoff_policy policy = ocf_core_get_seq_cutoff_policy(core);
-	uint32_t threshold = ocf_core_get_seq_cutoff_threshold(core);
+	ocf_seq_cutoff_policy policy;
+	uint32_t threshold;
 	uint32_t promotion_count =
 			ocf_core_get_seq_cutoff_promotion_count(core);
 	struct ocf_seq_cutoff_stream *stream;
 	bool promote = false;
 
+	ocf_seq_cutoff_get_config(core, req, &policy, &threshold);
+
 	if (policy == ocf_seq_cutoff_policy_never)
 		return;
 
@@ -10,11 +10,40 @@
 #include "ocf_request.h"
 #include "utils/utils_rbtree.h"
 
+/*
+ * Request which lands up to OCF_SEQ_CUTOFF_TOLERANCE bytes away from expected
+ * position of stream (e.g. reordered by multi-queue submission) continues
+ * the stream.
+ */
+#define OCF_SEQ_CUTOFF_TOLERANCE (64 * KiB)
+
+/* Maximal gap between requests of strided stream */
+#define OCF_SEQ_CUTOFF_MAX_STRIDE (1 * MiB)
+
+enum ocf_seq_cutoff_pattern {
+	ocf_seq_cutoff_pattern_sequential,
+	ocf_seq_cutoff_pattern_reordered,
+	ocf_seq_cutoff_pattern_strided,
+	ocf_seq_cutoff_pattern_reverse,
+	ocf_seq_cutoff_pattern_max,
+};
+
 struct ocf_seq_cutoff_stream {
+	/* Expected position of next request - its start address for forward
+	 * streams and its end address for reverse streams */
 	uint64_t last;
 	uint64_t bytes;
+	/* Length of last request */
+	uint32_t len;
+	/* Gap between consecutive requests of strided stream */
+	uint32_t stride;
+	/* Bytes skipped by requests which went ahead of the stream, which
+	 * may be still filled by reordered requests */
+	uint32_t skipped;
 	uint32_t rw : 1;
 	uint32_t valid : 1;
+	uint32_t reverse : 1;
+	uint32_t pattern : 2;
 	uint32_t req_count : 16;
 	struct ocf_rb_node node;
 	struct list_head list;
@@ -33,6 +33,7 @@ static inline uint32_t ocf_evict_part_do(struct ocf_request *req,
 {
 	uint32_t unmapped = ocf_engine_unmapped_count(req);
 	uint32_t to_evict = 0;
+	uint32_t evicted = 0;
 
 	to_evict = ocf_evict_calculate(req->cache, user_part, unmapped);
 
@@ -42,7 +43,14 @@ static inline uint32_t ocf_evict_part_do(struct ocf_request *req,
 		return 0;
 	}
 
-	return ocf_lru_req_clines(req, &user_part->part, to_evict);
+	if (req->cache->alloc_policy == ocf_alloc_policy_log) {
+		evicted = ocf_lru_req_clines_log(req, user_part, to_evict);
+		if (evicted >= to_evict)
+			return evicted;
+	}
+
+	return evicted + ocf_lru_req_clines(req, &user_part->part,
+			to_evict - evicted);
 }
 
 static inline uint32_t ocf_evict_user_partitions(ocf_cache_t cache,
@@ -111,9 +119,22 @@ static inline uint32_t ocf_remap_do(struct ocf_request *req)
 	uint32_t remap_cline_no = ocf_engine_unmapped_count(req);
 	uint32_t remapped = 0;
 
-	/* First attempt to map from freelist */
-	if (ocf_lru_num_free(cache) > 0)
-		remapped = ocf_lru_req_clines(req, &cache->free, remap_cline_no);
+	if (cache->alloc_policy == ocf_alloc_policy_log) {
+		/* Allocate at write frontier, fall back to regular
+		 * allocation only if the frontier is congested */
+		remapped = ocf_lru_req_clines_log(req, NULL, remap_cline_no);
+		if (remapped >= remap_cline_no)
+			return remapped;
+	}
+
+	/* First attempt to map from freelist. Deduplicated cache has more
+	 * cache lines than data slots, so if data slots are running out
+	 * cache lines are evicted instead to release theirs. */
+	if (ocf_lru_num_free(cache) > 0 && ocf_dedup_slots_available(cache,
+			remap_cline_no - remapped)) {
+		remapped += ocf_lru_req_clines(req, &cache->free,
+				remap_cline_no - remapped);
+	}
 
 	if (remapped >= remap_cline_no)
 		return remapped;
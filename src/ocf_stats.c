@@ -205,13 +205,14 @@ void ocf_core_stats_initialize(ocf_core_t core)
 
 void ocf_core_stats_initialize_all(ocf_cache_t cache)
 {
+	ocf_core_t core;
 	ocf_core_id_t id;
 
-	for (id = 0; id < OCF_CORE_MAX; id++) {
+	for_each_core_all(cache, core, id) {
 		if (!env_bit_test(id, cache->conf_meta->valid_core_bitmap))
 			continue;
 
-		ocf_core_stats_initialize(&cache->core[id]);
+		ocf_core_stats_initialize(core);
 	}
 }
 
@@ -0,0 +1,236 @@
+/*
+ * Copyright(c) 2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "ocf_warm_state.h"
+#include "ocf_cache_priv.h"
+#include "ocf_priv.h"
+#include "metadata/metadata.h"
+#include "promotion/promotion.h"
+#include "utils/utils_cache_line.h"
+#include "utils/utils_user_part.h"
+
+#define OCF_WARM_STATE_MAGIC 0x5741524d
+#define OCF_WARM_STATE_VERSION 1
+
+/* First page of reserved area is used for cache volume test on attach */
+#define OCF_WARM_STATE_OFFSET PAGE_SIZE
+
+/* Limit of hot cache lines gathered from LRU lists */
+#define OCF_WARM_STATE_MAX_HOT_LINES (64 * 1024)
+
+struct ocf_warm_state_header {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t crc;
+	uint32_t saved_time;
+	uint64_t cache_line_size;
+	uint32_t range_count;
+	uint32_t promotion_type;
+	uint32_t promotion_size;
+	uint32_t reserved;
+} __attribute__((packed));
+
+static struct ocf_warm_state_header *ocf_warm_state_get(ocf_cache_t cache,
+		uint32_t *payload_size)
+{
+	uint32_t size;
+	void *area;
+
+	area = ocf_metadata_get_reserved(cache, &size);
+	ENV_BUG_ON(size <= OCF_WARM_STATE_OFFSET +
+			sizeof(struct ocf_warm_state_header));
+
+	*payload_size = size - OCF_WARM_STATE_OFFSET -
+			sizeof(struct ocf_warm_state_header);
+
+	return area + OCF_WARM_STATE_OFFSET;
+}
+
+static int _ocf_warm_state_range_cmp(const void *a, const void *b)
+{
+	const struct ocf_warm_state_range *r1 = a, *r2 = b;
+
+	if (r1->core_id != r2->core_id)
+		return r1->core_id < r2->core_id ? -1 : 1;
+
+	if (r1->core_line != r2->core_line)
+		return r1->core_line < r2->core_line ? -1 : 1;
+
+	return 0;
+}
+
+static uint32_t _ocf_warm_state_get_hot_list(ocf_cache_t cache,
+		struct ocf_lru_list *list, struct ocf_warm_state_range *lines,
+		uint32_t count, uint32_t max)
+{
+	ocf_cache_line_t cline = list->head;
+	ocf_core_id_t core_id;
+	uint64_t core_line;
+
+	while (count < max && cline < cache->device->collision_table_entries) {
+		if (!ocf_metadata_get_lru(cache, cline)->hot)
+			break;
+
+		ocf_metadata_get_core_info(cache, cline, &core_id, &core_line);
+
+		lines[count].core_line = core_line;
+		lines[count].count = 1;
+		lines[count].core_id = core_id;
+		lines[count].reserved = 0;
+		count++;
+
+		cline = ocf_metadata_get_lru(cache, cline)->next;
+	}
+
+	return count;
+}
+
+/* Gather hot cache lines into sorted and merged core line ranges */
+static uint32_t _ocf_warm_state_get_hot_ranges(ocf_cache_t cache,
+		struct ocf_warm_state_range *ranges, uint32_t max_ranges)
+{
+	struct ocf_warm_state_range *lines;
+	struct ocf_user_part *user_part;
+	struct ocf_lru_part_meta *lru;
+	ocf_part_id_t part_id;
+	uint32_t count = 0, merged = 0;
+	uint32_t i;
+
+	lines = env_vmalloc(OCF_WARM_STATE_MAX_HOT_LINES * sizeof(*lines));
+	if (!lines)
+		return 0;
+
+	for_each_user_part(cache, user_part, part_id) {
+		for (i = 0; i < OCF_NUM_LRU_LISTS; i++) {
+			lru = &user_part->part.runtime->lru[i];
+			count = _ocf_warm_state_get_hot_list(cache, &lru->clean,
+					lines, count, OCF_WARM_STATE_MAX_HOT_LINES);
+			count = _ocf_warm_state_get_hot_list(cache, &lru->dirty,
+					lines, count, OCF_WARM_STATE_MAX_HOT_LINES);
+		}
+	}
+
+	env_sort(lines, count, sizeof(*lines), _ocf_warm_state_range_cmp, NULL);
+
+	for (i = 0; i < count; i++) {
+		if (merged && ranges[merged - 1].core_id == lines[i].core_id &&
+				ranges[merged - 1].core_line +
+				ranges[merged - 1].count == lines[i].core_line) {
+			ranges[merged - 1].count++;
+			continue;
+		}
+
+		if (merged == max_ranges)
+			break;
+
+		ranges[merged++] = lines[i];
+	}
+
+	env_vfree(lines);
+
+	return merged;
+}
+
+void ocf_warm_state_build(ocf_cache_t cache)
+{
+	struct ocf_warm_state_header *hdr;
+	struct ocf_warm_state_range *ranges;
+	uint32_t payload_size, ranges_size;
+	void *payload;
+
+	hdr = ocf_warm_state_get(cache, &payload_size);
+	payload = hdr + 1;
+	ranges = payload;
+
+	/* Hot ranges may take up to half of the snapshot, promotion policy
+	 * state takes the rest */
+	hdr->range_count = _ocf_warm_state_get_hot_ranges(cache, ranges,
+			payload_size / 2 / sizeof(*ranges));
+	ranges_size = hdr->range_count * sizeof(*ranges);
+
+	hdr->promotion_type = cache->conf_meta->promotion_policy_type;
+	hdr->promotion_size = ocf_promotion_save_state(cache->promotion_policy,
+			payload + ranges_size, payload_size - ranges_size);
+
+	hdr->magic = OCF_WARM_STATE_MAGIC;
+	hdr->version = OCF_WARM_STATE_VERSION;
+	hdr->saved_time = env_ticks_to_secs(env_get_tick_count());
+	hdr->cache_line_size = ocf_line_size(cache);
+	hdr->reserved = 0;
+	hdr->crc = env_crc32(0, payload, ranges_size + hdr->promotion_size);
+}
+
+static struct ocf_warm_state_header *ocf_warm_state_get_valid(
+		ocf_cache_t cache)
+{
+	struct ocf_warm_state_header *hdr;
+	uint32_t payload_size;
+
+	hdr = ocf_warm_state_get(cache, &payload_size);
+
+	if (hdr->magic != OCF_WARM_STATE_MAGIC ||
+			hdr->version != OCF_WARM_STATE_VERSION) {
+		return NULL;
+	}
+
+	if (hdr->cache_line_size != ocf_line_size(cache))
+		return NULL;
+
+	if (hdr->range_count > payload_size / sizeof(struct ocf_warm_state_range))
+		return NULL;
+
+	if (hdr->promotion_size > payload_size - hdr->range_count *
+			sizeof(struct ocf_warm_state_range)) {
+		return NULL;
+	}
+
+	if (hdr->crc != env_crc32(0, (void *)(hdr + 1), hdr->range_count *
+			sizeof(struct ocf_warm_state_range) +
+			hdr->promotion_size)) {
+		return NULL;
+	}
+
+	return hdr;
+}
+
+bool ocf_warm_state_restore(ocf_cache_t cache, bool clean)
+{
+	struct ocf_warm_state_header *hdr;
+	void *promotion_state;
+
+	hdr = ocf_warm_state_get_valid(cache);
+	if (!hdr)
+		return false;
+
+	if (hdr->promotion_type == cache->conf_meta->promotion_policy_type) {
+		promotion_state = (void *)(hdr + 1) + hdr->range_count *
+				sizeof(struct ocf_warm_state_range);
+		ocf_promotion_load_state(cache->promotion_policy,
+				promotion_state, hdr->promotion_size);
+	}
+
+	/* Cleaning policy metadata is persistent only across clean shutdown */
+	if (clean)
+		ocf_cleaning_rebase_timestamps(cache, hdr->saved_time);
+
+	ocf_cache_log(cache, log_info, "Restored warm state: %u hot ranges\n",
+			hdr->range_count);
+
+	return true;
+}
+
+const struct ocf_warm_state_range *ocf_warm_state_get_ranges(
+		ocf_cache_t cache, uint32_t *count)
+{
+	struct ocf_warm_state_header *hdr;
+
+	hdr = ocf_warm_state_get_valid(cache);
+	if (!hdr)
+		return NULL;
+
+	*count = hdr->range_count;
+
+	return (void *)(hdr + 1);
+}
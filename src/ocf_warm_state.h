@@ -0,0 +1,57 @@
+/*
+ * Copyright(c) 2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __OCF_WARM_STATE_H__
+#define __OCF_WARM_STATE_H__
+
+#include "ocf/ocf.h"
+
+/*
+ * Cache warm state snapshot is kept in metadata reserved area. It is saved
+ * when cache is stopped or detached and restored when cache is loaded or
+ * attached, so that cache does not start cold after restart.
+ */
+
+struct ocf_warm_state_range {
+	uint64_t core_line;
+	uint32_t count;
+	ocf_core_id_t core_id;
+	uint16_t reserved;
+} __attribute__((packed));
+
+/**
+ * @brief Build warm state snapshot in metadata reserved area memory
+ *
+ * Snapshot contains ranges of core lines marked hot in LRU lists and state
+ * of promotion policy. Cache must not handle any IO while building snapshot.
+ *
+ * @param cache Cache instance
+ */
+void ocf_warm_state_build(ocf_cache_t cache);
+
+/**
+ * @brief Restore cache state from warm state snapshot loaded into metadata
+ *	  reserved area memory
+ *
+ * @param cache Cache instance
+ * @param clean true if cache metadata has been loaded after clean shutdown
+ *
+ * @retval true Valid snapshot has been found and restored
+ */
+bool ocf_warm_state_restore(ocf_cache_t cache, bool clean);
+
+/**
+ * @brief Get hot core line ranges from warm state snapshot
+ *
+ * @param cache Cache instance
+ * @param[out] count Number of ranges
+ *
+ * @retval Hot ranges sorted by core id and core line, NULL if there is no
+ *	   valid snapshot
+ */
+const struct ocf_warm_state_range *ocf_warm_state_get_ranges(
+		ocf_cache_t cache, uint32_t *count);
+
+#endif /* __OCF_WARM_STATE_H__ */
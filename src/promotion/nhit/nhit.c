@@ -44,6 +44,10 @@ ocf_error_t nhit_init(ocf_cache_t cache)
 	int result = 0;
 	uint64_t available, size;
 
+	/* Already initialized for IO class promotion policy override */
+	if (cache->promotion_policy->ctx)
+		return 0;
+
 	size = nhit_sizeof(cache);
 	available = env_get_free_memory();
 
@@ -192,20 +196,19 @@ void nhit_req_purge(ocf_promotion_policy_t policy,
 }
 
 static bool core_line_should_promote(ocf_promotion_policy_t policy,
-		ocf_core_id_t core_id, uint64_t core_lba)
+		uint32_t insertion_threshold, ocf_core_id_t core_id,
+		uint64_t core_lba)
 {
-	struct nhit_promotion_policy_config *cfg;
 	struct nhit_policy_context *ctx;
 	bool hit;
 	int32_t counter;
 
-	cfg = (struct nhit_promotion_policy_config*)policy->config;
 	ctx = policy->ctx;
 
 	hit = nhit_hash_query(ctx->hash_map, core_id, core_lba, &counter);
 	if (hit) {
 		/* we have a hit, return now */
-		return cfg->insertion_threshold <= counter;
+		return insertion_threshold <= counter;
 	}
 
 	nhit_hash_insert(ctx->hash_map, core_id, core_lba);
@@ -217,6 +220,8 @@ bool nhit_req_should_promote(ocf_promotion_policy_t policy,
 		struct ocf_request *req)
 {
 	struct nhit_promotion_policy_config *cfg;
+	struct ocf_io_class_promotion *class_cfg;
+	uint32_t insertion_threshold, trigger_threshold;
 	bool result = true;
 	uint32_t i;
 	uint64_t core_line;
@@ -224,10 +229,19 @@ bool nhit_req_should_promote(ocf_promotion_policy_t policy,
 		ocf_metadata_collision_table_entries(policy->owner) -
 		ocf_lru_num_free(policy->owner);
 
-	cfg = (struct nhit_promotion_policy_config*)policy->config;
+	cfg = (void *) &policy->owner->conf_meta->promotion[ocf_promotion_nhit].data;
+	class_cfg = &policy->owner->user_parts[req->part_id].config->promotion;
+
+	if (class_cfg->enabled) {
+		insertion_threshold = class_cfg->nhit_insertion_threshold;
+		trigger_threshold = class_cfg->nhit_trigger_threshold;
+	} else {
+		insertion_threshold = cfg->insertion_threshold;
+		trigger_threshold = cfg->trigger_threshold;
+	}
 
 	if (occupied_cachelines < OCF_DIV_ROUND_UP(
-			((uint64_t)cfg->trigger_threshold *
+			((uint64_t)trigger_threshold *
 			ocf_metadata_get_cachelines_count(policy->owner)), 100)) {
 		return true;
 	}
@@ -236,8 +250,8 @@ bool nhit_req_should_promote(ocf_promotion_policy_t policy,
 			core_line <= req->core_line_last; core_line++, i++) {
 		struct ocf_map_info *entry = &(req->map[i]);
 
-		if (!core_line_should_promote(policy, entry->core_id,
-					entry->core_line)) {
+		if (!core_line_should_promote(policy, insertion_threshold,
+					entry->core_id, entry->core_line)) {
 			result = false;
 		}
 	}
@@ -247,3 +261,32 @@ bool nhit_req_should_promote(ocf_promotion_policy_t policy,
 	return result || ocf_engine_mapped_count(req);
 }
 
+uint32_t nhit_save_state(ocf_promotion_policy_t policy, void *buf,
+		uint32_t size)
+{
+	struct nhit_policy_context *ctx = policy->ctx;
+	uint64_t count;
+
+	count = nhit_hash_dump(ctx->hash_map, buf,
+			size / sizeof(struct nhit_hash_entry));
+
+	return count * sizeof(struct nhit_hash_entry);
+}
+
+void nhit_load_state(ocf_promotion_policy_t policy, const void *buf,
+		uint32_t size)
+{
+	struct nhit_policy_context *ctx = policy->ctx;
+	const struct nhit_hash_entry *entries = buf;
+	uint32_t count = size / sizeof(*entries);
+	uint32_t i;
+
+	/* Entries are saved most recent first - insert them in reverse order
+	 * to recreate ring buffer ordering */
+	for (i = count; i > 0; i--) {
+		nhit_hash_insert(ctx->hash_map, entries[i - 1].core_id,
+				entries[i - 1].core_lba);
+		nhit_hash_set_occurences(ctx->hash_map, entries[i - 1].core_id,
+				entries[i - 1].core_lba, entries[i - 1].counter);
+	}
+}
@@ -29,4 +29,10 @@ void nhit_req_purge(ocf_promotion_policy_t policy,
 bool nhit_req_should_promote(ocf_promotion_policy_t policy,
 		struct ocf_request *req);
 
+uint32_t nhit_save_state(ocf_promotion_policy_t policy, void *buf,
+		uint32_t size);
+
+void nhit_load_state(ocf_promotion_policy_t policy, const void *buf,
+		uint32_t size);
+
 #endif /* NHIT_PROMOTION_POLICY_H_ */
@@ -415,3 +415,34 @@ void nhit_hash_set_occurences(nhit_hash_t ctx, ocf_core_id_t core_id,
 	env_rwsem_up_read(&ctx->hash_locks[hash]);
 }
 
+/* Copy core lines with nonzero counter into entries, starting from most
+ * recently inserted one. Caller must make sure that hash is not modified
+ * concurrently. */
+uint64_t nhit_hash_dump(nhit_hash_t ctx, struct nhit_hash_entry *entries,
+		uint64_t max_entries)
+{
+	struct nhit_list_elem *elem;
+	uint64_t count = 0;
+	uint64_t i, slot;
+	int32_t counter;
+
+	for (i = 1; i <= ctx->rb_entries && count < max_entries; i++) {
+		slot = (ctx->rb_pointer + ctx->rb_entries - i) % ctx->rb_entries;
+		elem = &ctx->ring_buffer[slot];
+
+		if (elem->core_id == OCF_CORE_ID_INVALID)
+			continue;
+
+		counter = env_atomic_read(&elem->counter);
+		if (counter <= 0)
+			continue;
+
+		entries[count].core_lba = elem->core_lba;
+		entries[count].counter = counter;
+		entries[count].core_id = elem->core_id;
+		entries[count].reserved = 0;
+		count++;
+	}
+
+	return count;
+}
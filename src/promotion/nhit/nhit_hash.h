@@ -10,6 +10,13 @@
 
 typedef struct nhit_hash *nhit_hash_t;
 
+struct nhit_hash_entry {
+	uint64_t core_lba;
+	uint32_t counter;
+	ocf_core_id_t core_id;
+	uint16_t reserved;
+} __attribute__((packed));
+
 uint64_t nhit_hash_sizeof(uint64_t hash_size);
 
 ocf_error_t nhit_hash_init(uint64_t hash_size, nhit_hash_t *ctx);
@@ -23,4 +30,7 @@ bool nhit_hash_query(nhit_hash_t ctx, ocf_core_id_t core_id, uint64_t core_lba,
 
 void nhit_hash_set_occurences(nhit_hash_t ctx, ocf_core_id_t core_id,
 		uint64_t core_lba, int32_t occurences);
+
+uint64_t nhit_hash_dump(nhit_hash_t ctx, struct nhit_hash_entry *entries,
+		uint64_t max_entries);
 #endif /* NHIT_HASH_H_ */
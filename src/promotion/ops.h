@@ -49,6 +49,14 @@ struct promotion_policy_ops {
 	bool (*req_should_promote)(ocf_promotion_policy_t policy,
 			struct ocf_request *req);
 		/*!< Should request lines be inserted into cache */
+
+	uint32_t (*save_state)(ocf_promotion_policy_t policy, void *buf,
+			uint32_t size);
+		/*!< Save promotion state into buffer, return bytes used */
+
+	void (*load_state)(ocf_promotion_policy_t policy, const void *buf,
+			uint32_t size);
+		/*!< Restore promotion state saved with save_state */
 };
 
 extern struct promotion_policy_ops ocf_promotion_policies[ocf_promotion_max];
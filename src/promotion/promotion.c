@@ -4,6 +4,7 @@
  */
 
 #include "../metadata/metadata.h"
+#include "../utils/utils_user_part.h"
 
 #include "promotion.h"
 #include "ops.h"
@@ -22,9 +23,39 @@ struct promotion_policy_ops ocf_promotion_policies[ocf_promotion_max] = {
 		.get_param = nhit_get_param,
 		.req_purge = nhit_req_purge,
 		.req_should_promote = nhit_req_should_promote,
+		.save_state = nhit_save_state,
+		.load_state = nhit_load_state,
 	},
 };
 
+static bool ocf_promotion_classes_use(ocf_cache_t cache, ocf_promotion_t type)
+{
+	struct ocf_user_part *user_part;
+	ocf_part_id_t part_id;
+
+	for_each_user_part(cache, user_part, part_id) {
+		if (ocf_user_part_is_valid(user_part) &&
+				user_part->config->promotion.enabled &&
+				user_part->config->promotion.policy == type) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static ocf_promotion_t ocf_promotion_req_type(ocf_promotion_policy_t policy,
+		struct ocf_request *req)
+{
+	struct ocf_user_part_config *config =
+			policy->owner->user_parts[req->part_id].config;
+
+	if (config->promotion.enabled)
+		return config->promotion.policy;
+
+	return policy->type;
+}
+
 ocf_error_t ocf_promotion_init(ocf_cache_t cache, ocf_promotion_t type)
 {
 	ocf_promotion_policy_t policy;
@@ -38,6 +69,7 @@ ocf_error_t ocf_promotion_init(ocf_cache_t cache, ocf_promotion_t type)
 
 	policy->type = type;
 	policy->owner = cache;
+	policy->ctx = NULL;
 	policy->config =
 		(void *)&cache->conf_meta->promotion[type].data;
 	cache->promotion_policy = policy;
@@ -45,6 +77,9 @@ ocf_error_t ocf_promotion_init(ocf_cache_t cache, ocf_promotion_t type)
 	if (ocf_promotion_policies[type].init)
 		result = ocf_promotion_policies[type].init(cache);
 
+	if (!result)
+		result = ocf_promotion_update_classes(policy);
+
 	if (result) {
 		env_vfree(cache->promotion_policy);
 		cache->promotion_policy = NULL;
@@ -68,6 +103,8 @@ void ocf_promotion_deinit(ocf_promotion_policy_t policy)
 
 	if (ocf_promotion_policies[type].deinit)
 		ocf_promotion_policies[type].deinit(policy);
+	else if (policy->ctx)
+		ocf_promotion_policies[ocf_promotion_nhit].deinit(policy);
 
 	env_vfree(policy);
 }
@@ -90,8 +127,11 @@ ocf_error_t ocf_promotion_set_policy(ocf_promotion_policy_t policy,
 		return 0;
 	}
 
-	if (ocf_promotion_policies[prev_policy].deinit)
+	/* Keep context of policy which is still used by IO class override */
+	if (ocf_promotion_policies[prev_policy].deinit &&
+			!ocf_promotion_classes_use(cache, prev_policy)) {
 		ocf_promotion_policies[prev_policy].deinit(policy);
+	}
 
 	cache->conf_meta->promotion_policy_type = type;
 	policy->type = type;
@@ -115,6 +155,25 @@ ocf_error_t ocf_promotion_set_policy(ocf_promotion_policy_t policy,
 	return result;
 }
 
+ocf_error_t ocf_promotion_update_classes(ocf_promotion_policy_t policy)
+{
+	ocf_cache_t cache = policy->owner;
+	bool needed;
+
+	/* Only nhit keeps runtime context, which is shared by cache policy
+	 * and IO class overrides */
+	needed = policy->type == ocf_promotion_nhit ||
+			ocf_promotion_classes_use(cache, ocf_promotion_nhit);
+
+	if (needed && !policy->ctx)
+		return ocf_promotion_policies[ocf_promotion_nhit].init(cache);
+
+	if (!needed && policy->ctx)
+		ocf_promotion_policies[ocf_promotion_nhit].deinit(policy);
+
+	return 0;
+}
+
 ocf_error_t ocf_promotion_set_param(ocf_cache_t cache, ocf_promotion_t type,
 		uint8_t param_id, uint32_t param_value)
 {
@@ -148,23 +207,23 @@ ocf_error_t ocf_promotion_get_param(ocf_cache_t cache, ocf_promotion_t type,
 void ocf_promotion_req_purge(ocf_promotion_policy_t policy,
 		struct ocf_request *req)
 {
-	ocf_promotion_t type = policy->type;
+	ocf_promotion_t type = ocf_promotion_req_type(policy, req);
 
 	ENV_BUG_ON(type >= ocf_promotion_max);
 
-	if (ocf_promotion_policies[type].req_purge)
+	if (ocf_promotion_policies[type].req_purge && policy->ctx)
 		ocf_promotion_policies[type].req_purge(policy, req);
 }
 
 bool ocf_promotion_req_should_promote(ocf_promotion_policy_t policy,
 		struct ocf_request *req)
 {
-	ocf_promotion_t type = policy->type;
+	ocf_promotion_t type = ocf_promotion_req_type(policy, req);
 	bool result = true;
 
 	ENV_BUG_ON(type >= ocf_promotion_max);
 
-	if (ocf_promotion_policies[type].req_should_promote) {
+	if (ocf_promotion_policies[type].req_should_promote && policy->ctx) {
 		result = ocf_promotion_policies[type].req_should_promote(policy,
 				req);
 	}
@@ -172,3 +231,26 @@ bool ocf_promotion_req_should_promote(ocf_promotion_policy_t policy,
 	return result;
 }
 
+uint32_t ocf_promotion_save_state(ocf_promotion_policy_t policy, void *buf,
+		uint32_t size)
+{
+	ocf_promotion_t type = policy->type;
+
+	ENV_BUG_ON(type >= ocf_promotion_max);
+
+	if (!ocf_promotion_policies[type].save_state)
+		return 0;
+
+	return ocf_promotion_policies[type].save_state(policy, buf, size);
+}
+
+void ocf_promotion_load_state(ocf_promotion_policy_t policy, const void *buf,
+		uint32_t size)
+{
+	ocf_promotion_t type = policy->type;
+
+	ENV_BUG_ON(type >= ocf_promotion_max);
+
+	if (ocf_promotion_policies[type].load_state)
+		ocf_promotion_policies[type].load_state(policy, buf, size);
+}
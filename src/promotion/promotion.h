@@ -59,6 +59,18 @@ void ocf_promotion_deinit(ocf_promotion_policy_t policy);
  */
 ocf_error_t ocf_promotion_set_policy(ocf_promotion_policy_t policy,
 		ocf_promotion_t type);
+
+/**
+ * @brief Allocate or free promotion policy context according to promotion
+ * policy overrides of valid IO classes. Should be called after IO class
+ * configuration has changed.
+ *
+ * @param[in] policy promotion policy handle
+ *
+ * @retval ocf_error_t
+ */
+ocf_error_t ocf_promotion_update_classes(ocf_promotion_policy_t policy);
+
 /**
  * @brief Set promotion policy parameter
  *
@@ -108,4 +120,29 @@ void ocf_promotion_req_purge(ocf_promotion_policy_t policy,
 bool ocf_promotion_req_should_promote(ocf_promotion_policy_t policy,
 		struct ocf_request *req);
 
+/**
+ * @brief Save promotion policy state (e.g. access counters) so that it can be
+ * restored after cache restart
+ *
+ * @param[in] policy promotion policy handle
+ * @param[out] buf buffer for promotion policy state
+ * @param[in] size size of buffer
+ *
+ * @retval number of bytes of buffer used
+ */
+uint32_t ocf_promotion_save_state(ocf_promotion_policy_t policy, void *buf,
+		uint32_t size);
+
+/**
+ * @brief Restore promotion policy state saved with ocf_promotion_save_state()
+ *
+ * @param[in] policy promotion policy handle
+ * @param[in] buf buffer with promotion policy state
+ * @param[in] size size of saved state
+ *
+ * @retval none
+ */
+void ocf_promotion_load_state(ocf_promotion_policy_t policy, const void *buf,
+		uint32_t size);
+
 #endif /* PROMOTION_H_ */
@@ -6,6 +6,7 @@
 #include "../ocf_cache_priv.h"
 #include "../ocf_priv.h"
 #include "../ocf_request.h"
+#include "../ocf_queue_priv.h"
 #include "utils_alock.h"
 
 #define OCF_CACHE_CONCURRENCY_DEBUG 0
@@ -39,7 +40,8 @@
 #define _WAITERS_LIST_ENTRIES \
 	(_WAITERS_LIST_SIZE / sizeof(struct ocf_alock_waiters_list))
 
-#define _WAITERS_LIST_ITEM(entry) ((entry) % _WAITERS_LIST_ENTRIES)
+#define _WAITERS_LIST_ITEM(alock, entry) \
+	(ocf_alock_slot(alock, entry) % _WAITERS_LIST_ENTRIES)
 
 struct ocf_alock_waiter {
 	ocf_cache_line_t entry;
@@ -62,14 +64,86 @@ struct ocf_alock {
 		env_atomic waiting;
 	} __attribute__((__aligned__(64)));
 
+	struct {
+		env_atomic64 resumed;
+		env_atomic64 wait_time;
+		env_atomic64 batches;
+	} stats __attribute__((__aligned__(64)));
+
 	ocf_cache_line_t num_entries;
+
+	/* Number of lock slots in striped lock table, 0 if each entry has
+	 * its own lock slot */
+	uint32_t num_slots;
+
 	env_atomic *access;
+
+	/* Entry for which each lock slot of striped table was last acquired */
+	ocf_cache_line_t *tags;
+	env_atomic64 collisions;
+
 	env_allocator *allocator;
 	struct ocf_alock_lock_cbs *cbs;
 	struct ocf_alock_waiters_list waiters_lsts[_WAITERS_LIST_ENTRIES];
 
 } __attribute__((__aligned__(64)));
 
+/*
+ * In striped mode entries are hashed into fixed number of lock slots, so that
+ * memory consumed by locks doesn't depend on number of entries. Entries
+ * sharing lock slot are mutually excluded as if they were single entry.
+ */
+static inline ocf_cache_line_t ocf_alock_slot(struct ocf_alock *alock,
+		ocf_cache_line_t entry)
+{
+	if (!alock->num_slots)
+		return entry;
+
+	return (uint32_t)(entry * 2654435761U) % alock->num_slots;
+}
+
+static inline env_atomic *ocf_alock_access(struct ocf_alock *alock,
+		ocf_cache_line_t entry)
+{
+	return &alock->access[ocf_alock_slot(alock, entry)];
+}
+
+static inline bool ocf_alock_same_slot(struct ocf_alock *alock,
+		ocf_cache_line_t entry1, ocf_cache_line_t entry2)
+{
+	return ocf_alock_slot(alock, entry1) == ocf_alock_slot(alock, entry2);
+}
+
+static inline void ocf_alock_tag(struct ocf_alock *alock,
+		ocf_cache_line_t entry)
+{
+	if (alock->num_slots)
+		alock->tags[ocf_alock_slot(alock, entry)] = entry;
+}
+
+/* Count lock slot found busy because of entry other than requested one.
+ * Tags are not synchronized, so it's only an estimation. */
+static inline void ocf_alock_note_busy(struct ocf_alock *alock,
+		ocf_cache_line_t entry)
+{
+	if (!alock->num_slots)
+		return;
+
+	if (alock->tags[ocf_alock_slot(alock, entry)] != entry)
+		env_atomic64_inc(&alock->collisions);
+}
+
+bool ocf_alock_is_striped(struct ocf_alock *alock)
+{
+	return !!alock->num_slots;
+}
+
+ocf_cache_line_t ocf_alock_entry_slot(struct ocf_alock *alock,
+		ocf_cache_line_t entry)
+{
+	return ocf_alock_slot(alock, entry);
+}
+
 void ocf_alock_mark_index_locked(struct ocf_alock *alock,
 		struct ocf_request *req, unsigned index, bool locked)
 {
@@ -90,8 +164,9 @@ size_t ocf_alock_obj_size(void)
 	return sizeof(struct ocf_alock);
 }
 
-int ocf_alock_init_inplace(struct ocf_alock *self, unsigned num_entries,
-		const char* name, struct ocf_alock_lock_cbs *cbs, ocf_cache_t cache)
+static int _ocf_alock_init_inplace(struct ocf_alock *self,
+		unsigned num_entries, unsigned num_slots, const char* name,
+		struct ocf_alock_lock_cbs *cbs, ocf_cache_t cache)
 {
 	uint32_t i;
 	int error = 0;
@@ -100,21 +175,37 @@ int ocf_alock_init_inplace(struct ocf_alock *self, unsigned num_entries,
 
 	self->cache = cache;
 	self->num_entries = num_entries;
+	self->num_slots = num_slots;
 	self->cbs = cbs;
 
+	env_atomic64_set(&self->collisions, 0);
+
+	env_atomic64_set(&self->stats.resumed, 0);
+	env_atomic64_set(&self->stats.wait_time, 0);
+	env_atomic64_set(&self->stats.batches, 0);
+
 	error = env_mutex_init(&self->lock);
 	if (error) {
 		error = __LINE__;
 		goto rwsem_err;
 	}
 
-	self->access = env_vzalloc(num_entries * sizeof(self->access[0]));
+	self->access = env_vzalloc((num_slots ?: num_entries) *
+			sizeof(self->access[0]));
 
 	if (!self->access) {
 		error = __LINE__;
 		goto allocation_err;
 	}
 
+	if (num_slots) {
+		self->tags = env_vzalloc(num_slots * sizeof(self->tags[0]));
+		if (!self->tags) {
+			error = __LINE__;
+			goto allocation_err;
+		}
+	}
+
 	self->allocator = env_allocator_create(sizeof(struct ocf_alock_waiter), name, false);
 	if (!self->allocator) {
 		error = __LINE__;
@@ -141,6 +232,9 @@ allocation_err:
 	if (self->allocator)
 		env_allocator_destroy(self->allocator);
 
+	if (self->tags)
+		env_vfree(self->tags);
+
 	if (self->access)
 		env_vfree(self->access);
 
@@ -152,8 +246,15 @@ rwsem_err:
 	return -1;
 }
 
-int ocf_alock_init(struct ocf_alock **self, unsigned num_entries,
+int ocf_alock_init_inplace(struct ocf_alock *self, unsigned num_entries,
 		const char* name, struct ocf_alock_lock_cbs *cbs, ocf_cache_t cache)
+{
+	return _ocf_alock_init_inplace(self, num_entries, 0, name, cbs, cache);
+}
+
+int ocf_alock_init_striped(struct ocf_alock **self, unsigned num_entries,
+		unsigned num_slots, const char* name,
+		struct ocf_alock_lock_cbs *cbs, ocf_cache_t cache)
 {
 	struct ocf_alock *alock;
 	int ret;
@@ -164,7 +265,7 @@ int ocf_alock_init(struct ocf_alock **self, unsigned num_entries,
 	if (!alock)
 		return -OCF_ERR_NO_MEM;
 
-	ret = ocf_alock_init_inplace(alock, num_entries,
+	ret = _ocf_alock_init_inplace(alock, num_entries, num_slots,
 			name, cbs, cache);
 
 	if (!ret)
@@ -175,6 +276,12 @@ int ocf_alock_init(struct ocf_alock **self, unsigned num_entries,
 	return ret;
 }
 
+int ocf_alock_init(struct ocf_alock **self, unsigned num_entries,
+		const char* name, struct ocf_alock_lock_cbs *cbs, ocf_cache_t cache)
+{
+	return ocf_alock_init_striped(self, num_entries, 0, name, cbs, cache);
+}
+
 void ocf_alock_deinit(struct ocf_alock **self)
 {
 	struct ocf_alock *concurrency = *self;
@@ -193,6 +300,9 @@ void ocf_alock_deinit(struct ocf_alock **self)
 	if (concurrency->access)
 		env_vfree(concurrency->access);
 
+	if (concurrency->tags)
+		env_vfree(concurrency->tags);
+
 	if (concurrency->allocator)
 		env_allocator_destroy(concurrency->allocator);
 
@@ -213,12 +323,24 @@ size_t ocf_alock_size(unsigned num_entries)
 	return size;
 }
 
+size_t ocf_alock_striped_size(unsigned num_slots)
+{
+	size_t size;
+
+	size = sizeof(env_atomic) + sizeof(ocf_cache_line_t);
+	size *= num_slots;
+
+	size += sizeof(struct ocf_alock);
+
+	return size;
+}
+
 static inline bool ocf_alock_waitlist_is_empty_locked(struct ocf_alock *alock,
 		ocf_cache_line_t entry)
 {
 	bool are = false;
 	struct list_head *iter;
-	uint32_t idx = _WAITERS_LIST_ITEM(entry);
+	uint32_t idx = _WAITERS_LIST_ITEM(alock, entry);
 	struct ocf_alock_waiters_list *lst = &alock->waiters_lsts[idx];
 	struct ocf_alock_waiter *waiter;
 
@@ -229,7 +351,7 @@ static inline bool ocf_alock_waitlist_is_empty_locked(struct ocf_alock *alock,
 	list_for_each(iter, &lst->head) {
 		waiter = list_entry(iter, struct ocf_alock_waiter, item);
 
-		if (waiter->entry == entry) {
+		if (ocf_alock_same_slot(alock, waiter->entry, entry)) {
 			are = true;
 			break;
 		}
@@ -241,7 +363,7 @@ static inline bool ocf_alock_waitlist_is_empty_locked(struct ocf_alock *alock,
 static inline void ocf_alock_waitlist_add(struct ocf_alock *alock,
 		ocf_cache_line_t entry, struct ocf_alock_waiter *waiter)
 {
-	uint32_t idx = _WAITERS_LIST_ITEM(entry);
+	uint32_t idx = _WAITERS_LIST_ITEM(alock, entry);
 	struct ocf_alock_waiters_list *lst = &alock->waiters_lsts[idx];
 
 	list_add_tail(&waiter->item, &lst->head);
@@ -250,14 +372,14 @@ static inline void ocf_alock_waitlist_add(struct ocf_alock *alock,
 
 #define ocf_alock_waitlist_lock(cncrrncy, entry, flags) \
 	do { \
-		uint32_t idx = _WAITERS_LIST_ITEM(entry); \
+		uint32_t idx = _WAITERS_LIST_ITEM(cncrrncy, entry); \
 		struct ocf_alock_waiters_list *lst = &cncrrncy->waiters_lsts[idx]; \
 		env_spinlock_lock_irqsave(&lst->lock, flags); \
 	} while (0)
 
 #define ocf_alock_waitlist_unlock(cncrrncy, entry, flags) \
 	do { \
-		uint32_t idx = _WAITERS_LIST_ITEM(entry); \
+		uint32_t idx = _WAITERS_LIST_ITEM(cncrrncy, entry); \
 		struct ocf_alock_waiters_list *lst = &cncrrncy->waiters_lsts[idx]; \
 		env_spinlock_unlock_irqrestore(&lst->lock, flags); \
 	} while (0)
@@ -266,35 +388,47 @@ static inline void ocf_alock_waitlist_add(struct ocf_alock *alock,
 bool ocf_alock_trylock_entry_wr(struct ocf_alock *alock,
 		ocf_cache_line_t entry)
 {
-	env_atomic *access = &alock->access[entry];
+	env_atomic *access = ocf_alock_access(alock, entry);
 	int prev = env_atomic_cmpxchg(access, OCF_CACHE_LINE_ACCESS_IDLE,
 			OCF_CACHE_LINE_ACCESS_WR);
 
-	return prev == OCF_CACHE_LINE_ACCESS_IDLE;
+	if (prev != OCF_CACHE_LINE_ACCESS_IDLE)
+		return false;
+
+	ocf_alock_tag(alock, entry);
+	return true;
 }
 
 bool ocf_alock_trylock_entry_rd_idle(struct ocf_alock *alock,
 		ocf_cache_line_t entry)
 {
-	env_atomic *access = &alock->access[entry];
+	env_atomic *access = ocf_alock_access(alock, entry);
 	int prev = env_atomic_cmpxchg(access, OCF_CACHE_LINE_ACCESS_IDLE,
 			OCF_CACHE_LINE_ACCESS_ONE_RD);
 
-	return (prev == OCF_CACHE_LINE_ACCESS_IDLE);
+	if (prev != OCF_CACHE_LINE_ACCESS_IDLE)
+		return false;
+
+	ocf_alock_tag(alock, entry);
+	return true;
 }
 
 static inline bool ocf_alock_trylock_entry_rd(struct ocf_alock *alock,
 		ocf_cache_line_t entry)
 {
-	env_atomic *access = &alock->access[entry];
+	env_atomic *access = ocf_alock_access(alock, entry);
 
-	return !!env_atomic_add_unless(access, 1, OCF_CACHE_LINE_ACCESS_WR);
+	if (!env_atomic_add_unless(access, 1, OCF_CACHE_LINE_ACCESS_WR))
+		return false;
+
+	ocf_alock_tag(alock, entry);
+	return true;
 }
 
 static inline void ocf_alock_unlock_entry_wr(struct ocf_alock *alock,
 		ocf_cache_line_t entry)
 {
-	env_atomic *access = &alock->access[entry];
+	env_atomic *access = ocf_alock_access(alock, entry);
 
 	ENV_BUG_ON(env_atomic_read(access) != OCF_CACHE_LINE_ACCESS_WR);
 	env_atomic_set(access, OCF_CACHE_LINE_ACCESS_IDLE);
@@ -303,7 +437,7 @@ static inline void ocf_alock_unlock_entry_wr(struct ocf_alock *alock,
 static inline void ocf_alock_unlock_entry_rd(struct ocf_alock *alock,
 		ocf_cache_line_t entry)
 {
-	env_atomic *access = &alock->access[entry];
+	env_atomic *access = ocf_alock_access(alock, entry);
 
 	int v = env_atomic_read(access);
 
@@ -315,7 +449,7 @@ static inline void ocf_alock_unlock_entry_rd(struct ocf_alock *alock,
 static inline bool ocf_alock_trylock_entry_wr2wr(struct ocf_alock *alock,
 		ocf_cache_line_t entry)
 {
-	env_atomic *access = &alock->access[entry];
+	env_atomic *access = ocf_alock_access(alock, entry);
 	int v = env_atomic_read(access);
 
 	ENV_BUG_ON(v != OCF_CACHE_LINE_ACCESS_WR);
@@ -325,7 +459,7 @@ static inline bool ocf_alock_trylock_entry_wr2wr(struct ocf_alock *alock,
 static inline bool ocf_alock_trylock_entry_wr2rd(struct ocf_alock *alock,
 		ocf_cache_line_t entry)
 {
-	env_atomic *access = &alock->access[entry];
+	env_atomic *access = ocf_alock_access(alock, entry);
 	int v = env_atomic_read(access);
 
 	ENV_BUG_ON(v != OCF_CACHE_LINE_ACCESS_WR);
@@ -336,7 +470,7 @@ static inline bool ocf_alock_trylock_entry_wr2rd(struct ocf_alock *alock,
 static inline bool ocf_alock_trylock_entry_rd2wr(struct ocf_alock *alock,
 		ocf_cache_line_t entry)
 {
-	env_atomic *access = &alock->access[entry];
+	env_atomic *access = ocf_alock_access(alock, entry);
 
 	int v = env_atomic_read(access);
 
@@ -352,7 +486,7 @@ static inline bool ocf_alock_trylock_entry_rd2wr(struct ocf_alock *alock,
 static inline bool ocf_alock_trylock_entry_rd2rd(struct ocf_alock *alock,
 		ocf_cache_line_t entry)
 {
-	env_atomic *access = &alock->access[entry];
+	env_atomic *access = ocf_alock_access(alock, entry);
 
 	int v = env_atomic_read(access);
 
@@ -362,15 +496,79 @@ static inline bool ocf_alock_trylock_entry_rd2rd(struct ocf_alock *alock,
 	return true;
 }
 
+void ocf_alock_wake_batch_init(struct ocf_alock_wake_batch *batch)
+{
+	batch->count = 0;
+}
+
+/*
+ * Resume lock waiters collected in batch. Waiters are grouped by their I/O
+ * queue and each queue is kicked once, after all requests resumed into it
+ * have been pushed.
+ */
+void ocf_alock_wake_batch_flush(struct ocf_alock *alock,
+		struct ocf_alock_wake_batch *batch)
+{
+	struct ocf_request *req;
+	ocf_queue_t queue;
+	unsigned i, j;
+
+	for (i = 0; i < batch->count; i++) {
+		req = batch->waiters[i].req;
+		if (!req)
+			continue;
+
+		queue = req->io_queue;
+		if (!queue) {
+			batch->waiters[i].cmpl(req);
+			continue;
+		}
+
+		/* Resumed request may complete and release the queue before
+		 * the queue is kicked */
+		ocf_queue_get(queue);
+		ocf_queue_hold_kick(queue);
+
+		for (j = i; j < batch->count; j++) {
+			req = batch->waiters[j].req;
+			if (!req || req->io_queue != queue)
+				continue;
+
+			/* NOTE: do not dereference @req once it is resumed */
+			batch->waiters[j].req = NULL;
+			batch->waiters[j].cmpl(req);
+		}
+
+		ocf_queue_release_kick(queue);
+		ocf_queue_put(queue);
+
+		env_atomic64_inc(&alock->stats.batches);
+	}
+
+	batch->count = 0;
+}
+
 static void ocf_alock_entry_locked(struct ocf_alock *alock,
-		struct ocf_request *req, ocf_req_async_lock_cb cmpl)
+		struct ocf_request *req, ocf_req_async_lock_cb cmpl,
+		struct ocf_alock_wake_batch *batch)
 {
 	if (env_atomic_dec_return(&req->lock_remaining) == 0) {
 		/* All cache entry locked, resume request */
 		OCF_DEBUG_RQ(req, "Resume");
 		ENV_BUG_ON(!cmpl);
 		env_atomic_dec(&alock->waiting);
-		cmpl(req);
+
+		env_atomic64_inc(&alock->stats.resumed);
+		env_atomic64_add(env_ticks_to_nsecs(env_get_tick_count() -
+				req->alock_wait_start), &alock->stats.wait_time);
+
+		if (batch && batch->count < OCF_ALOCK_WAKE_BATCH_SIZE) {
+			batch->waiters[batch->count].req = req;
+			batch->waiters[batch->count].cmpl = cmpl;
+			batch->count++;
+		} else {
+			cmpl(req);
+		}
 	}
 }
 
@@ -387,7 +585,7 @@ bool ocf_alock_lock_one_wr(struct ocf_alock *alock,
 	if (ocf_alock_trylock_entry_wr(alock, entry)) {
 		/* lock was not owned by anyone */
 		ocf_alock_mark_index_locked(alock, req, idx, true);
-		ocf_alock_entry_locked(alock, req, cmpl);
+		ocf_alock_entry_locked(alock, req, cmpl, NULL);
 		return true;
 	}
 
@@ -413,6 +611,7 @@ bool ocf_alock_lock_one_wr(struct ocf_alock *alock,
 
 	/* Add to waiters list */
 	ocf_alock_waitlist_add(alock, entry, waiter);
+	ocf_alock_note_busy(alock, entry);
 	waiting = true;
 
 unlock:
@@ -420,7 +619,7 @@ unlock:
 
 	if (!waiting) {
 		ocf_alock_mark_index_locked(alock, req, idx, true);
-		ocf_alock_entry_locked(alock, req, cmpl);
+		ocf_alock_entry_locked(alock, req, cmpl, NULL);
 		env_allocator_del(alock->allocator, waiter);
 	}
 
@@ -444,7 +643,7 @@ bool ocf_alock_lock_one_rd(struct ocf_alock *alock,
 	if( ocf_alock_trylock_entry_rd_idle(alock, entry)) {
 		/* lock was not owned by anyone */
 		ocf_alock_mark_index_locked(alock, req, idx, true);
-		ocf_alock_entry_locked(alock, req, cmpl);
+		ocf_alock_entry_locked(alock, req, cmpl, NULL);
 		return true;
 	}
 
@@ -475,6 +674,7 @@ bool ocf_alock_lock_one_rd(struct ocf_alock *alock,
 
 	/* Add to waiters list */
 	ocf_alock_waitlist_add(alock, entry, waiter);
+	ocf_alock_note_busy(alock, entry);
 	waiting = true;
 
 unlock:
@@ -482,7 +682,7 @@ unlock:
 
 	if (!waiting) {
 		ocf_alock_mark_index_locked(alock, req, idx, true);
-		ocf_alock_entry_locked(alock, req, cmpl);
+		ocf_alock_entry_locked(alock, req, cmpl, NULL);
 		env_allocator_del(alock->allocator, waiter);
 	}
 
@@ -495,12 +695,12 @@ unlock:
  * or kept as a readlock. If there are no waiters, it's just unlocked.
  */
 static inline void ocf_alock_unlock_one_rd_common(struct ocf_alock *alock,
-		const ocf_cache_line_t entry)
+		const ocf_cache_line_t entry, struct ocf_alock_wake_batch *batch)
 {
 	bool locked = false;
 	bool exchanged = true;
 
-	uint32_t idx = _WAITERS_LIST_ITEM(entry);
+	uint32_t idx = _WAITERS_LIST_ITEM(alock, entry);
 	struct ocf_alock_waiters_list *lst = &alock->waiters_lsts[idx];
 	struct ocf_alock_waiter *waiter;
 
@@ -517,7 +717,7 @@ static inline void ocf_alock_unlock_one_rd_common(struct ocf_alock *alock,
 	list_for_each_safe(iter, next, &lst->head) {
 		waiter = list_entry(iter, struct ocf_alock_waiter, item);
 
-		if (entry != waiter->entry)
+		if (!ocf_alock_same_slot(alock, waiter->entry, entry))
 			continue;
 
 		if (exchanged) {
@@ -540,8 +740,11 @@ static inline void ocf_alock_unlock_one_rd_common(struct ocf_alock *alock,
 			exchanged = false;
 			list_del(iter);
 
+			ocf_alock_tag(alock, waiter->entry);
+
 			ocf_alock_mark_index_locked(alock, waiter->req, waiter->idx, true);
-			ocf_alock_entry_locked(alock, waiter->req, waiter->cmpl);
+			ocf_alock_entry_locked(alock, waiter->req,
+					waiter->cmpl, batch);
 
 			env_allocator_del(alock->allocator, waiter);
 		} else {
@@ -560,11 +763,26 @@ static inline void ocf_alock_unlock_one_rd_common(struct ocf_alock *alock,
 bool ocf_alock_trylock_one_rd(struct ocf_alock *alock,
 		ocf_cache_line_t entry)
 {
-	return ocf_alock_trylock_entry_rd_idle(alock, entry);
+	if (ocf_alock_trylock_entry_rd_idle(alock, entry))
+		return true;
+
+	ocf_alock_note_busy(alock, entry);
+	return false;
+}
+
+bool ocf_alock_trylock_one_wr(struct ocf_alock *alock,
+		ocf_cache_line_t entry)
+{
+	if (ocf_alock_trylock_entry_wr(alock, entry))
+		return true;
+
+	ocf_alock_note_busy(alock, entry);
+	return false;
 }
 
-void ocf_alock_unlock_one_rd(struct ocf_alock *alock,
-		const ocf_cache_line_t entry)
+void ocf_alock_unlock_one_rd_batch(struct ocf_alock *alock,
+		const ocf_cache_line_t entry,
+		struct ocf_alock_wake_batch *batch)
 {
 	unsigned long flags = 0;
 
@@ -572,22 +790,32 @@ void ocf_alock_unlock_one_rd(struct ocf_alock *alock,
 
 	/* Lock waiters list */
 	ocf_alock_waitlist_lock(alock, entry, flags);
-	ocf_alock_unlock_one_rd_common(alock, entry);
+	ocf_alock_unlock_one_rd_common(alock, entry, batch);
 	ocf_alock_waitlist_unlock(alock, entry, flags);
 }
 
+void ocf_alock_unlock_one_rd(struct ocf_alock *alock,
+		const ocf_cache_line_t entry)
+{
+	struct ocf_alock_wake_batch batch;
+
+	ocf_alock_wake_batch_init(&batch);
+	ocf_alock_unlock_one_rd_batch(alock, entry, &batch);
+	ocf_alock_wake_batch_flush(alock, &batch);
+}
+
 /*
  * Unlocks the given write lock. If any waiters are registered for the same
  * cacheline, one is awakened and the lock is either downgraded to a readlock
  * or kept as a writelock. If there are no waiters, it's just unlocked.
  */
 static inline void ocf_alock_unlock_one_wr_common(struct ocf_alock *alock,
-		const ocf_cache_line_t entry)
+		const ocf_cache_line_t entry, struct ocf_alock_wake_batch *batch)
 {
 	bool locked = false;
 	bool exchanged = true;
 
-	uint32_t idx = _WAITERS_LIST_ITEM(entry);
+	uint32_t idx = _WAITERS_LIST_ITEM(alock, entry);
 	struct ocf_alock_waiters_list *lst = &alock->waiters_lsts[idx];
 	struct ocf_alock_waiter *waiter;
 
@@ -604,7 +832,7 @@ static inline void ocf_alock_unlock_one_wr_common(struct ocf_alock *alock,
 	list_for_each_safe(iter, next, &lst->head) {
 		waiter = list_entry(iter, struct ocf_alock_waiter, item);
 
-		if (entry != waiter->entry)
+		if (!ocf_alock_same_slot(alock, waiter->entry, entry))
 			continue;
 
 		if (exchanged) {
@@ -627,8 +855,11 @@ static inline void ocf_alock_unlock_one_wr_common(struct ocf_alock *alock,
 			exchanged = false;
 			list_del(iter);
 
+			ocf_alock_tag(alock, waiter->entry);
+
 			ocf_alock_mark_index_locked(alock, waiter->req, waiter->idx, true);
-			ocf_alock_entry_locked(alock, waiter->req, waiter->cmpl);
+			ocf_alock_entry_locked(alock, waiter->req,
+					waiter->cmpl, batch);
 
 			env_allocator_del(alock->allocator, waiter);
 		} else {
@@ -644,8 +875,9 @@ static inline void ocf_alock_unlock_one_wr_common(struct ocf_alock *alock,
 	}
 }
 
-void ocf_alock_unlock_one_wr(struct ocf_alock *alock,
-		const ocf_cache_line_t entry)
+void ocf_alock_unlock_one_wr_batch(struct ocf_alock *alock,
+		const ocf_cache_line_t entry,
+		struct ocf_alock_wake_batch *batch)
 {
 	unsigned long flags = 0;
 
@@ -653,10 +885,20 @@ void ocf_alock_unlock_one_wr(struct ocf_alock *alock,
 
 	/* Lock waiters list */
 	ocf_alock_waitlist_lock(alock, entry, flags);
-	ocf_alock_unlock_one_wr_common(alock, entry);
+	ocf_alock_unlock_one_wr_common(alock, entry, batch);
 	ocf_alock_waitlist_unlock(alock, entry, flags);
 }
 
+void ocf_alock_unlock_one_wr(struct ocf_alock *alock,
+		const ocf_cache_line_t entry)
+{
+	struct ocf_alock_wake_batch batch;
+
+	ocf_alock_wake_batch_init(&batch);
+	ocf_alock_unlock_one_wr_batch(alock, entry, &batch);
+	ocf_alock_wake_batch_flush(alock, &batch);
+}
+
 /*
  * Safely remove cache entry lock waiter from waiting list.
  * Request can be assigned with lock asynchronously at any point of time,
@@ -665,19 +907,22 @@ void ocf_alock_unlock_one_wr(struct ocf_alock *alock,
 void ocf_alock_waitlist_remove_entry(struct ocf_alock *alock,
 	struct ocf_request *req, ocf_cache_line_t entry, int i, int rw)
 {
-	uint32_t idx = _WAITERS_LIST_ITEM(entry);
+	uint32_t idx = _WAITERS_LIST_ITEM(alock, entry);
 	struct ocf_alock_waiters_list *lst = &alock->waiters_lsts[idx];
 	struct list_head *iter, *next;
 	struct ocf_alock_waiter *waiter;
+	struct ocf_alock_wake_batch batch;
 	unsigned long flags = 0;
 
+	ocf_alock_wake_batch_init(&batch);
+
 	ocf_alock_waitlist_lock(alock, entry, flags);
 
 	if (ocf_alock_is_index_locked(alock, req, i)) {
 		if (rw == OCF_READ)
-			ocf_alock_unlock_one_rd_common(alock, entry);
+			ocf_alock_unlock_one_rd_common(alock, entry, &batch);
 		else
-			ocf_alock_unlock_one_wr_common(alock, entry);
+			ocf_alock_unlock_one_wr_common(alock, entry, &batch);
 		ocf_alock_mark_index_locked(alock, req, i, false);
 	} else {
 		list_for_each_safe(iter, next, &lst->head) {
@@ -691,6 +936,8 @@ void ocf_alock_waitlist_remove_entry(struct ocf_alock *alock,
 	}
 
 	ocf_alock_waitlist_unlock(alock, entry, flags);
+
+	ocf_alock_wake_batch_flush(alock, &batch);
 }
 
 int ocf_alock_lock_rd(struct ocf_alock *alock,
@@ -712,6 +959,7 @@ int ocf_alock_lock_rd(struct ocf_alock *alock,
 		env_atomic_inc(&alock->waiting);
 		env_atomic_set(&req->lock_remaining, req->core_line_count);
 		env_atomic_inc(&req->lock_remaining);
+		req->alock_wait_start = env_get_tick_count();
 
 		status = alock->cbs->lock_entries_slow(alock, req, OCF_READ, cmpl);
 		if (!status) {
@@ -748,6 +996,7 @@ int ocf_alock_lock_wr(struct ocf_alock *alock,
 		env_atomic_inc(&alock->waiting);
 		env_atomic_set(&req->lock_remaining, req->core_line_count);
 		env_atomic_inc(&req->lock_remaining);
+		req->alock_wait_start = env_get_tick_count();
 
 		status = alock->cbs->lock_entries_slow(alock, req, OCF_WRITE, cmpl);
 		if (!status) {
@@ -771,7 +1020,7 @@ bool ocf_cache_line_is_used(struct ocf_alock *alock,
 {
 	ENV_BUG_ON(entry >= alock->num_entries);
 
-	if (env_atomic_read(&(alock->access[entry])))
+	if (env_atomic_read(ocf_alock_access(alock, entry)))
 		return true;
 
 	return !ocf_alock_waitlist_is_empty(alock, entry);
@@ -799,3 +1048,21 @@ uint32_t ocf_alock_waitlist_count(struct ocf_alock *alock)
 {
 	return env_atomic_read(&alock->waiting);
 }
+
+void ocf_alock_get_stats(struct ocf_alock *alock,
+		struct ocf_alock_stats *stats)
+{
+	uint32_t i;
+
+	stats->resumed = env_atomic64_read(&alock->stats.resumed);
+	stats->wait_time = env_atomic64_read(&alock->stats.wait_time);
+	stats->batches = env_atomic64_read(&alock->stats.batches);
+
+	stats->slots = alock->num_slots;
+	stats->busy = 0;
+	for (i = 0; i < alock->num_slots; i++) {
+		if (env_atomic_read(&alock->access[i]))
+			stats->busy++;
+	}
+	stats->collisions = env_atomic64_read(&alock->collisions);
+}
@@ -32,6 +32,45 @@ struct ocf_alock_lock_cbs
 	ocf_cl_lock_slow lock_entries_slow;
 };
 
+/**
+ * @brief Number of lock waiters resumed within single wake batch
+ */
+#define OCF_ALOCK_WAKE_BATCH_SIZE	16
+
+/*
+ * Lock waiters which acquired all their entries during unlock. They are
+ * resumed once unlock has been completed, grouped by I/O queue, so that each
+ * queue is kicked once per batch.
+ */
+struct ocf_alock_wake_batch {
+	unsigned count;
+	struct {
+		struct ocf_request *req;
+		ocf_req_async_lock_cb cmpl;
+	} waiters[OCF_ALOCK_WAKE_BATCH_SIZE];
+};
+
+struct ocf_alock_stats {
+	uint64_t resumed;
+		/*!< Number of requests resumed after waiting for lock */
+
+	uint64_t wait_time;
+		/*!< Total time requests have been waiting (in nanoseconds) */
+
+	uint64_t batches;
+		/*!< Number of wake batches delivered to I/O queues */
+
+	uint32_t slots;
+		/*!< Number of lock slots in striped lock table */
+
+	uint32_t busy;
+		/*!< Number of currently locked slots of striped lock table */
+
+	uint64_t collisions;
+		/*!< Number of times lock slot was found busy because of other
+		  entry sharing it */
+};
+
 bool ocf_alock_trylock_one_rd(struct ocf_alock *alock,
 		ocf_cache_line_t entry);
 
@@ -41,9 +80,25 @@ void ocf_alock_unlock_one_rd(struct ocf_alock *alock,
 bool ocf_alock_trylock_entry_wr(struct ocf_alock *alock,
 		ocf_cache_line_t entry);
 
+bool ocf_alock_trylock_one_wr(struct ocf_alock *alock,
+		ocf_cache_line_t entry);
+
 void ocf_alock_unlock_one_wr(struct ocf_alock *alock,
 		const ocf_cache_line_t entry_idx);
 
+void ocf_alock_wake_batch_init(struct ocf_alock_wake_batch *batch);
+
+void ocf_alock_wake_batch_flush(struct ocf_alock *alock,
+		struct ocf_alock_wake_batch *batch);
+
+void ocf_alock_unlock_one_rd_batch(struct ocf_alock *alock,
+		const ocf_cache_line_t entry,
+		struct ocf_alock_wake_batch *batch);
+
+void ocf_alock_unlock_one_wr_batch(struct ocf_alock *alock,
+		const ocf_cache_line_t entry,
+		struct ocf_alock_wake_batch *batch);
+
 int ocf_alock_lock_rd(struct ocf_alock *alock,
 		struct ocf_request *req, ocf_req_async_lock_cb cmpl);
 
@@ -55,6 +110,9 @@ bool ocf_alock_waitlist_is_empty(struct ocf_alock *alock,
 
 uint32_t ocf_alock_waitlist_count(struct ocf_alock *alock);
 
+void ocf_alock_get_stats(struct ocf_alock *alock,
+		struct ocf_alock_stats *stats);
+
 size_t ocf_alock_obj_size(void);
 
 int ocf_alock_init_inplace(struct ocf_alock *self, unsigned num_entries,
@@ -63,10 +121,21 @@ int ocf_alock_init_inplace(struct ocf_alock *self, unsigned num_entries,
 int ocf_alock_init(struct ocf_alock **self, unsigned num_entries,
 		const char* name, struct ocf_alock_lock_cbs *cbs, ocf_cache_t cache);
 
+int ocf_alock_init_striped(struct ocf_alock **self, unsigned num_entries,
+		unsigned num_slots, const char* name,
+		struct ocf_alock_lock_cbs *cbs, ocf_cache_t cache);
+
 void ocf_alock_deinit(struct ocf_alock **self);
 
 size_t ocf_alock_size(unsigned num_entries);
 
+size_t ocf_alock_striped_size(unsigned num_slots);
+
+bool ocf_alock_is_striped(struct ocf_alock *alock);
+
+ocf_cache_line_t ocf_alock_entry_slot(struct ocf_alock *alock,
+		ocf_cache_line_t entry);
+
 bool ocf_alock_is_index_locked(struct ocf_alock *alock,
 		struct ocf_request *req, unsigned index);
 
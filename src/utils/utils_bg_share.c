@@ -0,0 +1,93 @@
+/*
+ * Copyright(c) 2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "ocf/ocf.h"
+#include "utils_bg_share.h"
+#include "../ocf_cache_priv.h"
+
+void ocf_bg_share_set(ocf_cache_t cache, uint32_t share)
+{
+	struct ocf_bg_share *bg = &cache->bg_share;
+	unsigned i;
+
+	bg->share = share;
+
+	env_atomic64_set(&bg->window_start, env_get_tick_count());
+	for (i = 0; i < 2; i++) {
+		env_atomic64_set(&bg->user_bytes[i], 0);
+		env_atomic64_set(&bg->bg_bytes[i], 0);
+	}
+}
+
+/* Races between concurrent window switches only lose some of the bytes */
+static void ocf_bg_share_roll(struct ocf_bg_share *bg)
+{
+	uint64_t now = env_get_tick_count();
+	uint64_t start = env_atomic64_read(&bg->window_start);
+	uint64_t elapsed = env_ticks_to_msecs(now - start);
+
+	if (elapsed < OCF_BG_SHARE_WINDOW_MS)
+		return;
+
+	if (env_atomic64_cmpxchg(&bg->window_start, start, now) != start)
+		return;
+
+	/* Nothing was accounted in window preceding the current one */
+	if (elapsed >= 2 * OCF_BG_SHARE_WINDOW_MS) {
+		env_atomic64_set(&bg->user_bytes[1], 0);
+		env_atomic64_set(&bg->bg_bytes[1], 0);
+	} else {
+		env_atomic64_set(&bg->user_bytes[1],
+				env_atomic64_read(&bg->user_bytes[0]));
+		env_atomic64_set(&bg->bg_bytes[1],
+				env_atomic64_read(&bg->bg_bytes[0]));
+	}
+
+	env_atomic64_set(&bg->user_bytes[0], 0);
+	env_atomic64_set(&bg->bg_bytes[0], 0);
+}
+
+void ocf_bg_share_io_submit(ocf_cache_t cache, struct ocf_io *io)
+{
+	struct ocf_bg_share *bg = &cache->bg_share;
+
+	if (bg->share == OCF_CACHE_BACKGROUND_IO_SHARE_INACTIVE)
+		return;
+
+	ocf_bg_share_roll(bg);
+
+	switch (ocf_io_get_origin(io)) {
+	case ocf_io_origin_user:
+		env_atomic64_add(io->bytes, &bg->user_bytes[0]);
+		break;
+	case ocf_io_origin_backfill:
+	case ocf_io_origin_cleaner:
+		env_atomic64_add(io->bytes, &bg->bg_bytes[0]);
+		break;
+	default:
+		break;
+	}
+}
+
+bool ocf_bg_share_exceeded(ocf_cache_t cache)
+{
+	struct ocf_bg_share *bg = &cache->bg_share;
+	uint64_t user_bytes, bg_bytes;
+
+	if (bg->share == OCF_CACHE_BACKGROUND_IO_SHARE_INACTIVE)
+		return false;
+
+	ocf_bg_share_roll(bg);
+
+	user_bytes = env_atomic64_read(&bg->user_bytes[0]) +
+			env_atomic64_read(&bg->user_bytes[1]);
+	if (!user_bytes)
+		return false;
+
+	bg_bytes = env_atomic64_read(&bg->bg_bytes[0]) +
+			env_atomic64_read(&bg->bg_bytes[1]);
+
+	return bg_bytes * 100 >= (user_bytes + bg_bytes) * bg->share;
+}
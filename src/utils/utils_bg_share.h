@@ -0,0 +1,66 @@
+/*
+ * Copyright(c) 2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __UTILS_BG_SHARE_H__
+#define __UTILS_BG_SHARE_H__
+
+#include "ocf/ocf.h"
+#include "ocf_env.h"
+
+/*
+ * Background share counts bytes of data IO submitted to cache device on
+ * behalf of user requests and of background work (backfill and cleaning)
+ * in time windows of OCF_BG_SHARE_WINDOW_MS. While user IO hit cache device
+ * in current or previous window, background work taking more than configured
+ * percentage of these bytes is deferred: periodic cleaning is postponed and
+ * read misses are not inserted into cache.
+ */
+#define OCF_BG_SHARE_WINDOW_MS 100
+
+struct ocf_bg_share {
+	/* Percentage of cache device bandwidth available to background work
+	 * while user IO is active, 0 if not limited */
+	uint32_t share;
+	/* Start of current window (in ticks) */
+	env_atomic64 window_start;
+	/* Bytes submitted by user IO in current and previous window */
+	env_atomic64 user_bytes[2];
+	/* Bytes submitted by background work in current and previous window */
+	env_atomic64 bg_bytes[2];
+	/* Periodic cleaner runs postponed because of user IO */
+	env_atomic64 cleaner_deferred;
+	/* Read misses not inserted into cache because of user IO */
+	env_atomic64 backfill_skipped;
+};
+
+/**
+ * @brief Set background share and reset bandwidth accounting
+ *
+ * @param cache Cache instance
+ * @param share Percentage of cache device bandwidth, or
+ *	OCF_CACHE_BACKGROUND_IO_SHARE_INACTIVE
+ */
+void ocf_bg_share_set(ocf_cache_t cache, uint32_t share);
+
+/**
+ * @brief Account data IO about to be submitted to cache device
+ *
+ * @note Only IO tagged with user, backfill or cleaner origin is accounted
+ *
+ * @param cache Cache instance
+ * @param io IO to cache device
+ */
+void ocf_bg_share_io_submit(ocf_cache_t cache, struct ocf_io *io);
+
+/**
+ * @brief Check whether background work should be deferred
+ *
+ * @param cache Cache instance
+ *
+ * @retval true Background work exceeds its share while user IO is active
+ */
+bool ocf_bg_share_exceeded(ocf_cache_t cache);
+
+#endif /* __UTILS_BG_SHARE_H__ */
@@ -16,6 +16,8 @@ static void __set_cache_line_invalid(struct ocf_cache *cache, uint8_t start_bit,
 	ENV_BUG_ON(core_id >= OCF_CORE_MAX);
 	core = ocf_cache_get_core(cache, core_id);
 
+	metadata_clear_zero_sec(cache, line, start_bit, end_bit);
+
 	if (metadata_clear_valid_sec_changed(cache, line, start_bit, end_bit,
 			&is_valid)) {
 		/*
@@ -30,6 +30,71 @@ static inline uint64_t ocf_line_pages(struct ocf_cache *cache)
 	return cache->metadata.settings.size / PAGE_SIZE;
 }
 
+/*
+ * Cache line status is tracked per sector. Sector size is fixed at cache
+ * start and is either 512 B or 4 KiB (see ocf_status_granularity_t).
+ */
+static inline uint64_t ocf_line_sector_size(struct ocf_cache *cache)
+{
+	return 1ULL << cache->metadata.settings.sector_shift;
+}
+
+/*
+ * With compression enabled cache line data is stored on cache device in
+ * a slot of cache line size divided by compression ratio, so data offsets
+ * within cache line are scaled down by the ratio as well.
+ */
+static inline bool ocf_cache_compression_enabled(struct ocf_cache *cache)
+{
+	return cache->conf_meta->compression != ocf_compression_none;
+}
+
+static inline uint64_t ocf_line_slot_size(struct ocf_cache *cache)
+{
+	return ocf_line_size(cache) / cache->conf_meta->compression;
+}
+
+/*
+ * With deduplication enabled cache line data is stored in data slot
+ * assigned to cache line when it's written, otherwise each cache line has
+ * its own fixed data slot at its physical position.
+ */
+static inline bool ocf_cache_dedup_enabled(struct ocf_cache *cache)
+{
+	return cache->conf_meta->dedup != ocf_dedup_none;
+}
+
+static inline ocf_cache_line_t ocf_cache_line_slot(struct ocf_cache *cache,
+		ocf_cache_line_t line)
+{
+	if (ocf_cache_dedup_enabled(cache))
+		return ocf_metadata_get_data_slot(cache, line);
+
+	return ocf_metadata_map_lg2phy(cache, line);
+}
+
+static inline uint64_t ocf_cache_line_addr(struct ocf_cache *cache,
+		ocf_cache_line_t line, uint64_t offset)
+{
+	uint64_t phys = ocf_cache_line_slot(cache, line);
+
+	return cache->device->metadata_offset +
+		(phys * ocf_line_size(cache) + offset) /
+		cache->conf_meta->compression;
+}
+
+static inline uint64_t ocf_bytes_2_sectors(struct ocf_cache *cache,
+		uint64_t bytes)
+{
+	return bytes >> cache->metadata.settings.sector_shift;
+}
+
+static inline uint64_t ocf_sectors_2_bytes(struct ocf_cache *cache,
+		uint64_t sectors)
+{
+	return sectors << cache->metadata.settings.sector_shift;
+}
+
 static inline uint64_t ocf_line_sectors(struct ocf_cache *cache)
 {
 	return cache->metadata.settings.sector_count;
@@ -218,15 +283,17 @@ static inline void ocf_purge_map_info(struct ocf_request *req)
 		if (map_idx == 0) {
 			/* First */
 
-			start_bit = BYTES_TO_SECTORS(req->byte_position)
-					% ocf_line_sectors(cache);
+			start_bit = ocf_bytes_2_sectors(cache,
+					req->byte_position) %
+					ocf_line_sectors(cache);
 
 		}
 
 		if (map_idx == (count - 1)) {
 			/* Last */
 
-			end_bit = BYTES_TO_SECTORS(req->byte_position +
+			end_bit = ocf_bytes_2_sectors(cache,
+					req->byte_position +
 					req->byte_length - 1) %
 					ocf_line_sectors(cache);
 		}
@@ -244,7 +311,7 @@ static inline
 uint8_t ocf_map_line_start_sector(struct ocf_request *req, uint32_t line)
 {
 	if (line == 0) {
-		return BYTES_TO_SECTORS(req->byte_position)
+		return ocf_bytes_2_sectors(req->cache, req->byte_position)
 					% ocf_line_sectors(req->cache);
 	}
 
@@ -255,7 +322,7 @@ static inline
 uint8_t ocf_map_line_end_sector(struct ocf_request *req, uint32_t line)
 {
 	if (line == req->core_line_count - 1) {
-		return BYTES_TO_SECTORS(req->byte_position +
+		return ocf_bytes_2_sectors(req->cache, req->byte_position +
 					req->byte_length - 1) %
 					ocf_line_sectors(req->cache);
 	}
@@ -348,6 +415,50 @@ static inline void ocf_set_clean_map_info(struct ocf_request *req)
 	}
 }
 
+static inline void ocf_set_zero_map_info(struct ocf_request *req)
+{
+	uint32_t map_idx = 0;
+	uint8_t start_bit;
+	uint8_t end_bit;
+	struct ocf_cache *cache = req->cache;
+	uint32_t count = req->core_line_count;
+	struct ocf_map_info *map = req->map;
+	bool changed;
+
+	/* Set zero bits for sectors of cache lines with all-zero data and
+	 * clear them for cache lines which data is written to cache
+	 */
+
+	for (map_idx = 0; map_idx < count; map_idx++) {
+		if (!map[map_idx].zero_update)
+			continue;
+
+		start_bit = ocf_map_line_start_sector(req, map_idx);
+		end_bit = ocf_map_line_end_sector(req, map_idx);
+
+		ocf_metadata_start_collision_shared_access(cache, map[map_idx].
+				coll_idx);
+		if (map[map_idx].zero) {
+			changed = metadata_set_zero_sec_changed(cache,
+					map[map_idx].coll_idx, start_bit,
+					end_bit);
+		} else {
+			changed = metadata_clear_zero_sec_changed(cache,
+					map[map_idx].coll_idx, start_bit,
+					end_bit);
+		}
+		ocf_metadata_end_collision_shared_access(cache, map[map_idx].
+				coll_idx);
+
+		/* Zero status tells where data of the line is, so it has to be
+		 * persisted together with the dirty status */
+		if (changed) {
+			ocf_metadata_flush_mark(cache, req, map_idx, ZERO,
+					start_bit, end_bit);
+		}
+	}
+}
+
 /**
  * @brief Validate cache line size
  *
@@ -364,10 +475,112 @@ static inline bool ocf_cache_line_size_is_valid(uint64_t size)
 	case ocf_cache_line_size_16:
 	case ocf_cache_line_size_32:
 	case ocf_cache_line_size_64:
+	case ocf_cache_line_size_128:
+	case ocf_cache_line_size_256:
+	case ocf_cache_line_size_512:
+	case ocf_cache_line_size_1024:
+	case ocf_cache_line_size_2048:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/**
+ * @brief Validate cache line status granularity
+ *
+ * @param[in] granularity Status granularity
+ *
+ * @retval true status granularity is valid
+ * @retval false status granularity is invalid
+ */
+static inline bool ocf_status_granularity_is_valid(uint64_t granularity)
+{
+	switch (granularity) {
+	case ocf_status_granularity_512:
+	case ocf_status_granularity_1:
+	case ocf_status_granularity_2:
+	case ocf_status_granularity_4:
+	case ocf_status_granularity_8:
+	case ocf_status_granularity_16:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/**
+ * @brief Validate cache data compression ratio
+ *
+ * @param[in] compression Compression ratio
+ *
+ * @retval true compression ratio is valid
+ * @retval false compression ratio is invalid
+ */
+static inline bool ocf_compression_is_valid(uint64_t compression)
+{
+	switch (compression) {
+	case ocf_compression_none:
+	case ocf_compression_2:
+	case ocf_compression_4:
 		return true;
 	default:
 		return false;
 	}
 }
 
+/**
+ * @brief Check if compression ratio can be used with given status granularity
+ *
+ * @param[in] granularity Status granularity
+ * @param[in] compression Compression ratio
+ *
+ * @retval true compressed status units are aligned to device sectors
+ * @retval false status granularity is too fine for the compression ratio
+ */
+static inline bool ocf_compression_fits(uint64_t granularity,
+		uint64_t compression)
+{
+	return granularity / compression >= SECTORS_TO_BYTES(1);
+}
+
+/**
+ * @brief Validate cache data deduplication factor
+ *
+ * @param[in] dedup Deduplication factor
+ *
+ * @retval true deduplication factor is valid
+ * @retval false deduplication factor is invalid
+ */
+static inline bool ocf_dedup_is_valid(uint64_t dedup)
+{
+	switch (dedup) {
+	case ocf_dedup_none:
+	case ocf_dedup_2:
+	case ocf_dedup_4:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/* Maximum number of status granularity units within single cache line */
+#define OCF_LINE_STATUS_UNITS_MAX 128
+
+/**
+ * @brief Check if status granularity can be used with given cache line size
+ *
+ * @param[in] line_size Cache line size
+ * @param[in] granularity Status granularity
+ *
+ * @retval true status bits of the cache line fit in metadata
+ * @retval false cache line is too big for the granularity
+ */
+static inline bool ocf_status_granularity_fits(uint64_t line_size,
+		uint64_t granularity)
+{
+	return granularity <= line_size &&
+		line_size / granularity <= OCF_LINE_STATUS_UNITS_MAX;
+}
+
 #endif /* UTILS_CACHE_LINE_H_ */
@@ -11,8 +11,10 @@
 #include "utils_cleaner.h"
 #include "utils_user_part.h"
 #include "utils_io.h"
+#include "utils_compress.h"
 #include "utils_cache_line.h"
 #include "../ocf_queue_priv.h"
+#include "../ocf_ctx_priv.h"
 
 #define OCF_UTILS_CLEANER_DEBUG 0
 
@@ -48,6 +50,7 @@ static struct ocf_request *_ocf_cleaner_alloc_req(struct ocf_cache *cache,
 
 	req->info.internal = true;
 	req->info.cleaner_cache_line_lock = attribs->lock_cacheline;
+	req->io_origin = ocf_io_origin_cleaner;
 
 	/* Allocate pages for cleaning IO */
 	req->data = ctx_data_alloc(cache->owner,
@@ -286,6 +289,8 @@ static int _ocf_cleaner_fire_flush_cache(struct ocf_request *req)
 		return -OCF_ERR_NO_MEM;
 	}
 
+	ocf_io_set_origin(io, req->io_origin);
+
 	ocf_io_set_cmpl(io, req, NULL, _ocf_cleaner_flush_cache_io_end);
 
 	ocf_volume_submit_flush(io);
@@ -342,7 +347,7 @@ static int _ocf_cleaner_update_metadata(struct ocf_request *req)
 		if (metadata_test_dirty(cache, cache_line)) {
 			ocf_metadata_get_core_and_part_id(cache, cache_line,
 					&core_id, &req->part_id);
-			req->core = &cache->core[core_id];
+			req->core = cache->core[core_id];
 
 			ocf_metadata_start_collision_shared_access(cache,
 					cache_line);
@@ -443,6 +448,8 @@ static int _ocf_cleaner_fire_flush_cores(struct ocf_request *req)
 			continue;
 		}
 
+		ocf_io_set_origin(io, req->io_origin);
+
 		ocf_io_set_cmpl(io, iter, req, _ocf_cleaner_flush_cores_io_cmpl);
 
 		ocf_volume_submit_flush(io);
@@ -503,12 +510,13 @@ static void _ocf_cleaner_core_io_for_dirty_range(struct ocf_request *req,
 			iter->coll_idx);
 
 	addr = (ocf_line_size(cache) * iter->core_line)
-			+ SECTORS_TO_BYTES(begin);
+			+ ocf_sectors_2_bytes(cache, begin);
 	offset = (ocf_line_size(cache) * iter->hash)
-			+ SECTORS_TO_BYTES(begin);
+			+ ocf_sectors_2_bytes(cache, begin);
 
 	io = ocf_new_core_io(core, req->io_queue, addr,
-			SECTORS_TO_BYTES(end - begin), OCF_WRITE, part_id, 0);
+			ocf_sectors_2_bytes(cache, end - begin), OCF_WRITE,
+			part_id, 0);
 	if (!io)
 		goto error;
 
@@ -518,10 +526,11 @@ static void _ocf_cleaner_core_io_for_dirty_range(struct ocf_request *req,
 		goto error;
 	}
 
+	ocf_io_set_origin(io, req->io_origin);
 	ocf_io_set_cmpl(io, iter, req, _ocf_cleaner_core_io_cmpl);
 
 	ocf_core_stats_core_block_update(core, part_id, OCF_WRITE,
-			SECTORS_TO_BYTES(end - begin));
+			ocf_sectors_2_bytes(cache, end - begin));
 
 	OCF_DEBUG_PARAM(req->cache, "Core write, line = %llu, "
 			"sector = %llu, count = %llu", iter->core_line, begin,
@@ -539,6 +548,70 @@ error:
 	_ocf_cleaner_set_error(req);
 }
 
+/*
+ * Zero sectors are not stored on cache device, so they are filled in data
+ * read from cache before it's written to core
+ */
+static void _ocf_cleaner_fill_zero(struct ocf_request *req,
+		struct ocf_map_info *iter)
+{
+	struct ocf_cache *cache = req->cache;
+	uint8_t start = ocf_line_start_sector(cache);
+	uint8_t end = ocf_line_end_sector(cache);
+	uint8_t len;
+	bool zero;
+
+	while (start <= end) {
+		len = ocf_metadata_zero_run(cache, iter->coll_idx, start, end,
+				&zero);
+
+		if (zero) {
+			ctx_data_seek_check(cache->owner, req->data,
+					ctx_data_seek_begin,
+					ocf_line_size(cache) * iter->hash +
+					ocf_sectors_2_bytes(cache, start));
+			ctx_data_zero_check(cache->owner, req->data,
+					ocf_sectors_2_bytes(cache, len));
+		}
+
+		start += len;
+	}
+}
+
+/*
+ * Dirty sectors of compressed cache line are decompressed into their place
+ * in request data, other sectors are not written to core
+ */
+static int _ocf_cleaner_decompress(struct ocf_request *req,
+		struct ocf_map_info *iter)
+{
+	struct ocf_cache *cache = req->cache;
+	uint64_t ratio = cache->conf_meta->compression;
+	uint64_t offset = ocf_line_size(cache) * iter->hash;
+	uint64_t sector_offset;
+	uint32_t i;
+	int result;
+
+	for (i = 0; i < ocf_line_sectors(cache); i++) {
+		if (!_ocf_cleaner_sector_is_dirty(cache, iter->coll_idx, i))
+			continue;
+
+		if (metadata_test_zero_sec(cache, iter->coll_idx, i, i))
+			continue;
+
+		sector_offset = ocf_sectors_2_bytes(cache, i);
+
+		result = ocf_decompress_data(cache, req->data,
+				offset + sector_offset, req->cdata,
+				(offset + sector_offset) / ratio,
+				ocf_line_sector_size(cache));
+		if (result)
+			return result;
+	}
+
+	return 0;
+}
+
 static void _ocf_cleaner_core_submit_io(struct ocf_request *req,
 		struct ocf_map_info *iter)
 {
@@ -546,6 +619,15 @@ static void _ocf_cleaner_core_submit_io(struct ocf_request *req,
 	struct ocf_cache *cache = req->cache;
 	bool counting_dirty = false;
 
+	if (ocf_cache_compression_enabled(cache) &&
+			_ocf_cleaner_decompress(req, iter)) {
+		iter->invalid = true;
+		_ocf_cleaner_set_error(req);
+		return;
+	}
+
+	_ocf_cleaner_fill_zero(req, iter);
+
 	/* Check integrity of entry to be cleaned */
 	if (metadata_test_valid(cache, iter->coll_idx)
 		&& metadata_test_dirty(cache, iter->coll_idx)) {
@@ -668,9 +750,21 @@ static int _ocf_cleaner_fire_cache(struct ocf_request *req)
 	struct ocf_map_info *iter = req->map;
 	uint64_t addr, offset;
 	ocf_part_id_t part_id;
+	ctx_data_t *data = req->data;
+	uint64_t slot_size = ocf_line_slot_size(cache);
 	struct ocf_io *io;
 	int err;
 
+	/* Compressed cache lines are read into separate buffer and
+	 * decompressed before core write */
+	if (ocf_cache_compression_enabled(cache)) {
+		if (!req->cdata) {
+			req->cdata = ctx_data_alloc(cache->owner, BYTES_TO_PAGES(
+					req->core_line_count * slot_size));
+		}
+		data = req->cdata;
+	}
+
 	/* Protect IO completion race */
 	env_atomic_inc(&req->req_remaining);
 
@@ -681,21 +775,26 @@ static int _ocf_cleaner_fire_cache(struct ocf_request *req)
 		if (iter->status == LOOKUP_MISS)
 			continue;
 
+		if (metadata_test_zero_sec(cache, iter->coll_idx,
+				ocf_line_start_sector(cache),
+				ocf_line_end_sector(cache))) {
+			/* Nothing to read, data is filled with zeros before
+			 * core write */
+			env_atomic_dec(&req->req_remaining);
+			continue;
+		}
+
 		OCF_DEBUG_PARAM(req->cache, "Cache read, line =  %u",
 				iter->coll_idx);
 
-		addr = ocf_metadata_map_lg2phy(cache,
-				iter->coll_idx);
-		addr *= ocf_line_size(cache);
-		addr += cache->device->metadata_offset;
+		addr = ocf_cache_line_addr(cache, iter->coll_idx, 0);
 
-		offset = ocf_line_size(cache) * iter->hash;
+		offset = slot_size * iter->hash;
 
 		part_id = ocf_metadata_get_partition_id(cache, iter->coll_idx);
 
-		io = ocf_new_cache_io(cache, req->io_queue,
-				addr, ocf_line_size(cache),
-				OCF_READ, part_id, 0);
+		io = data ? ocf_new_cache_io(cache, req->io_queue,
+				addr, slot_size, OCF_READ, part_id, 0) : NULL;
 		if (!io) {
 			/* Allocation error */
 			iter->invalid = true;
@@ -703,8 +802,9 @@ static int _ocf_cleaner_fire_cache(struct ocf_request *req)
 			continue;
 		}
 
+		ocf_io_set_origin(io, req->io_origin);
 		ocf_io_set_cmpl(io, iter, req, _ocf_cleaner_cache_io_cmpl);
-		err = ocf_io_set_data(io, req->data, offset);
+		err = ocf_io_set_data(io, data, offset);
 		if (err) {
 			ocf_io_put(io);
 			iter->invalid = true;
@@ -713,8 +813,9 @@ static int _ocf_cleaner_fire_cache(struct ocf_request *req)
 		}
 
 		ocf_core_stats_cache_block_update(core, part_id, OCF_READ,
-				ocf_line_size(cache));
+				slot_size);
 
+		ocf_bg_share_io_submit(cache, io);
 		ocf_volume_submit_io(io);
 	}
 
@@ -805,13 +906,18 @@ static int _ocf_cleaner_do_fire(struct ocf_request *req,  uint32_t i_out,
 	return _ocf_cleaner_fire(req);
 }
 
-static inline uint32_t _ocf_cleaner_get_req_max_count(uint32_t count,
-		bool low_mem)
+static inline uint32_t _ocf_cleaner_get_req_max_count(struct ocf_cache *cache,
+		uint32_t count, bool low_mem)
 {
+	/* Limits are tuned for cache lines up to 64 kiB - scale them down
+	 * for bigger lines to keep request buffer size bounded */
+	uint32_t scale = OCF_DIV_ROUND_UP(ocf_line_size(cache),
+			ocf_cache_line_size_64);
+
 	if (low_mem || count <= 4096)
-		return count < 128 ? count : 128;
+		return OCF_MIN(count, 128 / scale);
 
-	return 1024;
+	return 1024 / scale;
 }
 
 static void _ocf_cleaner_fire_error(struct ocf_request *master,
@@ -834,7 +940,7 @@ void ocf_cleaner_fire(struct ocf_cache *cache,
 	 * optimal number, but for smaller 1024 is too large to benefit from
 	 * cleaning request overlapping
 	 */
-	uint32_t max = _ocf_cleaner_get_req_max_count(count, false);
+	uint32_t max = _ocf_cleaner_get_req_max_count(cache, count, false);
 	ocf_cache_line_t cache_line;
 	/* it is possible that more than one cleaning request will be generated
 	 * for each cleaning order, thus multiple allocations. At the end of
@@ -855,7 +961,7 @@ void ocf_cleaner_fire(struct ocf_cache *cache,
 
 	if (!master) {
 		/* Some memory allocation error, try re-allocate request */
-		max = _ocf_cleaner_get_req_max_count(count, true);
+		max = _ocf_cleaner_get_req_max_count(cache, count, true);
 		master = _ocf_cleaner_alloc_master_req(cache, max, attribs);
 	}
 
@@ -885,7 +991,7 @@ void ocf_cleaner_fire(struct ocf_cache *cache,
 			/* Some memory allocation error,
 			 * try re-allocate request
 			 */
-			max = _ocf_cleaner_get_req_max_count(max, true);
+			max = _ocf_cleaner_get_req_max_count(cache, max, true);
 			req = _ocf_cleaner_alloc_slave_req(master, max, attribs);
 		}
 
@@ -939,7 +1045,7 @@ void ocf_cleaner_fire(struct ocf_cache *cache,
 		if (skip)
 			continue;
 
-		if (unlikely(!cache->core[core_id].opened)) {
+		if (unlikely(!cache->core[core_id]->opened)) {
 			OCF_DEBUG_MSG(cache, "Core object inactive");
 			continue;
 		}
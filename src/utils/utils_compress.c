@@ -0,0 +1,87 @@
+/*
+ * Copyright(c) 2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "ocf/ocf.h"
+#include "../ocf_cache_priv.h"
+#include "../ocf_ctx_priv.h"
+#include "utils_compress.h"
+#include "utils_cache_line.h"
+
+bool ocf_compress_data(ocf_cache_t cache, ctx_data_t *dst, uint64_t to,
+		ctx_data_t *src, uint64_t from, uint64_t bytes)
+{
+	ocf_ctx_t ctx = cache->owner;
+	uint64_t unit = ocf_line_sector_size(cache);
+	uint64_t slot = unit / cache->conf_meta->compression;
+	uint64_t start = env_get_tick_count();
+	uint64_t in = 0, out = 0;
+	uint8_t hdr[OCF_COMPRESS_HDR_SIZE];
+	uint32_t size;
+	bool fits = true;
+
+	ENV_BUG_ON(bytes % unit);
+
+	for (; bytes; bytes -= unit, from += unit, to += slot) {
+		size = ctx_data_compress(ctx, dst, src,
+				to + OCF_COMPRESS_HDR_SIZE, from, unit,
+				slot - OCF_COMPRESS_HDR_SIZE);
+		if (!size) {
+			fits = false;
+			break;
+		}
+
+		hdr[0] = size & 0xff;
+		hdr[1] = size >> 8;
+
+		ctx_data_seek_check(ctx, dst, ctx_data_seek_begin, to);
+		ctx_data_wr_check(ctx, dst, hdr, sizeof(hdr));
+
+		in += unit;
+		out += size + OCF_COMPRESS_HDR_SIZE;
+	}
+
+	env_atomic64_add(env_ticks_to_nsecs(env_get_tick_count() - start),
+			&cache->compression.compress_ns);
+	env_atomic64_add(in, &cache->compression.bytes_in);
+	env_atomic64_add(out, &cache->compression.bytes_out);
+
+	return fits;
+}
+
+int ocf_decompress_data(ocf_cache_t cache, ctx_data_t *dst, uint64_t to,
+		ctx_data_t *src, uint64_t from, uint64_t bytes)
+{
+	ocf_ctx_t ctx = cache->owner;
+	uint64_t unit = ocf_line_sector_size(cache);
+	uint64_t slot = unit / cache->conf_meta->compression;
+	uint64_t start = env_get_tick_count();
+	uint8_t hdr[OCF_COMPRESS_HDR_SIZE];
+	uint32_t size;
+	int result = 0;
+
+	ENV_BUG_ON(bytes % unit);
+
+	for (; bytes; bytes -= unit, from += slot, to += unit) {
+		ctx_data_seek_check(ctx, src, ctx_data_seek_begin, from);
+		ctx_data_rd_check(ctx, hdr, src, sizeof(hdr));
+
+		size = hdr[0] | (hdr[1] << 8);
+		if (!size || size > slot - OCF_COMPRESS_HDR_SIZE) {
+			result = -OCF_ERR_IO;
+			break;
+		}
+
+		if (ctx_data_decompress(ctx, dst, src, to,
+				from + OCF_COMPRESS_HDR_SIZE, size, unit)) {
+			result = -OCF_ERR_IO;
+			break;
+		}
+	}
+
+	env_atomic64_add(env_ticks_to_nsecs(env_get_tick_count() - start),
+			&cache->compression.decompress_ns);
+
+	return result;
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright(c) 2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __UTILS_COMPRESS_H__
+#define __UTILS_COMPRESS_H__
+
+#include "ocf/ocf.h"
+
+/*
+ * Each status granularity unit is compressed separately into its share of
+ * cache line slot (unit size divided by compression ratio). Compressed data
+ * is prefixed with its size stored as 16-bit little endian value.
+ */
+#define OCF_COMPRESS_HDR_SIZE 2
+
+/**
+ * @brief Compress data to be written to cache device
+ *
+ * @param cache Cache instance
+ * @param dst Buffer for compressed data
+ * @param to Offset of compressed data in dst buffer
+ * @param src Data to be compressed
+ * @param from Offset of data in src buffer
+ * @param bytes Number of bytes to be compressed, multiple of status
+ *	granularity
+ *
+ * @retval true Data has been compressed
+ * @retval false Some unit of data doesn't fit into its slot
+ */
+bool ocf_compress_data(ocf_cache_t cache, ctx_data_t *dst, uint64_t to,
+		ctx_data_t *src, uint64_t from, uint64_t bytes);
+
+/**
+ * @brief Decompress data read from cache device
+ *
+ * @param cache Cache instance
+ * @param dst Buffer for decompressed data
+ * @param to Offset of decompressed data in dst buffer
+ * @param src Compressed data
+ * @param from Offset of compressed data in src buffer
+ * @param bytes Number of bytes after decompression, multiple of status
+ *	granularity
+ *
+ * @retval 0 Data has been decompressed
+ * @retval -OCF_ERR_IO Compressed data is corrupted
+ */
+int ocf_decompress_data(ocf_cache_t cache, ctx_data_t *dst, uint64_t to,
+		ctx_data_t *src, uint64_t from, uint64_t bytes);
+
+#endif /* __UTILS_COMPRESS_H__ */
@@ -0,0 +1,628 @@
+/*
+ * Copyright(c) 2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "../ocf_priv.h"
+#include "../ocf_cache_priv.h"
+#include "../ocf_ctx_priv.h"
+#include "../ocf_request.h"
+#include "../metadata/metadata.h"
+#include "utils_dedup.h"
+#include "utils_cache_line.h"
+#include "utils_compress.h"
+#include "utils_io.h"
+
+/* Size of buffer for reading data being fingerprinted or compared */
+#define OCF_DEDUP_FP_CHUNK 256
+
+int ocf_dedup_init(ocf_cache_t cache)
+{
+	struct ocf_dedup *dedup = &cache->dedup;
+	uint32_t slots = cache->device->data_slots;
+	uint32_t buckets = 1;
+	int result;
+
+	if (!ocf_cache_dedup_enabled(cache))
+		return 0;
+
+	while (buckets < slots / 2)
+		buckets <<= 1;
+
+	dedup->slots = env_vzalloc(sizeof(*dedup->slots) * slots);
+	dedup->free = env_vzalloc(sizeof(*dedup->free) * slots);
+	dedup->buckets = env_vzalloc(sizeof(*dedup->buckets) * buckets);
+	if (!dedup->slots || !dedup->free || !dedup->buckets) {
+		result = -OCF_ERR_NO_MEM;
+		goto err;
+	}
+
+	result = env_spinlock_init(&dedup->lock);
+	if (result)
+		goto err;
+
+	dedup->bucket_mask = buckets - 1;
+	env_atomic64_set(&dedup->hits, 0);
+	env_atomic64_set(&dedup->cow, 0);
+	env_atomic64_set(&dedup->no_slot, 0);
+	env_atomic64_set(&dedup->collisions, 0);
+
+	return 0;
+
+err:
+	env_vfree(dedup->buckets);
+	env_vfree(dedup->free);
+	env_vfree(dedup->slots);
+	dedup->slots = NULL;
+
+	return result;
+}
+
+void ocf_dedup_deinit(ocf_cache_t cache)
+{
+	struct ocf_dedup *dedup = &cache->dedup;
+
+	if (!dedup->slots)
+		return;
+
+	env_spinlock_destroy(&dedup->lock);
+	env_vfree(dedup->buckets);
+	env_vfree(dedup->free);
+	env_vfree(dedup->slots);
+	dedup->slots = NULL;
+}
+
+int ocf_dedup_rebuild(ocf_cache_t cache)
+{
+	struct ocf_dedup *dedup = &cache->dedup;
+	ocf_cache_line_t invalid = cache->device->data_slots;
+	ocf_cache_line_t line, slot;
+	unsigned int step = 0;
+
+	if (!ocf_cache_dedup_enabled(cache))
+		return 0;
+
+	for (slot = 0; slot < invalid; slot++) {
+		dedup->slots[slot].refcnt = 0;
+		dedup->slots[slot].state = ocf_dedup_slot_unindexed;
+		dedup->slots[slot].next = invalid;
+	}
+
+	for (slot = 0; slot <= dedup->bucket_mask; slot++)
+		dedup->buckets[slot] = invalid;
+
+	dedup->shared = 0;
+
+	for (line = 0; line < cache->device->collision_table_entries;
+			line++) {
+		slot = ocf_metadata_get_data_slot(cache, line);
+		if (slot == invalid)
+			continue;
+
+		if (slot > invalid)
+			return -OCF_ERR_INVAL;
+
+		if (!metadata_test_valid_any(cache, line)) {
+			ocf_metadata_set_data_slot(cache, line, invalid);
+			continue;
+		}
+
+		if (++dedup->slots[slot].refcnt == 2)
+			dedup->shared++;
+
+		OCF_COND_RESCHED_DEFAULT(step);
+	}
+
+	/* Lowest free data slots are allocated first */
+	dedup->free_count = 0;
+	for (slot = invalid; slot-- > 0; ) {
+		if (!dedup->slots[slot].refcnt)
+			dedup->free[dedup->free_count++] = slot;
+	}
+
+	return 0;
+}
+
+bool ocf_dedup_slots_available(ocf_cache_t cache, uint32_t count)
+{
+	if (!ocf_cache_dedup_enabled(cache))
+		return true;
+
+	return cache->dedup.free_count >= count;
+}
+
+static inline uint64_t ocf_dedup_rotl(uint64_t x, int r)
+{
+	return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t ocf_dedup_fmix(uint64_t k)
+{
+	k ^= k >> 33;
+	k *= 0xff51afd7ed558ccdULL;
+	k ^= k >> 33;
+	k *= 0xc4ceb9fe1a85ec53ULL;
+	k ^= k >> 33;
+
+	return k;
+}
+
+/*
+ * 128-bit MurmurHash3 of cache line data. Fingerprints are kept only in
+ * memory, so they don't need to be stable across platforms.
+ */
+static void ocf_dedup_fingerprint(ocf_cache_t cache, ctx_data_t *data,
+		uint64_t offset, uint64_t size, uint64_t fp[2])
+{
+	const uint64_t c1 = 0x87c37b91114253d5ULL;
+	const uint64_t c2 = 0x4cf5ad432745937fULL;
+	uint64_t buf[OCF_DEDUP_FP_CHUNK / sizeof(uint64_t)];
+	uint64_t h1 = 0, h2 = 0, k1, k2;
+	uint64_t len = size;
+	uint32_t i, bytes;
+
+	ctx_data_seek_check(cache->owner, data, ctx_data_seek_begin, offset);
+
+	for (; size; size -= bytes) {
+		bytes = OCF_MIN(size, sizeof(buf));
+		ctx_data_rd_check(cache->owner, buf, data, bytes);
+
+		for (i = 0; i < bytes / sizeof(uint64_t); i += 2) {
+			k1 = buf[i] * c1;
+			k1 = ocf_dedup_rotl(k1, 31) * c2;
+			h1 ^= k1;
+			h1 = ocf_dedup_rotl(h1, 27) + h2;
+			h1 = h1 * 5 + 0x52dce729;
+
+			k2 = buf[i + 1] * c2;
+			k2 = ocf_dedup_rotl(k2, 33) * c1;
+			h2 ^= k2;
+			h2 = ocf_dedup_rotl(h2, 31) + h1;
+			h2 = h2 * 5 + 0x38495ab5;
+		}
+	}
+
+	h1 ^= len;
+	h2 ^= len;
+	h1 += h2;
+	h2 += h1;
+	h1 = ocf_dedup_fmix(h1);
+	h2 = ocf_dedup_fmix(h2);
+	h1 += h2;
+	h2 += h1;
+
+	fp[0] = h1;
+	fp[1] = h2;
+}
+
+static inline ocf_cache_line_t *ocf_dedup_bucket(struct ocf_dedup *dedup,
+		const uint64_t fp[2])
+{
+	return &dedup->buckets[fp[0] & dedup->bucket_mask];
+}
+
+static ocf_cache_line_t ocf_dedup_lookup(ocf_cache_t cache,
+		const uint64_t fp[2])
+{
+	struct ocf_dedup *dedup = &cache->dedup;
+	ocf_cache_line_t slot = *ocf_dedup_bucket(dedup, fp);
+	struct ocf_dedup_slot *entry;
+
+	for (; slot != cache->device->data_slots; slot = entry->next) {
+		entry = &dedup->slots[slot];
+
+		if (entry->state == ocf_dedup_slot_indexed &&
+				entry->fingerprint[0] == fp[0] &&
+				entry->fingerprint[1] == fp[1]) {
+			return slot;
+		}
+	}
+
+	return slot;
+}
+
+static void ocf_dedup_unindex(ocf_cache_t cache, ocf_cache_line_t slot)
+{
+	struct ocf_dedup *dedup = &cache->dedup;
+	struct ocf_dedup_slot *entry = &dedup->slots[slot];
+	ocf_cache_line_t *iter;
+
+	if (entry->state == ocf_dedup_slot_unindexed)
+		return;
+
+	iter = ocf_dedup_bucket(dedup, entry->fingerprint);
+	while (*iter != slot)
+		iter = &dedup->slots[*iter].next;
+
+	*iter = entry->next;
+	entry->next = cache->device->data_slots;
+	entry->state = ocf_dedup_slot_unindexed;
+}
+
+static void ocf_dedup_index(ocf_cache_t cache, ocf_cache_line_t slot,
+		const uint64_t fp[2])
+{
+	struct ocf_dedup *dedup = &cache->dedup;
+	struct ocf_dedup_slot *entry = &dedup->slots[slot];
+	ocf_cache_line_t *bucket = ocf_dedup_bucket(dedup, fp);
+
+	ocf_dedup_unindex(cache, slot);
+
+	entry->fingerprint[0] = fp[0];
+	entry->fingerprint[1] = fp[1];
+	entry->state = ocf_dedup_slot_pending;
+	entry->next = *bucket;
+	*bucket = slot;
+}
+
+static void ocf_dedup_get_slot(ocf_cache_t cache, ocf_cache_line_t slot)
+{
+	struct ocf_dedup *dedup = &cache->dedup;
+
+	if (++dedup->slots[slot].refcnt == 2)
+		dedup->shared++;
+}
+
+static void ocf_dedup_put_slot(ocf_cache_t cache, ocf_cache_line_t slot)
+{
+	struct ocf_dedup *dedup = &cache->dedup;
+	struct ocf_dedup_slot *entry = &dedup->slots[slot];
+
+	ENV_BUG_ON(!entry->refcnt);
+
+	if (--entry->refcnt == 1)
+		dedup->shared--;
+
+	if (entry->refcnt)
+		return;
+
+	ocf_dedup_unindex(cache, slot);
+	dedup->free[dedup->free_count++] = slot;
+}
+
+void ocf_dedup_put_line(ocf_cache_t cache, ocf_cache_line_t line)
+{
+	ocf_cache_line_t slot = ocf_metadata_get_data_slot(cache, line);
+
+	if (slot == cache->device->data_slots)
+		return;
+
+	ocf_metadata_set_data_slot(cache, line, cache->device->data_slots);
+
+	env_spinlock_lock(&cache->dedup.lock);
+	ocf_dedup_put_slot(cache, slot);
+	env_spinlock_unlock(&cache->dedup.lock);
+}
+
+/*
+ * Sectors of cache line copied on write which are not written by request
+ * stay in shared data slot, so they are no longer valid. Shared data slots
+ * hold only clean data.
+ */
+static void ocf_dedup_drop_unwritten(struct ocf_request *req, uint32_t idx)
+{
+	ocf_cache_t cache = req->cache;
+	ocf_cache_line_t line = req->map[idx].coll_idx;
+	uint8_t start = ocf_map_line_start_sector(req, idx);
+	uint8_t end = ocf_map_line_end_sector(req, idx);
+	bool valid = metadata_test_valid_any(cache, line);
+	ocf_core_id_t core_id;
+	ocf_part_id_t part_id;
+	ocf_core_t core;
+	uint8_t i;
+
+	for (i = ocf_line_start_sector(cache);
+			i <= ocf_line_end_sector(cache); i++) {
+		if ((i < start || i > end) &&
+				!metadata_test_zero_sec(cache, line, i, i)) {
+			metadata_clear_valid_sec_one(cache, line, i);
+		}
+	}
+
+	if (!valid || metadata_test_valid_any(cache, line))
+		return;
+
+	ocf_metadata_get_core_and_part_id(cache, line, &core_id, &part_id);
+	core = ocf_cache_get_core(cache, core_id);
+
+	env_atomic_dec(&core->runtime_meta->cached_clines);
+	env_atomic_dec(&core->runtime_meta->
+			part_counters[part_id].cached_clines);
+}
+
+/* Data slot of dirty cache line must be persistent along with its status */
+static inline void ocf_dedup_mark_flush(struct ocf_request *req, uint32_t idx)
+{
+	if (metadata_test_dirty(req->cache, req->map[idx].coll_idx)) {
+		req->map[idx].flush = true;
+		req->info.flush_metadata = true;
+	}
+}
+
+static bool ocf_dedup_map_line(struct ocf_request *req, uint32_t idx,
+		const uint64_t *fp, bool full)
+{
+	ocf_cache_t cache = req->cache;
+	struct ocf_dedup *dedup = &cache->dedup;
+	struct ocf_map_info *entry = &req->map[idx];
+	ocf_cache_line_t invalid = cache->device->data_slots;
+	ocf_cache_line_t old, slot;
+
+	old = ocf_metadata_get_data_slot(cache, entry->coll_idx);
+
+	env_spinlock_lock(&dedup->lock);
+
+	slot = fp ? ocf_dedup_lookup(cache, fp) : invalid;
+	if (slot != invalid) {
+		/* Identical data is already in cache */
+		if (slot != old) {
+			ocf_dedup_get_slot(cache, slot);
+			ocf_metadata_set_data_slot(cache, entry->coll_idx,
+					slot);
+			if (old != invalid)
+				ocf_dedup_put_slot(cache, old);
+		}
+
+		env_spinlock_unlock(&dedup->lock);
+
+		/* Shared data slot is pinned until it's verified */
+		entry->dedup = true;
+		return true;
+	}
+
+	if (old != invalid && dedup->slots[old].refcnt == 1) {
+		/* Exclusive data slot is overwritten in place */
+		slot = old;
+		ocf_dedup_unindex(cache, slot);
+	} else {
+		if (!dedup->free_count) {
+			env_spinlock_unlock(&dedup->lock);
+			return false;
+		}
+
+		slot = dedup->free[--dedup->free_count];
+		dedup->slots[slot].refcnt = 1;
+		ocf_metadata_set_data_slot(cache, entry->coll_idx, slot);
+
+		if (old != invalid)
+			ocf_dedup_put_slot(cache, old);
+	}
+
+	if (fp)
+		ocf_dedup_index(cache, slot, fp);
+
+	env_spinlock_unlock(&dedup->lock);
+
+	if (slot == old)
+		return true;
+
+	if (old != invalid) {
+		env_atomic64_inc(&dedup->cow);
+		if (!full)
+			ocf_dedup_drop_unwritten(req, idx);
+	}
+
+	ocf_dedup_mark_flush(req, idx);
+
+	return true;
+}
+
+bool ocf_dedup_map_req(struct ocf_request *req, bool backfill)
+{
+	ocf_cache_t cache = req->cache;
+	struct ocf_map_info *entry;
+	uint64_t line_size = ocf_line_size(cache);
+	uint64_t fp[2], offset;
+	bool full, lookup;
+	uint32_t i;
+
+	for (i = 0; i < req->core_line_count; i++) {
+		entry = &req->map[i];
+		entry->dedup = false;
+
+		if (backfill && !entry->backfill)
+			continue;
+
+		full = ocf_map_line_start_sector(req, i) ==
+				ocf_line_start_sector(cache) &&
+			ocf_map_line_end_sector(req, i) ==
+				ocf_line_end_sector(cache);
+
+		if (entry->zero) {
+			/* All-zero data is not stored in data slot */
+			if (full) {
+				ocf_dedup_put_line(cache, entry->coll_idx);
+				ocf_dedup_mark_flush(req, i);
+			}
+			continue;
+		}
+
+		/* Only clean data inserted on read miss is deduplicated */
+		lookup = backfill && full &&
+				!metadata_test_dirty(cache, entry->coll_idx);
+		if (lookup) {
+			offset = i * line_size - req->byte_position % line_size;
+			ocf_dedup_fingerprint(cache, req->data,
+					req->offset + offset, line_size, fp);
+		}
+
+		if (!ocf_dedup_map_line(req, i, lookup ? fp : NULL, full)) {
+			env_atomic64_inc(&cache->dedup.no_slot);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void ocf_dedup_publish_req(struct ocf_request *req)
+{
+	ocf_cache_t cache = req->cache;
+	struct ocf_dedup *dedup = &cache->dedup;
+	struct ocf_map_info *entry;
+	ocf_cache_line_t slot;
+	uint32_t i;
+
+	if (!ocf_cache_dedup_enabled(cache))
+		return;
+
+	env_spinlock_lock(&dedup->lock);
+
+	for (i = 0; i < req->core_line_count; i++) {
+		entry = &req->map[i];
+
+		if (!entry->backfill || entry->dedup || entry->zero)
+			continue;
+
+		slot = ocf_metadata_get_data_slot(cache, entry->coll_idx);
+		if (slot != cache->device->data_slots &&
+				dedup->slots[slot].state ==
+					ocf_dedup_slot_pending) {
+			dedup->slots[slot].state = ocf_dedup_slot_indexed;
+		}
+	}
+
+	env_spinlock_unlock(&dedup->lock);
+}
+
+static inline uint64_t ocf_dedup_line_offset(struct ocf_request *req,
+		uint32_t idx)
+{
+	uint64_t line_size = ocf_line_size(req->cache);
+
+	return idx * line_size - req->byte_position % line_size;
+}
+
+bool ocf_dedup_read_req(struct ocf_request *req, ocf_req_end_t callback)
+{
+	ocf_cache_t cache = req->cache;
+	uint64_t ratio = cache->conf_meta->compression;
+	ctx_data_t *data;
+	bool submitted = false;
+	uint32_t i;
+
+	for (i = 0; i < req->core_line_count; i++) {
+		if (!req->map[i].dedup)
+			continue;
+
+		if (!req->dedup_data) {
+			req->dedup_data = ctx_data_alloc(cache->owner,
+					BYTES_TO_PAGES(req->byte_length));
+		}
+
+		env_atomic_inc(&req->req_remaining);
+		submitted = true;
+
+		if (!req->dedup_data) {
+			callback(req, -OCF_ERR_NO_MEM);
+			break;
+		}
+
+		/* Compressed slots are read into space reserved for them in
+		 * compressed request data, which these cache lines don't use */
+		data = ocf_cache_compression_enabled(cache) ?
+				req->cdata : req->dedup_data;
+
+		ocf_submit_cache_line_buf(cache, req, i, data,
+				ocf_dedup_line_offset(req, i) / ratio, callback);
+	}
+
+	return submitted;
+}
+
+static bool ocf_dedup_line_matches(struct ocf_request *req, uint64_t offset)
+{
+	ocf_cache_t cache = req->cache;
+	uint64_t ratio = cache->conf_meta->compression;
+	uint8_t buf[2][OCF_DEDUP_FP_CHUNK];
+	uint64_t size = ocf_line_size(cache);
+	uint32_t bytes;
+	int diff;
+
+	if (ocf_cache_compression_enabled(cache) &&
+			ocf_decompress_data(cache, req->dedup_data, offset,
+				req->cdata, offset / ratio, size)) {
+		return false;
+	}
+
+	ctx_data_seek_check(cache->owner, req->data, ctx_data_seek_begin,
+			req->offset + offset);
+	ctx_data_seek_check(cache->owner, req->dedup_data,
+			ctx_data_seek_begin, offset);
+
+	for (; size; size -= bytes) {
+		bytes = OCF_MIN(size, sizeof(buf[0]));
+		ctx_data_rd_check(cache->owner, buf[0], req->data, bytes);
+		ctx_data_rd_check(cache->owner, buf[1], req->dedup_data, bytes);
+
+		if (env_memcmp(buf[0], bytes, buf[1], bytes, &diff) || diff)
+			return false;
+	}
+
+	return true;
+}
+
+/*
+ * Cache line which data differs from data slot with matching fingerprint
+ * gets its own data slot, the same way as if the fingerprint wasn't found
+ */
+static bool ocf_dedup_unshare_line(struct ocf_request *req, uint32_t idx)
+{
+	ocf_cache_t cache = req->cache;
+	struct ocf_dedup *dedup = &cache->dedup;
+	struct ocf_map_info *entry = &req->map[idx];
+	ocf_cache_line_t old, slot;
+
+	old = ocf_metadata_get_data_slot(cache, entry->coll_idx);
+
+	env_spinlock_lock(&dedup->lock);
+
+	if (dedup->slots[old].refcnt == 1) {
+		/* Exclusive data slot is overwritten in place */
+		ocf_dedup_unindex(cache, old);
+	} else {
+		if (!dedup->free_count) {
+			env_spinlock_unlock(&dedup->lock);
+			return false;
+		}
+
+		slot = dedup->free[--dedup->free_count];
+		dedup->slots[slot].refcnt = 1;
+		ocf_metadata_set_data_slot(cache, entry->coll_idx, slot);
+		ocf_dedup_put_slot(cache, old);
+	}
+
+	env_spinlock_unlock(&dedup->lock);
+
+	entry->dedup = false;
+
+	return true;
+}
+
+int ocf_dedup_verify_req(struct ocf_request *req)
+{
+	struct ocf_dedup *dedup = &req->cache->dedup;
+	int unshared = 0;
+	uint32_t i;
+
+	for (i = 0; i < req->core_line_count; i++) {
+		if (!req->map[i].dedup)
+			continue;
+
+		if (ocf_dedup_line_matches(req, ocf_dedup_line_offset(req, i))) {
+			env_atomic64_inc(&dedup->hits);
+			continue;
+		}
+
+		env_atomic64_inc(&dedup->collisions);
+
+		if (!ocf_dedup_unshare_line(req, i)) {
+			env_atomic64_inc(&dedup->no_slot);
+			return -OCF_ERR_NO_MEM;
+		}
+
+		unshared++;
+	}
+
+	return unshared;
+}
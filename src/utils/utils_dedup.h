@@ -0,0 +1,167 @@
+/*
+ * Copyright(c) 2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __UTILS_DEDUP_H__
+#define __UTILS_DEDUP_H__
+
+#include "ocf/ocf.h"
+#include "ocf_env.h"
+#include "../ocf_request.h"
+
+/*
+ * With deduplication enabled each cache line keeps index of data slot which
+ * holds its data in its collision entry. Data slots are reference
+ * counted, clean cache lines inserted on read miss are looked up by content
+ * fingerprint and share data slot with identical cache line if there is one,
+ * once data read back from that data slot has been found equal.
+ * Data slot used by more than one cache line is never written, cache line
+ * written while sharing data slot gets a new one (copy on write).
+ */
+
+enum ocf_dedup_slot_state {
+	/* Data slot is not in fingerprint index */
+	ocf_dedup_slot_unindexed = 0,
+	/* Data of the slot is being written, it can't be shared yet */
+	ocf_dedup_slot_pending,
+	/* Data slot can be shared by cache lines with the same fingerprint */
+	ocf_dedup_slot_indexed,
+};
+
+struct ocf_dedup_slot {
+	/* Fingerprint of data slot content */
+	uint64_t fingerprint[2];
+	/* Next data slot in fingerprint index bucket */
+	ocf_cache_line_t next;
+	/* Number of cache lines using this data slot */
+	uint32_t refcnt;
+	/* Fingerprint index state (see ocf_dedup_slot_state) */
+	uint8_t state;
+};
+
+struct ocf_dedup {
+	env_spinlock lock;
+	struct ocf_dedup_slot *slots;
+	/* Stack of free data slots */
+	ocf_cache_line_t *free;
+	uint32_t free_count;
+	/* Fingerprint index buckets, power of two of them */
+	ocf_cache_line_t *buckets;
+	uint32_t bucket_mask;
+	/* Number of data slots used by more than one cache line */
+	uint32_t shared;
+
+	/* Cache lines inserted into shared data slot instead of writing */
+	env_atomic64 hits;
+	/* Shared data slots copied on write */
+	env_atomic64 cow;
+	/* Requests not written to cache because of no free data slots */
+	env_atomic64 no_slot;
+	/* Cache lines with data different from data slot of the same
+	 * fingerprint */
+	env_atomic64 collisions;
+};
+
+/**
+ * @brief Allocate deduplication runtime data for attached cache
+ *
+ * @note Does nothing if cache data deduplication is disabled
+ *
+ * @param cache Cache instance
+ *
+ * @retval 0 Success
+ * @retval -OCF_ERR_NO_MEM Not enough memory for data slots table
+ */
+int ocf_dedup_init(ocf_cache_t cache);
+
+void ocf_dedup_deinit(ocf_cache_t cache);
+
+/**
+ * @brief Rebuild data slot reference counts and free data slots from data
+ *	slots of valid cache lines, fingerprint index starts empty
+ *
+ * @note Must be called with exclusive metadata access, once collision
+ *	table has been initialized or loaded
+ *
+ * @param cache Cache instance
+ *
+ * @retval 0 Success
+ * @retval -OCF_ERR_INVAL Cache line refers to data slot out of range
+ */
+int ocf_dedup_rebuild(ocf_cache_t cache);
+
+/**
+ * @brief Check whether there are enough free data slots to write given
+ *	number of newly mapped cache lines
+ */
+bool ocf_dedup_slots_available(ocf_cache_t cache, uint32_t count);
+
+/**
+ * @brief Release data slot of cache line being removed from collision
+ *
+ * @param cache Cache instance
+ * @param line Cache line
+ */
+void ocf_dedup_put_line(ocf_cache_t cache, ocf_cache_line_t line);
+
+/**
+ * @brief Assign exclusive data slots to cache lines of request to be
+ *	written to cache, copying shared ones on write. Backfilled cache
+ *	lines fully covered by the request are looked up by fingerprint
+ *	first and those found in cache share existing data slot and get
+ *	map dedup flag set instead, until ocf_dedup_verify_req() compares
+ *	their data.
+ *
+ * @note Must be called with request hash buckets write locked, after all-zero
+ *	cache lines have been detected. Valid status of sectors of cache line
+ *	copied on write which are not written by request is cleared, as their
+ *	data remains in shared data slot.
+ *
+ * @param req OCF request with data to be written to cache
+ * @param backfill Only cache lines marked for backfill are written
+ *
+ * @retval true Each cache line to be written has its own data slot
+ * @retval false There is no free data slot, data must not be written
+ */
+bool ocf_dedup_map_req(struct ocf_request *req, bool backfill);
+
+/**
+ * @brief Make data slots written by backfill request available for sharing
+ *
+ * @param req Completed backfill request
+ */
+void ocf_dedup_publish_req(struct ocf_request *req);
+
+/**
+ * @brief Read data slots shared by cache lines of backfill request found
+ *	by fingerprint, so that their content can be compared with request
+ *	data
+ *
+ * @param req OCF request after ocf_dedup_map_req() and data compression
+ * @param callback Completion called for each submitted IO, req_remaining
+ *	is incremented accordingly and has to be guarded by caller
+ *
+ * @retval true Reads have been submitted
+ * @retval false There are no shared data slots to be read
+ */
+bool ocf_dedup_read_req(struct ocf_request *req, ocf_req_end_t callback);
+
+/**
+ * @brief Compare data slots read by ocf_dedup_read_req() with request data.
+ *	Fingerprint match alone doesn't prove data is the same, so cache
+ *	lines which data differs get their own data slot and map dedup flag
+ *	cleared, to be written to cache as any other cache line.
+ *
+ * @note Must be called with request hash buckets write locked. Data of cache
+ *	lines which got own data slot is not compressed.
+ *
+ * @param req OCF request which data slots have been read
+ *
+ * @retval Number of cache lines which got own data slot
+ * @retval -OCF_ERR_NO_MEM There is no free data slot, data must not be
+ *	written
+ */
+int ocf_dedup_verify_req(struct ocf_request *req);
+
+#endif /* __UTILS_DEDUP_H__ */
@@ -0,0 +1,95 @@
+/*
+ * Copyright(c) 2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "ocf/ocf.h"
+#include "utils_hedge.h"
+#include "../ocf_cache_priv.h"
+#include "../ocf_request.h"
+
+void ocf_hedge_set_percentile(ocf_cache_t cache, uint32_t percentile)
+{
+	struct ocf_hedge *hedge = &cache->hedge;
+	unsigned i;
+
+	hedge->percentile = percentile;
+
+	for (i = 0; i < OCF_HEDGE_BUCKETS; i++)
+		env_atomic_set(&hedge->buckets[i], 0);
+
+	env_atomic_set(&hedge->samples, 0);
+	env_atomic64_set(&hedge->deadline, 0);
+}
+
+bool ocf_hedge_is_enabled(ocf_cache_t cache)
+{
+	return cache->hedge.percentile != OCF_CACHE_READ_HEDGE_INACTIVE;
+}
+
+uint64_t ocf_hedge_get_deadline(ocf_cache_t cache)
+{
+	if (!ocf_hedge_is_enabled(cache))
+		return 0;
+
+	return env_atomic64_read(&cache->hedge.deadline);
+}
+
+void ocf_hedge_read_start(struct ocf_request *req)
+{
+	req->hedge.start = ocf_hedge_is_enabled(req->cache) ?
+			env_get_tick_count() : 0;
+}
+
+/* Races with concurrent samples only make histogram slightly inaccurate */
+static void ocf_hedge_update_deadline(struct ocf_hedge *hedge)
+{
+	uint32_t counts[OCF_HEDGE_BUCKETS];
+	uint64_t total = 0, target, sum = 0;
+	unsigned i;
+
+	for (i = 0; i < OCF_HEDGE_BUCKETS; i++) {
+		counts[i] = env_atomic_read(&hedge->buckets[i]);
+		total += counts[i];
+	}
+
+	if (total < OCF_HEDGE_MIN_SAMPLES)
+		return;
+
+	target = OCF_DIV_ROUND_UP(total * hedge->percentile, 1000);
+
+	for (i = 0; i < OCF_HEDGE_BUCKETS - 1; i++) {
+		sum += counts[i];
+		if (sum >= target)
+			break;
+	}
+
+	env_atomic64_set(&hedge->deadline, 2ULL << i);
+
+	if (total < OCF_HEDGE_WINDOW)
+		return;
+
+	for (i = 0; i < OCF_HEDGE_BUCKETS; i++)
+		env_atomic_sub(counts[i] / 2, &hedge->buckets[i]);
+}
+
+void ocf_hedge_read_end(struct ocf_request *req)
+{
+	struct ocf_hedge *hedge = &req->cache->hedge;
+	uint64_t latency;
+	unsigned bucket = 0;
+
+	if (!req->hedge.start || !ocf_hedge_is_enabled(req->cache))
+		return;
+
+	latency = env_ticks_to_nsecs(env_get_tick_count() - req->hedge.start);
+	while ((latency >>= 1) && bucket < OCF_HEDGE_BUCKETS - 1)
+		bucket++;
+
+	env_atomic_inc(&hedge->buckets[bucket]);
+
+	if (!(env_atomic_inc_return(&hedge->samples) %
+			OCF_HEDGE_UPDATE_INTERVAL)) {
+		ocf_hedge_update_deadline(hedge);
+	}
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright(c) 2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __UTILS_HEDGE_H__
+#define __UTILS_HEDGE_H__
+
+#include "ocf/ocf.h"
+#include "ocf_env.h"
+
+/*
+ * Read hedging keeps histogram of cache read hit latency with power of two
+ * buckets. Deadline of cache read is the upper bound of bucket containing
+ * configured latency percentile. Clean read hit, which is not served by
+ * cache device before its deadline, is read also from core and completed
+ * by whichever read finishes first.
+ */
+#define OCF_HEDGE_BUCKETS 40
+
+/* Deadline is not known until histogram holds that many samples */
+#define OCF_HEDGE_MIN_SAMPLES 64
+
+/* Deadline is recalculated each OCF_HEDGE_UPDATE_INTERVAL samples */
+#define OCF_HEDGE_UPDATE_INTERVAL 64
+
+/* Histogram is halved once it holds that many samples, so that deadline
+ * follows changes of cache device latency */
+#define OCF_HEDGE_WINDOW 4096
+
+struct ocf_request;
+
+struct ocf_hedge {
+	/* Latency percentile in per mille, 0 if hedging is disabled */
+	uint32_t percentile;
+	/* Number of cache reads with latency of 2^i to 2^(i+1) ns */
+	env_atomic buckets[OCF_HEDGE_BUCKETS];
+	/* Samples since last deadline recalculation */
+	env_atomic samples;
+	/* Cache read deadline (in ns), 0 if not known yet */
+	env_atomic64 deadline;
+	/* Requests for which hedged core read has been issued */
+	env_atomic64 hedged;
+	/* Requests completed by hedged core read */
+	env_atomic64 core_won;
+};
+
+/**
+ * @brief Set hedging percentile and reset latency histogram
+ *
+ * @param cache Cache instance
+ * @param percentile Latency percentile in per mille, or
+ *	OCF_CACHE_READ_HEDGE_INACTIVE
+ */
+void ocf_hedge_set_percentile(ocf_cache_t cache, uint32_t percentile);
+
+/**
+ * @brief Get cache read deadline
+ *
+ * @retval Deadline in nanoseconds, 0 if hedging is disabled or latency
+ *	of cache device is not known yet
+ */
+uint64_t ocf_hedge_get_deadline(ocf_cache_t cache);
+
+/**
+ * @brief Start measuring latency of cache read hit
+ *
+ * @param req Read request about to be served from cache
+ */
+void ocf_hedge_read_start(struct ocf_request *req);
+
+/**
+ * @brief Account latency of successfully completed cache read hit
+ *
+ * @param req Request passed to ocf_hedge_read_start() before
+ */
+void ocf_hedge_read_end(struct ocf_request *req);
+
+/**
+ * @brief Check whether clean read hits should be considered for hedging
+ */
+bool ocf_hedge_is_enabled(ocf_cache_t cache);
+
+#endif /* __UTILS_HEDGE_H__ */
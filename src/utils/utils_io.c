@@ -10,6 +10,8 @@
 #include "../ocf_request.h"
 #include "utils_io.h"
 #include "utils_cache_line.h"
+#include "utils_compress.h"
+#include "utils_steering.h"
 
 struct ocf_submit_volume_context {
 	env_atomic req_remaining;
@@ -35,6 +37,7 @@ void ocf_submit_volume_flush(ocf_volume_t volume,
 	if (!io)
 		OCF_CMPL_RET(priv, -OCF_ERR_NO_MEM);
 
+	ocf_io_set_origin(io, ocf_io_origin_mngt);
 	ocf_io_set_cmpl(io, cmpl, priv, _ocf_volume_flush_end);
 
 	ocf_volume_submit_flush(io);
@@ -83,6 +86,7 @@ void ocf_submit_volume_discard(ocf_volume_t volume, uint64_t addr,
 			break;
 		}
 
+		ocf_io_set_origin(io, ocf_io_origin_mngt);
 		env_atomic_inc(&context->req_remaining);
 
 		ocf_io_set_cmpl(io, context, NULL, ocf_submit_volume_end);
@@ -125,6 +129,7 @@ void ocf_submit_write_zeros(ocf_volume_t volume, uint64_t addr,
 			break;
 		}
 
+		ocf_io_set_origin(io, ocf_io_origin_mngt);
 		env_atomic_inc(&context->req_remaining);
 
 		ocf_io_set_cmpl(io, context, NULL, ocf_submit_volume_end);
@@ -141,16 +146,16 @@ void ocf_submit_write_zeros(ocf_volume_t volume, uint64_t addr,
 	env_vfree(context);
 }
 
-struct ocf_submit_cache_page_context {
+struct ocf_submit_metadata_page_context {
 	ocf_cache_t cache;
 	void *buffer;
 	ocf_submit_end_t cmpl;
 	void *priv;
 };
 
-static void ocf_submit_cache_page_end(struct ocf_io *io, int error)
+static void ocf_submit_metadata_page_end(struct ocf_io *io, int error)
 {
-	struct ocf_submit_cache_page_context *context = io->priv1;
+	struct ocf_submit_metadata_page_context *context = io->priv1;
 	ctx_data_t *data = ocf_io_get_data(io);
 
 	if (io->dir == OCF_READ) {
@@ -164,10 +169,10 @@ static void ocf_submit_cache_page_end(struct ocf_io *io, int error)
 	ocf_io_put(io);
 }
 
-void ocf_submit_cache_page(ocf_cache_t cache, uint64_t addr, int dir,
+void ocf_submit_metadata_page(ocf_cache_t cache, uint64_t addr, int dir,
 		void *buffer, ocf_submit_end_t cmpl, void *priv)
 {
-	struct ocf_submit_cache_page_context *context;
+	struct ocf_submit_metadata_page_context *context;
 	ctx_data_t *data;
 	struct ocf_io *io;
 	int result = 0;
@@ -181,7 +186,7 @@ void ocf_submit_cache_page(ocf_cache_t cache, uint64_t addr, int dir,
 	context->cmpl = cmpl;
 	context->priv = priv;
 
-	io = ocf_new_cache_io(cache, NULL, addr, PAGE_SIZE, dir, 0, 0);
+	io = ocf_new_metadata_io(cache, NULL, addr, PAGE_SIZE, dir, 0, 0);
 	if (!io) {
 		result = -OCF_ERR_NO_MEM;
 		goto err_io;
@@ -200,7 +205,7 @@ void ocf_submit_cache_page(ocf_cache_t cache, uint64_t addr, int dir,
 	if (result)
 		goto err_set_data;
 
-	ocf_io_set_cmpl(io, context, NULL, ocf_submit_cache_page_end);
+	ocf_io_set_cmpl(io, context, NULL, ocf_submit_metadata_page_end);
 
 	ocf_volume_submit_io(io);
 	return;
@@ -219,14 +224,169 @@ static void ocf_submit_volume_req_cmpl(struct ocf_io *io, int error)
 	struct ocf_request *req = io->priv1;
 	ocf_req_end_t callback = io->priv2;
 
+	ocf_steering_io_end(req->cache, io);
+
 	callback(req, error);
 
 	ocf_io_put(io);
 }
 
-void ocf_submit_cache_reqs(struct ocf_cache *cache,
+struct ocf_submit_compressed_context {
+	struct ocf_request *req;
+	ocf_req_end_t callback;
+	env_atomic req_remaining;
+	int error;
+	uint64_t offset;
+	uint64_t size;
+	unsigned int reqs;
+};
+
+static void ocf_submit_compressed_read_end(
+		struct ocf_submit_compressed_context *context)
+{
+	struct ocf_request *req = context->req;
+	uint64_t ratio = req->cache->conf_meta->compression;
+	unsigned int i;
+	int error;
+
+	if (env_atomic_dec_return(&context->req_remaining))
+		return;
+
+	error = context->error;
+	if (!error) {
+		error = ocf_decompress_data(req->cache, req->data,
+				req->offset + context->offset, req->cdata,
+				context->offset / ratio, context->size);
+	}
+
+	/* Caller expects completion of each cache IO it requested */
+	for (i = 0; i < context->reqs; i++)
+		context->callback(req, error);
+
+	env_free(context);
+}
+
+static void ocf_submit_compressed_read_cmpl(struct ocf_io *io, int error)
+{
+	struct ocf_submit_compressed_context *context = io->priv1;
+
+	ocf_steering_io_end(context->req->cache, io);
+
+	if (error)
+		context->error = error;
+
+	ocf_io_put(io);
+
+	ocf_submit_compressed_read_end(context);
+}
+
+/*
+ * Compressed data of the request is kept in req->cdata, where each cache
+ * line takes slot size instead of its full size. Written data has been
+ * compressed by the engine already, read data is decompressed into request
+ * buffer once all IOs have completed.
+ */
+static void ocf_submit_cache_reqs_compressed(struct ocf_cache *cache,
 		struct ocf_request *req, int dir, uint64_t offset,
 		uint64_t size, unsigned int reqs, ocf_req_end_t callback)
+{
+	struct ocf_submit_compressed_context *context = NULL;
+	uint64_t flags = req->ioi.io.flags;
+	uint32_t io_class = req->ioi.io.io_class;
+	uint64_t ratio = cache->conf_meta->compression;
+	uint64_t line_offset, addr, bytes, total_bytes = 0;
+	struct ocf_io *io;
+	int err = 0;
+	uint32_t i;
+	uint32_t first_cl = ocf_bytes_2_lines(cache, req->byte_position +
+			offset) - ocf_bytes_2_lines(cache, req->byte_position);
+
+	if (dir == OCF_READ) {
+		if (!req->cdata) {
+			req->cdata = ctx_data_alloc(cache->owner,
+					BYTES_TO_PAGES(req->byte_length / ratio));
+		}
+
+		context = env_malloc(sizeof(*context), ENV_MEM_NOIO);
+		if (!context || !req->cdata) {
+			env_free(context);
+			for (i = 0; i < reqs; i++)
+				callback(req, -OCF_ERR_NO_MEM);
+			return;
+		}
+
+		context->req = req;
+		context->callback = callback;
+		context->error = 0;
+		context->offset = offset;
+		context->size = size;
+		context->reqs = reqs;
+		env_atomic_set(&context->req_remaining, 1);
+	}
+
+	ENV_BUG_ON(!req->cdata);
+
+	for (i = 0; i < reqs; i++) {
+		line_offset = (req->byte_position + offset + total_bytes) %
+				ocf_line_size(cache);
+
+		/* Single IO may span physically contiguous cache lines */
+		bytes = reqs == 1 ? size : OCF_MIN(size - total_bytes,
+				ocf_line_size(cache) - line_offset);
+
+		addr = ocf_cache_line_addr(cache,
+				req->map[first_cl + i].coll_idx, line_offset);
+
+		io = ocf_new_cache_io(cache, req->io_queue,
+				addr, bytes / ratio, dir, io_class, flags);
+		if (!io) {
+			err = -OCF_ERR_NO_MEM;
+			break;
+		}
+
+		ocf_io_set_origin(io, req->io_origin);
+
+		err = ocf_io_set_data(io, req->cdata,
+				(offset + total_bytes) / ratio);
+		if (err) {
+			ocf_io_put(io);
+			break;
+		}
+
+		if (context) {
+			env_atomic_inc(&context->req_remaining);
+			ocf_io_set_cmpl(io, context, NULL,
+					ocf_submit_compressed_read_cmpl);
+		} else {
+			ocf_io_set_cmpl(io, req, callback,
+					ocf_submit_volume_req_cmpl);
+		}
+
+		ocf_core_stats_cache_block_update(req->core, io_class,
+				dir, bytes / ratio);
+
+		ocf_steering_io_submit(cache, io);
+		ocf_bg_share_io_submit(cache, io);
+		ocf_volume_submit_io(io);
+		total_bytes += bytes;
+	}
+
+	if (context) {
+		if (err)
+			context->error = err;
+		ocf_submit_compressed_read_end(context);
+		return;
+	}
+
+	/* Finish all IOs which left with ERROR */
+	for (; i < reqs; i++)
+		callback(req, err);
+}
+
+static void _ocf_submit_cache_reqs(struct ocf_cache *cache,
+		struct ocf_request *req, ctx_data_t *data, uint32_t data_offset,
+		int dir, uint64_t offset, uint64_t size, unsigned int reqs,
+		ocf_req_end_t callback)
 {
 	uint64_t flags = req->ioi.io.flags;
 	uint32_t io_class = req->ioi.io.io_class;
@@ -237,15 +397,10 @@ void ocf_submit_cache_reqs(struct ocf_cache *cache,
 	uint32_t first_cl = ocf_bytes_2_lines(cache, req->byte_position +
 			offset) - ocf_bytes_2_lines(cache, req->byte_position);
 
-	ENV_BUG_ON(req->byte_length < offset + size);
-	ENV_BUG_ON(first_cl + reqs > req->core_line_count);
-
 	if (reqs == 1) {
-		addr = ocf_metadata_map_lg2phy(cache,
-					req->map[first_cl].coll_idx);
-		addr *= ocf_line_size(cache);
-		addr += cache->device->metadata_offset;
-		addr += ((req->byte_position + offset) % ocf_line_size(cache));
+		addr = ocf_cache_line_addr(cache, req->map[first_cl].coll_idx,
+				(req->byte_position + offset) %
+				ocf_line_size(cache));
 		bytes = size;
 
 		io = ocf_new_cache_io(cache, req->io_queue,
@@ -255,9 +410,11 @@ void ocf_submit_cache_reqs(struct ocf_cache *cache,
 			return;
 		}
 
+		ocf_io_set_origin(io, req->io_origin);
+
 		ocf_io_set_cmpl(io, req, callback, ocf_submit_volume_req_cmpl);
 
-		err = ocf_io_set_data(io, req->data, offset);
+		err = ocf_io_set_data(io, data, data_offset + offset);
 		if (err) {
 			ocf_io_put(io);
 			callback(req, err);
@@ -267,16 +424,16 @@ void ocf_submit_cache_reqs(struct ocf_cache *cache,
 		ocf_core_stats_cache_block_update(req->core, io_class,
 				dir, bytes);
 
+		ocf_steering_io_submit(cache, io);
+		ocf_bg_share_io_submit(cache, io);
 		ocf_volume_submit_io(io);
 		return;
 	}
 
 	/* Issue requests to cache. */
 	for (i = 0; i < reqs; i++) {
-		addr  = ocf_metadata_map_lg2phy(cache,
-				req->map[first_cl + i].coll_idx);
-		addr *= ocf_line_size(cache);
-		addr += cache->device->metadata_offset;
+		addr = ocf_cache_line_addr(cache,
+				req->map[first_cl + i].coll_idx, 0);
 		bytes = ocf_line_size(cache);
 
 		if (i == 0) {
@@ -305,9 +462,12 @@ void ocf_submit_cache_reqs(struct ocf_cache *cache,
 			return;
 		}
 
+		ocf_io_set_origin(io, req->io_origin);
+
 		ocf_io_set_cmpl(io, req, callback, ocf_submit_volume_req_cmpl);
 
-		err = ocf_io_set_data(io, req->data, offset + total_bytes);
+		err = ocf_io_set_data(io, data,
+				data_offset + offset + total_bytes);
 		if (err) {
 			ocf_io_put(io);
 			/* Finish all IOs which left with ERROR */
@@ -317,6 +477,8 @@ void ocf_submit_cache_reqs(struct ocf_cache *cache,
 		}
 		ocf_core_stats_cache_block_update(req->core, io_class,
 				dir, bytes);
+		ocf_steering_io_submit(cache, io);
+		ocf_bg_share_io_submit(cache, io);
 		ocf_volume_submit_io(io);
 		total_bytes += bytes;
 	}
@@ -324,8 +486,80 @@ void ocf_submit_cache_reqs(struct ocf_cache *cache,
 	ENV_BUG_ON(total_bytes != size);
 }
 
-void ocf_submit_volume_req(ocf_volume_t volume, struct ocf_request *req,
+void ocf_submit_cache_reqs(struct ocf_cache *cache,
+		struct ocf_request *req, int dir, uint64_t offset,
+		uint64_t size, unsigned int reqs, ocf_req_end_t callback)
+{
+	uint32_t first_cl = ocf_bytes_2_lines(cache, req->byte_position +
+			offset) - ocf_bytes_2_lines(cache, req->byte_position);
+
+	ENV_BUG_ON(req->byte_length < offset + size);
+	ENV_BUG_ON(first_cl + reqs > req->core_line_count);
+
+	if (ocf_cache_compression_enabled(cache) && size) {
+		ocf_submit_cache_reqs_compressed(cache, req, dir, offset,
+				size, reqs, callback);
+		return;
+	}
+
+	_ocf_submit_cache_reqs(cache, req, req->data, req->offset, dir,
+			offset, size, reqs, callback);
+}
+
+void ocf_submit_cache_reqs_buf(struct ocf_cache *cache,
+		struct ocf_request *req, ctx_data_t *data, unsigned int reqs,
 		ocf_req_end_t callback)
+{
+	ENV_BUG_ON(reqs > req->core_line_count);
+	ENV_BUG_ON(ocf_cache_compression_enabled(cache));
+
+	_ocf_submit_cache_reqs(cache, req, data, 0, OCF_READ, 0,
+			req->byte_length, reqs, callback);
+}
+
+void ocf_submit_cache_line_buf(struct ocf_cache *cache,
+		struct ocf_request *req, uint32_t idx, ctx_data_t *data,
+		uint64_t data_offset, ocf_req_end_t callback)
+{
+	uint64_t flags = req->ioi.io.flags;
+	uint32_t io_class = req->ioi.io.io_class;
+	uint64_t addr, bytes;
+	struct ocf_io *io;
+	int err;
+
+	ENV_BUG_ON(idx >= req->core_line_count);
+
+	addr = ocf_cache_line_addr(cache, req->map[idx].coll_idx, 0);
+	bytes = ocf_line_size(cache) / cache->conf_meta->compression;
+
+	io = ocf_new_cache_io(cache, req->io_queue, addr, bytes, OCF_READ,
+			io_class, flags);
+	if (!io) {
+		callback(req, -OCF_ERR_NO_MEM);
+		return;
+	}
+
+	ocf_io_set_origin(io, req->io_origin);
+	ocf_io_set_cmpl(io, req, callback, ocf_submit_volume_req_cmpl);
+
+	err = ocf_io_set_data(io, data, data_offset);
+	if (err) {
+		ocf_io_put(io);
+		callback(req, err);
+		return;
+	}
+
+	ocf_core_stats_cache_block_update(req->core, io_class, OCF_READ,
+			bytes);
+
+	ocf_steering_io_submit(cache, io);
+	ocf_bg_share_io_submit(cache, io);
+	ocf_volume_submit_io(io);
+}
+
+static void _ocf_submit_volume_req(ocf_volume_t volume,
+		struct ocf_request *req, ctx_data_t *data, uint32_t data_offset,
+		uint64_t offset, uint64_t size, ocf_req_end_t callback)
 {
 	uint64_t flags = req->ioi.io.flags;
 	uint32_t io_class = req->ioi.io.io_class;
@@ -333,22 +567,46 @@ void ocf_submit_volume_req(ocf_volume_t volume, struct ocf_request *req,
 	struct ocf_io *io;
 	int err;
 
-	ocf_core_stats_core_block_update(req->core, io_class, dir,
-			req->byte_length);
+	ENV_BUG_ON(req->byte_length < offset + size);
 
-	io = ocf_volume_new_io(volume, req->io_queue, req->byte_position,
-			req->byte_length, dir, io_class, flags);
+	ocf_core_stats_core_block_update(req->core, io_class, dir, size);
+
+	io = ocf_volume_new_io(volume, req->io_queue,
+			req->byte_position + offset, size, dir, io_class,
+			flags);
 	if (!io) {
 		callback(req, -OCF_ERR_NO_MEM);
 		return;
 	}
 
+	ocf_io_set_origin(io, req->io_origin);
 	ocf_io_set_cmpl(io, req, callback, ocf_submit_volume_req_cmpl);
-	err = ocf_io_set_data(io, req->data, 0);
+	err = ocf_io_set_data(io, data, data_offset + offset);
 	if (err) {
 		ocf_io_put(io);
 		callback(req, err);
 		return;
 	}
+	ocf_steering_io_submit(req->cache, io);
 	ocf_volume_submit_io(io);
 }
+
+void ocf_submit_volume_req_part(ocf_volume_t volume, struct ocf_request *req,
+		uint64_t offset, uint64_t size, ocf_req_end_t callback)
+{
+	_ocf_submit_volume_req(volume, req, req->data, req->offset, offset,
+			size, callback);
+}
+
+void ocf_submit_volume_req_buf(ocf_volume_t volume, struct ocf_request *req,
+		ctx_data_t *data, ocf_req_end_t callback)
+{
+	_ocf_submit_volume_req(volume, req, data, 0, 0, req->byte_length,
+			callback);
+}
+
+void ocf_submit_volume_req(ocf_volume_t volume, struct ocf_request *req,
+		ocf_req_end_t callback)
+{
+	ocf_submit_volume_req_part(volume, req, 0, req->byte_length, callback);
+}
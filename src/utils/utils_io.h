@@ -54,16 +54,35 @@ void ocf_submit_volume_discard(ocf_volume_t volume, uint64_t addr,
 void ocf_submit_write_zeros(ocf_volume_t volume, uint64_t addr,
 		uint64_t length, ocf_submit_end_t cmpl, void *priv);
 
-void ocf_submit_cache_page(ocf_cache_t cache, uint64_t addr, int dir,
+void ocf_submit_metadata_page(ocf_cache_t cache, uint64_t addr, int dir,
 		void *buffer, ocf_submit_end_t cmpl, void *priv);
 
+void ocf_submit_volume_req_part(ocf_volume_t volume, struct ocf_request *req,
+		uint64_t offset, uint64_t size, ocf_req_end_t callback);
+
 void ocf_submit_volume_req(ocf_volume_t volume, struct ocf_request *req,
 		ocf_req_end_t callback);
 
+/* Read whole request into given buffer instead of request data */
+void ocf_submit_volume_req_buf(ocf_volume_t volume, struct ocf_request *req,
+		ctx_data_t *data, ocf_req_end_t callback);
+
 void ocf_submit_cache_reqs(struct ocf_cache *cache,
 		struct ocf_request *req, int dir, uint64_t offset,
 		uint64_t size, unsigned int reqs, ocf_req_end_t callback);
 
+/* Read whole request from cache into given buffer instead of request data,
+ * not supported with compression */
+void ocf_submit_cache_reqs_buf(struct ocf_cache *cache,
+		struct ocf_request *req, ctx_data_t *data, unsigned int reqs,
+		ocf_req_end_t callback);
+
+/* Read data slot of single cache line of the request into given buffer, as
+ * it is stored on cache device (compressed if compression is enabled) */
+void ocf_submit_cache_line_buf(struct ocf_cache *cache,
+		struct ocf_request *req, uint32_t idx, ctx_data_t *data,
+		uint64_t data_offset, ocf_req_end_t callback);
+
 static inline struct ocf_io *ocf_new_cache_io(ocf_cache_t cache,
 		ocf_queue_t queue, uint64_t addr, uint32_t bytes,
 		uint32_t dir, uint32_t io_class, uint64_t flags)
@@ -73,6 +92,20 @@ static inline struct ocf_io *ocf_new_cache_io(ocf_cache_t cache,
 			addr, bytes, dir, io_class, flags);
 }
 
+static inline struct ocf_io *ocf_new_metadata_io(ocf_cache_t cache,
+		ocf_queue_t queue, uint64_t addr, uint32_t bytes,
+		uint32_t dir, uint32_t io_class, uint64_t flags)
+{
+	struct ocf_io *io;
+
+	io = ocf_volume_new_io(ocf_cache_get_metadata_volume(cache), queue,
+			addr, bytes, dir, io_class, flags);
+	if (io)
+		ocf_io_set_origin(io, ocf_io_origin_metadata);
+
+	return io;
+}
+
 static inline struct ocf_io *ocf_new_core_io(ocf_core_t core,
 		ocf_queue_t queue, uint64_t addr, uint32_t bytes,
 		uint32_t dir, uint32_t io_class, uint64_t flags)
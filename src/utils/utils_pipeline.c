@@ -123,6 +123,17 @@ void ocf_pipeline_next(ocf_pipeline_t pipeline)
 	ocf_engine_push_req_front(pipeline->req, true);
 }
 
+/* Run current step (or current argument of foreach step) once again */
+void ocf_pipeline_rerun(ocf_pipeline_t pipeline)
+{
+	if (pipeline->next_arg)
+		pipeline->next_arg--;
+	else
+		pipeline->next_step--;
+
+	ocf_engine_push_req_front(pipeline->req, true);
+}
+
 void ocf_pipeline_finish(ocf_pipeline_t pipeline, int error)
 {
 	pipeline->finish = true;
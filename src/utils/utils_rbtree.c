@@ -469,3 +469,26 @@ struct ocf_rb_node *ocf_rb_tree_find(struct ocf_rb_tree *tree,
 
 	return tree->find(&iter->list);
 }
+
+struct ocf_rb_node *ocf_rb_tree_find_floor(struct ocf_rb_tree *tree,
+		struct ocf_rb_node *node)
+{
+	struct ocf_rb_node *iter = tree->root;
+	struct ocf_rb_node *floor = NULL;
+	int cmp = 0;
+
+	while (iter) {
+		cmp = tree->cmp(node, iter);
+		if (cmp >= 0)
+			floor = iter;
+		if (!cmp)
+			break;
+
+		iter = (cmp < 0) ? iter->left : iter->right;
+	}
+
+	if (!floor || list_empty(&floor->list))
+		return floor;
+
+	return tree->find(&floor->list);
+}
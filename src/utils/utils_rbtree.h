@@ -41,4 +41,8 @@ bool ocf_rb_tree_can_update(struct ocf_rb_tree *tree,
 struct ocf_rb_node *ocf_rb_tree_find(struct ocf_rb_tree *tree,
 		struct ocf_rb_node *node);
 
+/* Find greatest node which is not greater than given one */
+struct ocf_rb_node *ocf_rb_tree_find_floor(struct ocf_rb_tree *tree,
+		struct ocf_rb_node *node);
+
 #endif /* __UTILS_RBTREE_H__ */
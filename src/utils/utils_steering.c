@@ -0,0 +1,119 @@
+/*
+ * Copyright(c) 2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "ocf/ocf.h"
+#include "utils_steering.h"
+#include "../ocf_cache_priv.h"
+#include "../ocf_io_priv.h"
+#include "../ocf_request.h"
+
+void ocf_steering_set_threshold(ocf_cache_t cache, uint32_t threshold)
+{
+	struct ocf_steering *steering = &cache->steering;
+
+	steering->threshold = threshold;
+
+	env_atomic64_set(&steering->cache_latency, 0);
+	env_atomic64_set(&steering->core_latency, 0);
+	env_atomic_set(&steering->probe, 0);
+	env_atomic_set(&steering->cache_samples, 0);
+}
+
+void ocf_steering_io_submit(ocf_cache_t cache, struct ocf_io *io)
+{
+	if (cache->steering.threshold == OCF_CACHE_READ_STEERING_INACTIVE)
+		return;
+
+	if (io->dir != OCF_READ)
+		return;
+
+	ocf_io_set_timestamp(io, env_get_tick_count());
+}
+
+static void ocf_steering_update(env_atomic64 *average, uint64_t sample)
+{
+	int64_t old = env_atomic64_read(average);
+
+	/* Races between concurrent updates only lose some samples */
+	if (!old) {
+		env_atomic64_set(average, sample);
+		return;
+	}
+
+	env_atomic64_set(average, old + (((int64_t)sample - old) >>
+			OCF_STEERING_EWMA_SHIFT));
+}
+
+void ocf_steering_io_end(ocf_cache_t cache, struct ocf_io *io)
+{
+	struct ocf_steering *steering = &cache->steering;
+	uint64_t timestamp = ocf_io_get_timestamp(io);
+	uint64_t latency;
+
+	if (!timestamp)
+		return;
+
+	latency = env_ticks_to_nsecs(env_get_tick_count() - timestamp);
+	/* Zero average means no samples yet */
+	if (!latency)
+		latency = 1;
+
+	if (ocf_io_get_volume(io) == ocf_cache_get_volume(cache)) {
+		ocf_steering_update(&steering->cache_latency, latency);
+		env_atomic_inc(&steering->cache_samples);
+	} else {
+		ocf_steering_update(&steering->core_latency, latency);
+		env_atomic_set(&steering->cache_samples, 0);
+	}
+}
+
+bool ocf_steering_is_on(ocf_cache_t cache)
+{
+	struct ocf_steering *steering = &cache->steering;
+	uint64_t cache_latency, core_latency;
+
+	if (steering->threshold == OCF_CACHE_READ_STEERING_INACTIVE)
+		return false;
+
+	cache_latency = env_atomic64_read(&steering->cache_latency);
+	core_latency = env_atomic64_read(&steering->core_latency);
+
+	/* Don't steer until latency of both devices is known */
+	if (!cache_latency || !core_latency)
+		return false;
+
+	return cache_latency * 100 > core_latency * steering->threshold;
+}
+
+bool ocf_steering_core_probe_due(ocf_cache_t cache)
+{
+	struct ocf_steering *steering = &cache->steering;
+
+	if (steering->threshold == OCF_CACHE_READ_STEERING_INACTIVE)
+		return false;
+
+	return env_atomic_read(&steering->cache_samples) >=
+			OCF_STEERING_CORE_PROBE_INTERVAL;
+}
+
+bool ocf_steering_steer_req(struct ocf_request *req)
+{
+	struct ocf_steering *steering = &req->cache->steering;
+
+	if (!ocf_steering_is_on(req->cache)) {
+		/* Only one probe until core device read is measured */
+		env_atomic_set(&steering->cache_samples, 0);
+		return true;
+	}
+
+	if (!(env_atomic_inc_return(&steering->probe) %
+			OCF_STEERING_PROBE_INTERVAL)) {
+		return false;
+	}
+
+	env_atomic64_inc(&steering->steered);
+
+	return true;
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright(c) 2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __UTILS_STEERING_H__
+#define __UTILS_STEERING_H__
+
+#include "ocf/ocf.h"
+#include "ocf_env.h"
+
+/*
+ * Read steering keeps moving average of read latency of cache and core
+ * devices. Once cache latency exceeds threshold percentage of core latency,
+ * reads of clean data are served from core and cache lines are not promoted
+ * until cache device catches up. Every OCF_STEERING_PROBE_INTERVAL-th request
+ * eligible for steering is still served from cache to keep its latency
+ * average up to date.
+ *
+ * Core devices are read only on misses, so with all reads hitting cache there
+ * may be no core latency sample at all, or just a stale one. Once
+ * OCF_STEERING_CORE_PROBE_INTERVAL cache device reads have been measured
+ * since the last core device read, one clean read hit is served from core
+ * as a probe.
+ */
+#define OCF_STEERING_PROBE_INTERVAL 16
+
+#define OCF_STEERING_CORE_PROBE_INTERVAL 64
+
+/* Weight of new sample in moving average is 1 / 2^OCF_STEERING_EWMA_SHIFT */
+#define OCF_STEERING_EWMA_SHIFT 3
+
+struct ocf_request;
+
+struct ocf_steering {
+	/* Cache to core latency percentage, 0 if steering is disabled */
+	uint32_t threshold;
+	/* Moving average of cache device read latency (in ns) */
+	env_atomic64 cache_latency;
+	/* Moving average of core devices read latency (in ns) */
+	env_atomic64 core_latency;
+	/* Requests eligible for steering since last probe */
+	env_atomic probe;
+	/* Cache device reads measured since last core device read */
+	env_atomic cache_samples;
+	/* Requests served from core because of cache device latency */
+	env_atomic64 steered;
+};
+
+/**
+ * @brief Set steering threshold and reset latency averages
+ *
+ * @param cache Cache instance
+ * @param threshold Cache to core latency percentage, or
+ *	OCF_CACHE_READ_STEERING_INACTIVE
+ */
+void ocf_steering_set_threshold(ocf_cache_t cache, uint32_t threshold);
+
+/**
+ * @brief Start measuring latency of data IO about to be submitted
+ *
+ * @note Only reads are measured and only if steering is enabled
+ *
+ * @param cache Cache instance
+ * @param io IO to cache or core device
+ */
+void ocf_steering_io_submit(ocf_cache_t cache, struct ocf_io *io);
+
+/**
+ * @brief Account latency of completed data IO
+ *
+ * @param cache Cache instance
+ * @param io IO passed to ocf_steering_io_submit() before
+ */
+void ocf_steering_io_end(ocf_cache_t cache, struct ocf_io *io);
+
+/**
+ * @brief Check whether cache device latency exceeds steering threshold
+ */
+bool ocf_steering_is_on(ocf_cache_t cache);
+
+/**
+ * @brief Check whether clean read hit should be served from core to sample
+ *	core device latency
+ */
+bool ocf_steering_core_probe_due(ocf_cache_t cache);
+
+/**
+ * @brief Decide whether clean read request should be served from core
+ *
+ * @note Each call accounts request as eligible for steering, it's let to
+ *	cache once per OCF_STEERING_PROBE_INTERVAL calls. If steering is not on,
+ *	request is served from core as core latency probe.
+ *
+ * @param req Read request without dirty cache lines
+ *
+ * @retval true Request should be served from core
+ */
+bool ocf_steering_steer_req(struct ocf_request *req);
+
+#endif /* __UTILS_STEERING_H__ */
@@ -0,0 +1,288 @@
+/*
+ * Copyright(c) 2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "../ocf_priv.h"
+#include "../ocf_cache_priv.h"
+#include "../metadata/metadata.h"
+#include "../concurrency/ocf_concurrency.h"
+#include "utils_trimmer.h"
+#include "utils_cache_line.h"
+
+struct ocf_trimmer_context {
+	ocf_cache_t cache;
+	ocf_trimmer_end_t cmpl;
+	env_atomic remaining;
+};
+
+int ocf_trimmer_init(ocf_cache_t cache)
+{
+	return env_spinlock_init(&cache->trimmer.lock);
+}
+
+void ocf_trimmer_deinit(ocf_cache_t cache)
+{
+	env_spinlock_destroy(&cache->trimmer.lock);
+}
+
+static int ocf_trimmer_range_cmp(const void *a, const void *b)
+{
+	const struct ocf_trimmer_range *r1 = a, *r2 = b;
+
+	if (r1->phys < r2->phys)
+		return -1;
+
+	return r1->phys > r2->phys;
+}
+
+/* Sort pending ranges by physical position and merge neighbours */
+static void ocf_trimmer_compact(struct ocf_trimmer *trimmer,
+		uint32_t max_count)
+{
+	struct ocf_trimmer_range *ranges = trimmer->ranges;
+	ocf_cache_line_t end;
+	uint32_t i, j;
+
+	if (trimmer->count < 2)
+		return;
+
+	env_sort(ranges, trimmer->count, sizeof(*ranges),
+			ocf_trimmer_range_cmp, NULL);
+
+	for (i = 0, j = 1; j < trimmer->count; j++) {
+		end = OCF_MAX(ranges[i].phys + ranges[i].count,
+				ranges[j].phys + ranges[j].count);
+
+		/* Line might have been freed more than once */
+		if (ranges[j].phys <= ranges[i].phys + ranges[i].count &&
+				end - ranges[i].phys <= max_count) {
+			ranges[i].count = end - ranges[i].phys;
+			continue;
+		}
+
+		ranges[++i] = ranges[j];
+	}
+
+	trimmer->count = i + 1;
+}
+
+void ocf_trimmer_add(ocf_cache_t cache, ocf_cache_line_t cline)
+{
+	struct ocf_trimmer *trimmer = &cache->trimmer;
+	struct ocf_trimmer_range *range;
+	uint32_t max_count = OCF_TRIMMER_MAX_DISCARD / ocf_line_slot_size(cache);
+	ocf_cache_line_t phys;
+
+	/* Rate may be left over from cache attached without deduplication */
+	if (!trimmer->rate || ocf_cache_dedup_enabled(cache))
+		return;
+
+	phys = ocf_metadata_map_lg2phy(cache, cline);
+
+	env_spinlock_lock(&trimmer->lock);
+
+	/* Try to extend most recently added range first */
+	if (trimmer->count) {
+		range = &trimmer->ranges[trimmer->count - 1];
+
+		if (range->count < max_count &&
+				range->phys + range->count == phys) {
+			range->count++;
+			goto unlock;
+		}
+
+		if (range->count < max_count && phys + 1 == range->phys) {
+			range->phys = phys;
+			range->count++;
+			goto unlock;
+		}
+	}
+
+	if (trimmer->count == OCF_TRIMMER_RANGES && !trimmer->full) {
+		ocf_trimmer_compact(trimmer, max_count);
+		/* Don't sort again on each freed line if merging didn't
+		 * help much - wait for trimmer to drain the table */
+		trimmer->full = trimmer->count > OCF_TRIMMER_RANGES * 3 / 4;
+	}
+
+	if (trimmer->count < OCF_TRIMMER_RANGES) {
+		range = &trimmer->ranges[trimmer->count++];
+		range->phys = phys;
+		range->count = 1;
+	}
+
+unlock:
+	env_spinlock_unlock(&trimmer->lock);
+}
+
+static bool ocf_trimmer_pop(struct ocf_trimmer *trimmer, uint32_t max_count,
+		struct ocf_trimmer_range *range)
+{
+	struct ocf_trimmer_range *last;
+	bool found = false;
+
+	env_spinlock_lock(&trimmer->lock);
+
+	if (trimmer->count) {
+		last = &trimmer->ranges[trimmer->count - 1];
+
+		range->count = OCF_MIN(last->count, max_count);
+		last->count -= range->count;
+		range->phys = last->phys + last->count;
+		if (!last->count)
+			trimmer->count--;
+
+		trimmer->full = false;
+		found = true;
+	}
+
+	env_spinlock_unlock(&trimmer->lock);
+
+	return found;
+}
+
+/*
+ * Line might have been allocated again since it was queued. Holding write
+ * lock on a free line makes request which maps it wait until discard is done.
+ */
+static bool ocf_trimmer_lock_line(ocf_cache_t cache, ocf_cache_line_t phys)
+{
+	ocf_cache_line_t cline = ocf_metadata_map_phy2lg(cache, phys);
+	bool locked = false;
+
+	OCF_METADATA_LRU_WR_LOCK(cline);
+
+	if (ocf_metadata_get_partition_id(cache, cline) == PARTITION_FREELIST) {
+		locked = ocf_cache_line_try_lock_wr(
+				ocf_cache_line_concurrency(cache), cline);
+	}
+
+	OCF_METADATA_LRU_WR_UNLOCK(cline);
+
+	return locked;
+}
+
+static void ocf_trimmer_unlock_lines(ocf_cache_t cache, ocf_cache_line_t phys,
+		uint32_t count)
+{
+	uint32_t i;
+
+	for (i = 0; i < count; i++) {
+		ocf_cache_line_unlock_wr(ocf_cache_line_concurrency(cache),
+				ocf_metadata_map_phy2lg(cache, phys + i));
+	}
+}
+
+static void ocf_trimmer_put(struct ocf_trimmer_context *context)
+{
+	if (env_atomic_dec_return(&context->remaining))
+		return;
+
+	context->cmpl(context->cache);
+	env_vfree(context);
+}
+
+static void ocf_trimmer_discard_end(struct ocf_io *io, int error)
+{
+	struct ocf_trimmer_context *context = io->priv1;
+	ocf_cache_t cache = context->cache;
+	ocf_cache_line_t phys;
+
+	/* Discard is only a hint for the device, so error is not reported */
+	phys = (io->addr - cache->device->metadata_offset) /
+			ocf_line_slot_size(cache);
+	ocf_trimmer_unlock_lines(cache, phys,
+			io->bytes / ocf_line_slot_size(cache));
+
+	ocf_io_put(io);
+	ocf_trimmer_put(context);
+}
+
+static void ocf_trimmer_discard(struct ocf_trimmer_context *context,
+		ocf_cache_line_t phys, uint32_t count)
+{
+	ocf_cache_t cache = context->cache;
+	uint64_t addr;
+	struct ocf_io *io;
+
+	/* Compressed cache lines take only a slot of their size */
+	addr = cache->device->metadata_offset +
+			(uint64_t)phys * ocf_line_slot_size(cache);
+
+	io = ocf_volume_new_io(&cache->device->volume, NULL, addr,
+			count * ocf_line_slot_size(cache), OCF_WRITE, 0, 0);
+	if (!io) {
+		ocf_trimmer_unlock_lines(cache, phys, count);
+		return;
+	}
+
+	ocf_io_set_origin(io, ocf_io_origin_trim);
+	env_atomic_inc(&context->remaining);
+
+	ocf_io_set_cmpl(io, context, NULL, ocf_trimmer_discard_end);
+	ocf_volume_submit_discard(io);
+}
+
+static void ocf_trimmer_discard_range(struct ocf_trimmer_context *context,
+		struct ocf_trimmer_range *range)
+{
+	ocf_cache_t cache = context->cache;
+	uint32_t entries = ocf_metadata_collision_table_entries(cache);
+	ocf_cache_line_t phys, start = range->phys;
+
+	/* Split range around lines which are no longer free */
+	for (phys = range->phys; phys < range->phys + range->count; phys++) {
+		if (phys < entries && ocf_trimmer_lock_line(cache, phys))
+			continue;
+
+		if (phys > start)
+			ocf_trimmer_discard(context, start, phys - start);
+		start = phys + 1;
+	}
+
+	if (phys > start)
+		ocf_trimmer_discard(context, start, phys - start);
+}
+
+void ocf_trimmer_run(ocf_cache_t cache, ocf_trimmer_end_t cmpl)
+{
+	struct ocf_trimmer *trimmer = &cache->trimmer;
+	struct ocf_trimmer_context *context;
+	struct ocf_trimmer_range range;
+	uint64_t now, elapsed, lines;
+
+	if (!trimmer->rate || !ocf_cache_is_device_attached(cache))
+		OCF_CMPL_RET(cache);
+
+	/* Budget accumulates for at most one second */
+	now = env_ticks_to_msecs(env_get_tick_count());
+	elapsed = OCF_MIN(now - trimmer->last_run_ms, 1000);
+	lines = trimmer->rate * MiB * elapsed / 1000 /
+			ocf_line_slot_size(cache);
+	if (!lines)
+		OCF_CMPL_RET(cache);
+
+	trimmer->last_run_ms = now;
+
+	env_spinlock_lock(&trimmer->lock);
+	ocf_trimmer_compact(trimmer,
+			OCF_TRIMMER_MAX_DISCARD / ocf_line_slot_size(cache));
+	env_spinlock_unlock(&trimmer->lock);
+
+	context = env_vzalloc(sizeof(*context));
+	if (!context)
+		OCF_CMPL_RET(cache);
+
+	context->cache = cache;
+	context->cmpl = cmpl;
+	env_atomic_set(&context->remaining, 1);
+
+	while (lines && ocf_trimmer_pop(trimmer, OCF_MIN(lines, UINT32_MAX),
+			&range)) {
+		lines -= range.count;
+		ocf_trimmer_discard_range(context, &range);
+	}
+
+	ocf_trimmer_put(context);
+}
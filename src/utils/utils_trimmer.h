@@ -0,0 +1,64 @@
+/*
+ * Copyright(c) 2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __UTILS_TRIMMER_H__
+#define __UTILS_TRIMMER_H__
+
+#include "ocf/ocf.h"
+#include "ocf_env.h"
+
+/* Number of pending ranges of freed cache lines. Ranges are sorted and
+ * merged when table fills up, lines freed while it's still full are not
+ * discarded */
+#define OCF_TRIMMER_RANGES 1024
+
+/* Maximum size of single discard request */
+#define OCF_TRIMMER_MAX_DISCARD (64 * MiB)
+
+struct ocf_trimmer_range {
+	/* First physical cache line */
+	ocf_cache_line_t phys;
+	/* Number of cache lines */
+	uint32_t count;
+};
+
+struct ocf_trimmer {
+	/* Discard rate limit in MiB/s, 0 if trimming is disabled */
+	uint32_t rate;
+	/* Time of last trimmer run */
+	uint64_t last_run_ms;
+
+	env_spinlock lock;
+	struct ocf_trimmer_range ranges[OCF_TRIMMER_RANGES];
+	uint32_t count;
+	/* Merging ranges didn't free enough space in the table */
+	bool full;
+};
+
+typedef void (*ocf_trimmer_end_t)(ocf_cache_t cache);
+
+int ocf_trimmer_init(ocf_cache_t cache);
+
+void ocf_trimmer_deinit(ocf_cache_t cache);
+
+/**
+ * @brief Queue freed cache line for discard
+ *
+ * @param cache Cache instance
+ * @param cline Cache line which has just been moved to freelist
+ */
+void ocf_trimmer_add(ocf_cache_t cache, ocf_cache_line_t cline);
+
+/**
+ * @brief Discard pending ranges of freed cache lines within rate limit
+ *
+ * @note Caller must hold management lock until cmpl is called
+ *
+ * @param cache Cache instance
+ * @param cmpl Completion called when all discards have finished
+ */
+void ocf_trimmer_run(ocf_cache_t cache, ocf_trimmer_end_t cmpl);
+
+#endif /* __UTILS_TRIMMER_H__ */
@@ -0,0 +1,217 @@
+/*
+ * Copyright(c) 2021 Intel Corporation
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+/*
+ * Reader-writer lock microbenchmark. Each thread repeatedly takes the lock
+ * for read or write (with given write percentage), runs short critical
+ * section and releases the lock. Throughput and maximum time writer waited
+ * for the lock are reported for each lock type.
+ *
+ * Usage: lockbench [threads] [write_percent] [seconds]
+ */
+
+#include "ocf_env.h"
+
+struct bench_lock {
+	const char *name;
+	void (*init)(void *lock);
+	void (*rd_lock)(void *lock, unsigned idx);
+	void (*rd_unlock)(void *lock, unsigned idx);
+	void (*wr_lock)(void *lock);
+	void (*wr_unlock)(void *lock);
+};
+
+static void pthread_init(void *lock)
+{
+	ENV_BUG_ON(pthread_rwlock_init(lock, NULL));
+}
+
+static void pthread_rd_lock(void *lock, unsigned idx)
+{
+	pthread_rwlock_rdlock(lock);
+}
+
+static void pthread_rd_unlock(void *lock, unsigned idx)
+{
+	pthread_rwlock_unlock(lock);
+}
+
+static void pthread_wr_lock(void *lock)
+{
+	pthread_rwlock_wrlock(lock);
+}
+
+static void pthread_wr_unlock(void *lock)
+{
+	pthread_rwlock_unlock(lock);
+}
+
+static void rwsem_init(void *lock)
+{
+	ENV_BUG_ON(env_rwsem_init(lock));
+}
+
+static void rwsem_rd_lock(void *lock, unsigned idx)
+{
+	env_rwsem_down_read(lock);
+}
+
+static void rwsem_rd_unlock(void *lock, unsigned idx)
+{
+	env_rwsem_up_read(lock);
+}
+
+static void rwsem_wr_lock(void *lock)
+{
+	env_rwsem_down_write(lock);
+}
+
+static void rwsem_wr_unlock(void *lock)
+{
+	env_rwsem_up_write(lock);
+}
+
+static const struct bench_lock locks[] = {
+	{ "pthread_rwlock", pthread_init, pthread_rd_lock, pthread_rd_unlock,
+		pthread_wr_lock, pthread_wr_unlock },
+	{ "env_rwsem", rwsem_init, rwsem_rd_lock, rwsem_rd_unlock,
+		rwsem_wr_lock, rwsem_wr_unlock },
+};
+
+union bench_lock_storage {
+	pthread_rwlock_t pthread;
+	env_rwsem rwsem;
+};
+
+struct bench_ctx {
+	const struct bench_lock *ops;
+	union bench_lock_storage lock;
+	unsigned write_percent;
+	volatile int stop;
+
+	/* Protected by the lock under test */
+	volatile uint64_t shared[8];
+} __attribute__((aligned(64)));
+
+struct bench_thread {
+	struct bench_ctx *ctx;
+	pthread_t thread;
+	unsigned idx;
+	uint64_t reads;
+	uint64_t writes;
+	uint64_t max_wr_wait_ns;
+} __attribute__((aligned(64)));
+
+static uint64_t bench_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void *bench_thread_fn(void *arg)
+{
+	struct bench_thread *t = arg;
+	struct bench_ctx *ctx = t->ctx;
+	uint64_t seed = t->idx * 2654435761ULL + 1;
+	uint64_t start, wait, sum, first;
+	unsigned i;
+
+	while (!ctx->stop) {
+		seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+		if ((seed >> 33) % 100 < ctx->write_percent) {
+			start = bench_now_ns();
+			ctx->ops->wr_lock(&ctx->lock);
+			wait = bench_now_ns() - start;
+			for (i = 0; i < ARRAY_SIZE(ctx->shared); i++)
+				ctx->shared[i]++;
+			ctx->ops->wr_unlock(&ctx->lock);
+			t->max_wr_wait_ns = MAX(t->max_wr_wait_ns, wait);
+			t->writes++;
+		} else {
+			ctx->ops->rd_lock(&ctx->lock, t->idx);
+			first = ctx->shared[0];
+			for (i = 0, sum = 0; i < ARRAY_SIZE(ctx->shared); i++)
+				sum += ctx->shared[i];
+			ctx->ops->rd_unlock(&ctx->lock, t->idx);
+			/* Writer inside critical section would be visible */
+			ENV_BUG_ON(sum != first * ARRAY_SIZE(ctx->shared));
+			t->reads++;
+		}
+	}
+
+	return NULL;
+}
+
+static void bench_run(const struct bench_lock *ops, unsigned threads,
+		unsigned write_percent, unsigned seconds)
+{
+	struct bench_ctx *ctx;
+	struct bench_thread *t;
+	uint64_t reads = 0, writes = 0, max_wait = 0;
+	unsigned i;
+
+	ctx = env_zalloc(sizeof(*ctx), ENV_MEM_NORMAL);
+	t = env_zalloc(sizeof(*t) * threads, ENV_MEM_NORMAL);
+	ENV_BUG_ON(!ctx || !t);
+
+	ctx->ops = ops;
+	ctx->write_percent = write_percent;
+	ops->init(&ctx->lock);
+
+	for (i = 0; i < threads; i++) {
+		t[i].ctx = ctx;
+		t[i].idx = i;
+		ENV_BUG_ON(pthread_create(&t[i].thread, NULL,
+				bench_thread_fn, &t[i]));
+	}
+
+	sleep(seconds);
+	ctx->stop = 1;
+
+	for (i = 0; i < threads; i++) {
+		pthread_join(t[i].thread, NULL);
+		reads += t[i].reads;
+		writes += t[i].writes;
+		max_wait = MAX(max_wait, t[i].max_wr_wait_ns);
+	}
+
+	printf("%-18s %12.0f rd/s %10.0f wr/s   max wr wait %8.1f us\n",
+			ops->name, (double)reads / seconds,
+			(double)writes / seconds, max_wait / 1000.0);
+
+	env_free(t);
+	env_free(ctx);
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned threads = env_get_execution_context_count();
+	unsigned write_percent = 1;
+	unsigned seconds = 2;
+	unsigned i;
+
+	if (argc > 1)
+		threads = atoi(argv[1]);
+	if (argc > 2)
+		write_percent = atoi(argv[2]);
+	if (argc > 3)
+		seconds = atoi(argv[3]);
+
+	if (!threads || write_percent > 100 || !seconds) {
+		fprintf(stderr, "Usage: %s [threads] [write_percent] "
+				"[seconds]\n", argv[0]);
+		return 1;
+	}
+
+	printf("threads: %u, writes: %u%%, time: %us\n", threads,
+			write_percent, seconds);
+
+	for (i = 0; i < ARRAY_SIZE(locks); i++)
+		bench_run(&locks[i], threads, write_percent, seconds);
+
+	return 0;
+}
@@ -28,14 +28,18 @@ from .shared import (
     OcfErrorCode,
     CacheLineSize,
     CacheLines,
+    StatusGranularity,
+    Compression,
+    Dedup,
     OcfCompletion,
     SeqCutOffPolicy,
 )
 from ..utils import Size, struct_to_dict
 from .core import Core
 from .queue import Queue
+from .cleaner import Cleaner
 from .stats.cache import CacheInfo
-from .ioclass import IoClassesInfo, IoClassInfo
+from .ioclass import IoClassesInfo, IoClassInfo, IoClassPromotion
 from .stats.shared import UsageStats, RequestsStats, BlocksStats, ErrorsStats
 
 
@@ -50,6 +54,9 @@ class CacheConfig(Structure):
         ("_cache_mode", c_uint32),
         ("_promotion_policy", c_uint32),
         ("_cache_line_size", c_uint64),
+        ("_status_granularity", c_uint32),
+        ("_compression", c_uint32),
+        ("_dedup", c_uint32),
         ("_metadata_layout", c_uint32),
         ("_metadata_volatile", c_bool),
         ("_locked", c_bool),
@@ -68,7 +75,11 @@ class CacheDeviceConfig(Structure):
         ("_force", c_bool),
         ("_perform_test", c_bool),
         ("_discard_on_start", c_bool),
+        ("_cache_line_lock_slots", c_uint32),
         ("_volume_params", c_void_p),
+        ("_metadata_uuid", Uuid),
+        ("_metadata_volume_type", c_uint8),
+        ("_metadata_volume_params", c_void_p),
     ]
 
 
@@ -133,6 +144,12 @@ class CleaningPolicy(IntEnum):
     DEFAULT = ALRU
 
 
+class AllocPolicy(IntEnum):
+    LRU = 0
+    LOG = 1
+    DEFAULT = LRU
+
+
 class AlruParams(IntEnum):
     WAKE_UP_TIME = 0
     STALE_BUFFER_TIME = 1
@@ -164,6 +181,9 @@ class Cache:
         cache_mode: CacheMode = CacheMode.DEFAULT,
         promotion_policy: PromotionPolicy = PromotionPolicy.DEFAULT,
         cache_line_size: CacheLineSize = CacheLineSize.DEFAULT,
+        status_granularity: StatusGranularity = None,
+        compression: Compression = Compression.DEFAULT,
+        dedup: Dedup = Dedup.DEFAULT,
         metadata_layout: MetadataLayout = MetadataLayout.DEFAULT,
         metadata_volatile: bool = False,
         max_queue_size: int = DEFAULT_BACKFILL_QUEUE_SIZE,
@@ -171,17 +191,30 @@ class Cache:
         locked: bool = False,
         pt_unaligned_io: bool = DEFAULT_PT_UNALIGNED_IO,
         use_submit_fast: bool = DEFAULT_USE_SUBMIT_FAST,
+        cache_line_lock_slots: int = 0,
     ):
         self.device = None
+        self.metadata_device = None
         self.started = False
         self.owner = owner
         self.cache_line_size = cache_line_size
+        self.cache_line_lock_slots = cache_line_lock_slots
+
+        if status_granularity is None:
+            # Finest granularity allowed for given cache line size and
+            # compression ratio
+            status_granularity = max(
+                StatusGranularity.DEFAULT, cache_line_size // 128, 512 * compression
+            )
 
         self.cfg = CacheConfig(
             _name=name.encode("ascii"),
             _cache_mode=cache_mode,
             _promotion_policy=promotion_policy,
             _cache_line_size=cache_line_size,
+            _status_granularity=status_granularity,
+            _compression=compression,
+            _dedup=dedup,
             _metadata_layout=metadata_layout,
             _metadata_volatile=metadata_volatile,
             _backfill=Backfill(
@@ -329,6 +362,84 @@ class Cache:
                 "Error setting cache seq cut off policy promotion count", status
             )
 
+    def set_io_split(self, lines: int):
+        self.write_lock()
+
+        status = self.owner.lib.ocf_mngt_cache_set_io_split(self.cache_handle, lines)
+
+        self.write_unlock()
+
+        if status:
+            raise OcfError("Error setting cache io split", status)
+
+    def set_read_steering_threshold(self, threshold: int):
+        self.write_lock()
+
+        status = self.owner.lib.ocf_mngt_cache_set_read_steering_threshold(
+            self.cache_handle, threshold
+        )
+
+        self.write_unlock()
+
+        if status:
+            raise OcfError("Error setting cache read steering threshold", status)
+
+    def set_read_hedge_percentile(self, percentile: int):
+        self.write_lock()
+
+        status = self.owner.lib.ocf_mngt_cache_set_read_hedge_percentile(
+            self.cache_handle, percentile
+        )
+
+        self.write_unlock()
+
+        if status:
+            raise OcfError("Error setting cache read hedge percentile", status)
+
+    def set_background_io_share(self, share: int):
+        self.write_lock()
+
+        status = self.owner.lib.ocf_mngt_cache_set_background_io_share(
+            self.cache_handle, share
+        )
+
+        self.write_unlock()
+
+        if status:
+            raise OcfError("Error setting cache background io share", status)
+
+    def set_alloc_policy(self, policy: AllocPolicy):
+        self.write_lock()
+
+        status = self.owner.lib.ocf_mngt_cache_set_alloc_policy(
+            self.cache_handle, policy
+        )
+
+        self.write_unlock()
+
+        if status:
+            raise OcfError("Error setting cache allocation policy", status)
+
+    def set_trim_rate(self, rate: int):
+        self.write_lock()
+
+        status = self.owner.lib.ocf_mngt_cache_set_trim_rate(self.cache_handle, rate)
+
+        self.write_unlock()
+
+        if status:
+            raise OcfError("Error setting cache trim rate", status)
+
+    def run_cleaner(self):
+        cleaner = Cleaner.get_by_cache(self.cache_handle)
+
+        c = OcfCompletion([("cleaner", c_void_p), ("interval", c_uint32)])
+        self.owner.lib.ocf_cleaner_set_cmpl(cleaner, c)
+        self.owner.lib.ocf_cleaner_run(cleaner, self.get_default_queue())
+        c.wait()
+
+        return int(c.results["interval"])
+
     def get_partition_info(self, part_id: int):
         ioclass_info = IoClassInfo()
         self.read_lock()
@@ -350,6 +461,8 @@ class Cache:
             "_min_size": int(ioclass_info._min_size),
             "_max_size": int(ioclass_info._max_size),
             "_cleaning_policy_type": int(ioclass_info._cleaning_policy_type),
+            "_promotion": ioclass_info._promotion,
+            "_seq_cutoff_threshold": int(ioclass_info._seq_cutoff_threshold),
         }
 
     def add_partition(
@@ -381,6 +494,8 @@ class Cache:
         max_size: int,
         priority: int,
         cache_mode=CACHE_MODE_NONE,
+        promotion: IoClassPromotion = None,
+        seq_cutoff_threshold: int = None,
     ):
         ioclasses_info = IoClassesInfo()
 
@@ -400,6 +515,10 @@ class Cache:
             ioclasses_info._config[i]._priority = ioclass_info._priority
             ioclasses_info._config[i]._cache_mode = ioclass_info._cache_mode
             ioclasses_info._config[i]._max_size = ioclass_info._max_size
+            ioclasses_info._config[i]._promotion = ioclass_info._promotion
+            ioclasses_info._config[i]._seq_cutoff_threshold = (
+                ioclass_info._seq_cutoff_threshold
+            )
 
         self.read_unlock()
 
@@ -407,6 +526,10 @@ class Cache:
         ioclasses_info._config[part_id]._cache_mode = int(cache_mode)
         ioclasses_info._config[part_id]._priority = priority
         ioclasses_info._config[part_id]._max_size = max_size
+        if promotion is not None:
+            ioclasses_info._config[part_id]._promotion = promotion
+        if seq_cutoff_threshold is not None:
+            ioclasses_info._config[part_id]._seq_cutoff_threshold = seq_cutoff_threshold
 
         self.write_lock()
 
@@ -426,9 +549,21 @@ class Cache:
         perform_test=True,
         cache_line_size=None,
         open_cores=True,
+        metadata_device=None,
     ):
         self.device = device
         self.device_name = device.uuid
+        self.metadata_device = metadata_device
+        if metadata_device:
+            metadata_uuid = Uuid(
+                _data=cast(
+                    create_string_buffer(metadata_device.uuid.encode("ascii")),
+                    c_char_p,
+                ),
+                _size=len(metadata_device.uuid) + 1,
+            )
+        else:
+            metadata_uuid = Uuid(_data=None, _size=0)
         self.dev_cfg = CacheDeviceConfig(
             _uuid=Uuid(
                 _data=cast(
@@ -444,13 +579,24 @@ class Cache:
             _force=force,
             _perform_test=perform_test,
             _discard_on_start=False,
+            _cache_line_lock_slots=self.cache_line_lock_slots,
             _volume_params=None,
+            _metadata_uuid=metadata_uuid,
+            _metadata_volume_type=metadata_device.type_id if metadata_device else 0,
+            _metadata_volume_params=None,
         )
 
     def attach_device(
-        self, device, force=False, perform_test=False, cache_line_size=None
+        self,
+        device,
+        force=False,
+        perform_test=False,
+        cache_line_size=None,
+        metadata_device=None,
     ):
-        self.configure_device(device, force, perform_test, cache_line_size, False)
+        self.configure_device(
+            device, force, perform_test, cache_line_size, False, metadata_device
+        )
         self.write_lock()
 
         c = OcfCompletion([("cache", c_void_p), ("priv", c_void_p), ("error", c_int)])
@@ -478,8 +624,10 @@ class Cache:
         if c.results["error"]:
             raise OcfError("Attaching cache device failed", c.results["error"])
 
-    def load_cache(self, device, open_cores=True):
-        self.configure_device(device, open_cores=open_cores)
+    def load_cache(self, device, open_cores=True, metadata_device=None):
+        self.configure_device(
+            device, open_cores=open_cores, metadata_device=metadata_device
+        )
         c = OcfCompletion([("cache", c_void_p), ("priv", c_void_p), ("error", c_int)])
         device.owner.lib.ocf_mngt_cache_load(
             self.cache_handle, byref(self.dev_cfg), c, None
@@ -490,12 +638,16 @@ class Cache:
             raise OcfError("Loading cache device failed", c.results["error"])
 
     @classmethod
-    def load_from_device(cls, device, name="cache", open_cores=True):
+    def load_from_device(
+        cls, device, name="cache", open_cores=True, metadata_device=None
+    ):
         c = cls(name=name, owner=device.owner)
 
         c.start_cache()
         try:
-            c.load_cache(device, open_cores=open_cores)
+            c.load_cache(
+                device, open_cores=open_cores, metadata_device=metadata_device
+            )
         except:  # noqa E722
             c.stop()
             raise
@@ -503,12 +655,12 @@ class Cache:
         return c
 
     @classmethod
-    def start_on_device(cls, device, **kwargs):
+    def start_on_device(cls, device, metadata_device=None, **kwargs):
         c = cls(owner=device.owner, **kwargs)
 
         c.start_cache()
         try:
-            c.attach_device(device, force=True)
+            c.attach_device(device, force=True, metadata_device=metadata_device)
         except:  # noqa E722
             c.stop()
             raise
@@ -631,6 +783,32 @@ class Cache:
                     "error_counter": cache_info.fallback_pt.error_counter,
                     "status": cache_info.fallback_pt.status,
                 },
+                "steering": {
+                    "status": cache_info.steering.status,
+                    "cache_latency": cache_info.steering.cache_latency,
+                    "core_latency": cache_info.steering.core_latency,
+                    "steered": cache_info.steering.steered,
+                },
+                "hedging": {
+                    "deadline": cache_info.hedging.deadline,
+                    "hedged": cache_info.hedging.hedged,
+                    "core_won": cache_info.hedging.core_won,
+                },
+                "background_io": {
+                    "cleaner_deferred": cache_info.background_io.cleaner_deferred,
+                    "backfill_skipped": cache_info.background_io.backfill_skipped,
+                },
+                "lock_wait": {
+                    "waiting": cache_info.lock_wait.waiting,
+                    "resumed": cache_info.lock_wait.resumed,
+                    "wait_time": cache_info.lock_wait.wait_time,
+                    "batches": cache_info.lock_wait.batches,
+                },
+                "lock_table": {
+                    "slots": cache_info.lock_table.slots,
+                    "busy": cache_info.lock_table.busy,
+                    "collisions": cache_info.lock_table.collisions,
+                },
                 "state": cache_info.state,
                 "cleaning_policy": CleaningPolicy(cache_info.cleaning_policy),
                 "promotion_policy": PromotionPolicy(cache_info.promotion_policy),
@@ -638,8 +816,30 @@ class Cache:
                 "flushed": CacheLines(cache_info.flushed, line_size),
                 "core_count": cache_info.core_count,
                 "metadata_footprint": Size(cache_info.metadata_footprint),
-                "metadata_end_offset": Size(cache_info.metadata_end_offset),
+                "metadata_end_offset": Size.from_KiB(cache_info.metadata_end_offset * 4),
                 "cache_name": cache_name,
+                "compression": {
+                    "ratio": Compression(cache_info.compression.ratio),
+                    "bytes_in": Size(cache_info.compression.bytes_in),
+                    "bytes_out": Size(cache_info.compression.bytes_out),
+                    "incompressible": cache_info.compression.incompressible,
+                    "compress_time": timedelta(
+                        microseconds=cache_info.compression.compress_time
+                    ),
+                    "decompress_time": timedelta(
+                        microseconds=cache_info.compression.decompress_time
+                    ),
+                },
+                "dedup": {
+                    "factor": Dedup(cache_info.dedup.factor),
+                    "data_slots": cache_info.dedup.data_slots,
+                    "free_slots": cache_info.dedup.free_slots,
+                    "shared_slots": cache_info.dedup.shared_slots,
+                    "hits": cache_info.dedup.hits,
+                    "cow": cache_info.dedup.cow,
+                    "no_slot": cache_info.dedup.no_slot,
+                    "collisions": cache_info.dedup.collisions,
+                },
             },
             "block": struct_to_dict(block),
             "req": struct_to_dict(req),
@@ -708,6 +908,17 @@ class Cache:
         if c.results["error"]:
             raise OcfError("Couldn't flush cache", c.results["error"])
 
+    def prewarm(self):
+        self.read_lock()
+
+        c = OcfCompletion([("cache", c_void_p), ("priv", c_void_p), ("error", c_int)])
+        self.owner.lib.ocf_mngt_cache_prewarm(self.cache_handle, c, None)
+        c.wait()
+        self.read_unlock()
+
+        if c.results["error"]:
+            raise OcfError("Couldn't prewarm cache", c.results["error"])
+
     def get_name(self):
         self.read_lock()
 
@@ -765,5 +976,17 @@ lib.ocf_mngt_add_partition_to_cache.argtypes = [
     c_uint8,
     c_bool,
 ]
+lib.ocf_mngt_cache_set_io_split.restype = c_int
+lib.ocf_mngt_cache_set_io_split.argtypes = [c_void_p, c_uint32]
+lib.ocf_mngt_cache_set_read_steering_threshold.restype = c_int
+lib.ocf_mngt_cache_set_read_steering_threshold.argtypes = [c_void_p, c_uint32]
+lib.ocf_mngt_cache_set_read_hedge_percentile.restype = c_int
+lib.ocf_mngt_cache_set_read_hedge_percentile.argtypes = [c_void_p, c_uint32]
+lib.ocf_mngt_cache_set_background_io_share.restype = c_int
+lib.ocf_mngt_cache_set_background_io_share.argtypes = [c_void_p, c_uint32]
+lib.ocf_mngt_cache_set_alloc_policy.restype = c_int
+lib.ocf_mngt_cache_set_alloc_policy.argtypes = [c_void_p, c_uint32]
+lib.ocf_mngt_cache_set_trim_rate.restype = c_int
+lib.ocf_mngt_cache_set_trim_rate.argtypes = [c_void_p, c_uint32]
 lib.ocf_mngt_cache_io_classes_configure.restype = c_int
 lib.ocf_mngt_cache_io_classes_configure.argtypes = [c_void_p, c_void_p]
@@ -4,6 +4,7 @@
 #
 
 from ctypes import c_void_p, CFUNCTYPE, Structure, c_int
+from ..ocf import OcfLib
 from .shared import SharedOcfObject
 
 
@@ -17,6 +18,7 @@ class CleanerOps(Structure):
 
 class Cleaner(SharedOcfObject):
     _instances_ = {}
+    _cleaners_ = {}
     _fields_ = [("cleaner", c_void_p)]
 
     def __init__(self):
@@ -27,9 +29,15 @@ class Cleaner(SharedOcfObject):
     def get_ops(cls):
         return CleanerOps(init=cls._init, kick=cls._kick, stop=cls._stop)
 
+    @classmethod
+    def get_by_cache(cls, cache_handle):
+        return cls._cleaners_[cache_handle.value]
+
     @staticmethod
     @CleanerOps.INIT
     def _init(cleaner):
+        lib = OcfLib.getInstance()
+        Cleaner._cleaners_[lib.ocf_cleaner_get_cache(cleaner)] = cleaner
         return 0
 
     @staticmethod
@@ -40,4 +48,12 @@ class Cleaner(SharedOcfObject):
     @staticmethod
     @CleanerOps.STOP
     def _stop(cleaner):
-        pass
+        lib = OcfLib.getInstance()
+        Cleaner._cleaners_.pop(lib.ocf_cleaner_get_cache(cleaner), None)
+
+
+lib = OcfLib.getInstance()
+lib.ocf_cleaner_get_cache.argtypes = [c_void_p]
+lib.ocf_cleaner_get_cache.restype = c_void_p
+lib.ocf_cleaner_set_cmpl.argtypes = [c_void_p, c_void_p]
+lib.ocf_cleaner_run.argtypes = [c_void_p, c_void_p]
@@ -148,6 +148,7 @@ class Core:
             "dirty_for": timedelta(seconds=core_info.dirty_for),
             "seq_cutoff_policy": SeqCutOffPolicy(core_info.seq_cutoff_policy),
             "seq_cutoff_threshold": core_info.seq_cutoff_threshold,
+            "seq_cutoff_streams": struct_to_dict(core_info.seq_cutoff_streams),
             "usage": struct_to_dict(usage),
             "req": struct_to_dict(req),
             "blocks": struct_to_dict(blocks),
@@ -199,8 +200,10 @@ class Core:
 
         position = 0
         while position < read_buffer_all.size:
+            # Device doesn't have to be multiple of cache line size
+            size = min(cache_line_size, read_buffer_all.size - position)
             io = self.new_io(self.cache.get_default_queue(), position,
-                             cache_line_size, IoDir.READ, 0, 0)
+                             size, IoDir.READ, 0, 0)
             io.set_data(read_buffer)
 
             cmpl = OcfCompletion([("err", c_int)])
@@ -211,8 +214,8 @@ class Core:
             if cmpl.results["err"]:
                 raise Exception("Error reading whole exported object")
 
-            read_buffer_all.copy(read_buffer, position, 0, cache_line_size)
-            position += cache_line_size
+            read_buffer_all.copy(read_buffer, position, 0, size)
+            position += size
 
         return read_buffer_all.md5()
 
@@ -6,6 +6,7 @@
 from ctypes import (
     c_void_p,
     c_uint32,
+    c_bool,
     CFUNCTYPE,
     c_uint64,
     create_string_buffer,
@@ -20,6 +21,7 @@ from ctypes import (
 from enum import IntEnum
 from hashlib import md5
 import weakref
+import zlib
 
 from ..utils import print_buffer, Size as S
 
@@ -40,6 +42,9 @@ class DataOps(Structure):
     SEEK = CFUNCTYPE(c_uint32, c_void_p, c_uint32, c_uint32)
     COPY = CFUNCTYPE(c_uint64, c_void_p, c_void_p, c_uint64, c_uint64, c_uint64)
     SECURE_ERASE = CFUNCTYPE(None, c_void_p)
+    IS_ZERO = CFUNCTYPE(c_bool, c_void_p, c_uint32)
+    COMPRESS = CFUNCTYPE(c_uint32, c_void_p, c_void_p, c_uint64, c_uint64, c_uint32, c_uint32)
+    DECOMPRESS = CFUNCTYPE(c_int, c_void_p, c_void_p, c_uint64, c_uint64, c_uint32, c_uint32)
 
     _fields_ = [
         ("_alloc", ALLOC),
@@ -52,6 +57,9 @@ class DataOps(Structure):
         ("_seek", SEEK),
         ("_copy", COPY),
         ("_secure_erase", SECURE_ERASE),
+        ("_is_zero", IS_ZERO),
+        ("_compress", COMPRESS),
+        ("_decompress", DECOMPRESS),
     ]
 
 
@@ -89,6 +97,9 @@ class Data:
             _seek=cls._seek,
             _copy=cls._copy,
             _secure_erase=cls._secure_erase,
+            _is_zero=cls._is_zero,
+            _compress=cls._compress,
+            _decompress=cls._decompress,
         )
 
     @classmethod
@@ -170,6 +181,23 @@ class Data:
     def _secure_erase(dst):
         Data.get_instance(dst).secure_erase()
 
+    @staticmethod
+    @DataOps.IS_ZERO
+    def _is_zero(src, size):
+        return Data.get_instance(src).is_zero(size)
+
+    @staticmethod
+    @DataOps.COMPRESS
+    def _compress(dst, src, to, _from, size, max_size):
+        return Data.get_instance(dst).compress(Data.get_instance(src), to, _from, size, max_size)
+
+    @staticmethod
+    @DataOps.DECOMPRESS
+    def _decompress(dst, src, to, _from, size, expected):
+        return Data.get_instance(dst).decompress(
+            Data.get_instance(src), to, _from, size, expected
+        )
+
     def read(self, dst, size):
         to_read = min(self.size - self.position, size)
         memmove(dst, self.handle.value + self.position, to_read)
@@ -216,6 +244,30 @@ class Data:
     def secure_erase(self):
         pass
 
+    def is_zero(self, size):
+        to_check = min(self.size - self.position, size)
+        return string_at(self.handle.value + self.position, to_check) == bytes(to_check)
+
+    def compress(self, src, to, _from, size, max_size):
+        compressed = zlib.compress(string_at(src.handle.value + _from, size), 1)
+        if len(compressed) > min(max_size, self.size - to):
+            return 0
+
+        memmove(self.handle.value + to, compressed, len(compressed))
+        return len(compressed)
+
+    def decompress(self, src, to, _from, size, expected):
+        try:
+            data = zlib.decompress(string_at(src.handle.value + _from, size))
+        except zlib.error:
+            return -1
+
+        if len(data) != expected or to + expected > self.size:
+            return -1
+
+        memmove(self.handle.value + to, data, expected)
+        return 0
+
     def dump(self, ignore=DATA_POISON, **kwargs):
         print_buffer(self.buffer, self.size, ignore=ignore, **kwargs)
 
@@ -25,6 +25,20 @@ class IoDir(IntEnum):
     WRITE = 1
 
 
+class IoOrigin(IntEnum):
+    USER = 0
+    METADATA = 1
+    MNGT = 2
+    BACKFILL = 3
+    CLEANER = 4
+    TRIM = 5
+
+
+class IoPriority(IntEnum):
+    FOREGROUND = 0
+    BACKGROUND = 1
+
+
 class IoOps(Structure):
     pass
 
@@ -98,6 +112,12 @@ class Io(Structure):
     def submit(self):
         return OcfLib.getInstance().ocf_core_submit_io_wrapper(byref(self))
 
+    def submit_flush(self):
+        return OcfLib.getInstance().ocf_core_submit_flush_wrapper(byref(self))
+
+    def submit_discard(self):
+        return OcfLib.getInstance().ocf_core_submit_discard_wrapper(byref(self))
+
     def set_data(self, data: Data, offset: int = 0):
         self.data = data
         OcfLib.getInstance().ocf_io_set_data(byref(self), data, offset)
@@ -116,3 +136,9 @@ lib.ocf_core_new_io_wrapper.restype = c_void_p
 
 lib.ocf_io_set_data.argtypes = [POINTER(Io), c_void_p, c_uint32]
 lib.ocf_io_set_data.restype = c_int
+
+lib.ocf_io_get_origin.argtypes = [POINTER(Io)]
+lib.ocf_io_get_origin.restype = c_int
+
+lib.ocf_io_get_priority.argtypes = [POINTER(Io)]
+lib.ocf_io_get_priority.restype = c_int
@@ -3,7 +3,26 @@
 # SPDX-License-Identifier: BSD-3-Clause-Clear
 #
 
-from ctypes import c_uint8, c_uint32, c_int, c_int16, c_uint16, c_char, c_char_p, Structure
+from ctypes import (
+    c_bool,
+    c_uint8,
+    c_uint32,
+    c_int,
+    c_int16,
+    c_uint16,
+    c_char,
+    c_char_p,
+    Structure,
+)
+
+
+class IoClassPromotion(Structure):
+    _fields_ = [
+        ("_enabled", c_bool),
+        ("_policy", c_int),
+        ("_nhit_insertion_threshold", c_uint32),
+        ("_nhit_trigger_threshold", c_uint32),
+    ]
 
 
 class IoClassInfo(Structure):
@@ -16,6 +35,8 @@ class IoClassInfo(Structure):
         ("_min_size", c_uint32),
         ("_max_size", c_uint32),
         ("_cleaning_policy_type", c_int),
+        ("_promotion", IoClassPromotion),
+        ("_seq_cutoff_threshold", c_uint32),
     ]
 
 
@@ -26,6 +47,8 @@ class IoClassConfig(Structure):
         ("_name", c_char_p),
         ("_cache_mode", c_int),
         ("_priority", c_uint16),
+        ("_promotion", IoClassPromotion),
+        ("_seq_cutoff_threshold", c_uint32),
     ]
 
 
@@ -97,6 +97,9 @@ class Queue:
     def put(self):
         OcfLib.getInstance().ocf_queue_put(self)
 
+    def check_deadlines(self):
+        OcfLib.getInstance().ocf_queue_check_deadlines(self.handle)
+
     def stop(self):
         with self.kick_condition:
             self.stop_event.set()
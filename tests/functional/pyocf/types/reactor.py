@@ -0,0 +1,89 @@
+#
+# Copyright(c) 2021 Intel Corporation
+# SPDX-License-Identifier: BSD-3-Clause-Clear
+#
+
+from ctypes import c_void_p, c_int, c_uint32, c_char_p, Structure, byref
+
+from ..ocf import OcfLib
+from .cleaner import Cleaner, CleanerOps
+from .shared import OcfError, OcfErrorCode
+
+
+class ReactorConfig(Structure):
+    _fields_ = [
+        ("_cpu", c_int),
+        ("_busy_poll_us", c_uint32),
+        ("_max_sleep_us", c_uint32),
+        ("_name", c_char_p),
+    ]
+
+
+class Reactor:
+    """Polling reactor thread of posix environment"""
+
+    def __init__(self, name="ocf_reactor", cpu=-1, busy_poll_us=100, max_sleep_us=10000):
+        self.cfg = ReactorConfig(
+            _cpu=cpu, _busy_poll_us=busy_poll_us, _max_sleep_us=max_sleep_us, _name=name.encode()
+        )
+
+        self.handle = OcfLib.getInstance().env_reactor_create(byref(self.cfg))
+        if not self.handle:
+            raise OcfError("Couldn't create reactor", OcfErrorCode.OCF_ERR_NO_MEM)
+
+        self._as_parameter_ = self.handle
+
+    def destroy(self):
+        OcfLib.getInstance().env_reactor_destroy(self)
+        self.handle = None
+
+
+class ReactorQueue:
+    """OCF IO queue served by reactor. Cache stop puts it."""
+
+    def __init__(self, reactor: Reactor, cache):
+        self.handle = c_void_p()
+        status = OcfLib.getInstance().env_reactor_queue_create(
+            reactor, cache.cache_handle, byref(self.handle)
+        )
+        if status:
+            raise OcfError("Couldn't create reactor queue", status)
+
+        self._as_parameter_ = self.handle
+
+
+class ReactorCleaner(Cleaner):
+    """Context cleaner ops running cleaners on reactors"""
+
+    @staticmethod
+    @CleanerOps.INIT
+    def _init(cleaner):
+        lib = OcfLib.getInstance()
+        result = lib.env_reactor_cleaner_init(cleaner)
+        if not result:
+            Cleaner._cleaners_[lib.ocf_cleaner_get_cache(cleaner)] = cleaner
+        return result
+
+    @staticmethod
+    @CleanerOps.KICK
+    def _kick(cleaner):
+        OcfLib.getInstance().env_reactor_cleaner_kick(cleaner)
+
+    @staticmethod
+    @CleanerOps.STOP
+    def _stop(cleaner):
+        lib = OcfLib.getInstance()
+        lib.env_reactor_cleaner_stop(cleaner)
+        Cleaner._cleaners_.pop(lib.ocf_cleaner_get_cache(cleaner), None)
+
+
+lib = OcfLib.getInstance()
+lib.env_reactor_create.argtypes = [c_void_p]
+lib.env_reactor_create.restype = c_void_p
+lib.env_reactor_destroy.argtypes = [c_void_p]
+lib.env_reactor_queue_create.argtypes = [c_void_p, c_void_p, c_void_p]
+lib.env_reactor_queue_create.restype = c_int
+lib.env_reactor_cleaner_init.argtypes = [c_void_p]
+lib.env_reactor_cleaner_init.restype = c_int
+lib.env_reactor_cleaner_kick.argtypes = [c_void_p]
+lib.env_reactor_cleaner_stop.argtypes = [c_void_p]
@@ -143,9 +143,38 @@ class CacheLineSize(IntEnum):
     LINE_16KiB = S.from_KiB(16)
     LINE_32KiB = S.from_KiB(32)
     LINE_64KiB = S.from_KiB(64)
+    LINE_128KiB = S.from_KiB(128)
+    LINE_256KiB = S.from_KiB(256)
+    LINE_512KiB = S.from_KiB(512)
+    LINE_1MiB = S.from_MiB(1)
+    LINE_2MiB = S.from_MiB(2)
     DEFAULT = LINE_4KiB
 
 
+class StatusGranularity(IntEnum):
+    SECTOR_512B = 512
+    BLOCK_1KiB = S.from_KiB(1)
+    BLOCK_2KiB = S.from_KiB(2)
+    BLOCK_4KiB = S.from_KiB(4)
+    BLOCK_8KiB = S.from_KiB(8)
+    BLOCK_16KiB = S.from_KiB(16)
+    DEFAULT = SECTOR_512B
+
+
+class Compression(IntEnum):
+    NONE = 1
+    RATIO_2 = 2
+    RATIO_4 = 4
+    DEFAULT = NONE
+
+
+class Dedup(IntEnum):
+    NONE = 1
+    FACTOR_2 = 2
+    FACTOR_4 = 4
+    DEFAULT = NONE
+
+
 class SeqCutOffPolicy(IntEnum):
     ALWAYS = 0
     FULL = 1
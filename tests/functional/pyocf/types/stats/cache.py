@@ -15,6 +15,71 @@ class _FallbackPt(Structure):
     _fields_ = [("error_counter", c_int), ("status", c_bool)]
 
 
+class _Steering(Structure):
+    _fields_ = [
+        ("status", c_bool),
+        ("cache_latency", c_uint64),
+        ("core_latency", c_uint64),
+        ("steered", c_uint64),
+    ]
+
+
+class _Hedging(Structure):
+    _fields_ = [
+        ("deadline", c_uint64),
+        ("hedged", c_uint64),
+        ("core_won", c_uint64),
+    ]
+
+
+class _BackgroundIo(Structure):
+    _fields_ = [
+        ("cleaner_deferred", c_uint64),
+        ("backfill_skipped", c_uint64),
+    ]
+
+
+class _LockWait(Structure):
+    _fields_ = [
+        ("waiting", c_uint32),
+        ("resumed", c_uint64),
+        ("wait_time", c_uint64),
+        ("batches", c_uint64),
+    ]
+
+
+class _LockTable(Structure):
+    _fields_ = [
+        ("slots", c_uint32),
+        ("busy", c_uint32),
+        ("collisions", c_uint64),
+    ]
+
+
+class _Compression(Structure):
+    _fields_ = [
+        ("ratio", c_uint32),
+        ("bytes_in", c_uint64),
+        ("bytes_out", c_uint64),
+        ("incompressible", c_uint64),
+        ("compress_time", c_uint64),
+        ("decompress_time", c_uint64),
+    ]
+
+
+class _Dedup(Structure):
+    _fields_ = [
+        ("factor", c_uint32),
+        ("data_slots", c_uint32),
+        ("free_slots", c_uint32),
+        ("shared_slots", c_uint32),
+        ("hits", c_uint64),
+        ("cow", c_uint64),
+        ("no_slot", c_uint64),
+        ("collisions", c_uint64),
+    ]
+
+
 class CacheInfo(Structure):
     _fields_ = [
         ("attached", c_bool),
@@ -28,6 +93,11 @@ class CacheInfo(Structure):
         ("dirty_initial", c_uint32),
         ("cache_mode", c_uint32),
         ("fallback_pt", _FallbackPt),
+        ("steering", _Steering),
+        ("hedging", _Hedging),
+        ("background_io", _BackgroundIo),
+        ("lock_wait", _LockWait),
+        ("lock_table", _LockTable),
         ("cleaning_policy", c_uint32),
         ("promotion_policy", c_uint32),
         ("cache_line_size", c_uint64),
@@ -35,4 +105,6 @@ class CacheInfo(Structure):
         ("core_count", c_uint32),
         ("metadata_footprint", c_uint64),
         ("metadata_end_offset", c_uint32),
+        ("compression", _Compression),
+        ("dedup", _Dedup),
     ]
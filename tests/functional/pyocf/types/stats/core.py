@@ -9,6 +9,15 @@ from ctypes import c_uint32, c_uint64, Structure
 from .shared import OcfStatsReq, OcfStatsBlock, OcfStatsDebug, OcfStatsError
 
 
+class _SeqCutoffStreams(Structure):
+    _fields_ = [
+        ("sequential", c_uint64),
+        ("reordered", c_uint64),
+        ("strided", c_uint64),
+        ("reverse", c_uint64),
+    ]
+
+
 class CoreInfo(Structure):
     _fields_ = [
         ("core_size", c_uint64),
@@ -18,4 +27,5 @@ class CoreInfo(Structure):
         ("dirty_for", c_uint64),
         ("seq_cutoff_threshold", c_uint32),
         ("seq_cutoff_policy", c_uint32),
+        ("seq_cutoff_streams", _SeqCutoffStreams),
     ]
@@ -393,6 +393,67 @@ class TraceDevice(Volume):
             super().submit_io(io)
 
 
+class HoldTrace:
+    """
+    Trace function for TraceDevice counting matching IO and, while hold is
+    set, keeping it from reaching the device until released. Matches data
+    IO at or above data_offset in given direction (any if None), or
+    flushes if flush is set.
+    """
+
+    def __init__(self, direction=None, flush=False, hold=False):
+        self.direction = direction
+        self.flush = flush
+        self.data_offset = 0
+        self.hold = hold
+        self.count = 0
+        self.held = []
+
+    def match(self, io):
+        if self.flush:
+            return io.contents._bytes == 0
+
+        if io.contents._bytes == 0 or io.contents._addr < self.data_offset:
+            return False
+
+        return self.direction is None or io.contents._dir == self.direction
+
+    def __call__(self, vol, io):
+        if not self.match(io):
+            return True
+
+        self.count += 1
+        if not self.hold:
+            return True
+
+        self.held.append((vol, io))
+        return False
+
+    def release(self, error=None):
+        """
+        Pass held IO to the device, or complete it with error if given.
+        IO submitted afterwards is held again unless hold is cleared.
+        """
+        held, self.held = self.held, []
+        for vol, io in held:
+            if error is not None:
+                io.contents._end(io, error)
+            elif self.flush:
+                Volume.submit_flush(vol, io)
+            else:
+                Volume.submit_io(vol, io)
+
+
+class DiscardTraceDevice(Volume):
+    def __init__(self, size, uuid=None):
+        super().__init__(size, uuid)
+        self.discards = []
+
+    def submit_discard(self, discard):
+        self.discards.append((int(discard.contents._addr), int(discard.contents._bytes)))
+        super().submit_discard(discard)
+
+
 lib = OcfLib.getInstance()
 lib.ocf_io_get_priv.restype = POINTER(VolumeIoPriv)
 lib.ocf_io_get_volume.argtypes = [c_void_p]
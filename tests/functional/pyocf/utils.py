@@ -3,7 +3,8 @@
 # SPDX-License-Identifier: BSD-3-Clause-Clear
 #
 
-from ctypes import string_at
+from ctypes import string_at, c_int
+from time import sleep
 
 
 def print_buffer(
@@ -230,3 +231,62 @@ def struct_to_dict(struct):
         d[field] = value
 
     return d
+
+
+def wait_for(condition, timeout=1, interval=0.01):
+    """
+    Poll condition until it's met, for work OCF finishes in background
+    after request completion (e.g. backfill). Returns final condition value.
+    """
+    for _ in range(int(timeout / interval)):
+        if condition():
+            return True
+        sleep(interval)
+
+    return condition()
+
+
+def submit_io(core, address, data, direction, queue=None, io_class=0, flags=0):
+    """
+    Submit IO to core (on cache default queue unless other queue is given)
+    without waiting for it. Returns completion to wait on.
+    """
+    from .types.shared import OcfCompletion
+
+    queue = queue or core.cache.get_default_queue()
+    io = core.new_io(queue, address, data.size, direction, io_class, flags)
+    io.set_data(data)
+
+    completion = OcfCompletion([("err", c_int)])
+    io.callback = completion.callback
+    io.submit()
+
+    return completion
+
+
+def io_to_core(core, address, data, direction, queue=None, io_class=0, flags=0):
+    """
+    Submit IO to core and wait for its completion. Returns IO error code.
+    """
+    completion = submit_io(core, address, data, direction, queue, io_class, flags)
+    completion.wait()
+
+    return int(completion.results["err"])
+
+
+def start_cache_with_core(cache_device, core_device, core_name="core", **kwargs):
+    """
+    Start cache on cache_device with cache config from kwargs and add core
+    on core_device. Sequential cutoff is disabled, so that all IO goes
+    through cache. Returns cache and core.
+    """
+    from .types.cache import Cache
+    from .types.core import Core
+    from .types.shared import SeqCutOffPolicy
+
+    cache = Cache.start_on_device(cache_device, **kwargs)
+    core = Core.using_device(core_device, name=core_name)
+    cache.add_core(core)
+    cache.set_seq_cut_off_policy(SeqCutOffPolicy.NEVER)
+
+    return cache, core
@@ -0,0 +1,192 @@
+#
+# Copyright(c) 2021 Intel Corporation
+# SPDX-License-Identifier: BSD-3-Clause-Clear
+#
+
+from time import sleep
+
+import pytest
+
+from pyocf.ocf import OcfLib
+from pyocf.types.cache import Cache, CacheMode, CleaningPolicy
+from pyocf.types.data import Data
+from pyocf.types.io import IoDir, IoOrigin, IoPriority
+from pyocf.types.shared import OcfError, OcfErrorCode
+from pyocf.types.volume import TraceDevice
+from pyocf.utils import Size, wait_for, io_to_core, start_cache_with_core
+
+BLOCK = int(Size.from_KiB(4))
+LINES = 32
+
+
+class OriginTrace:
+    """Record origin and priority of data IO submitted to device"""
+
+    def __init__(self):
+        self.data_offset = None
+        self.ios = []
+
+    def __call__(self, vol, io):
+        lib = OcfLib.getInstance()
+
+        if self.data_offset is not None and io.contents._bytes:
+            self.ios.append(
+                (
+                    IoOrigin(lib.ocf_io_get_origin(io)),
+                    IoPriority(lib.ocf_io_get_priority(io)),
+                    IoDir(io.contents._dir),
+                    int(io.contents._addr) >= self.data_offset,
+                )
+            )
+        return True
+
+    def origins(self, direction, data=True):
+        return {o for o, _, d, is_data in self.ios if d == direction and is_data == data}
+
+    def reset(self):
+        self.ios = []
+
+
+def pattern(i):
+    return bytes([i % 255 + 1]) * BLOCK
+
+
+def fill_core(core, start, count=LINES):
+    """Put data directly on core device, bypassing cache"""
+    for i in range(start, start + count):
+        core.device.data[i * BLOCK : (i + 1) * BLOCK] = pattern(i)
+
+
+def write_blocks(core, start, count=LINES):
+    for i in range(start, start + count):
+        assert io_to_core(core, i * BLOCK, Data.from_bytes(pattern(i)), IoDir.WRITE) == 0
+
+
+def read_blocks(core, start, count=LINES):
+    for i in range(start, start + count):
+        read = Data(BLOCK)
+        assert io_to_core(core, i * BLOCK, read, IoDir.READ) == 0
+        assert read.buffer[:BLOCK] == pattern(i)
+
+
+def prepare(cache_mode):
+    cache_trace = OriginTrace()
+    core_trace = OriginTrace()
+    cache, core = start_cache_with_core(
+        TraceDevice(Size.from_MiB(50), trace_fcn=cache_trace),
+        TraceDevice(Size.from_MiB(50), trace_fcn=core_trace),
+        cache_mode=cache_mode,
+    )
+
+    cache_trace.data_offset = int(cache.get_stats()["conf"]["metadata_end_offset"])
+    core_trace.data_offset = 0
+
+    return cache, core, cache_trace, core_trace
+
+
+def test_background_io_origin(pyocf_ctx):
+    """
+    Verify that IO submitted by OCF to cache and core devices is tagged with
+    its origin: user writes, backfill of read misses, cleaner reads from cache
+    and writes to core, and metadata.
+    """
+    cache, core, cache_trace, core_trace = prepare(CacheMode.WB)
+
+    write_blocks(core, 0)
+    assert cache_trace.origins(IoDir.WRITE) == {IoOrigin.USER}
+    assert core_trace.origins(IoDir.WRITE) == set()
+
+    write_blocks(core, LINES)
+    cache.flush()
+    cache_trace.reset()
+    core_trace.reset()
+
+    fill_core(core, 2 * LINES)
+    read_blocks(core, 2 * LINES)
+    assert wait_for(
+        lambda: cache.get_stats()["usage"]["occupancy"]["value"] >= 3 * LINES
+    )
+    assert core_trace.origins(IoDir.READ) == {IoOrigin.USER}
+    assert cache_trace.origins(IoDir.WRITE) == {IoOrigin.BACKFILL}
+    assert {p for o, p, _, _ in cache_trace.ios} == {IoPriority.BACKGROUND}
+
+    write_blocks(core, 0)
+    cache_trace.reset()
+    core_trace.reset()
+
+    cache.flush()
+    assert cache_trace.origins(IoDir.READ) == {IoOrigin.CLEANER}
+    assert core_trace.origins(IoDir.WRITE) == {IoOrigin.CLEANER}
+    assert cache_trace.origins(IoDir.WRITE, data=False) == {IoOrigin.METADATA}
+
+
+def test_background_io_share_skips_backfill(pyocf_ctx):
+    """
+    Keep cache device busy with user writes and verify that once backfill
+    exceeds its share, read misses are served from core without being
+    inserted into cache.
+    """
+    cache, core, cache_trace, _ = prepare(CacheMode.WT)
+    cache.set_background_io_share(1)
+
+    write_blocks(core, 0)
+    fill_core(core, LINES)
+    read_blocks(core, LINES)
+
+    stats = cache.get_stats()
+    assert stats["conf"]["background_io"]["backfill_skipped"] > 0
+    assert stats["usage"]["occupancy"]["value"] < 2 * LINES
+    assert IoOrigin.BACKFILL in cache_trace.origins(IoDir.WRITE)
+
+    read_blocks(core, LINES)
+
+
+def test_background_io_share_inactive(pyocf_ctx):
+    cache, core, _, _ = prepare(CacheMode.WT)
+
+    write_blocks(core, 0)
+    fill_core(core, LINES)
+    read_blocks(core, LINES)
+
+    assert wait_for(
+        lambda: cache.get_stats()["usage"]["occupancy"]["value"] == 2 * LINES
+    )
+    assert cache.get_stats()["conf"]["background_io"]["backfill_skipped"] == 0
+
+
+def test_background_io_share_defers_cleaner(pyocf_ctx):
+    """
+    Verify that cleaner run is postponed once cleaning exceeds its share of
+    cache device bandwidth while user IO is active, and that it proceeds
+    once user IO is gone.
+    """
+    cache, core, cache_trace, _ = prepare(CacheMode.WB)
+    cache.set_cleaning_policy(CleaningPolicy.ACP)
+    cache.set_background_io_share(1)
+
+    write_blocks(core, 0)
+    cache.run_cleaner()
+    assert IoOrigin.CLEANER in cache_trace.origins(IoDir.READ)
+    assert cache.get_stats()["conf"]["background_io"]["cleaner_deferred"] == 0
+
+    write_blocks(core, 0)
+    cache_trace.reset()
+    assert cache.run_cleaner() == 100
+    assert cache.get_stats()["conf"]["background_io"]["cleaner_deferred"] == 1
+    assert IoOrigin.CLEANER not in cache_trace.origins(IoDir.READ)
+
+    # User IO is considered inactive after two accounting windows
+    sleep(0.3)
+    cache.run_cleaner()
+    assert cache.get_stats()["conf"]["background_io"]["cleaner_deferred"] == 1
+    assert IoOrigin.CLEANER in cache_trace.origins(IoDir.READ)
+
+
+@pytest.mark.parametrize("share", [100, 1000])
+def test_background_io_share_invalid(pyocf_ctx, share):
+    cache = Cache.start_on_device(TraceDevice(Size.from_MiB(50)))
+
+    with pytest.raises(OcfError) as e:
+        cache.set_background_io_share(share)
+
+    assert e.value.error_code == OcfErrorCode.OCF_ERR_INVAL
@@ -0,0 +1,209 @@
+#
+# Copyright(c) 2021 Intel Corporation
+# SPDX-License-Identifier: BSD-3-Clause-Clear
+#
+
+import os
+
+import pytest
+
+from pyocf.types.cache import Cache, CacheMode
+from pyocf.types.core import Core
+from pyocf.types.data import Data
+from pyocf.types.io import IoDir
+from pyocf.types.shared import Compression
+from pyocf.types.volume import Volume, TraceDevice
+from pyocf.utils import Size, wait_for, io_to_core, start_cache_with_core
+
+
+class DataIoTrace:
+    def __init__(self):
+        self.data_offset = None
+        self.reads = 0
+        self.writes = 0
+
+    def __call__(self, vol, io):
+        if self.data_offset is not None and io.contents._addr >= self.data_offset:
+            if io.contents._dir == IoDir.WRITE:
+                self.writes += int(io.contents._bytes)
+            else:
+                self.reads += int(io.contents._bytes)
+        return True
+
+    def reset(self):
+        self.reads = 0
+        self.writes = 0
+
+
+def compressible(size):
+    line = b"2021-10-18 12:00:00 INFO request served from cache\n"
+    return (line * (size // len(line) + 1))[:size]
+
+
+def prepare(cache_mode, compression):
+    trace = DataIoTrace()
+    cache_device = TraceDevice(Size.from_MiB(50), trace_fcn=trace)
+    core_device = Volume(Size.from_MiB(200))
+
+    cache, core = start_cache_with_core(
+        cache_device, core_device, cache_mode=cache_mode, compression=compression
+    )
+
+    trace.data_offset = int(cache.get_stats()["conf"]["metadata_end_offset"])
+
+    return cache, core, cache_device, core_device, trace
+
+
+@pytest.mark.parametrize("compression", [Compression.RATIO_2, Compression.RATIO_4])
+def test_compression_capacity(pyocf_ctx, compression):
+    """
+    Verify that compressed cache holds compression ratio times more cache
+    lines on the same cache device.
+    """
+    cache_device = Volume(Size.from_MiB(50))
+    cache = Cache.start_on_device(cache_device)
+    lines = int(cache.get_stats()["conf"]["size"])
+    cache.stop()
+
+    cache_device = Volume(Size.from_MiB(50))
+    cache = Cache.start_on_device(cache_device, compression=compression)
+    stats = cache.get_stats()
+
+    assert stats["conf"]["compression"]["ratio"] == compression
+    assert int(stats["conf"]["size"]) > lines * (compression - 1)
+
+
+@pytest.mark.parametrize("compression", [Compression.RATIO_2, Compression.RATIO_4])
+@pytest.mark.parametrize("cache_mode", [CacheMode.WT, CacheMode.WB])
+def test_compression_write_read(pyocf_ctx, cache_mode, compression):
+    """
+    Write compressible data and verify that only its compressed size is
+    written to cache device and it's read back from cache correctly.
+    """
+    cache, core, cache_device, core_device, trace = prepare(cache_mode, compression)
+    size = int(Size.from_MiB(1))
+    data = Data.from_bytes(compressible(size))
+
+    assert io_to_core(core, 0, data, IoDir.WRITE) == 0
+    assert trace.writes == size // compression
+
+    read = Data(size)
+    assert io_to_core(core, 0, read, IoDir.READ) == 0
+    assert read.md5() == data.md5()
+    assert trace.reads == size // compression
+
+    stats = cache.get_stats()
+    assert stats["req"]["rd_hits"]["value"] == 1
+    assert int(stats["conf"]["compression"]["bytes_in"]) == size
+    assert int(stats["conf"]["compression"]["bytes_out"]) < size // compression
+
+    cache.flush()
+    assert core_device.get_bytes()[:size] == compressible(size)
+
+
+def test_compression_partial_overwrite(pyocf_ctx):
+    """
+    Overwrite parts of compressed cache lines and verify consistency of data
+    read from cache and flushed to core.
+    """
+    cache, core, cache_device, core_device, trace = prepare(
+        CacheMode.WB, Compression.RATIO_4
+    )
+    line = int(cache.get_stats()["conf"]["cache_line_size"])
+    size = line * 8
+
+    expected = bytearray(compressible(size))
+    assert io_to_core(core, 0, Data.from_bytes(bytes(expected)), IoDir.WRITE) == 0
+
+    pattern = b"\x55" * 4096
+    for offset in [line // 2, line * 3, line * 5 + 2048]:
+        expected[offset : offset + len(pattern)] = pattern
+        assert io_to_core(core, offset, Data.from_bytes(pattern), IoDir.WRITE) == 0
+
+    data = Data(size)
+    assert io_to_core(core, 0, data, IoDir.READ) == 0
+    assert data.md5() == Data.from_bytes(bytes(expected)).md5()
+
+    cache.flush()
+    assert core_device.get_bytes()[:size] == bytes(expected)
+
+
+@pytest.mark.parametrize("cache_mode", [CacheMode.WT, CacheMode.WB])
+def test_compression_incompressible(pyocf_ctx, cache_mode):
+    """
+    Write data which doesn't fit into compressed slots over cached data and
+    verify that it goes to core only and its cache lines are invalidated.
+    """
+    cache, core, cache_device, core_device, trace = prepare(cache_mode, Compression.RATIO_2)
+    size = int(Size.from_KiB(64))
+
+    assert io_to_core(core, 0, Data.from_bytes(compressible(size)), IoDir.WRITE) == 0
+    assert cache.get_stats()["usage"]["occupancy"]["value"] == size // 4096
+
+    random = os.urandom(size)
+    trace.reset()
+    assert io_to_core(core, 0, Data.from_bytes(random), IoDir.WRITE) == 0
+    assert trace.writes == 0
+    assert core_device.get_bytes()[:size] == random
+
+    stats = cache.get_stats()
+    assert stats["usage"]["occupancy"]["value"] == 0
+    assert stats["conf"]["compression"]["incompressible"] == 1
+
+    data = Data(size)
+    assert io_to_core(core, 0, data, IoDir.READ) == 0
+    assert data.md5() == Data.from_bytes(random).md5()
+
+
+def test_compression_backfill(pyocf_ctx):
+    """
+    Verify that read misses insert compressible data in compressed form and
+    incompressible data isn't inserted at all.
+    """
+    cache, core, cache_device, core_device, trace = prepare(CacheMode.PT, Compression.RATIO_2)
+    size = int(Size.from_MiB(1))
+    random = os.urandom(size)
+
+    assert io_to_core(core, 0, Data.from_bytes(compressible(size)), IoDir.WRITE) == 0
+    assert io_to_core(core, size, Data.from_bytes(random), IoDir.WRITE) == 0
+    cache.change_cache_mode(CacheMode.WT)
+
+    for offset, expected in [(0, compressible(size)), (size, random)]:
+        data = Data(size)
+        assert io_to_core(core, offset, data, IoDir.READ) == 0
+        assert data.md5() == Data.from_bytes(expected).md5()
+
+    assert wait_for(
+        lambda: cache.get_stats()["usage"]["occupancy"]["value"] == size // 4096
+    )
+    assert trace.writes == size // 2
+
+    trace.reset()
+    data = Data(size)
+    assert io_to_core(core, 0, data, IoDir.READ) == 0
+    assert data.md5() == Data.from_bytes(compressible(size)).md5()
+    assert trace.reads == size // 2
+
+
+def test_compression_load(pyocf_ctx):
+    """
+    Verify that compressed dirty data survives cache stop and load.
+    """
+    cache, core, cache_device, core_device, trace = prepare(CacheMode.WB, Compression.RATIO_4)
+    size = int(Size.from_MiB(1))
+
+    assert io_to_core(core, 0, Data.from_bytes(compressible(size)), IoDir.WRITE) == 0
+    cache.stop()
+
+    cache = Cache.load_from_device(cache_device, open_cores=False)
+    core = Core(device=core_device, try_add=True)
+    cache.add_core(core)
+
+    assert cache.get_stats()["conf"]["compression"]["ratio"] == Compression.RATIO_4
+
+    data = Data(size)
+    assert io_to_core(core, 0, data, IoDir.READ) == 0
+    assert data.md5() == Data.from_bytes(compressible(size)).md5()
+
+    cache.flush()
+    assert core_device.get_bytes()[:size] == compressible(size)
@@ -0,0 +1,315 @@
+#
+# Copyright(c) 2021 Intel Corporation
+# SPDX-License-Identifier: BSD-3-Clause-Clear
+#
+
+import os
+import struct
+
+import pytest
+
+from pyocf.types.cache import Cache, CacheMode
+from pyocf.types.core import Core
+from pyocf.types.data import Data
+from pyocf.types.io import IoDir
+from pyocf.types.shared import (
+    OcfError,
+    OcfErrorCode,
+    SeqCutOffPolicy,
+    CacheLineSize,
+    Dedup,
+)
+from pyocf.types.volume import Volume, TraceDevice
+from pyocf.utils import Size, wait_for, io_to_core
+
+
+class DataIoTrace:
+    def __init__(self):
+        self.data_offset = None
+        self.reads = 0
+        self.writes = 0
+
+    def __call__(self, vol, io):
+        if self.data_offset is not None and io.contents._addr >= self.data_offset:
+            if io.contents._dir == IoDir.WRITE:
+                self.writes += int(io.contents._bytes)
+            else:
+                self.reads += int(io.contents._bytes)
+        return True
+
+    def reset(self):
+        self.reads = 0
+        self.writes = 0
+
+
+def prepare(cache_line_size=CacheLineSize.DEFAULT, cores=2):
+    trace = DataIoTrace()
+    cache_device = TraceDevice(Size.from_MiB(50), trace_fcn=trace)
+    core_devices = [Volume(Size.from_MiB(50)) for _ in range(cores)]
+
+    cache = Cache.start_on_device(
+        cache_device,
+        cache_mode=CacheMode.PT,
+        cache_line_size=cache_line_size,
+        dedup=Dedup.FACTOR_2,
+    )
+    core_list = []
+    for i, core_device in enumerate(core_devices):
+        core = Core.using_device(core_device, name=f"core{i}")
+        cache.add_core(core)
+        core_list.append(core)
+    cache.set_seq_cut_off_policy(SeqCutOffPolicy.NEVER)
+
+    trace.data_offset = int(cache.get_stats()["conf"]["metadata_end_offset"])
+
+    return cache, core_list, cache_device, core_devices, trace
+
+
+def insert_shared(cache, cores, data, trace):
+    """Write the same data to each core in PT and read it back in WT"""
+    for core in cores:
+        assert io_to_core(core, 0, Data.from_bytes(data), IoDir.WRITE) == 0
+
+    cache.change_cache_mode(CacheMode.WT)
+
+    lines = len(data) // int(cache.get_stats()["conf"]["cache_line_size"])
+    trace.reset()
+
+    read = Data(len(data))
+    assert io_to_core(cores[0], 0, read, IoDir.READ) == 0
+    assert read.md5() == Data.from_bytes(data).md5()
+    assert wait_for(lambda: trace.writes == len(data))
+
+    for i, core in enumerate(cores[1:]):
+        read = Data(len(data))
+        assert io_to_core(core, 0, read, IoDir.READ) == 0
+        assert read.md5() == Data.from_bytes(data).md5()
+        assert wait_for(
+            lambda: cache.get_stats()["conf"]["dedup"]["hits"] == lines * (i + 1)
+        )
+
+    return lines
+
+
+def test_dedup_capacity(pyocf_ctx):
+    """
+    Verify that deduplicated cache has dedup factor times more cache lines
+    than data slots on the same cache device.
+    """
+    cache_device = Volume(Size.from_MiB(50))
+    cache = Cache.start_on_device(cache_device, dedup=Dedup.FACTOR_4)
+    stats = cache.get_stats()
+
+    slots = stats["conf"]["dedup"]["data_slots"]
+    assert stats["conf"]["dedup"]["factor"] == Dedup.FACTOR_4
+    assert int(stats["conf"]["size"]) == slots * 4
+    assert stats["conf"]["dedup"]["free_slots"] == slots
+    assert slots * 4096 < int(Size.from_MiB(50))
+
+
+def test_dedup_backfill_shared(pyocf_ctx):
+    """
+    Read identical data from two cores and verify that it's written to
+    cache device only once and read from the shared data slots.
+    """
+    cache, cores, cache_device, core_devices, trace = prepare()
+    size = int(Size.from_MiB(1))
+    data = os.urandom(size)
+
+    lines = insert_shared(cache, cores, data, trace)
+    assert trace.writes == size
+
+    stats = cache.get_stats()["conf"]["dedup"]
+    assert stats["hits"] == lines
+    assert stats["shared_slots"] == lines
+    assert stats["free_slots"] == stats["data_slots"] - lines
+
+    trace.reset()
+    read = Data(size)
+    assert io_to_core(cores[1], 0, read, IoDir.READ) == 0
+    assert read.md5() == Data.from_bytes(data).md5()
+    assert trace.reads == size
+    assert cache.get_stats()["req"]["rd_hits"]["value"] == 1
+
+
+def test_dedup_copy_on_write(pyocf_ctx):
+    """
+    Overwrite data shared by two cores on one of them and verify that the
+    other one keeps reading its original data.
+    """
+    cache, cores, cache_device, core_devices, trace = prepare()
+    size = int(Size.from_MiB(1))
+    data = os.urandom(size)
+    lines = insert_shared(cache, cores, data, trace)
+
+    cache.change_cache_mode(CacheMode.WB)
+    update = os.urandom(size // 2)
+    assert io_to_core(cores[0], 0, Data.from_bytes(update), IoDir.WRITE) == 0
+
+    stats = cache.get_stats()["conf"]["dedup"]
+    assert stats["cow"] == lines // 2
+    assert stats["shared_slots"] == lines // 2
+
+    for core, expected in [(cores[0], update + data[size // 2 :]), (cores[1], data)]:
+        read = Data(size)
+        assert io_to_core(core, 0, read, IoDir.READ) == 0
+        assert read.md5() == Data.from_bytes(expected).md5()
+
+    cache.flush()
+    assert core_devices[0].get_bytes()[:size] == update + data[size // 2 :]
+    assert core_devices[1].get_bytes()[:size] == data
+
+
+def test_dedup_partial_copy_on_write(pyocf_ctx):
+    """
+    Partially overwrite cache lines sharing data slot and verify that not
+    written part of cache line is still read correctly.
+    """
+    cache, cores, cache_device, core_devices, trace = prepare(
+        cache_line_size=CacheLineSize.LINE_16KiB
+    )
+    line = int(CacheLineSize.LINE_16KiB)
+    size = line * 8
+    data = os.urandom(size)
+    insert_shared(cache, cores, data, trace)
+
+    cache.change_cache_mode(CacheMode.WB)
+    expected = bytearray(data)
+    pattern = os.urandom(4096)
+    for offset in [line // 2, line * 3, line * 5 + 2048]:
+        expected[offset : offset + len(pattern)] = pattern
+        assert io_to_core(cores[0], offset, Data.from_bytes(pattern), IoDir.WRITE) == 0
+
+    assert cache.get_stats()["conf"]["dedup"]["cow"] == 3
+
+    for core, result in [(cores[0], bytes(expected)), (cores[1], data)]:
+        read = Data(size)
+        assert io_to_core(core, 0, read, IoDir.READ) == 0
+        assert read.md5() == Data.from_bytes(result).md5()
+
+    cache.flush()
+    assert core_devices[0].get_bytes()[:size] == bytes(expected)
+
+
+def test_dedup_load(pyocf_ctx):
+    """
+    Verify that shared data slots and dirty data written over them survive
+    cache stop and load.
+    """
+    cache, cores, cache_device, core_devices, trace = prepare()
+    size = int(Size.from_MiB(1))
+    data = os.urandom(size)
+    lines = insert_shared(cache, cores, data, trace)
+
+    cache.change_cache_mode(CacheMode.WB)
+    update = os.urandom(size // 4)
+    assert io_to_core(cores[1], 0, Data.from_bytes(update), IoDir.WRITE) == 0
+    cache.stop()
+
+    cache = Cache.load_from_device(cache_device, open_cores=False)
+    for i, core_device in enumerate(core_devices):
+        cache.add_core(Core(device=core_device, try_add=True, name=f"core{i}"))
+    cores = cache.cores
+
+    stats = cache.get_stats()["conf"]["dedup"]
+    assert stats["factor"] == Dedup.FACTOR_2
+    assert stats["shared_slots"] == lines - lines // 4
+    assert stats["free_slots"] == stats["data_slots"] - lines - lines // 4
+
+    for core, expected in [(cores[0], data), (cores[1], update + data[size // 4 :])]:
+        read = Data(size)
+        assert io_to_core(core, 0, read, IoDir.READ) == 0
+        assert read.md5() == Data.from_bytes(expected).md5()
+
+    cache.flush()
+    assert core_devices[1].get_bytes()[:size] == update + data[size // 4 :]
+
+
+MASK64 = (1 << 64) - 1
+FP_C1 = 0x87C37B91114253D5
+FP_C2 = 0x4CF5AD432745937F
+
+
+def rotl64(x, r):
+    return ((x << r) | (x >> (64 - r))) & MASK64
+
+
+def fingerprint_blocks(data, h1=0, h2=0):
+    """MurmurHash3 x64 128 body, as used for cache line fingerprints"""
+    for i in range(0, len(data), 16):
+        b1, b2 = struct.unpack_from("<QQ", data, i)
+        h1 ^= rotl64(b1 * FP_C1 & MASK64, 31) * FP_C2 & MASK64
+        h1 = ((rotl64(h1, 27) + h2) * 5 + 0x52DCE729) & MASK64
+        h2 ^= rotl64(b2 * FP_C2 & MASK64, 33) * FP_C1 & MASK64
+        h2 = ((rotl64(h2, 31) + h1) * 5 + 0x38495AB5) & MASK64
+    return h1, h2
+
+
+def colliding_line(line):
+    """
+    Return different data with the same fingerprint. MurmurHash3 is not
+    collision resistant: state after any block can be steered to any value
+    by the following block, so the second block is picked to bring state
+    back to the one of original data.
+    """
+    inv5 = pow(5, -1, 1 << 64)
+    target = fingerprint_blocks(line[:32])
+    first = bytes(b ^ 0xFF for b in line[:16])
+    h1, h2 = fingerprint_blocks(first)
+
+    k1 = rotl64(((target[0] - 0x52DCE729) * inv5 - h2) & MASK64, 64 - 27) ^ h1
+    k2 = rotl64(((target[1] - 0x38495AB5) * inv5 - target[0]) & MASK64, 64 - 31) ^ h2
+    b1 = rotl64(k1 * pow(FP_C2, -1, 1 << 64) & MASK64, 64 - 31)
+    b1 = b1 * pow(FP_C1, -1, 1 << 64) & MASK64
+    b2 = rotl64(k2 * pow(FP_C1, -1, 1 << 64) & MASK64, 64 - 33)
+    b2 = b2 * pow(FP_C2, -1, 1 << 64) & MASK64
+
+    collision = first + struct.pack("<QQ", b1, b2) + line[32:]
+    assert fingerprint_blocks(collision) == fingerprint_blocks(line)
+    return collision
+
+
+def test_dedup_fingerprint_collision(pyocf_ctx):
+    """
+    Read data with the same fingerprint as data already in cache and verify
+    that it doesn't share data slot with it, as it's different.
+    """
+    cache, cores, cache_device, core_devices, trace = prepare()
+    line = int(cache.get_stats()["conf"]["cache_line_size"])
+    lines = 4
+    data = os.urandom(line * lines)
+    collision = b"".join(
+        colliding_line(data[i : i + line]) for i in range(0, len(data), line)
+    )
+
+    assert io_to_core(cores[0], 0, Data.from_bytes(data), IoDir.WRITE) == 0
+    assert io_to_core(cores[1], 0, Data.from_bytes(collision), IoDir.WRITE) == 0
+    cache.change_cache_mode(CacheMode.WT)
+    trace.reset()
+
+    for i, expected in enumerate([data, collision]):
+        read = Data(len(data))
+        assert io_to_core(cores[i], 0, read, IoDir.READ) == 0
+        assert read.md5() == Data.from_bytes(expected).md5()
+        assert wait_for(lambda: trace.writes == len(data) * (i + 1))
+
+    stats = cache.get_stats()["conf"]["dedup"]
+    assert stats["collisions"] == lines
+    assert stats["hits"] == 0
+    assert stats["shared_slots"] == 0
+
+    for core, expected in [(cores[0], data), (cores[1], collision)]:
+        read = Data(len(data))
+        assert io_to_core(core, 0, read, IoDir.READ) == 0
+        assert read.md5() == Data.from_bytes(expected).md5()
+    assert cache.get_stats()["req"]["rd_hits"]["value"] == 2
+
+
+def test_dedup_trim_not_supported(pyocf_ctx):
+    cache_device = Volume(Size.from_MiB(50))
+    cache = Cache.start_on_device(cache_device, dedup=Dedup.FACTOR_2)
+
+    with pytest.raises(OcfError) as e:
+        cache.set_trim_rate(100)
+
+    assert e.value.error_code == OcfErrorCode.OCF_ERR_NOT_SUPP
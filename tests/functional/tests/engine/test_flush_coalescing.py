@@ -0,0 +1,149 @@
+#
+# Copyright(c) 2021 Intel Corporation
+# SPDX-License-Identifier: BSD-3-Clause-Clear
+#
+
+from ctypes import c_int
+from time import sleep
+
+from pyocf.types.cache import Cache
+from pyocf.types.core import Core
+from pyocf.types.data import Data
+from pyocf.types.io import IoDir
+from pyocf.types.shared import OcfCompletion, OcfErrorCode
+from pyocf.types.volume import TraceDevice, HoldTrace
+from pyocf.utils import Size, wait_for
+
+
+class FlushTraceDevice(TraceDevice):
+    """Trace also flushes submitted by OCF directly to volume"""
+
+    def submit_flush(self, flush):
+        if self.trace_fcn(self, flush):
+            super().submit_flush(flush)
+
+
+def submit_flush(core):
+    io = core.new_io(core.cache.get_default_queue(), 0, 0, IoDir.WRITE, 0, 0)
+    io.set_data(Data(0))
+
+    completion = OcfCompletion([("err", c_int)])
+    io.callback = completion.callback
+    io.submit_flush()
+
+    return completion
+
+
+def prepare(cores):
+    cache_trace = HoldTrace(flush=True)
+    core_traces = [HoldTrace(flush=True, hold=True) for _ in range(cores)]
+    cache = Cache.start_on_device(
+        TraceDevice(Size.from_MiB(50), trace_fcn=cache_trace)
+    )
+
+    core_list = []
+    for i, trace in enumerate(core_traces):
+        core = Core.using_device(
+            TraceDevice(Size.from_MiB(50), trace_fcn=trace), name=f"core{i}"
+        )
+        cache.add_core(core)
+        core_list.append(core)
+
+    return cache, core_list, cache_trace, core_traces
+
+
+def test_flush_coalescing(pyocf_ctx):
+    """
+    Submit flushes while device flush is in progress and verify that they
+    are all served by single generation of device flushes issued once the
+    previous one has completed.
+    """
+    cache, cores, cache_trace, core_traces = prepare(cores=1)
+    trace = core_traces[0]
+
+    first = submit_flush(cores[0])
+    assert wait_for(lambda: trace.count == 1)
+
+    waiting = [submit_flush(cores[0]) for _ in range(8)]
+    sleep(0.1)
+    assert trace.count == 1
+    assert cache_trace.count == 1
+
+    trace.release()
+    first.wait()
+    assert first.results["err"] == 0
+    assert wait_for(lambda: trace.count == 2)
+    assert cache_trace.count == 2
+    assert not any(c.e.is_set() for c in waiting)
+
+    trace.release()
+    for c in waiting:
+        c.wait()
+        assert c.results["err"] == 0
+
+    assert trace.count == 2
+    assert cache_trace.count == 2
+
+
+def test_flush_coalescing_cores(pyocf_ctx):
+    """
+    Verify that generation flushes each core device with pending flush once
+    and cache device once, and that core device flush error is reported only
+    to flushes of that core.
+    """
+    cache, cores, cache_trace, core_traces = prepare(cores=3)
+
+    first = submit_flush(cores[2])
+    assert wait_for(lambda: core_traces[2].count == 1)
+
+    waiting = [submit_flush(core) for core in cores[:2] for _ in range(4)]
+    sleep(0.1)
+
+    core_traces[2].release()
+    first.wait()
+    assert wait_for(lambda: all(t.count == 1 for t in core_traces[:2]))
+    assert cache_trace.count == 2
+
+    core_traces[0].release(-OcfErrorCode.OCF_ERR_IO)
+    core_traces[1].release()
+    for i, c in enumerate(waiting):
+        c.wait()
+        assert (c.results["err"] != 0) == (i < 4)
+
+    assert [t.count for t in core_traces] == [1, 1, 1]
+    assert cache_trace.count == 2
+
+
+def test_flush_coalescing_metadata_volume(pyocf_ctx):
+    """
+    Verify that generation flushes separate metadata volume too and flush
+    completes only once metadata volume flush has completed.
+    """
+    cache_trace = HoldTrace(flush=True)
+    metadata_trace = HoldTrace(flush=True)
+    core_trace = HoldTrace(flush=True)
+    cache = Cache.start_on_device(
+        TraceDevice(Size.from_MiB(50), trace_fcn=cache_trace),
+        metadata_device=FlushTraceDevice(Size.from_MiB(50), trace_fcn=metadata_trace),
+    )
+    core = Core.using_device(TraceDevice(Size.from_MiB(50), trace_fcn=core_trace))
+    cache.add_core(core)
+
+    metadata_trace.count = 0
+    metadata_trace.hold = True
+    cache_flushes = cache_trace.count
+
+    flush = submit_flush(core)
+    assert wait_for(lambda: cache_trace.count == cache_flushes + 1)
+    assert core_trace.count == 1
+    sleep(0.1)
+    metadata_flushes = metadata_trace.count
+    completed = flush.e.is_set()
+
+    metadata_trace.hold = False
+    metadata_trace.release(-OcfErrorCode.OCF_ERR_IO)
+    flush.wait()
+
+    assert metadata_flushes == 1
+    assert not completed
+    assert flush.results["err"] != 0
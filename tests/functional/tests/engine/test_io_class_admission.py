@@ -0,0 +1,189 @@
+#
+# Copyright(c) 2021 Intel Corporation
+# SPDX-License-Identifier: BSD-3-Clause-Clear
+#
+
+import pytest
+
+from pyocf.types.cache import CacheMode, NhitParams, PromotionPolicy
+from pyocf.types.data import Data
+from pyocf.types.io import IoDir
+from pyocf.types.ioclass import IoClassPromotion
+from pyocf.types.shared import OcfError, OcfErrorCode
+from pyocf.types.volume import Volume
+from pyocf.utils import Size, io_to_core, start_cache_with_core
+
+BLOCK = int(Size.from_KiB(4))
+LINES = 16
+
+SCAN_CLASS = 1
+HOT_CLASS = 2
+
+
+def write_to_class(core, address, io_class):
+    data = Data.from_bytes(bytes([io_class + 1]) * BLOCK)
+    assert io_to_core(core, address, data, IoDir.WRITE, io_class=io_class) == 0
+
+
+def class_occupancy(cache, io_class):
+    return cache.get_partition_info(part_id=io_class)["_curr_size"]
+
+
+def prepare(promotion_policy=PromotionPolicy.ALWAYS):
+    cache, core = start_cache_with_core(
+        Volume(Size.from_MiB(50)),
+        Volume(Size.from_MiB(50)),
+        cache_mode=CacheMode.WT,
+        promotion_policy=promotion_policy,
+    )
+
+    return cache, core
+
+
+def nhit(insertion_threshold, trigger_threshold=0):
+    return IoClassPromotion(
+        _enabled=True,
+        _policy=PromotionPolicy.NHIT,
+        _nhit_insertion_threshold=insertion_threshold,
+        _nhit_trigger_threshold=trigger_threshold,
+    )
+
+
+def test_io_class_nhit_override(pyocf_ctx):
+    """
+    Verify that IO class with nhit promotion override is inserted into cache
+    only after core line is accessed insertion threshold times, while other
+    IO class follows cache 'always' promotion policy.
+    """
+    insertion_threshold = 3
+    cache, core = prepare()
+
+    cache.configure_partition(
+        part_id=SCAN_CLASS,
+        name="scan",
+        max_size=100,
+        priority=1,
+        promotion=nhit(insertion_threshold),
+    )
+    cache.configure_partition(part_id=HOT_CLASS, name="hot", max_size=100, priority=1)
+
+    info = cache.get_partition_info(part_id=SCAN_CLASS)
+    assert info["_promotion"]._enabled
+    assert info["_promotion"]._policy == PromotionPolicy.NHIT
+    assert info["_promotion"]._nhit_insertion_threshold == insertion_threshold
+
+    for i in range(LINES):
+        write_to_class(core, i * BLOCK, HOT_CLASS)
+    assert class_occupancy(cache, HOT_CLASS) == LINES
+
+    address = LINES * BLOCK
+    for _ in range(insertion_threshold - 1):
+        write_to_class(core, address, SCAN_CLASS)
+    assert class_occupancy(cache, SCAN_CLASS) == 0
+
+    write_to_class(core, address, SCAN_CLASS)
+    assert class_occupancy(cache, SCAN_CLASS) == 1
+
+    # Default nhit parameters of cache are not affected by IO class override
+    assert (
+        cache.get_promotion_policy_param(
+            PromotionPolicy.NHIT, NhitParams.INSERTION_THRESHOLD
+        )
+        != insertion_threshold
+    )
+
+
+def test_io_class_always_override(pyocf_ctx):
+    """
+    Verify that IO class with 'always' promotion override is inserted into
+    cache on first access, while default IO class follows cache nhit policy.
+    """
+    cache, core = prepare(PromotionPolicy.NHIT)
+    cache.set_promotion_policy_param(
+        PromotionPolicy.NHIT, NhitParams.TRIGGER_THRESHOLD, 0
+    )
+
+    cache.configure_partition(
+        part_id=HOT_CLASS,
+        name="hot",
+        max_size=100,
+        priority=1,
+        promotion=IoClassPromotion(_enabled=True, _policy=PromotionPolicy.ALWAYS),
+    )
+
+    for i in range(LINES):
+        write_to_class(core, i * BLOCK, 0)
+        write_to_class(core, (LINES + i) * BLOCK, HOT_CLASS)
+
+    assert class_occupancy(cache, 0) == 0
+    assert class_occupancy(cache, HOT_CLASS) == LINES
+
+    # IO class override keeps working after cache policy is switched
+    cache.set_promotion_policy(PromotionPolicy.ALWAYS)
+    cache.configure_partition(
+        part_id=SCAN_CLASS,
+        name="scan",
+        max_size=100,
+        priority=1,
+        promotion=nhit(2),
+    )
+    write_to_class(core, 2 * LINES * BLOCK, SCAN_CLASS)
+    assert class_occupancy(cache, SCAN_CLASS) == 0
+    write_to_class(core, 2 * LINES * BLOCK, SCAN_CLASS)
+    assert class_occupancy(cache, SCAN_CLASS) == 1
+
+
+def test_io_class_seq_cutoff_threshold(pyocf_ctx):
+    """
+    Verify that sequential stream of IO class with its own sequential cutoff
+    threshold is sent to pass-through once threshold is exceeded, even though
+    sequential cutoff is disabled for core.
+    """
+    cache, core = prepare()
+
+    cache.configure_partition(
+        part_id=SCAN_CLASS,
+        name="scan",
+        max_size=100,
+        priority=1,
+        seq_cutoff_threshold=4 * BLOCK,
+    )
+    cache.configure_partition(part_id=HOT_CLASS, name="hot", max_size=100, priority=1)
+    assert (
+        cache.get_partition_info(part_id=SCAN_CLASS)["_seq_cutoff_threshold"]
+        == 4 * BLOCK
+    )
+
+    for i in range(LINES):
+        write_to_class(core, i * BLOCK, SCAN_CLASS)
+        write_to_class(core, (LINES + i) * BLOCK, HOT_CLASS)
+
+    assert class_occupancy(cache, SCAN_CLASS) < LINES
+    assert class_occupancy(cache, HOT_CLASS) == LINES
+    assert cache.get_stats()["req"]["wr_pt"]["value"] > 0
+
+
+@pytest.mark.parametrize(
+    "promotion,seq_cutoff_threshold",
+    [
+        (IoClassPromotion(_enabled=True, _policy=2), 0),
+        (nhit(1), 0),
+        (nhit(1001), 0),
+        (nhit(2, 101), 0),
+        (None, 4294841345),
+    ],
+)
+def test_io_class_admission_invalid(pyocf_ctx, promotion, seq_cutoff_threshold):
+    cache, _ = prepare()
+
+    with pytest.raises(OcfError) as e:
+        cache.configure_partition(
+            part_id=SCAN_CLASS,
+            name="scan",
+            max_size=100,
+            priority=1,
+            promotion=promotion,
+            seq_cutoff_threshold=seq_cutoff_threshold,
+        )
+
+    assert e.value.error_code == OcfErrorCode.OCF_ERR_INVAL
@@ -0,0 +1,91 @@
+#
+# Copyright(c) 2021 Intel Corporation
+# SPDX-License-Identifier: BSD-3-Clause-Clear
+#
+
+import random
+
+import pytest
+
+from pyocf.types.cache import Cache, CacheMode
+from pyocf.types.core import Core
+from pyocf.types.volume import Volume
+from pyocf.types.data import Data
+from pyocf.types.io import IoDir
+from pyocf.types.queue import Queue
+from pyocf.utils import Size, io_to_core
+from pyocf.types.shared import OcfError
+
+
+@pytest.mark.parametrize("cache_mode", [CacheMode.WT, CacheMode.WB, CacheMode.WO])
+def test_io_split(pyocf_ctx, cache_mode):
+    """
+    Write and read back requests large enough to be split into several
+    sub-requests, some of them not aligned to cache line, and verify that
+    data is consistent.
+    """
+    cache_device = Volume(Size.from_MiB(50))
+    core_device = Volume(Size.from_MiB(50))
+
+    cache = Cache.start_on_device(cache_device, cache_mode=cache_mode)
+    core = Core.using_device(core_device)
+    cache.add_core(core)
+
+    cache.set_io_split(8)
+
+    seed = random.randrange(2 ** 32)
+    random.seed(seed)
+
+    size = Size.from_KiB(512)
+    pattern = bytes(random.getrandbits(8) for _ in range(int(size)))
+
+    for offset in [0, 512, Size.from_KiB(3)]:
+        data = Data.from_bytes(pattern)
+        assert io_to_core(core, int(offset), data, IoDir.WRITE) == 0, seed
+
+        data = Data(int(size))
+        assert io_to_core(core, int(offset), data, IoDir.READ) == 0, seed
+        assert data.md5() == Data.from_bytes(pattern).md5(), seed
+
+    stats = cache.get_stats()
+    assert stats["req"]["rd_total"]["value"] > 3
+
+
+def check_split_io(core, queue):
+    pattern = bytes(i % 255 + 1 for i in range(int(Size.from_KiB(512))))
+    size = len(pattern)
+
+    data = Data.from_bytes(pattern)
+    assert io_to_core(core, 0, data, IoDir.WRITE, queue) == 0
+
+    data = Data(size)
+    assert io_to_core(core, 0, data, IoDir.READ, queue) == 0
+    assert data.md5() == Data.from_bytes(pattern).md5()
+
+
+def test_io_split_multiple_queues(pyocf_ctx):
+    """
+    Verify that sub-requests spread across several I/O queues complete
+    correctly regardless of queue request was submitted to.
+    """
+    cache = Cache.start_on_device(Volume(Size.from_MiB(50)), cache_mode=CacheMode.WB)
+    core = Core.using_device(Volume(Size.from_MiB(50)))
+    cache.add_core(core)
+
+    cache.io_queues += [Queue(cache, f"io{i}-{cache.get_name()}") for i in range(3)]
+    cache.set_io_split(8)
+
+    for queue in cache.io_queues:
+        check_split_io(core, queue)
+
+
+def test_io_split_invalid(pyocf_ctx):
+    """
+    Verify that split size smaller than allowed minimum is rejected.
+    """
+    cache = Cache.start_on_device(Volume(Size.from_MiB(50)))
+
+    with pytest.raises(OcfError):
+        cache.set_io_split(1)
+
+    cache.set_io_split(0)
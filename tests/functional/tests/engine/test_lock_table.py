@@ -0,0 +1,130 @@
+#
+# Copyright(c) 2021 Intel Corporation
+# SPDX-License-Identifier: BSD-3-Clause-Clear
+#
+
+from time import sleep
+
+import pytest
+
+from pyocf.types.cache import Cache, CacheMode
+from pyocf.types.core import Core
+from pyocf.types.data import Data
+from pyocf.types.io import IoDir
+from pyocf.types.shared import OcfError, OcfErrorCode
+from pyocf.types.volume import TraceDevice, Volume, HoldTrace
+from pyocf.utils import Size, wait_for, submit_io
+
+SLOTS = 1024
+IO_SIZE = int(Size.from_MiB(1))
+IO_COUNT = 4
+# Request spanning more cache lines than there are lock slots
+LARGE_IO_SIZE = int(Size.from_MiB(6))
+
+
+def pattern(i, seed, size=IO_SIZE):
+    return bytes([(i + seed) & 0xFF]) * size
+
+
+@pytest.mark.parametrize("cache_mode", [CacheMode.WT, CacheMode.WB])
+def test_lock_table_striped(pyocf_ctx, cache_mode):
+    """
+    Start cache with striped cache line lock table much smaller than number
+    of cache lines and run concurrent multi cache line requests, so that
+    cache lines of the same request as well as of different requests share
+    lock slots. Verify that all requests complete and data is consistent.
+    """
+    cache_device = Volume(Size.from_MiB(50))
+    core_device = Volume(Size.from_MiB(50))
+
+    cache = Cache.start_on_device(
+        cache_device, cache_mode=cache_mode, cache_line_lock_slots=SLOTS
+    )
+    core = Core.using_device(core_device)
+    cache.add_core(core)
+
+    assert cache.get_stats()["conf"]["lock_table"]["slots"] == SLOTS
+
+    size = LARGE_IO_SIZE
+    for seed in range(3):
+        completions = [
+            submit_io(core, i * size, Data.from_bytes(pattern(i, seed, size)), IoDir.WRITE)
+            for i in range(IO_COUNT)
+        ]
+        reads = [Data(size) for _ in range(IO_COUNT)]
+        completions += [
+            submit_io(core, i * size, reads[i], IoDir.READ) for i in range(IO_COUNT)
+        ]
+
+        for c in completions:
+            c.wait()
+            assert c.results["err"] == 0
+
+        for i in range(IO_COUNT):
+            read = Data(size)
+            c = submit_io(core, i * size, read, IoDir.READ)
+            c.wait()
+            assert c.results["err"] == 0
+            assert read.buffer[:size] == pattern(i, seed, size)
+
+    stats = cache.get_stats()["conf"]["lock_table"]
+    assert stats["busy"] == 0
+
+
+def test_lock_table_collisions(pyocf_ctx):
+    """
+    Keep write locks of many cache lines held by in flight write and verify
+    that read of other cache lines sharing lock slots with them waits until
+    the write completes and that such collisions are accounted.
+    """
+    cache_trace = HoldTrace(IoDir.WRITE)
+    cache = Cache.start_on_device(
+        TraceDevice(Size.from_MiB(50), trace_fcn=cache_trace),
+        cache_mode=CacheMode.WT,
+        cache_line_lock_slots=SLOTS,
+    )
+    core = Core.using_device(Volume(Size.from_MiB(50)))
+    cache.add_core(core)
+
+    cache_trace.data_offset = int(cache.get_stats()["conf"]["metadata_end_offset"])
+
+    # Cache lines are mapped in order of insertion, so lines of the last
+    # region are mapped SLOTS cache lines after lines of the first one
+    regions = SLOTS * 4096 // IO_SIZE + 1
+    for i in range(regions):
+        c = submit_io(core, i * IO_SIZE, Data.from_bytes(pattern(i, 0)), IoDir.WRITE)
+        c.wait()
+        assert c.results["err"] == 0
+
+    cache_trace.hold = True
+    write = submit_io(core, 0, Data.from_bytes(pattern(0, 1)), IoDir.WRITE)
+    assert wait_for(lambda: cache_trace.held)
+
+    read = Data(IO_SIZE)
+    c = submit_io(core, (regions - 1) * IO_SIZE, read, IoDir.READ)
+    sleep(0.1)
+    assert not c.e.is_set()
+    assert cache.get_stats()["conf"]["lock_table"]["collisions"] > 0
+
+    cache_trace.hold = False
+    cache_trace.release()
+    write.wait()
+    assert write.results["err"] == 0
+    c.wait()
+    assert c.results["err"] == 0
+    assert read.buffer[:IO_SIZE] == pattern(regions - 1, 0)
+
+
+def test_lock_table_default(pyocf_ctx):
+    cache = Cache.start_on_device(Volume(Size.from_MiB(50)))
+
+    stats = cache.get_stats()["conf"]["lock_table"]
+    assert stats["slots"] == 0
+    assert stats["collisions"] == 0
+
+
+def test_lock_table_invalid_slots(pyocf_ctx):
+    with pytest.raises(OcfError) as e:
+        Cache.start_on_device(Volume(Size.from_MiB(50)), cache_line_lock_slots=SLOTS - 1)
+
+    assert e.value.error_code == OcfErrorCode.OCF_ERR_INVAL
@@ -0,0 +1,71 @@
+#
+# Copyright(c) 2021 Intel Corporation
+# SPDX-License-Identifier: BSD-3-Clause-Clear
+#
+
+
+from pyocf.types.cache import Cache, CacheMode
+from pyocf.types.core import Core
+from pyocf.types.data import Data
+from pyocf.types.io import IoDir
+from pyocf.types.volume import TraceDevice, HoldTrace
+from pyocf.utils import Size, wait_for, submit_io
+
+BLOCK = int(Size.from_KiB(4))
+READERS = 8
+
+
+def test_lock_wait_batch(pyocf_ctx):
+    """
+    Make read requests wait for write lock of cache line held by in flight
+    write and verify that they are all resumed in single batch once the
+    write completes and that lock wait statistics account for them.
+    """
+    cache_trace = HoldTrace(IoDir.WRITE)
+    cache = Cache.start_on_device(
+        TraceDevice(Size.from_MiB(50), trace_fcn=cache_trace),
+        cache_mode=CacheMode.WT,
+    )
+    core_device = TraceDevice(Size.from_MiB(50))
+    core = Core.using_device(core_device)
+    cache.add_core(core)
+
+    cache_trace.data_offset = int(cache.get_stats()["conf"]["metadata_end_offset"])
+
+    old = Data.from_bytes(b"\xaa" * BLOCK)
+    new = Data.from_bytes(b"\x55" * BLOCK)
+    completion = submit_io(core, 0, old, IoDir.WRITE)
+    completion.wait()
+    assert completion.results["err"] == 0
+
+    stats = cache.get_stats()["conf"]["lock_wait"]
+    assert stats["waiting"] == 0
+    resumed = stats["resumed"]
+    batches = stats["batches"]
+
+    cache_trace.hold = True
+    write = submit_io(core, 0, new, IoDir.WRITE)
+    assert wait_for(lambda: len(cache_trace.held) == 1)
+
+    reads = [Data(BLOCK) for _ in range(READERS)]
+    completions = [submit_io(core, 0, data, IoDir.READ) for data in reads]
+    assert wait_for(
+        lambda: cache.get_stats()["conf"]["lock_wait"]["waiting"] == READERS
+    )
+    assert not any(c.e.is_set() for c in completions)
+
+    cache_trace.hold = False
+    cache_trace.release()
+    write.wait()
+    assert write.results["err"] == 0
+
+    for c, data in zip(completions, reads):
+        c.wait()
+        assert c.results["err"] == 0
+        assert data.buffer[:BLOCK] == new.buffer[:BLOCK]
+
+    stats = cache.get_stats()["conf"]["lock_wait"]
+    assert stats["waiting"] == 0
+    assert stats["resumed"] - resumed == READERS
+    assert stats["batches"] - batches == 1
+    assert stats["wait_time"] > 0
@@ -0,0 +1,79 @@
+#
+# Copyright(c) 2021 Intel Corporation
+# SPDX-License-Identifier: BSD-3-Clause-Clear
+#
+
+import gc
+
+import pytest
+
+from pyocf.ocf import OcfLib
+from pyocf.types.cache import CacheMode, CleaningPolicy
+from pyocf.types.ctx import OcfCtx
+from pyocf.types.data import Data
+from pyocf.types.io import IoDir
+from pyocf.types.logger import DefaultLogger, LogLevel
+from pyocf.types.reactor import Reactor, ReactorCleaner, ReactorQueue
+from pyocf.types.volume import Volume
+from pyocf.utils import Size, wait_for, io_to_core, start_cache_with_core
+
+BLOCK = int(Size.from_KiB(4))
+LINES = 64
+
+
+@pytest.fixture()
+def reactor_ctx():
+    """Context running cleaners on reactors. Reactors created by test are
+    destroyed after caches are stopped."""
+    c = OcfCtx(
+        OcfLib.getInstance(),
+        b"PyOCF reactor ctx",
+        DefaultLogger(LogLevel.WARN),
+        Data,
+        ReactorCleaner,
+    )
+    c.register_volume_type(Volume)
+    c.reactors = []
+    yield c
+    c.exit()
+    for reactor in c.reactors:
+        reactor.destroy()
+    gc.collect()
+
+
+def pattern(i):
+    return bytes([i % 255 + 1]) * BLOCK
+
+
+def test_reactor_io_and_cleaning(reactor_ctx):
+    """
+    Start cache while the only reactor has no queue of this cache, so that
+    cleaner is bound to it at attach, then serve IO from queue of another
+    reactor. Verify that IO completes and that cleaner follows the queue
+    and flushes dirty data to core.
+    """
+    first = Reactor("ocf_reactor0")
+    reactor_ctx.reactors.append(first)
+
+    cache, core = start_cache_with_core(
+        Volume(Size.from_MiB(50)), Volume(Size.from_MiB(50)), cache_mode=CacheMode.WB
+    )
+    cache.set_cleaning_policy(CleaningPolicy.ACP)
+
+    second = Reactor("ocf_reactor1")
+    reactor_ctx.reactors.append(second)
+    queue = ReactorQueue(second, cache)
+
+    for i in range(LINES):
+        assert io_to_core(core, i * BLOCK, Data.from_bytes(pattern(i)), IoDir.WRITE, queue) == 0
+
+    for i in range(LINES):
+        read = Data(BLOCK)
+        assert io_to_core(core, i * BLOCK, read, IoDir.READ, queue) == 0
+        assert read.buffer[:BLOCK] == pattern(i)
+
+    assert cache.get_stats()["usage"]["dirty"]["value"] > 0
+
+    assert wait_for(lambda: cache.get_stats()["usage"]["dirty"]["value"] == 0, timeout=10)
+    for i in range(LINES):
+        assert core.device.data[i * BLOCK : (i + 1) * BLOCK] == pattern(i)
@@ -408,3 +408,56 @@ def test_read_data_consistency(pyocf_ctx, cacheline_size, cache_mode, rand_seed)
                 ), "unexpected write to core device, region_state={}, start={}, end={}, insert_order = {}\n".format(
                     region_state, start, end, insert_order
                 )
+
+
+def test_read_partial_hit(pyocf_ctx):
+    """
+    Read cache line with only some sectors valid and verify that valid
+    sectors are served from cache while only the gaps are read from core.
+    """
+    cacheline_size = CacheLineSize.LINE_64KiB
+    cache_device = Volume(Size.from_MiB(50))
+    core_device = Volume(Size.from_MiB(50))
+
+    cache = Cache.start_on_device(
+        cache_device, cache_mode=CacheMode.WT, cache_line_size=cacheline_size
+    )
+    core = Core.using_device(core_device)
+    cache.add_core(core)
+
+    core_data = bytes([0xAA]) * cacheline_size
+    cache_data = bytes([0xBB]) * Size.from_KiB(4).B
+    stale_data = bytes([0xCC]) * Size.from_KiB(4).B
+    offset = Size.from_KiB(4).B
+
+    assert 0 == io_to_core(core, 0, len(core_data), core_data, 0, IoDir.WRITE)
+
+    # make sectors 8-15 of the cache line valid
+    assert 0 == io_to_exp_obj(
+        core, offset, len(cache_data), cache_data, 0, IoDir.WRITE
+    )
+
+    # modify core behind the cache back - valid sectors must not be read
+    # from core
+    assert 0 == io_to_core(core, offset, len(stale_data), stale_data, 0, IoDir.WRITE)
+
+    core_device.reset_stats()
+
+    result_b = bytes(cacheline_size)
+    assert 0 == io_to_exp_obj(core, 0, cacheline_size, result_b, 0, IoDir.READ)
+
+    expected = (
+        core_data[:offset]
+        + cache_data
+        + core_data[offset + len(cache_data):]
+    )
+    assert result_b == expected
+
+    # two gaps around valid sectors are read from core
+    assert core_device.get_stats()[IoDir.READ] == 2
+
+    # whole cache line is valid now
+    core_device.reset_stats()
+    assert 0 == io_to_exp_obj(core, 0, cacheline_size, result_b, 0, IoDir.READ)
+    assert result_b == expected
+    assert core_device.get_stats()[IoDir.READ] == 0
@@ -0,0 +1,138 @@
+#
+# Copyright(c) 2021 Intel Corporation
+# SPDX-License-Identifier: BSD-3-Clause-Clear
+#
+
+from time import sleep
+
+import pytest
+
+from pyocf.types.cache import Cache, CacheMode
+from pyocf.types.data import Data
+from pyocf.types.io import IoDir
+from pyocf.types.shared import OcfError, OcfErrorCode
+from pyocf.types.volume import TraceDevice, Volume, HoldTrace
+from pyocf.utils import Size, wait_for, io_to_core, start_cache_with_core, submit_io
+
+BLOCK = int(Size.from_KiB(4))
+LINES = 128
+PERCENTILE = 990
+
+
+def pattern(i):
+    # Avoid all-zero blocks, which are served without cache device read
+    return bytes([i % 255 + 1]) * BLOCK
+
+
+def prepare(cache_mode):
+    cache_trace = HoldTrace(IoDir.READ)
+    cache, core = start_cache_with_core(
+        TraceDevice(Size.from_MiB(50), trace_fcn=cache_trace),
+        Volume(Size.from_MiB(50)),
+        cache_mode=cache_mode,
+    )
+
+    cache_trace.data_offset = int(cache.get_stats()["conf"]["metadata_end_offset"])
+
+    for i in range(LINES):
+        assert io_to_core(core, i * BLOCK, Data.from_bytes(pattern(i)), IoDir.WRITE) == 0
+
+    return cache, core, cache_trace
+
+
+def collect_latency(core):
+    for i in range(LINES):
+        read = Data(BLOCK)
+        assert io_to_core(core, i * BLOCK, read, IoDir.READ) == 0
+        assert read.buffer[:BLOCK] == pattern(i)
+
+
+def test_read_hedge_stuck_cache_read(pyocf_ctx):
+    """
+    Learn cache read latency, then hold cache read of clean hit and verify
+    that once its deadline expires, the request is completed by hedged core
+    read with correct data, while held cache read completes later without
+    affecting the request.
+    """
+    cache, core, cache_trace = prepare(CacheMode.WT)
+    cache.set_read_hedge_percentile(PERCENTILE)
+
+    collect_latency(core)
+
+    stats = cache.get_stats()["conf"]["hedging"]
+    assert stats["deadline"] > 0
+    assert stats["hedged"] == 0
+
+    cache_trace.hold = True
+    read = Data(BLOCK)
+    c = submit_io(core, 0, read, IoDir.READ)
+    assert wait_for(lambda: cache_trace.held)
+
+    sleep(max(2 * stats["deadline"] / 1e9, 0.05))
+    assert not c.e.is_set()
+
+    cache.get_default_queue().check_deadlines()
+    c.wait()
+    assert c.results["err"] == 0
+    assert read.buffer[:BLOCK] == pattern(0)
+
+    stats = cache.get_stats()["conf"]["hedging"]
+    assert stats["hedged"] == 1
+    assert stats["core_won"] == 1
+
+    cache_trace.hold = False
+    cache_trace.release()
+
+    # Cache lines are unlocked once held cache read completes
+    read = Data(BLOCK)
+    assert io_to_core(core, 0, read, IoDir.READ) == 0
+    assert read.buffer[:BLOCK] == pattern(0)
+    assert cache.get_stats()["conf"]["hedging"]["hedged"] == 1
+
+
+def test_read_hedge_dirty_hit(pyocf_ctx):
+    """
+    Verify that read of dirty data is never hedged to core and waits for
+    cache read regardless of its deadline.
+    """
+    cache, core, cache_trace = prepare(CacheMode.WB)
+    cache.set_read_hedge_percentile(PERCENTILE)
+
+    collect_latency(core)
+    assert cache.get_stats()["usage"]["dirty"]["value"] > 0
+
+    cache_trace.hold = True
+    read = Data(BLOCK)
+    c = submit_io(core, 0, read, IoDir.READ)
+    assert wait_for(lambda: cache_trace.held)
+
+    sleep(0.05)
+    cache.get_default_queue().check_deadlines()
+    assert not c.e.is_set()
+
+    cache_trace.hold = False
+    cache_trace.release()
+    c.wait()
+    assert c.results["err"] == 0
+    assert read.buffer[:BLOCK] == pattern(0)
+    assert cache.get_stats()["conf"]["hedging"]["hedged"] == 0
+
+
+def test_read_hedge_disabled(pyocf_ctx):
+    cache, core, _ = prepare(CacheMode.WT)
+
+    collect_latency(core)
+
+    stats = cache.get_stats()["conf"]["hedging"]
+    assert stats["deadline"] == 0
+    assert stats["hedged"] == 0
+
+
+@pytest.mark.parametrize("percentile", [1, 499, 1000])
+def test_read_hedge_invalid_percentile(pyocf_ctx, percentile):
+    cache = Cache.start_on_device(Volume(Size.from_MiB(50)))
+
+    with pytest.raises(OcfError) as e:
+        cache.set_read_hedge_percentile(percentile)
+
+    assert e.value.error_code == OcfErrorCode.OCF_ERR_INVAL
@@ -0,0 +1,161 @@
+#
+# Copyright(c) 2021 Intel Corporation
+# SPDX-License-Identifier: BSD-3-Clause-Clear
+#
+
+from time import sleep
+
+import pytest
+
+from pyocf.types.cache import Cache, CacheMode
+from pyocf.types.data import Data
+from pyocf.types.io import IoDir
+from pyocf.types.shared import OcfError, OcfErrorCode
+from pyocf.types.volume import TraceDevice
+from pyocf.utils import Size, wait_for, io_to_core, start_cache_with_core
+
+BLOCK = int(Size.from_KiB(4))
+LINES = 32
+
+
+class ReadTrace:
+    def __init__(self):
+        self.data_offset = 0
+        self.reads = 0
+        self.delay = 0
+
+    def __call__(self, vol, io):
+        if io.contents._dir == IoDir.READ and io.contents._addr >= self.data_offset:
+            self.reads += 1
+            if self.delay:
+                sleep(self.delay)
+        return True
+
+
+def read_blocks(core, start, count=LINES):
+    data = bytearray()
+    for i in range(start, start + count):
+        read = Data(BLOCK)
+        assert io_to_core(core, i * BLOCK, read, IoDir.READ) == 0
+        data += read.buffer[:BLOCK]
+    return bytes(data)
+
+
+def prepare(cache_mode):
+    cache_trace = ReadTrace()
+    core_trace = ReadTrace()
+    cache_device = TraceDevice(Size.from_MiB(50), trace_fcn=cache_trace)
+    core_device = TraceDevice(Size.from_MiB(50), trace_fcn=core_trace)
+
+    cache, core = start_cache_with_core(cache_device, core_device, cache_mode=cache_mode)
+    cache.set_read_steering_threshold(1000)
+
+    cache_trace.data_offset = int(cache.get_stats()["conf"]["metadata_end_offset"])
+
+    return cache, core, core_device, cache_trace, core_trace
+
+
+def saturate(cache, core, cache_trace, start):
+    """Insert clean data, measure latency of both devices and slow down cache"""
+    read_blocks(core, start)
+    assert wait_for(
+        lambda: cache.get_stats()["usage"]["occupancy"]["value"] >= start + LINES
+    )
+    read_blocks(core, start)
+
+    stats = cache.get_stats()["conf"]["steering"]
+    assert not stats["status"]
+    assert stats["cache_latency"] > 0
+    assert stats["core_latency"] > 0
+
+    cache_trace.delay = 0.01
+    read_blocks(core, start, 1)
+    assert cache.get_stats()["conf"]["steering"]["status"]
+
+
+def test_read_steering_clean_hits(pyocf_ctx):
+    """
+    Slow down cache device reads and verify that clean read hits are served
+    from core, except for periodic probes of cache device.
+    """
+    cache, core, core_device, cache_trace, core_trace = prepare(CacheMode.WT)
+    saturate(cache, core, cache_trace, 0)
+
+    cache_trace.reads = 0
+    core_trace.reads = 0
+    data = read_blocks(core, 0)
+    assert data == core_device.get_bytes()[: LINES * BLOCK]
+
+    stats = cache.get_stats()
+    assert stats["conf"]["steering"]["steered"] >= LINES - LINES // 16
+    assert core_trace.reads == stats["conf"]["steering"]["steered"]
+    assert cache_trace.reads == LINES - core_trace.reads
+    assert stats["req"]["rd_pt"]["value"] >= LINES - LINES // 16
+
+    cache.set_read_steering_threshold(0)
+    assert not cache.get_stats()["conf"]["steering"]["status"]
+
+    core_trace.reads = 0
+    read_blocks(core, 0)
+    assert core_trace.reads == 0
+
+
+def test_read_steering_dirty_hits(pyocf_ctx):
+    """
+    Verify that dirty data is still read from cache device and that no new
+    cache lines are inserted while cache device is saturated.
+    """
+    cache, core, core_device, cache_trace, core_trace = prepare(CacheMode.WB)
+
+    dirty = bytes(range(256)) * (LINES * BLOCK // 256)
+    assert io_to_core(core, 0, Data.from_bytes(dirty), IoDir.WRITE) == 0
+    saturate(cache, core, cache_trace, LINES)
+
+    occupancy = cache.get_stats()["usage"]["occupancy"]["value"]
+    steered = cache.get_stats()["conf"]["steering"]["steered"]
+
+    cache_trace.reads = 0
+    core_trace.reads = 0
+    assert read_blocks(core, 0) == dirty
+    assert cache_trace.reads == LINES
+    assert core_trace.reads == 0
+    assert cache.get_stats()["conf"]["steering"]["steered"] == steered
+
+    read_blocks(core, 2 * LINES)
+    sleep(0.1)
+    assert cache.get_stats()["usage"]["occupancy"]["value"] == occupancy
+
+
+def test_read_steering_core_probe(pyocf_ctx):
+    """
+    Insert data by writes, so that core device read latency is never sampled
+    on miss, and verify that occasional clean read hits are served from core
+    to sample it, which lets steering turn on once cache device slows down.
+    """
+    cache, core, core_device, cache_trace, core_trace = prepare(CacheMode.WT)
+    data = bytes(range(256)) * (LINES * BLOCK // 256)
+    assert io_to_core(core, 0, Data.from_bytes(data), IoDir.WRITE) == 0
+
+    core_trace.reads = 0
+    for _ in range(2):
+        assert read_blocks(core, 0) == data
+    assert core_trace.reads == 0
+
+    assert read_blocks(core, 0) == data
+    assert core_trace.reads == 1
+    assert cache.get_stats()["conf"]["steering"]["core_latency"] > 0
+
+    cache_trace.delay = 0.01
+    read_blocks(core, 0, 1)
+    assert cache.get_stats()["conf"]["steering"]["status"]
+
+
+@pytest.mark.parametrize("threshold", [1, 99, 10001])
+def test_read_steering_invalid_threshold(pyocf_ctx, threshold):
+    cache_device = TraceDevice(Size.from_MiB(50))
+    cache = Cache.start_on_device(cache_device)
+
+    with pytest.raises(OcfError) as e:
+        cache.set_read_steering_threshold(threshold)
+
+    assert e.value.error_code == OcfErrorCode.OCF_ERR_INVAL
@@ -140,3 +140,79 @@ def test_seq_cutoff_max_streams(pyocf_ctx):
     assert (
         stats["req"]["serviced"]["value"] == old_serviced + 2
     ), "This request should be serviced by cache - lru_stream should be no longer tracked"
+
+
+def _reordered(count, io_size):
+    # Every pair of requests following the first one is swapped
+    order = [0, 1]
+    for i in range(2, count - 1, 2):
+        order += [i + 1, i]
+    return [i * io_size for i in order]
+
+
+@pytest.mark.parametrize(
+    "pattern,addresses",
+    [
+        ("sequential", lambda count, io_size: [i * io_size for i in range(count)]),
+        ("reordered", _reordered),
+        ("strided", lambda count, io_size: [2 * i * io_size for i in range(count)]),
+        (
+            "reverse",
+            lambda count, io_size: [(count - i) * io_size for i in range(count)],
+        ),
+    ],
+)
+def test_seq_cutoff_stream_patterns(pyocf_ctx, pattern, addresses):
+    """
+    Verify that sequential cutoff detects streams issued in different patterns
+    and accounts requests cut off to matching pattern.
+
+    1. Issue requests to a single stream, one at a time, in given pattern
+    2. Check that once stream exceeded threshold, requests were handled in PT
+    3. Check that only given pattern counter was incremented
+    """
+    count = 32
+    io_size = Size.from_KiB(4)
+    threshold = Size.from_KiB(16)
+
+    cache = Cache.start_on_device(Volume(Size.from_MiB(50)), cache_mode=CacheMode.WT)
+    core = Core.using_device(Volume(Size.from_MiB(50)))
+    cache.add_core(core)
+
+    cache.set_seq_cut_off_policy(SeqCutOffPolicy.ALWAYS)
+    cache.set_seq_cut_off_threshold(threshold)
+
+    for addr in addresses(count, int(io_size)):
+        c = _io(core, addr, io_size, IoDir.WRITE, context=None)
+        c.wait()
+        assert not c.results["error"], "No IO should fail"
+
+    stats = core.get_stats()
+    cut_off = stats["seq_cutoff_streams"]
+    assert stats["req"]["wr_pt"]["value"] >= count - 8
+    assert cut_off[pattern] == stats["req"]["wr_pt"]["value"]
+    assert sum(cut_off.values()) == cut_off[pattern]
+
+
+def test_seq_cutoff_rewrite_is_not_stream(pyocf_ctx):
+    """
+    Verify that rewriting the same block is not detected as sequential stream
+    even though it is within tolerance of stream position.
+    """
+    io_size = Size.from_KiB(4)
+
+    cache = Cache.start_on_device(Volume(Size.from_MiB(50)), cache_mode=CacheMode.WT)
+    core = Core.using_device(Volume(Size.from_MiB(50)))
+    cache.add_core(core)
+
+    cache.set_seq_cut_off_policy(SeqCutOffPolicy.ALWAYS)
+    cache.set_seq_cut_off_threshold(Size.from_KiB(8))
+
+    for _ in range(16):
+        c = _io(core, 0, io_size, IoDir.WRITE, context=None)
+        c.wait()
+        assert not c.results["error"], "No IO should fail"
+
+    stats = core.get_stats()
+    assert stats["req"]["wr_pt"]["value"] == 0
+    assert sum(stats["seq_cutoff_streams"].values()) == 0
@@ -0,0 +1,236 @@
+#
+# Copyright(c) 2021 Intel Corporation
+# SPDX-License-Identifier: BSD-3-Clause-Clear
+#
+
+from ctypes import c_int
+import random
+
+import pytest
+
+from pyocf.types.cache import Cache, CacheMode
+from pyocf.types.core import Core
+from pyocf.types.volume import Volume, DiscardTraceDevice
+from pyocf.types.data import Data
+from pyocf.types.io import IoDir
+from pyocf.utils import Size, io_to_core
+from pyocf.types.shared import OcfCompletion, OcfError, CacheLineSize, StatusGranularity
+
+
+@pytest.mark.parametrize("cache_mode", [CacheMode.WT, CacheMode.WB, CacheMode.WO])
+def test_status_granularity_io(pyocf_ctx, cache_mode):
+    """
+    Write 4 KiB aligned chunks covering parts of 64 KiB cache lines with
+    4 KiB status granularity and verify that data read back is consistent.
+    """
+    cache_device = Volume(Size.from_MiB(50))
+    core_device = Volume(Size.from_MiB(50))
+
+    cache = Cache.start_on_device(
+        cache_device,
+        cache_mode=cache_mode,
+        cache_line_size=CacheLineSize.LINE_64KiB,
+        status_granularity=StatusGranularity.BLOCK_4KiB,
+    )
+    core = Core.using_device(core_device)
+    cache.add_core(core)
+
+    seed = random.randrange(2 ** 32)
+    random.seed(seed)
+
+    block = int(Size.from_KiB(4))
+    size = int(Size.from_KiB(256))
+    expected = bytearray([Volume.VOLUME_POISON] * size)
+
+    for _ in range(32):
+        offset = random.randrange(size // block) * block
+        count = random.randint(1, min(8, (size - offset) // block)) * block
+        pattern = bytes(random.getrandbits(8) for _ in range(count))
+        expected[offset : offset + count] = pattern
+
+        data = Data.from_bytes(pattern)
+        assert io_to_core(core, offset, data, IoDir.WRITE) == 0, seed
+
+    data = Data(size)
+    assert io_to_core(core, 0, data, IoDir.READ) == 0, seed
+    assert data.md5() == Data.from_bytes(bytes(expected)).md5(), seed
+
+
+@pytest.mark.parametrize("cache_mode", [CacheMode.WT, CacheMode.WB, CacheMode.WO])
+@pytest.mark.parametrize("offset, size", [(0, 512), (512, 4096), (4096, 4096 + 512)])
+def test_status_granularity_unaligned_io(pyocf_ctx, cache_mode, offset, size):
+    """
+    Write IO not aligned to status granularity over dirty and clean data and
+    verify that it is served in pass-through mode without losing data
+    around it.
+    """
+    cache_device = Volume(Size.from_MiB(50))
+    core_device = Volume(Size.from_MiB(50))
+
+    cache = Cache.start_on_device(
+        cache_device,
+        cache_mode=cache_mode,
+        cache_line_size=CacheLineSize.LINE_64KiB,
+        status_granularity=StatusGranularity.BLOCK_4KiB,
+    )
+    core = Core.using_device(core_device)
+    cache.add_core(core)
+
+    line = int(Size.from_KiB(64))
+    expected = bytearray(bytes(i % 251 + 1 for i in range(2 * line)))
+    assert io_to_core(core, 0, Data.from_bytes(bytes(expected)), IoDir.WRITE) == 0
+
+    pattern = bytes([0xA5] * size)
+    expected[offset : offset + size] = pattern
+    assert io_to_core(core, offset, Data.from_bytes(pattern), IoDir.WRITE) == 0
+
+    data = Data(size + 512)
+    assert io_to_core(core, offset, data, IoDir.READ) == 0
+    assert data.md5() == Data.from_bytes(bytes(expected[offset : offset + size + 512])).md5()
+
+    data = Data(2 * line)
+    assert io_to_core(core, 0, data, IoDir.READ) == 0
+    assert data.md5() == Data.from_bytes(bytes(expected)).md5()
+
+    stats = cache.get_stats()
+    assert stats["req"]["wr_pt"]["value"] == 1
+    assert stats["req"]["rd_pt"]["value"] == 1
+
+    cache.flush()
+    assert core_device.get_bytes()[: 2 * line] == bytes(expected)
+
+
+
+def discard_core(core, address, size):
+    io = core.new_io(core.cache.get_default_queue(), address, size, IoDir.WRITE, 0, 0)
+    io.set_data(Data(size))
+
+    completion = OcfCompletion([("err", c_int)])
+    io.callback = completion.callback
+    io.submit_discard()
+    completion.wait()
+
+    return int(completion.results["err"])
+
+
+def test_status_granularity_discard(pyocf_ctx):
+    """
+    Discard ranges not aligned to status granularity and verify that core
+    gets the whole discards, while in cache only whole status units are
+    invalidated, so dirty data around the discards is kept.
+    """
+    cache_device = Volume(Size.from_MiB(50))
+    core_device = DiscardTraceDevice(Size.from_MiB(50))
+
+    cache = Cache.start_on_device(
+        cache_device,
+        cache_mode=CacheMode.WB,
+        cache_line_size=CacheLineSize.LINE_64KiB,
+        status_granularity=StatusGranularity.BLOCK_4KiB,
+    )
+    core = Core.using_device(core_device)
+    cache.add_core(core)
+
+    block = int(Size.from_KiB(4))
+    line = int(Size.from_KiB(64))
+    expected = bytearray(bytes(i % 251 + 1 for i in range(line)))
+    assert io_to_core(core, 0, Data.from_bytes(bytes(expected)), IoDir.WRITE) == 0
+
+    assert discard_core(core, 512, 512) == 0
+    assert discard_core(core, 2048, 2 * block) == 0
+    assert core_device.discards == [(512, 512), (2048, 2 * block)]
+
+    expected[block : 2 * block] = bytes(block)
+    cache.flush()
+    assert core_device.get_bytes()[:line] == bytes(expected)
+
+
+def test_status_granularity_metadata(pyocf_ctx):
+    """
+    Verify that coarser status granularity reduces metadata footprint and
+    survives cache stop and load.
+    """
+    footprint = {}
+
+    for granularity in StatusGranularity:
+        cache_device = Volume(Size.from_MiB(200))
+        cache = Cache.start_on_device(
+            cache_device,
+            cache_line_size=CacheLineSize.LINE_64KiB,
+            status_granularity=granularity,
+        )
+        footprint[granularity] = int(cache.get_stats()["conf"]["metadata_footprint"])
+        cache.stop()
+
+        cache = Cache.load_from_device(cache_device)
+        stats = cache.get_stats()
+        assert int(stats["conf"]["metadata_footprint"]) == footprint[granularity]
+        cache.stop()
+
+    assert (
+        footprint[StatusGranularity.BLOCK_4KiB]
+        < footprint[StatusGranularity.SECTOR_512B]
+    )
+
+
+def test_status_granularity_invalid(pyocf_ctx):
+    """
+    Verify that unsupported status granularity is rejected.
+    """
+    with pytest.raises(OcfError):
+        Cache.start_on_device(Volume(Size.from_MiB(50)), status_granularity=3072)
+
+
+@pytest.mark.parametrize("cache_mode", [CacheMode.WT, CacheMode.WB])
+@pytest.mark.parametrize("cls", [CacheLineSize.LINE_1MiB, CacheLineSize.LINE_2MiB])
+def test_large_cache_line_io(pyocf_ctx, cache_mode, cls):
+    """
+    Write big and small chunks to cache with cache lines bigger than 64 KiB
+    and verify that data read back, partially from cache and partially from
+    core, is consistent.
+    """
+    cache_device = Volume(Size.from_MiB(100))
+    core_device = Volume(Size.from_MiB(100))
+
+    cache = Cache.start_on_device(cache_device, cache_mode=cache_mode, cache_line_size=cls)
+    core = Core.using_device(core_device)
+    cache.add_core(core)
+
+    seed = random.randrange(2 ** 32)
+    random.seed(seed)
+
+    block = int(cls) // 128
+    size = int(Size.from_MiB(8))
+    expected = bytearray([Volume.VOLUME_POISON] * size)
+
+    for count in [int(Size.from_MiB(1))] * 4 + [block] * 16:
+        offset = random.randrange((size - count) // block) * block
+        pattern = bytes(random.getrandbits(8) for _ in range(count))
+        expected[offset : offset + count] = pattern
+
+        data = Data.from_bytes(pattern)
+        assert io_to_core(core, offset, data, IoDir.WRITE) == 0, seed
+
+    data = Data(size)
+    assert io_to_core(core, 0, data, IoDir.READ) == 0, seed
+    assert data.md5() == Data.from_bytes(bytes(expected)).md5(), seed
+
+    stats = cache.get_stats()
+    assert stats["conf"]["cache_line_size"] == cls
+    assert stats["usage"]["occupancy"]["value"] == size // int(Size.from_KiB(4)), seed
+
+    cache.flush()
+    assert core_device.get_bytes()[:size] == bytes(expected), seed
+
+
+@pytest.mark.parametrize("cls", [CacheLineSize.LINE_128KiB, CacheLineSize.LINE_2MiB])
+def test_large_cache_line_granularity_too_fine(pyocf_ctx, cls):
+    """
+    Verify that cache line with more than 128 status units is rejected.
+    """
+    with pytest.raises(OcfError):
+        Cache.start_on_device(
+            Volume(Size.from_MiB(100)),
+            cache_line_size=cls,
+            status_granularity=int(cls) // 256,
+        )
@@ -0,0 +1,112 @@
+#
+# Copyright(c) 2021 Intel Corporation
+# SPDX-License-Identifier: BSD-3-Clause-Clear
+#
+
+from pyocf.types.cache import Cache, CacheMode, PromotionPolicy, NhitParams
+from pyocf.types.core import Core
+from pyocf.types.data import Data
+from pyocf.types.io import IoDir
+from pyocf.types.shared import SeqCutOffPolicy
+from pyocf.types.volume import Volume
+from pyocf.utils import Size, io_to_core, start_cache_with_core
+
+REGION_SIZE = int(Size.from_MiB(1))
+
+
+def test_warm_state_nhit_restore(pyocf_ctx):
+    """
+    Verify that nhit promotion policy counters survive cache stop and load,
+    so that core line accessed before stop gets promoted once its total
+    access count reaches insertion threshold.
+    """
+    cache_device = Volume(Size.from_MiB(50))
+    core_device = Volume(Size.from_MiB(50))
+
+    cache = Cache.start_on_device(
+        cache_device, cache_mode=CacheMode.WT, promotion_policy=PromotionPolicy.NHIT
+    )
+    core = Core.using_device(core_device)
+    cache.add_core(core)
+
+    cache.set_promotion_policy_param(PromotionPolicy.NHIT, NhitParams.TRIGGER_THRESHOLD, 0)
+    cache.set_promotion_policy_param(PromotionPolicy.NHIT, NhitParams.INSERTION_THRESHOLD, 3)
+    cache.save()
+
+    block = int(Size.from_KiB(4))
+    for _ in range(2):
+        assert io_to_core(core, 0, Data(block), IoDir.READ) == 0
+    assert io_to_core(core, REGION_SIZE, Data(block), IoDir.READ) == 0
+    assert cache.get_stats()["usage"]["occupancy"]["value"] == 0
+
+    cache.stop()
+
+    cache = Cache.load_from_device(cache_device, open_cores=False)
+    core = Core(device=core_device, try_add=True)
+    cache.add_core(core)
+
+    # Third access in total - line is promoted
+    assert io_to_core(core, 0, Data(block), IoDir.READ) == 0
+    assert cache.get_stats()["usage"]["occupancy"]["value"] == 1
+
+    # Second access in total - line is not promoted yet
+    assert io_to_core(core, REGION_SIZE, Data(block), IoDir.READ) == 0
+    assert cache.get_stats()["usage"]["occupancy"]["value"] == 1
+
+
+def test_warm_state_prewarm(pyocf_ctx):
+    """
+    Fill cache with two regions, so that only lines of the most recently
+    accessed one are hot in LRU, stop and load cache, drop its content by
+    removing and re-adding core and verify that prewarm reads exactly the
+    hot region back into the cache.
+    """
+    cache_device = Volume(Size.from_MiB(50))
+    core_device = Volume(Size.from_MiB(50))
+
+    cache, core = start_cache_with_core(cache_device, core_device, cache_mode=CacheMode.WT)
+
+    cold = Data.from_bytes(b"\x11" * REGION_SIZE)
+    hot = Data.from_bytes(b"\x22" * REGION_SIZE)
+    assert io_to_core(core, 0, cold, IoDir.WRITE) == 0
+    assert io_to_core(core, 4 * REGION_SIZE, hot, IoDir.WRITE) == 0
+
+    line_size = cache.get_stats()["conf"]["cache_line_size"]
+    region_lines = REGION_SIZE // line_size
+    assert cache.get_stats()["usage"]["occupancy"]["value"] == 2 * region_lines
+
+    cache.stop()
+
+    cache = Cache.load_from_device(cache_device, open_cores=False)
+    core = Core(device=core_device, try_add=True)
+    cache.add_core(core)
+    cache.remove_core(core)
+    core = Core.using_device(core_device)
+    cache.add_core(core)
+    cache.set_seq_cut_off_policy(SeqCutOffPolicy.NEVER)
+    assert cache.get_stats()["usage"]["occupancy"]["value"] == 0
+
+    cache.prewarm()
+    assert cache.get_stats()["usage"]["occupancy"]["value"] == region_lines
+
+    cache.reset_stats()
+    data = Data(REGION_SIZE)
+    assert io_to_core(core, 4 * REGION_SIZE, data, IoDir.READ) == 0
+    assert data.md5() == hot.md5()
+
+    stats = cache.get_stats()["req"]
+    assert stats["rd_full_misses"]["value"] == 0
+    assert stats["rd_partial_misses"]["value"] == 0
+
+
+def test_warm_state_prewarm_no_snapshot(pyocf_ctx):
+    """
+    Verify that prewarm of cache started on device without saved warm state
+    completes without reading anything into cache.
+    """
+    cache = Cache.start_on_device(Volume(Size.from_MiB(50)))
+    core = Core.using_device(Volume(Size.from_MiB(50)))
+    cache.add_core(core)
+
+    cache.prewarm()
+    assert cache.get_stats()["usage"]["occupancy"]["value"] == 0
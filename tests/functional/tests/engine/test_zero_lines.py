@@ -0,0 +1,180 @@
+#
+# Copyright(c) 2021 Intel Corporation
+# SPDX-License-Identifier: BSD-3-Clause-Clear
+#
+
+import pytest
+
+from pyocf.types.cache import Cache, CacheMode, CleaningPolicy
+from pyocf.types.core import Core
+from pyocf.types.data import Data
+from pyocf.types.io import IoDir
+from pyocf.types.volume import Volume, TraceDevice
+from pyocf.utils import Size, io_to_core, start_cache_with_core
+
+
+class DataIoTrace:
+    def __init__(self):
+        self.data_offset = None
+        self.reads = 0
+        self.writes = 0
+
+    def __call__(self, vol, io):
+        if self.data_offset is not None and io.contents._addr >= self.data_offset:
+            if io.contents._dir == IoDir.WRITE:
+                self.writes += int(io.contents._bytes)
+            else:
+                self.reads += int(io.contents._bytes)
+        return True
+
+    def reset(self):
+        self.reads = 0
+        self.writes = 0
+
+
+def prepare(cache_mode):
+    trace = DataIoTrace()
+    cache_device = TraceDevice(Size.from_MiB(50), trace_fcn=trace)
+    core_device = Volume(Size.from_MiB(50))
+
+    cache, core = start_cache_with_core(cache_device, core_device, cache_mode=cache_mode)
+
+    trace.data_offset = int(cache.get_stats()["conf"]["metadata_end_offset"])
+
+    return cache, core, cache_device, core_device, trace
+
+
+@pytest.mark.parametrize("cache_mode", [CacheMode.WT, CacheMode.WB])
+def test_zero_lines_not_written(pyocf_ctx, cache_mode):
+    """
+    Overwrite cached data with zeros and verify that zeros are not written
+    to cache device, but are read back from cache without cache device IO.
+    """
+    cache, core, cache_device, core_device, trace = prepare(cache_mode)
+    size = int(Size.from_MiB(1))
+
+    assert io_to_core(core, 0, Data.from_bytes(b"\xaa" * size), IoDir.WRITE) == 0
+    assert trace.writes == size
+
+    trace.reset()
+    assert io_to_core(core, 0, Data.from_bytes(bytes(size)), IoDir.WRITE) == 0
+    assert trace.writes == 0
+
+    stats = cache.get_stats()
+    data = Data(size)
+    assert io_to_core(core, 0, data, IoDir.READ) == 0
+    assert data.md5() == Data.from_bytes(bytes(size)).md5()
+    assert trace.reads == 0
+
+    hits = cache.get_stats()["req"]["rd_full_misses"]["value"]
+    assert hits == stats["req"]["rd_full_misses"]["value"]
+
+    cache.flush()
+    assert core_device.get_bytes()[:size] == bytes(size)
+
+
+@pytest.mark.parametrize("cache_mode", [CacheMode.WT, CacheMode.WB])
+def test_zero_lines_partial_overwrite(pyocf_ctx, cache_mode):
+    """
+    Write zeros and then non-zero data over part of zero cache lines and
+    verify that data read back and flushed to core is consistent.
+    """
+    cache, core, cache_device, core_device, trace = prepare(cache_mode)
+    line = int(cache.get_stats()["conf"]["cache_line_size"])
+    size = line * 8
+
+    expected = bytearray(size)
+    assert io_to_core(core, 0, Data.from_bytes(bytes(size)), IoDir.WRITE) == 0
+
+    trace.reset()
+    pattern = b"\x55" * 4096
+    for offset in [line // 2, line * 3, line * 5 + 512]:
+        expected[offset : offset + len(pattern)] = pattern
+        assert io_to_core(core, offset, Data.from_bytes(pattern), IoDir.WRITE) == 0
+    assert trace.writes == 3 * len(pattern)
+
+    data = Data(size)
+    assert io_to_core(core, 0, data, IoDir.READ) == 0
+    assert data.md5() == Data.from_bytes(bytes(expected)).md5()
+
+    cache.flush()
+    assert core_device.get_bytes()[:size] == bytes(expected)
+
+
+def test_zero_lines_backfill(pyocf_ctx):
+    """
+    Read zero data from core and verify that read miss doesn't backfill it
+    to cache device, but following reads are served from cache.
+    """
+    cache, core, cache_device, core_device, trace = prepare(CacheMode.PT)
+    size = int(Size.from_MiB(1))
+
+    assert io_to_core(core, 0, Data.from_bytes(bytes(size)), IoDir.WRITE) == 0
+    cache.change_cache_mode(CacheMode.WT)
+
+    data = Data(size)
+    assert io_to_core(core, 0, data, IoDir.READ) == 0
+    assert data.md5() == Data.from_bytes(bytes(size)).md5()
+
+    stats = cache.get_stats()
+    assert stats["usage"]["occupancy"]["value"] == size // 4096
+    assert trace.writes == 0
+
+    data = Data(size)
+    assert io_to_core(core, 0, data, IoDir.READ) == 0
+    assert data.md5() == Data.from_bytes(bytes(size)).md5()
+    assert trace.reads == 0
+
+    stats = cache.get_stats()
+    assert stats["req"]["rd_hits"]["value"] == 1
+
+
+def test_zero_lines_load(pyocf_ctx):
+    """
+    Verify that zero status of cache lines survives cache stop and load.
+    """
+    cache, core, cache_device, core_device, trace = prepare(CacheMode.WB)
+    size = int(Size.from_MiB(1))
+
+    assert io_to_core(core, 0, Data.from_bytes(b"\xaa" * size), IoDir.WRITE) == 0
+    assert io_to_core(core, 0, Data.from_bytes(bytes(size // 2)), IoDir.WRITE) == 0
+    cache.stop()
+
+    cache = Cache.load_from_device(cache_device, open_cores=False)
+    core = Core(device=core_device, try_add=True)
+    cache.add_core(core)
+
+    data = Data(size)
+    assert io_to_core(core, 0, data, IoDir.READ) == 0
+    assert data.md5() == Data.from_bytes(bytes(size // 2) + b"\xaa" * (size // 2)).md5()
+
+
+def test_zero_lines_dirty_shutdown(pyocf_ctx):
+    """
+    Change zero status of dirty cache lines, load cache from device state
+    captured before stop and verify that data recovered is consistent.
+    """
+    cache, core, cache_device, core_device, trace = prepare(CacheMode.WB)
+    cache.set_cleaning_policy(CleaningPolicy.NOP)
+    size = int(Size.from_MiB(1))
+    half = size // 2
+
+    # Dirty data overwritten with zeros and dirty zeros overwritten with data
+    assert io_to_core(core, 0, Data.from_bytes(b"\xaa" * half), IoDir.WRITE) == 0
+    assert io_to_core(core, half, Data.from_bytes(bytes(half)), IoDir.WRITE) == 0
+    assert io_to_core(core, 0, Data.from_bytes(bytes(half)), IoDir.WRITE) == 0
+    assert io_to_core(core, half, Data.from_bytes(b"\x55" * half), IoDir.WRITE) == 0
+
+    # Device state as if power failed before cache stop
+    cache_device = cache_device.get_copy()
+    cache.stop()
+
+    cache = Cache.load_from_device(cache_device, open_cores=False)
+    core = Core(device=core_device, try_add=True)
+    cache.add_core(core)
+
+    assert cache.get_stats()["usage"]["dirty"]["value"] == size // 4096
+
+    data = Data(size)
+    assert io_to_core(core, 0, data, IoDir.READ) == 0
+    assert data.md5() == Data.from_bytes(bytes(half) + b"\x55" * half).md5()
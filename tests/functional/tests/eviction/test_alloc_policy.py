@@ -0,0 +1,99 @@
+#
+# Copyright(c) 2021 Intel Corporation
+# SPDX-License-Identifier: BSD-3-Clause-Clear
+#
+
+import random
+
+import pytest
+
+from pyocf.types.cache import Cache, CacheMode, AllocPolicy
+from pyocf.types.data import Data
+from pyocf.types.io import IoDir
+from pyocf.types.shared import OcfError
+from pyocf.types.volume import Volume, TraceDevice
+from pyocf.utils import Size, io_to_core, start_cache_with_core
+
+
+def test_alloc_policy_log_sequential(pyocf_ctx):
+    """
+    Write 4 KiB blocks in random order, enough to fill the cache and force
+    eviction, and verify that with log-structured allocation cache lines are
+    written to cache device in physical order, wrapping around only when end
+    of cache device is reached.
+    """
+    data_writes = []
+
+    def trace(vol, io):
+        if io.contents._dir == IoDir.WRITE and data_offset is not None:
+            if io.contents._addr >= data_offset:
+                data_writes.append(int(io.contents._addr))
+        return True
+
+    data_offset = None
+    cache_device = TraceDevice(Size.from_MiB(50), trace_fcn=trace)
+    core_device = Volume(Size.from_MiB(100))
+
+    cache, core = start_cache_with_core(cache_device, core_device, cache_mode=CacheMode.WT)
+    cache.set_alloc_policy(AllocPolicy.LOG)
+
+    stats = cache.get_stats()
+    data_offset = int(stats["conf"]["metadata_end_offset"])
+    cache_blocks = stats["conf"]["size"].blocks_4k
+
+    seed = random.randrange(2 ** 32)
+    random.seed(seed)
+
+    block = int(Size.from_KiB(4))
+    blocks = random.sample(range(int(core_device.size) // block), cache_blocks * 3 // 2)
+
+    for i in blocks:
+        data = Data.from_bytes((i + 1).to_bytes(8, "little") * (block // 8))
+        assert io_to_core(core, i * block, data, IoDir.WRITE) == 0, seed
+
+    assert len(data_writes) == len(blocks), seed
+
+    wraps = sum(1 for a, b in zip(data_writes, data_writes[1:]) if b < a)
+    jumps = sum(1 for a, b in zip(data_writes, data_writes[1:]) if b > a + block)
+    assert wraps <= 1, seed
+    assert jumps == 0, seed
+
+    assert cache.get_stats()["usage"]["occupancy"]["value"] == cache_blocks, seed
+
+    for i in blocks[-cache_blocks:]:
+        data = Data(block)
+        assert io_to_core(core, i * block, data, IoDir.READ) == 0, seed
+        assert data.md5() == Data.from_bytes((i + 1).to_bytes(8, "little") * (block // 8)).md5()
+
+
+def test_alloc_policy_log_dirty_skipped(pyocf_ctx):
+    """
+    Overwrite whole cache several times in Write-Back mode with log-structured
+    allocation and verify that dirty data is not lost when write frontier
+    passes over dirty cache lines.
+    """
+    cache_device = Volume(Size.from_MiB(50))
+    core_device = Volume(Size.from_MiB(100))
+
+    cache, core = start_cache_with_core(cache_device, core_device, cache_mode=CacheMode.WB)
+    cache.set_alloc_policy(AllocPolicy.LOG)
+
+    cache_blocks = cache.get_stats()["conf"]["size"].blocks_4k
+    block = int(Size.from_KiB(4))
+
+    dirty = Data.from_bytes(b"\xaa" * block * 16)
+    assert io_to_core(core, 0, dirty, IoDir.WRITE) == 0
+
+    for i in range(16, cache_blocks * 2, 16):
+        assert io_to_core(core, i * block, Data(block * 16), IoDir.WRITE) == 0
+
+    data = Data(block * 16)
+    assert io_to_core(core, 0, data, IoDir.READ) == 0
+    assert data.md5() == dirty.md5()
+
+
+def test_alloc_policy_invalid(pyocf_ctx):
+    cache = Cache.start_on_device(Volume(Size.from_MiB(50)))
+
+    with pytest.raises(OcfError):
+        cache.set_alloc_policy(AllocPolicy.LOG + 1)
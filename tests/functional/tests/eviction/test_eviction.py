@@ -61,7 +61,8 @@ def test_write_size_greater_than_cache(pyocf_ctx, mode: CacheMode, cls: CacheLin
     cache.add_core(core_exported)
     cache.set_seq_cut_off_policy(SeqCutOffPolicy.NEVER)
 
-    valid_io_size = Size.from_B(cache_size.B // 2)
+    # Occupancy is counted in whole cache lines
+    valid_io_size = Size.from_B(cache_size.B // 2 // cls * cls)
     test_data = Data(valid_io_size)
     send_io(core_exported, test_data)
 
@@ -135,11 +136,14 @@ def test_evict_overflown_pinned(pyocf_ctx, cls: CacheLineSize):
 
     cache_size = cache.get_stats()["conf"]["size"]
 
-    data = Data(4096)
+    # I/O smaller than status granularity of big cache lines isn't cached
+    io_size = max(4096, cache.cfg._status_granularity)
+    io_count = cache_size.B // io_size
+    data = Data(io_size)
 
     # Populate cache with data
-    for i in range(cache_size.blocks_4k):
-        send_io(core, data, i * 4096, test_ioclass_id)
+    for i in range(io_count):
+        send_io(core, data, i * io_size, test_ioclass_id)
 
     part_current_size = CacheLines(
         cache.get_partition_info(part_id=test_ioclass_id)["_curr_size"], cls
@@ -149,22 +153,22 @@ def test_evict_overflown_pinned(pyocf_ctx, cls: CacheLineSize):
     ), "Failed to populate the default partition"
 
     # Repart - force overflow of second partition occupancy limit
-    pinned_double_size = ceil(
-        (cache_size.blocks_4k * pinned_ioclass_max_occupancy * 2) / 100
-    )
+    pinned_double_size = ceil((io_count * pinned_ioclass_max_occupancy * 2) / 100)
     for i in range(pinned_double_size):
-        send_io(core, data, i * 4096, pinned_ioclass_id)
+        send_io(core, data, i * io_size, pinned_ioclass_id)
 
     part_current_size = CacheLines(
         cache.get_partition_info(part_id=pinned_ioclass_id)["_curr_size"], cls
     )
     assert isclose(
-        part_current_size.blocks_4k, pinned_double_size, abs_tol=Size(cls).blocks_4k
+        part_current_size.B,
+        pinned_double_size * io_size,
+        abs_tol=Size(cls).B,
     ), "Occupancy of pinned ioclass doesn't match expected value"
 
     # Trigger IO to the default ioclass - force eviction from overlown ioclass
-    for i in range(cache_size.blocks_4k):
-        send_io(core, data, (cache_size.blocks_4k + i) * 4096, test_ioclass_id)
+    for i in range(io_count):
+        send_io(core, data, (io_count + i) * io_size, test_ioclass_id)
 
     part_current_size = CacheLines(
         cache.get_partition_info(part_id=pinned_ioclass_id)["_curr_size"], cls
@@ -313,3 +313,62 @@ def _io_to_core(exported_obj: Core, data: Data):
     completion.wait()
 
     assert completion.results["err"] == 0, "IO to exported object completion"
+
+
+def test_add_remove_many_small_cores(pyocf_ctx):
+    """
+    Add many small cores, including core ids far beyond typical core count,
+    and verify that data and per-core statistics of each core are kept apart,
+    that removed core ids are reused and that cores are restored on load.
+    """
+    core_amount = 300
+    block = int(S.from_KiB(4))
+
+    cache_device = Volume(S.from_MiB(50))
+    cache = Cache.start_on_device(cache_device, cache_mode=CacheMode.WB)
+
+    cores = []
+    for i in range(0, core_amount):
+        core = Core.using_device(Volume(S.from_MiB(1)), name=f"core{i}")
+        cache.add_core(core)
+        cores.append(core)
+
+        data = Data.from_bytes(bytes([i % 255 + 1]) * block)
+        _io_to_core(core, data)
+
+    stats = cache.get_stats()
+    assert stats["conf"]["core_count"] == core_amount
+    assert stats["usage"]["occupancy"]["value"] == core_amount
+    for core in cores:
+        assert core.get_stats()["usage"]["occupancy"]["value"] == 1
+
+    for core in cores[::2]:
+        cache.remove_core(core)
+    assert cache.get_stats()["conf"]["core_count"] == core_amount // 2
+
+    core = Core.using_device(Volume(S.from_MiB(1)), name="core_new")
+    cache.add_core(core)
+    assert cache.get_stats()["conf"]["core_count"] == core_amount // 2 + 1
+    cache.remove_core(core)
+
+    cache.stop()
+
+    cache = Cache.load_from_device(cache_device, open_cores=False)
+    assert cache.get_stats()["conf"]["core_count"] == core_amount // 2
+
+    for i in range(1, core_amount, 2):
+        core = Core(device=cores[i].device, name=f"core{i}", try_add=True)
+        cache.add_core(core)
+
+        read = Data(block)
+        io = core.new_io(cache.get_default_queue(), 0, block, IoDir.READ, 0, 0)
+        io.set_data(read)
+
+        completion = OcfCompletion([("err", c_int)])
+        io.callback = completion.callback
+        io.submit()
+        completion.wait()
+
+        assert completion.results["err"] == 0
+        assert read.buffer[:block] == bytes([i % 255 + 1]) * block
+        assert core.get_stats()["usage"]["dirty"]["value"] == 1
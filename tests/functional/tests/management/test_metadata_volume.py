@@ -0,0 +1,97 @@
+#
+# Copyright(c) 2021 Intel Corporation
+# SPDX-License-Identifier: BSD-3-Clause-Clear
+#
+
+import pytest
+
+from pyocf.types.cache import Cache, CacheMode
+from pyocf.types.core import Core
+from pyocf.types.data import Data
+from pyocf.types.io import IoDir
+from pyocf.types.shared import OcfError, OcfErrorCode
+from pyocf.types.volume import Volume
+from pyocf.utils import Size, io_to_core
+
+IO_SIZE = int(Size.from_MiB(1))
+
+
+def test_metadata_volume_start_load(pyocf_ctx):
+    """
+    Start cache with metadata on separate volume, write dirty data, stop and
+    load cache from both volumes. Verify that metadata I/O goes to metadata
+    volume only, whole cache volume is used for data and that dirty data
+    survives cache load.
+    """
+    cache_device = Volume(Size.from_MiB(50))
+    metadata_device = Volume(Size.from_MiB(50))
+    core_device = Volume(Size.from_MiB(50))
+
+    cache = Cache.start_on_device(
+        cache_device, metadata_device=metadata_device, cache_mode=CacheMode.WB
+    )
+    core = Core.using_device(core_device)
+    cache.add_core(core)
+
+    stats = cache.get_stats()
+    assert int(stats["conf"]["metadata_end_offset"]) == 0
+    assert stats["conf"]["size"].bytes == int(cache_device.size)
+    assert cache_device.get_stats()[IoDir.WRITE] == 0
+    assert metadata_device.get_stats()[IoDir.WRITE] > 0
+
+    data = Data.from_bytes(b"\x5a" * IO_SIZE)
+    assert io_to_core(core, 0, data, IoDir.WRITE) == 0
+    data_writes = cache_device.get_stats()[IoDir.WRITE]
+    assert data_writes > 0
+    assert core_device.get_stats()[IoDir.WRITE] == 0
+    dirty = cache.get_stats()["usage"]["dirty"]["value"]
+    assert dirty > 0
+
+    cache.stop()
+    assert cache_device.get_stats()[IoDir.WRITE] == data_writes
+
+    cache = Cache.load_from_device(
+        cache_device, metadata_device=metadata_device, open_cores=False
+    )
+    core = Core(device=core_device, try_add=True)
+    cache.add_core(core)
+
+    assert cache.get_stats()["usage"]["dirty"]["value"] == dirty
+
+    read = Data(IO_SIZE)
+    assert io_to_core(core, 0, read, IoDir.READ) == 0
+    assert read.md5() == data.md5()
+    assert core_device.get_stats()[IoDir.READ] == 0
+
+
+def test_metadata_volume_too_small(pyocf_ctx):
+    with pytest.raises(OcfError) as e:
+        Cache.start_on_device(
+            Volume(Size.from_MiB(50)), metadata_device=Volume(Size.from_MiB(1))
+        )
+
+    assert e.value.error_code == OcfErrorCode.OCF_ERR_INVAL_CACHE_DEV
+
+
+def test_metadata_volume_load_mismatch(pyocf_ctx):
+    """
+    Verify that cache metadata kept at the beginning of cache volume can't be
+    loaded from volume given as metadata volume, and that cache with separate
+    metadata can't be loaded without its metadata volume.
+    """
+    cache_device = Volume(Size.from_MiB(50))
+    other_device = Volume(Size.from_MiB(50))
+
+    cache = Cache.start_on_device(cache_device)
+    cache.stop()
+
+    with pytest.raises(OcfError) as e:
+        Cache.load_from_device(other_device, metadata_device=cache_device)
+    assert e.value.error_code == OcfErrorCode.OCF_ERR_INVAL_CACHE_DEV
+
+    cache = Cache.start_on_device(other_device, metadata_device=cache_device)
+    cache.stop()
+
+    with pytest.raises(OcfError) as e:
+        Cache.load_from_device(other_device)
+    assert e.value.error_code == OcfErrorCode.OCF_ERR_NO_METADATA
@@ -15,7 +15,13 @@ from pyocf.types.cache import Cache, CacheMode, MetadataLayout,  CleaningPolicy
 from pyocf.types.core import Core
 from pyocf.types.data import Data
 from pyocf.types.io import IoDir
-from pyocf.types.shared import OcfError, OcfCompletion, CacheLineSize, SeqCutOffPolicy
+from pyocf.types.shared import (
+    OcfError,
+    OcfErrorCode,
+    OcfCompletion,
+    CacheLineSize,
+    SeqCutOffPolicy,
+)
 from pyocf.types.volume import Volume
 from pyocf.utils import Size
 
@@ -61,21 +67,22 @@ def test_start_write_first_and_check_mode(pyocf_ctx, mode: CacheMode, cls: Cache
     cache_device.reset_stats()
     core_device.reset_stats()
 
-    test_data = Data.from_string("This is test data")
-    io_to_core(core_exported, test_data, Size.from_sector(1).B)
+    block = status_block(cache)
+    test_data = block_from_string("This is test data", block)
+    io_to_core(core_exported, test_data, block)
     check_stats_write_empty(core_exported, mode, cls)
 
     logger.info("[STAGE] Read from exported object after initial write")
-    io_from_exported_object(core_exported, test_data.size, Size.from_sector(1).B)
+    io_from_exported_object(core_exported, test_data.size, block)
     check_stats_read_after_write(core_exported, mode, cls, True)
 
     logger.info("[STAGE] Write to exported object after read")
     cache_device.reset_stats()
     core_device.reset_stats()
 
-    test_data = Data.from_string("Changed test data")
+    test_data = block_from_string("Changed test data", block)
 
-    io_to_core(core_exported, test_data, Size.from_sector(1).B)
+    io_to_core(core_exported, test_data, block)
     check_stats_write_after_read(core_exported, mode, cls)
 
     check_md5_sums(core_exported, mode)
@@ -96,28 +103,29 @@ def test_start_read_first_and_check_mode(pyocf_ctx, mode: CacheMode, cls: CacheL
     cache.add_core(core_exported)
 
     logger.info("[STAGE] Initial write to core device")
-    test_data = Data.from_string("This is test data")
-    io_to_core(core_exported, test_data, Size.from_sector(1).B, True)
+    block = status_block(cache)
+    test_data = block_from_string("This is test data", block)
+    io_to_core(core_exported, test_data, block, True)
 
     cache_device.reset_stats()
     core_device.reset_stats()
 
     logger.info("[STAGE] Initial read from exported object")
-    io_from_exported_object(core_exported, test_data.size, Size.from_sector(1).B)
+    io_from_exported_object(core_exported, test_data.size, block)
     check_stats_read_empty(core_exported, mode, cls)
 
     logger.info("[STAGE] Write to exported object after initial read")
     cache_device.reset_stats()
     core_device.reset_stats()
 
-    test_data = Data.from_string("Changed test data")
+    test_data = block_from_string("Changed test data", block)
 
-    io_to_core(core_exported, test_data, Size.from_sector(1).B)
+    io_to_core(core_exported, test_data, block)
 
     check_stats_write_after_read(core_exported, mode, cls, True)
 
     logger.info("[STAGE] Read from exported object after write")
-    io_from_exported_object(core_exported, test_data.size, Size.from_sector(1).B)
+    io_from_exported_object(core_exported, test_data.size, block)
     check_stats_read_after_write(core_exported, mode, cls)
 
     check_md5_sums(core_exported, mode)
@@ -169,12 +177,12 @@ def test_stop(pyocf_ctx, mode: CacheMode, cls: CacheLineSize, with_flush: bool):
     Check if cache is stopped properly in different modes with or without preceding flush operation.
     """
 
-    cache_device = Volume(Size.from_MiB(50))
-    core_device = Volume(Size.from_MiB(5))
+    cls_no = 10
+    cache_device = Volume(Size(max(Size.from_MiB(50).B, 4 * cls_no * cls)))
+    core_device = Volume(Size(max(Size.from_MiB(5).B, cls_no * cls)))
     cache = Cache.start_on_device(cache_device, cache_mode=mode, cache_line_size=cls)
     core_exported = Core.using_device(core_device)
     cache.add_core(core_exported)
-    cls_no = 10
 
     run_io_and_cache_data_if_possible(core_exported, mode, cls, cls_no)
 
@@ -405,6 +413,31 @@ def test_start_stop_noqueue(pyocf_ctx):
     assert not c.results["error"], "Failed to stop cache: {}".format(c.results["error"])
 
 
+def test_load_cache_other_metadata_version(pyocf_ctx):
+    """
+    Verify that cache metadata saved with different metadata version, thus
+    possibly different layout, is refused on load.
+    """
+    # Offset of metadata_version in superblock at the beginning of volume
+    version_offset = 8
+
+    cache_device = Volume(Size.from_MiB(50))
+    cache = Cache.start_on_device(cache_device)
+    cache.stop()
+
+    version = bytes(cache_device.data[version_offset : version_offset + 4])
+    old_version = (int.from_bytes(version, "little") - 1).to_bytes(4, "little")
+    cache_device.data[version_offset : version_offset + 4] = old_version
+
+    with pytest.raises(OcfError) as e:
+        Cache.load_from_device(cache_device)
+
+    assert e.value.error_code == OcfErrorCode.OCF_ERR_METADATA_VER
+
+    cache_device.data[version_offset : version_offset + 4] = version
+    cache = Cache.load_from_device(cache_device)
+
+
 def run_io_and_cache_data_if_possible(exported_obj, mode, cls, cls_no):
     test_data = Data(cls_no * cls)
 
@@ -422,6 +455,16 @@ def run_io_and_cache_data_if_possible(exported_obj, mode, cls, cls_no):
         ((cls_no * cls / CacheLineSize.LINE_4KiB) if mode != CacheMode.PT else 0), "Occupancy"
 
 
+def status_block(cache: Cache):
+    # I/O smaller than status granularity is served in pass-through mode
+    return max(Size.from_sector(1).B, cache.cfg._status_granularity)
+
+
+def block_from_string(source: str, size: int):
+    b = bytes(source, "ascii")
+    return Data.from_bytes((b * (size // len(b) + 1))[:size])
+
+
 def io_to_core(exported_obj: Core, data: Data, offset: int, to_core_device=False):
     new_io = exported_obj.new_core_io if to_core_device else exported_obj.new_io
     io = new_io(exported_obj.cache.get_default_queue(), offset, data.size,
@@ -0,0 +1,85 @@
+#
+# Copyright(c) 2021 Intel Corporation
+# SPDX-License-Identifier: BSD-3-Clause-Clear
+#
+
+from pyocf.types.cache import CacheMode
+from pyocf.types.core import Core
+from pyocf.types.data import Data
+from pyocf.types.io import IoDir
+from pyocf.types.volume import Volume, DiscardTraceDevice
+from pyocf.utils import Size, io_to_core, start_cache_with_core
+
+
+def prepare(cache_device, trim_rate):
+    core_device = Volume(Size.from_MiB(50))
+
+    cache, core = start_cache_with_core(cache_device, core_device, cache_mode=CacheMode.WT)
+    cache.set_trim_rate(trim_rate)
+
+    data = Data.from_bytes(b"\xaa" * int(Size.from_MiB(4)))
+    assert io_to_core(core, 0, data, IoDir.WRITE) == 0
+
+    return cache, core
+
+
+def test_trim_freed_lines(pyocf_ctx):
+    """
+    Remove core and verify that cache lines freed by removal are discarded
+    on cache device by cleaner in few coalesced requests.
+    """
+    cache_device = DiscardTraceDevice(Size.from_MiB(50))
+    cache, core = prepare(cache_device, 1024)
+
+    data_offset = int(cache.get_stats()["conf"]["metadata_end_offset"])
+    cache.remove_core(core)
+    assert cache_device.discards == []
+
+    cache.run_cleaner()
+
+    discarded = sum(size for _, size in cache_device.discards)
+    assert discarded == int(Size.from_MiB(4))
+    assert len(cache_device.discards) < 16
+    for addr, size in cache_device.discards:
+        assert addr >= data_offset
+        assert cache_device.get_bytes()[addr : addr + size] == bytes(size)
+
+    cache_device.discards.clear()
+    cache.run_cleaner()
+    assert cache_device.discards == []
+
+    core = Core.using_device(Volume(Size.from_MiB(50)))
+    cache.add_core(core)
+    data = Data.from_bytes(b"\x55" * int(Size.from_MiB(4)))
+    assert io_to_core(core, 0, data, IoDir.WRITE) == 0
+
+    read = Data(int(Size.from_MiB(4)))
+    assert io_to_core(core, 0, read, IoDir.READ) == 0
+    assert read.md5() == data.md5()
+
+
+def test_trim_rate_limit(pyocf_ctx):
+    """
+    Verify that single cleaner run discards no more than trim rate allows.
+    """
+    cache_device = DiscardTraceDevice(Size.from_MiB(50))
+    cache, core = prepare(cache_device, 1)
+
+    cache.remove_core(core)
+    cache.run_cleaner()
+
+    discarded = sum(size for _, size in cache_device.discards)
+    assert 0 < discarded <= int(Size.from_MiB(1))
+
+
+def test_trim_disabled(pyocf_ctx):
+    """
+    Verify that freed cache lines are not discarded by default.
+    """
+    cache_device = DiscardTraceDevice(Size.from_MiB(50))
+    cache, core = prepare(cache_device, 0)
+
+    cache.remove_core(core)
+    cache.run_cleaner()
+
+    assert cache_device.discards == []
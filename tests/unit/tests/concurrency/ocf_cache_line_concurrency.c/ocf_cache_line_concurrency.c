@@ -40,6 +40,8 @@
  *  _req_on_lock
  *  ocf_cache_line_are_waiters
  *  ocf_cl_lock_line_needs_lock
+ *  ocf_cl_lock_line_is_shared
+ *  ocf_cl_lock_mark_shared
  *  ocf_cl_lock_line_get_entry
  *  ocf_cl_lock_line_is_acting
  *  ocf_cl_lock_line_slow
@@ -121,6 +123,29 @@ void __wrap_ocf_alock_unlock_one_rd(struct ocf_alock *alock,
 	ocf_alock_unlock_one_rd(alock, entry);
 }
 
+void __wrap_ocf_alock_unlock_one_wr_batch(struct ocf_alock *alock,
+  const ocf_cache_line_t entry, struct ocf_alock_wake_batch *batch)
+{
+	ocf_alock_unlock_one_wr_batch(alock, entry, batch);
+}
+
+void __wrap_ocf_alock_unlock_one_rd_batch(struct ocf_alock *alock,
+  const ocf_cache_line_t entry, struct ocf_alock_wake_batch *batch)
+{
+	ocf_alock_unlock_one_rd_batch(alock, entry, batch);
+}
+
+void __wrap_ocf_alock_wake_batch_init(struct ocf_alock_wake_batch *batch)
+{
+	ocf_alock_wake_batch_init(batch);
+}
+
+void __wrap_ocf_alock_wake_batch_flush(struct ocf_alock *alock,
+  struct ocf_alock_wake_batch *batch)
+{
+	ocf_alock_wake_batch_flush(alock, batch);
+}
+
 void __wrap_ocf_alock_is_index_locked(struct ocf_alock *alock,
 		  struct ocf_request *req, unsigned index)
 {
@@ -158,6 +183,30 @@ bool __wrap_ocf_alock_trylock_one_rd(struct ocf_alock *alock, ocf_cache_line_t e
 	return ocf_alock_trylock_one_rd(alock, entry);
 }
 
+bool __wrap_ocf_alock_trylock_one_wr(struct ocf_alock *alock, ocf_cache_line_t entry)
+{
+	return ocf_alock_trylock_one_wr(alock, entry);
+}
+
+int __wrap_ocf_alock_init_striped(struct ocf_alock **self,
+  unsigned num_entries, unsigned num_slots, const char* name,
+  struct ocf_alock_lock_cbs *cbs, ocf_cache_t cache)
+{
+	return ocf_alock_init_striped(self, num_entries, num_slots, name,
+			cbs, cache);
+}
+
+bool __wrap_ocf_alock_is_striped(struct ocf_alock *alock)
+{
+	return ocf_alock_is_striped(alock);
+}
+
+ocf_cache_line_t __wrap_ocf_alock_entry_slot(struct ocf_alock *alock,
+  ocf_cache_line_t entry)
+{
+	return ocf_alock_entry_slot(alock, entry);
+}
+
 bool __wrap_ocf_alock_trylock_entry_wr(struct ocf_alock *alock, ocf_cache_line_t entry)
 {
 	return ocf_alock_trylock_entry_wr(alock, entry);
@@ -447,7 +496,7 @@ static void cctest(unsigned num_threads, unsigned num_iterations, unsigned cline
 	threads = malloc(num_threads * sizeof(threads[0]));
 	memset(threads, 0, num_threads * sizeof(threads[0]));
 
-	assert_int_equal(0, ocf_cache_line_concurrency_init(&c, clines, NULL));
+	assert_int_equal(0, ocf_cache_line_concurrency_init(&c, clines, 0, NULL));
 
 	for (i = 0; i < num_threads; i++)
 	{
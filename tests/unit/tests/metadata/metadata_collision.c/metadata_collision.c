@@ -57,10 +57,39 @@ static void metadata_hash_func_test01(void **state)
 	test_free(cache);
 }
 
+static void metadata_hash_func_test02(void **state)
+{
+	struct ocf_cache *cache;
+	ocf_cache_line_t hash;
+	ocf_core_id_t core_id;
+	bool *used;
+
+	print_test_description("Verify that first core lines of all cores are "
+				"mapped to distinct hash table entries");
+
+	cache = test_malloc(sizeof(*cache));
+	cache->device = test_malloc(sizeof(*cache->device));
+	cache->device->hash_table_entries = OCF_CORE_MAX;
+
+	used = test_calloc(OCF_CORE_MAX, sizeof(*used));
+
+	for (core_id = 0; core_id < OCF_CORE_MAX; core_id++) {
+		hash = ocf_metadata_hash_func(cache, 0, core_id);
+		assert(hash < cache->device->hash_table_entries);
+		assert(!used[hash]);
+		used[hash] = true;
+	}
+
+	test_free(used);
+	test_free(cache->device);
+	test_free(cache);
+}
+
 int main(void)
 {
 	const struct CMUnitTest tests[] = {
-		cmocka_unit_test(metadata_hash_func_test01)
+		cmocka_unit_test(metadata_hash_func_test01),
+		cmocka_unit_test(metadata_hash_func_test02)
 	};
 
 	print_message("Unit test of src/metadata/metadata_collision.c");
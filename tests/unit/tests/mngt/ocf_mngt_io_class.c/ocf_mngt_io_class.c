@@ -33,6 +33,7 @@
 #include "../engine/cache_engine.h"
 #include "../utils/utils_user_part.h"
 #include "../ocf_lru.h"
+#include "../promotion/promotion.h"
 #include "ocf_env.h"
 
 #include "mngt/ocf_mngt_io_class.c/ocf_mngt_io_class_generated_wraps.c"
@@ -24,6 +24,7 @@
  *  ocf_rb_tree_remove
  *  ocf_rb_tree_can_update
  *  ocf_rb_tree_find
+ *  ocf_rb_tree_find_floor
  * </functions_to_leave>
  */
 
@@ -211,6 +212,33 @@ static void ocf_rb_tree_test05(void **state)
 			);
 }
 
+static void ocf_rb_tree_test06(void **state)
+{
+	struct ocf_rb_tree tree;
+	struct test_node *tmp_node;
+	struct test_node key;
+	int i;
+
+	struct {
+		int key;
+		int floor;
+	} lookups[] = {{1, 1}, {2, 1}, {44, 42}, {45, 45}, {98, 97},
+		{298, 99}, {1000, 299}};
+
+	print_test_description("Find greatest value not greater than key");
+
+	prepare(&tree);
+
+	for (i = 0; i < sizeof(lookups)/sizeof(lookups[0]); i++) {
+		key.val = lookups[i].key;
+		tmp_node = get_node(ocf_rb_tree_find_floor(&tree, &key.tree));
+		assert_int_equal(lookups[i].floor, tmp_node->val);
+	}
+
+	key.val = 0;
+	assert_null(ocf_rb_tree_find_floor(&tree, &key.tree));
+}
+
 int main(void)
 {
 	const struct CMUnitTest tests[] = {
@@ -218,7 +246,8 @@ int main(void)
 		cmocka_unit_test(ocf_rb_tree_test02),
 		cmocka_unit_test(ocf_rb_tree_test03),
 		cmocka_unit_test(ocf_rb_tree_test04),
-		cmocka_unit_test(ocf_rb_tree_test05)
+		cmocka_unit_test(ocf_rb_tree_test05),
+		cmocka_unit_test(ocf_rb_tree_test06)
 	};
 
 	print_message("Unit tests for rb tree\n");